@@ -0,0 +1,64 @@
+#include "allocation_benchmarks/allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace principia {
+namespace allocation_benchmarks {
+namespace _allocation_counter {
+namespace internal {
+
+namespace {
+std::atomic<std::int64_t> allocation_count = 0;
+}  // namespace
+
+std::int64_t AllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* CountedAllocate(std::size_t const size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  // |malloc| may return null for a zero size.
+  if (void* const pointer = std::malloc(size == 0 ? 1 : size);
+      pointer != nullptr) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace internal
+}  // namespace _allocation_counter
+}  // namespace allocation_benchmarks
+}  // namespace principia
+
+// Replacements for the global allocation functions.  The nothrow forms are
+// not replaced as the default ones call these.  The aligned forms are not
+// replaced, and neither are their matching deallocation functions.
+
+using principia::allocation_benchmarks::_allocation_counter::internal::
+    CountedAllocate;
+
+void* operator new(std::size_t const size) {
+  return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t const size) {
+  return CountedAllocate(size);
+}
+
+void operator delete(void* const pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* const pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* const pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* const pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
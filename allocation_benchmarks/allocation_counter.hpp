@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace principia {
+namespace allocation_benchmarks {
+namespace _allocation_counter {
+namespace internal {
+
+// Returns the number of calls to the global (unaligned) |operator new| made
+// since the start of the program, by all threads.  The benchmarks may use the
+// difference between two calls to check that some code doesn't allocate.
+std::int64_t AllocationCount();
+
+}  // namespace internal
+
+using internal::AllocationCount;
+
+}  // namespace _allocation_counter
+}  // namespace allocation_benchmarks
+}  // namespace principia
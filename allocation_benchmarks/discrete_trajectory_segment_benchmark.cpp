@@ -0,0 +1,130 @@
+// .\Release\x64\allocation_benchmarks.exe --benchmark_filter=ReusedOutput|DownsamplingAppend  // NOLINT(whitespace/line_length)
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "allocation_benchmarks/allocation_counter.hpp"
+#include "base/status_utilities.hpp"  // 🧙 For CHECK_OK.
+#include "benchmark/benchmark.h"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/instant.hpp"
+#include "geometry/space.hpp"
+#include "glog/logging.h"
+#include "numerics/fit_hermite_spline.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using namespace principia::allocation_benchmarks::_allocation_counter;
+using namespace principia::geometry::_frame;
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_instant;
+using namespace principia::geometry::_space;
+using namespace principia::numerics::_fit_hermite_spline;
+using namespace principia::physics::_degrees_of_freedom;
+using namespace principia::physics::_discrete_trajectory;
+using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+
+namespace {
+
+using World = Frame<struct WorldTag, Inertial>;
+
+AngularFrequency const ω = 1 * Radian / Second;
+Time const Δt = 0.1 * Second;
+
+// The degrees of freedom at time |t| of a uniform circular motion of radius
+// 1 m and angular frequency |ω| around the origin.
+DegreesOfFreedom<World> CircularMotion(Instant const& t) {
+  Angle const θ = ω * (t - Instant());
+  return DegreesOfFreedom<World>(
+      World::origin +
+          Displacement<World>({Cos(θ) * Metre, Sin(θ) * Metre, 0 * Metre}),
+      Velocity<World>({-Sin(θ) * Metre / Second,
+                       Cos(θ) * Metre / Second,
+                       0 * Metre / Second}));
+}
+
+}  // namespace
+
+// Fits a spline to the same samples repeatedly, reusing the output vector.
+// Once the vector has been sized by the first call, which is not measured,
+// fitting must not allocate.
+void BM_FitHermiteSplineReusedOutput(benchmark::State& state) {
+  struct Sample {
+    Instant t;
+    Position<World> q;
+    Velocity<World> v;
+  };
+  std::vector<Sample> samples;
+  for (int i = 0; i < state.range(0); ++i) {
+    Instant const t = Instant() + i * Δt;
+    auto const degrees_of_freedom = CircularMotion(t);
+    samples.push_back({.t = t,
+                       .q = degrees_of_freedom.position(),
+                       .v = degrees_of_freedom.velocity()});
+  }
+  std::vector<std::vector<Sample>::const_iterator> fit;
+  auto const fit_hermite_spline = [&samples, &fit]() {
+    return FitHermiteSpline<Position<World>, Instant>(
+        samples,
+        [](auto&& sample) -> auto&& { return sample.t; },
+        [](auto&& sample) -> auto&& { return sample.q; },
+        [](auto&& sample) -> auto&& { return sample.v; },
+        /*tolerance=*/1 * Milli(Metre),
+        fit);
+  };
+  CHECK_OK(fit_hermite_spline());
+
+  std::int64_t const allocations_before = AllocationCount();
+  for (auto _ : state) {
+    CHECK_OK(fit_hermite_spline());
+  }
+  std::int64_t const allocations = AllocationCount() - allocations_before;
+  CHECK_EQ(0, allocations);
+  state.counters["allocations_per_fit"] =
+      benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+}
+
+// Appends points one at a time to a downsampled trajectory, as is done for the
+// histories of the vessels, and reports the number of allocations per append.
+// The trajectory is first filled over several downsampling windows, which is
+// not measured.  The downsampling itself doesn't allocate after that, but the
+// timeline may still grow occasionally to accommodate the retained points.
+void BM_DiscreteTrajectoryDownsamplingAppend(benchmark::State& state) {
+  int const max_dense_intervals = state.range(0);
+  DiscreteTrajectory<World> trajectory;
+  trajectory.segments().front().SetDownsampling(
+      {.max_dense_intervals = max_dense_intervals,
+       .tolerance = 1 * Milli(Metre)});
+  Instant t;
+  for (int i = 0; i < 4 * max_dense_intervals; ++i) {
+    CHECK_OK(trajectory.Append(t, CircularMotion(t)));
+    t += Δt;
+  }
+
+  std::int64_t const allocations_before = AllocationCount();
+  for (auto _ : state) {
+    CHECK_OK(trajectory.Append(t, CircularMotion(t)));
+    t += Δt;
+  }
+  state.counters["allocations_per_append"] =
+      benchmark::Counter(AllocationCount() - allocations_before,
+                         benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_FitHermiteSplineReusedOutput)->Arg(100)->Arg(10'000);
+BENCHMARK(BM_DiscreteTrajectoryDownsamplingAppend)->Arg(100)->Arg(10'000);
+
+}  // namespace physics
+}  // namespace principia
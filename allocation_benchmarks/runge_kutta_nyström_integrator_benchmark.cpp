@@ -0,0 +1,169 @@
+// .\Release\x64\allocation_benchmarks.exe --benchmark_filter=RepeatedSolve
+
+#define GLOG_NO_ABBREVIATED_SEVERITIES
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "allocation_benchmarks/allocation_counter.hpp"
+#include "base/status_utilities.hpp"  // 🧙 For CHECK_OK.
+#include "benchmark/benchmark.h"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/instant.hpp"
+#include "geometry/space.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/integrators.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace integrators {
+
+using namespace principia::allocation_benchmarks::_allocation_counter;
+using namespace principia::geometry::_frame;
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_instant;
+using namespace principia::geometry::_space;
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_integrator;  // NOLINT
+using namespace principia::integrators::_integrators;
+using namespace principia::integrators::_methods;
+using namespace principia::integrators::_ordinary_differential_equations;
+using namespace principia::integrators::_symplectic_runge_kutta_nyström_integrator;  // NOLINT
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+
+namespace {
+
+using World = Frame<struct WorldTag, Inertial>;
+using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
+
+// Returns a problem made of |dimension| independent harmonic oscillators.
+InitialValueProblem<ODE> HarmonicOscillators(int const dimension) {
+  std::vector<Position<World>> q_initial;
+  std::vector<Velocity<World>> v_initial;
+  for (int k = 0; k < dimension; ++k) {
+    q_initial.push_back(
+        World::origin +
+        Displacement<World>({(k + 1) * Metre, -k * Metre, 0.5 * Metre}));
+    v_initial.push_back(Velocity<World>({0.1 * Metre / Second,
+                                         k * Metre / Second,
+                                         -0.2 * Metre / Second}));
+  }
+
+  ODE harmonic_oscillators;
+  harmonic_oscillators.compute_acceleration =
+      [](Instant const& t,
+         std::vector<Position<World>> const& q,
+         std::vector<Vector<Acceleration, World>>& result) {
+        for (int k = 0; k < q.size(); ++k) {
+          result[k] = (World::origin - q[k]) *
+                      (si::Unit<Stiffness> / si::Unit<Mass>);
+        }
+        return absl::OkStatus();
+      };
+  InitialValueProblem<ODE> problem;
+  problem.equation = harmonic_oscillators;
+  problem.initial_state = {Instant(), q_initial, v_initial};
+  return problem;
+}
+
+// Calls |Solve| repeatedly on |instance| for |solve_duration| at a time, as is
+// done when the game drives the integration, and reports the number of
+// allocations per call.  The first call, which sizes the scratch storage of the
+// instance, is not measured, so the count should be 0.
+void SolveRepeatedly(Integrator<ODE>::Instance& instance,
+                     Time const& solve_duration,
+                     benchmark::State& state) {
+  Instant t_final = instance.time().value + solve_duration;
+  CHECK_OK(instance.Solve(t_final));
+
+  std::int64_t const allocations_before = AllocationCount();
+  for (auto _ : state) {
+    t_final += solve_duration;
+    CHECK_OK(instance.Solve(t_final));
+  }
+  state.counters["allocations_per_solve"] =
+      benchmark::Counter(AllocationCount() - allocations_before,
+                         benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+template<typename Method>
+void BM_SymplecticRungeKuttaNyströmIntegratorRepeatedSolve(
+    benchmark::State& state) {
+  Time const step = 3.0e-4 * Second;
+  Length q_sum;
+  auto const instance =
+      SymplecticRungeKuttaNyströmIntegrator<Method, ODE>().NewInstance(
+          HarmonicOscillators(/*dimension=*/state.range(0)),
+          [&q_sum](ODE::State const& state) {
+            q_sum += (state.positions.back().value - World::origin).Norm();
+          },
+          step);
+  SolveRepeatedly(*instance, /*solve_duration=*/10 * step, state);
+  benchmark::DoNotOptimize(q_sum);
+}
+
+template<typename Method>
+void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorRepeatedSolve(
+    benchmark::State& state) {
+  Time const solve_duration = 1 * Second;
+  Length const length_tolerance = 1e-6 * Metre;
+  Speed const speed_tolerance = 1e-6 * Metre / Second;
+  Length q_sum;
+  // The last step must not be exact for the instance to be reusable.
+  AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+      /*first_time_step=*/solve_duration,
+      /*safety_factor=*/0.9,
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*last_step_is_exact=*/false);
+  auto const instance =
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, ODE>().NewInstance(
+          HarmonicOscillators(/*dimension=*/state.range(0)),
+          [&q_sum](ODE::State const& state) {
+            q_sum += (state.positions.back().value - World::origin).Norm();
+          },
+          [length_tolerance, speed_tolerance](
+              Time const& h,
+              ODE::State const& /*state*/,
+              ODE::State::Error const& error) {
+            double ratio = std::numeric_limits<double>::infinity();
+            for (int k = 0; k < error.position_error.size(); ++k) {
+              ratio = std::min({ratio,
+                                length_tolerance /
+                                    error.position_error[k].Norm(),
+                                speed_tolerance /
+                                    error.velocity_error[k].Norm()});
+            }
+            return ratio;
+          },
+          parameters);
+  SolveRepeatedly(*instance, solve_duration, state);
+  benchmark::DoNotOptimize(q_sum);
+}
+
+BENCHMARK_TEMPLATE(
+    BM_SymplecticRungeKuttaNyströmIntegratorRepeatedSolve,
+    methods::McLachlanAtela1992Order4Optimal)
+    ->Arg(1)->Arg(64);
+BENCHMARK_TEMPLATE(
+    BM_SymplecticRungeKuttaNyströmIntegratorRepeatedSolve,
+    methods::BlanesMoan2002SRKN14A)
+    ->Arg(1)->Arg(64);
+BENCHMARK_TEMPLATE(
+    BM_EmbeddedExplicitRungeKuttaNyströmIntegratorRepeatedSolve,
+    methods::DormandالمكاوىPrince1986RKN434FM)
+    ->Arg(1)->Arg(64);
+
+}  // namespace integrators
+}  // namespace principia
@@ -3,6 +3,7 @@
 #include "base/graveyard.hpp"
 
 #include <memory>
+#include <utility>
 
 namespace principia {
 namespace base {
@@ -14,10 +15,8 @@ inline Graveyard::Graveyard(std::int64_t const number_of_threads)
 
 template<typename T>
 void Graveyard::Bury(std::unique_ptr<T> t) {
-  // TODO(egg): Investigate the possibility of a mutable lambda with
-  // std::packaged_task in the ThreadPool instead of std::function.
-  gravedigger_.Add([coffin = t.release()]() {
-    delete coffin;
+  gravedigger_.AddDetached([coffin = std::move(t)]() mutable {
+    coffin.reset();
   });
 }
 
@@ -119,6 +119,10 @@ char const* const Architecture = "x86-64";
 // Set this to 1 to test analytical series based on piecewise Poisson series.
 #define PRINCIPIA_CONTINUOUS_TRAJECTORY_SUPPORTS_PIECEWISE_POISSON_SERIES 0
 
+// Set this to 1 to store the points of discrete trajectories in a
+// |FlatTimeline| instead of a B-tree.
+#define PRINCIPIA_DISCRETE_TRAJECTORY_FLAT_TIMELINE 0
+
 // Thread-safety analysis.
 #if PRINCIPIA_COMPILER_CLANG || PRINCIPIA_COMPILER_CLANG_CL
 #  define THREAD_ANNOTATION_ATTRIBUTE__(x) __attribute__((x))
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "base/jthread.hpp"
+#include "base/thread_pool.hpp"
+
+namespace principia {
+namespace base {
+namespace _parallel_for {
+namespace internal {
+
+using namespace principia::base::_jthread;
+using namespace principia::base::_thread_pool;
+
+// Calls |body(i)| for all |i| in [begin, end[ using the threads of |pool|.  The
+// range is cut into chunks of |grain_size| consecutive indices, which are
+// executed in increasing order within each chunk; the chunks are processed in
+// an unspecified order.  The calling thread also processes chunks, so this
+// function may be called from a thread of |pool| without risking a deadlock.
+// If a call to |body| returns an error, the chunks that have not started are
+// skipped, the chunks that have started run to completion, and the error with
+// the lowest chunk index is returned.  Similarly, once a stop is requested on
+// |stop_token|, the chunks that have not started are skipped and a
+// |CancelledError| is returned, unless a chunk with a lower index failed.  As
+// |body| does not necessarily run on the calling thread, it cannot rely on
+// |RETURN_IF_STOPPED|, but it may check |stop_token|.  Returns when all the
+// calls that were started have completed.
+template<typename T>
+absl::Status ParallelFor(
+    ThreadPool<T>& pool,
+    std::int64_t begin,
+    std::int64_t end,
+    std::function<absl::Status(std::int64_t index)> const& body,
+    std::int64_t grain_size = 1,
+    stop_token const& stop_token = {});
+
+// Same as |ParallelFor|, but each chunk accumulates its results in a value
+// initialized to |identity|, and the values of the chunks are combined in
+// increasing chunk order using |combine|.  Therefore, the result is
+// deterministic for a given |grain_size| even if |combine| is not associative
+// (e.g., floating-point addition).
+template<typename Value, typename T>
+absl::StatusOr<Value> ParallelReduce(
+    ThreadPool<T>& pool,
+    std::int64_t begin,
+    std::int64_t end,
+    Value const& identity,
+    std::type_identity_t<
+        std::function<absl::Status(std::int64_t index, Value& accumulator)>>
+        const& body,
+    std::type_identity_t<
+        std::function<Value(Value const& left, Value const& right)>>
+        const& combine,
+    std::int64_t grain_size = 1,
+    stop_token const& stop_token = {});
+
+}  // namespace internal
+
+using internal::ParallelFor;
+using internal::ParallelReduce;
+
+}  // namespace _parallel_for
+}  // namespace base
+}  // namespace principia
+
+#include "base/parallel_for_body.hpp"
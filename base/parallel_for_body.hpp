@@ -0,0 +1,197 @@
+#pragma once
+
+#include "base/parallel_for.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace _parallel_for {
+namespace internal {
+
+// The state shared by the threads that process the chunks of a loop.  It is
+// reference-counted because the tasks added to the pool may only start after
+// the loop has completed, in which case they find no chunk to process.
+class Chunks {
+ public:
+  Chunks(std::int64_t number_of_chunks,
+         std::function<absl::Status(std::int64_t chunk)> run_chunk,
+         stop_token stop_token);
+
+  // Processes chunks until there are none left to start.  A chunk that starts
+  // after a stop was requested on |stop_token_| fails with a |CancelledError|
+  // without being run.
+  void RunAvailable();
+
+  // Waits until all the chunks have completed, and returns the error of the
+  // chunk with the lowest index, if any.
+  absl::Status Await();
+
+ private:
+  std::int64_t const number_of_chunks_;
+  std::function<absl::Status(std::int64_t chunk)> const run_chunk_;
+  stop_token const stop_token_;
+
+  std::atomic<std::int64_t> next_chunk_ = 0;
+  std::atomic<bool> cancelled_ = false;
+
+  absl::Mutex lock_;
+  std::int64_t completed_chunks_ GUARDED_BY(lock_) = 0;
+  std::int64_t error_chunk_ GUARDED_BY(lock_) =
+      std::numeric_limits<std::int64_t>::max();
+  absl::Status status_ GUARDED_BY(lock_);
+};
+
+inline Chunks::Chunks(
+    std::int64_t const number_of_chunks,
+    std::function<absl::Status(std::int64_t chunk)> run_chunk,
+    stop_token stop_token)
+    : number_of_chunks_(number_of_chunks),
+      run_chunk_(std::move(run_chunk)),
+      stop_token_(std::move(stop_token)) {}
+
+inline void Chunks::RunAvailable() {
+  for (;;) {
+    std::int64_t const chunk =
+        next_chunk_.fetch_add(1, std::memory_order_relaxed);
+    if (chunk >= number_of_chunks_) {
+      return;
+    }
+    absl::Status status;
+    if (!cancelled_.load(std::memory_order_relaxed)) {
+      status = stop_token_.stop_requested()
+                   ? absl::CancelledError("Cancelled by stop token")
+                   : run_chunk_(chunk);
+      if (!status.ok()) {
+        cancelled_.store(true, std::memory_order_relaxed);
+      }
+    }
+    absl::MutexLock l(&lock_);
+    if (!status.ok() && chunk < error_chunk_) {
+      error_chunk_ = chunk;
+      status_ = std::move(status);
+    }
+    ++completed_chunks_;
+  }
+}
+
+inline absl::Status Chunks::Await() {
+  absl::MutexLock l(&lock_);
+  lock_.Await(absl::Condition(
+      +[](Chunks* const chunks) EXCLUSIVE_LOCKS_REQUIRED(chunks->lock_) {
+        return chunks->completed_chunks_ == chunks->number_of_chunks_;
+      },
+      this));
+  return status_;
+}
+
+// Processes |number_of_chunks| chunks on |pool| and on the calling thread,
+// until a stop is requested on |stop_token|.
+template<typename T>
+absl::Status RunChunks(
+    ThreadPool<T>& pool,
+    std::int64_t const number_of_chunks,
+    std::function<absl::Status(std::int64_t chunk)> run_chunk,
+    stop_token const& stop_token) {
+  if (number_of_chunks == 0) {
+    return absl::OkStatus();
+  }
+  auto const chunks = std::make_shared<Chunks>(
+      number_of_chunks, std::move(run_chunk), stop_token);
+  // The calling thread processes chunks too, so we need at most
+  // |number_of_chunks - 1| helpers.  The completion is tracked by |chunks|, so
+  // the helpers are detached: a helper that starts late has nothing to do.
+  std::int64_t const number_of_helpers =
+      std::min(number_of_chunks - 1, pool.pool_size());
+  for (std::int64_t i = 0; i < number_of_helpers; ++i) {
+    pool.AddDetached([chunks]() { chunks->RunAvailable(); });
+  }
+  chunks->RunAvailable();
+  return chunks->Await();
+}
+
+template<typename T>
+absl::Status ParallelFor(
+    ThreadPool<T>& pool,
+    std::int64_t const begin,
+    std::int64_t const end,
+    std::function<absl::Status(std::int64_t index)> const& body,
+    std::int64_t const grain_size,
+    stop_token const& stop_token) {
+  CHECK_LE(begin, end);
+  CHECK_LT(0, grain_size);
+  std::int64_t const number_of_chunks = (end - begin + grain_size - 1) /
+                                        grain_size;
+  return RunChunks(
+      pool,
+      number_of_chunks,
+      [begin, end, grain_size, &body](std::int64_t const chunk) {
+        std::int64_t const chunk_begin = begin + chunk * grain_size;
+        std::int64_t const chunk_end = std::min(end, chunk_begin + grain_size);
+        for (std::int64_t i = chunk_begin; i < chunk_end; ++i) {
+          if (absl::Status const status = body(i); !status.ok()) {
+            return status;
+          }
+        }
+        return absl::OkStatus();
+      },
+      stop_token);
+}
+
+template<typename Value, typename T>
+absl::StatusOr<Value> ParallelReduce(
+    ThreadPool<T>& pool,
+    std::int64_t const begin,
+    std::int64_t const end,
+    Value const& identity,
+    std::type_identity_t<
+        std::function<absl::Status(std::int64_t index, Value& accumulator)>>
+        const& body,
+    std::type_identity_t<
+        std::function<Value(Value const& left, Value const& right)>>
+        const& combine,
+    std::int64_t const grain_size,
+    stop_token const& stop_token) {
+  CHECK_LE(begin, end);
+  CHECK_LT(0, grain_size);
+  std::int64_t const number_of_chunks = (end - begin + grain_size - 1) /
+                                        grain_size;
+  std::vector<Value> accumulators(number_of_chunks, identity);
+  absl::Status const status = RunChunks(
+      pool,
+      number_of_chunks,
+      [begin, end, grain_size, &accumulators, &body](
+          std::int64_t const chunk) {
+        std::int64_t const chunk_begin = begin + chunk * grain_size;
+        std::int64_t const chunk_end = std::min(end, chunk_begin + grain_size);
+        for (std::int64_t i = chunk_begin; i < chunk_end; ++i) {
+          if (absl::Status const status = body(i, accumulators[chunk]);
+              !status.ok()) {
+            return status;
+          }
+        }
+        return absl::OkStatus();
+      },
+      stop_token);
+  if (!status.ok()) {
+    return status;
+  }
+  Value result = identity;
+  for (auto const& accumulator : accumulators) {
+    result = combine(result, accumulator);
+  }
+  return result;
+}
+
+}  // namespace internal
+}  // namespace _parallel_for
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,151 @@
+#include "base/parallel_for.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/jthread.hpp"
+#include "base/thread_pool.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+namespace base {
+
+using namespace principia::base::_jthread;
+using namespace principia::base::_parallel_for;
+using namespace principia::base::_thread_pool;
+using namespace principia::testing_utilities::_matchers;
+
+class ParallelForTest : public ::testing::Test {
+ protected:
+  ParallelForTest() : pool_(/*pool_size=*/4) {}
+
+  ThreadPool<void> pool_;
+};
+
+TEST_F(ParallelForTest, AllIndices) {
+  for (std::int64_t const grain_size : {1, 3, 7, 1000}) {
+    std::vector<std::atomic<int>> calls(100);
+    EXPECT_OK(ParallelFor(pool_,
+                          /*begin=*/10,
+                          /*end=*/110,
+                          [&calls](std::int64_t const i) {
+                            ++calls[i - 10];
+                            return absl::OkStatus();
+                          },
+                          grain_size));
+    for (auto const& c : calls) {
+      EXPECT_EQ(1, c) << grain_size;
+    }
+  }
+}
+
+TEST_F(ParallelForTest, EmptyRange) {
+  EXPECT_OK(ParallelFor(pool_,
+                        /*begin=*/5,
+                        /*end=*/5,
+                        [](std::int64_t const i) {
+                          ADD_FAILURE() << i;
+                          return absl::OkStatus();
+                        }));
+}
+
+TEST_F(ParallelForTest, Error) {
+  std::atomic<std::int64_t> calls = 0;
+  auto const status = ParallelFor(pool_,
+                                  /*begin=*/0,
+                                  /*end=*/100'000,
+                                  [&calls](std::int64_t const i) {
+                                    ++calls;
+                                    if (i == 17) {
+                                      return absl::CancelledError("17");
+                                    }
+                                    return absl::OkStatus();
+                                  },
+                                  /*grain_size=*/10);
+  EXPECT_THAT(status, StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_EQ("17", status.message());
+  // The chunks started after the error are skipped.
+  EXPECT_LT(calls, 100'000);
+}
+
+TEST_F(ParallelForTest, Stop) {
+  // A thread used only for its stop state.
+  jthread owner = MakeStoppableThread([]() {});
+  owner.join();
+
+  std::atomic<std::int64_t> calls = 0;
+  auto const status = ParallelFor(pool_,
+                                  /*begin=*/0,
+                                  /*end=*/100'000,
+                                  [&calls, &owner](std::int64_t const i) {
+                                    ++calls;
+                                    if (i == 17) {
+                                      owner.request_stop();
+                                    }
+                                    return absl::OkStatus();
+                                  },
+                                  /*grain_size=*/10,
+                                  owner.get_stop_token());
+  EXPECT_THAT(status, StatusIs(absl::StatusCode::kCancelled));
+  // The chunks started after the stop request are skipped.
+  EXPECT_LT(calls, 100'000);
+
+  // Nothing runs once a stop has been requested.
+  EXPECT_THAT(ParallelFor(pool_,
+                          /*begin=*/0,
+                          /*end=*/100,
+                          [](std::int64_t const i) {
+                            ADD_FAILURE() << i;
+                            return absl::OkStatus();
+                          },
+                          /*grain_size=*/1,
+                          owner.get_stop_token()),
+              StatusIs(absl::StatusCode::kCancelled));
+}
+
+TEST_F(ParallelForTest, Reduce) {
+  for (std::int64_t const grain_size : {1, 3, 64}) {
+    auto const sum = ParallelReduce(
+        pool_,
+        /*begin=*/0,
+        /*end=*/1000,
+        /*identity=*/std::int64_t{0},
+        [](std::int64_t const i, std::int64_t& accumulator) {
+          accumulator += i * i;
+          return absl::OkStatus();
+        },
+        [](std::int64_t const left, std::int64_t const right) {
+          return left + right;
+        },
+        grain_size);
+    ASSERT_THAT(sum, IsOk());
+    EXPECT_EQ(332'833'500, sum.value()) << grain_size;
+  }
+}
+
+TEST_F(ParallelForTest, Nested) {
+  // A pool with a single thread that runs a loop: the calling thread must do
+  // the work, otherwise this would deadlock.
+  ThreadPool<absl::Status> pool(/*pool_size=*/1);
+  std::vector<std::atomic<int>> calls(50);
+  auto future = pool.Add([&calls, &pool]() {
+    return ParallelFor(pool,
+                       /*begin=*/0,
+                       /*end=*/50,
+                       [&calls](std::int64_t const i) {
+                         ++calls[i];
+                         return absl::OkStatus();
+                       });
+  });
+  EXPECT_OK(future.get());
+  for (auto const& c : calls) {
+    EXPECT_EQ(1, c);
+  }
+}
+
+}  // namespace base
+}  // namespace principia
@@ -2,14 +2,17 @@
 
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "base/array.hpp"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "gipfeli/compression.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message.h"
@@ -21,6 +24,7 @@ namespace internal {
 
 using namespace principia::base::_array;
 using namespace principia::base::_not_null;
+using namespace principia::base::_thread_pool;
 
 using ::google::compression::Compressor;
 
@@ -62,15 +66,30 @@ class DelegatingArrayOutputStream
 // irrespective of the size of the message to serialize.
 class PullSerializer final {
  public:
+  using CompressorFactory = std::function<std::unique_ptr<Compressor>()>;
+
   // The |size| of the data objects enqueued by |Push| is never greater than
   // |chunk_size|.  At most |number_of_chunks| chunks are held in the internal
   // queue.  This class uses at most
   // |number_of_chunks * (chunk_size + O(1)) + O(1)| bytes.  Note that in the
-  // presence of compression |chunk_size| is replaced by |compressed_chunk_size|
-  // in this formula.
+  // presence of compression |chunk_size| is replaced by
+  // |chunk_size + compressed_chunk_size| in this formula.  The chunks are
+  // compressed, if needed, by a single thread distinct from the one that
+  // serializes the message.
   PullSerializer(int chunk_size,
                  int number_of_chunks,
                  std::unique_ptr<Compressor> compressor);
+
+  // Same as above, but the chunks are compressed by |compression_threads|
+  // threads, each of which uses a compressor returned by |compressor_factory|.
+  // There is no compression if |compressor_factory| returns null.  The chunks
+  // are still returned by |Pull| in order.  At most |number_of_chunks - 2|
+  // chunks are compressed concurrently.
+  PullSerializer(int chunk_size,
+                 int number_of_chunks,
+                 int compression_threads,
+                 CompressorFactory const& compressor_factory);
+
   ~PullSerializer();
 
   // Starts the serializer, which will proceed to serialize |message|.  This
@@ -87,40 +106,58 @@ class PullSerializer final {
   // stream and the boundaries between chunks are irrelevant.  In the presence
   // of compression however, the data producted by |Pull| are made of blocks and
   // the boundaries between chunks are relevant and must be preserved by the
-  // clients and used when feeding data back to the deserializer.
+  // clients and used when feeding data back to the deserializer.  Each block
+  // may be uncompressed independently of the others.
   Array<std::uint8_t> Pull();
 
  private:
-  // Enqueues the chunk of data to be returned to |Pull| and returns a free
-  // chunk.  Blocks if there are no free chunks.  Used as a callback for the
-  // underlying |DelegatingArrayOutputStream|.
+  // A chunk filled by the stream, and not yet released by |Pull|.
+  struct Chunk {
+    // The index of the chunk in |data_| (and |compressed_data_|), or -1 for
+    // a chunk that doesn't hold any data.
+    int index;
+    // The bytes to return to the client, if available.
+    Array<std::uint8_t> bytes;
+    // In the presence of compression, the result of the compression of the
+    // chunk.  Invalid once it has been waited for.
+    std::future<Array<std::uint8_t>> compressed_bytes;
+  };
+
+  PullSerializer(int chunk_size,
+                 int number_of_chunks,
+                 std::vector<std::unique_ptr<Compressor>> compressors);
+
+  // Enqueues the chunk of data to be returned to |Pull|, starting its
+  // compression if needed, and returns a free chunk.  Blocks if there are no
+  // free chunks.  Used as a callback for the underlying
+  // |DelegatingArrayOutputStream|.
   Array<std::uint8_t> Push(Array<std::uint8_t> bytes);
 
+  // Compresses the chunk at |index|, which holds |bytes|, into
+  // |compressed_data_|.  Runs on |compression_pool_|.
+  Array<std::uint8_t> Compress(int index, Array<std::uint8_t> bytes);
+
   // |owned_message_| is null if this object doesn't own the message.
   // |message_| is non-null after Start.
   std::unique_ptr<google::protobuf::Message const> owned_message_;
   google::protobuf::Message const* message_ = nullptr;
 
-  std::unique_ptr<Compressor> const compressor_;
-
   // The chunk size passed at construction.  The stream outputs chunks of that
   // size.
   int const chunk_size_;
 
   // The maximum size of a chunk after compression.  Greater than |chunk_size_|
   // because the compressor will occasionally expand data.  This is the size of
-  // the chunks in |data_|.
+  // the chunks in |compressed_data_|.
   int const compressed_chunk_size_;
 
   // The number of chunks passed at construction, used to size |data_|.
   int const number_of_chunks_;
 
-  // How many of the |number_of_chunks_| chunks in |data_| are reserved for
-  // compression.
-  int const number_of_compression_chunks_;
-
-  // The array supporting the stream and the stream itself.
-  std::unique_ptr<std::uint8_t[]> data_;
+  // The arrays supporting the stream, the arrays receiving the compressed data
+  // (null in the absence of compression), and the stream itself.
+  std::unique_ptr<std::uint8_t[]> const data_;
+  std::unique_ptr<std::uint8_t[]> const compressed_data_;
   DelegatingArrayOutputStream stream_;
 
   // The thread doing the actual serialization.
@@ -128,17 +165,23 @@ class PullSerializer final {
 
   absl::Mutex lock_;
 
-  // The |queue_| contains the |Array<std::uint8_t>| objects filled by |Push|
-  // and not yet consumed by |Pull|.  If a |Array<std::uint8_t>| object has been
-  // handed over to the caller by |Pull| it stays in the queue until the next
-  // call to |Pull|, to make sure that the pointer is not reused while the
-  // caller processes it.
-  std::queue<Array<std::uint8_t>> queue_ GUARDED_BY(lock_);
-
-  // The |free_| queue contains the start addresses of chunks that are not yet
-  // ready to be returned by |Pull|.  That includes the chunk currently being
-  // filled by the stream.
-  std::queue<not_null<std::uint8_t*>> free_ GUARDED_BY(lock_);
+  // The compressors not currently used by a thread of |compression_pool_|.
+  // Empty in the absence of compression.
+  std::vector<std::unique_ptr<Compressor>> idle_compressors_ GUARDED_BY(lock_);
+
+  // The |queue_| contains the chunks filled by |Push| and not yet consumed by
+  // |Pull|.  If a chunk has been handed over to the caller by |Pull| it stays
+  // in the queue until the next call to |Pull|, to make sure that its memory is
+  // not reused while the caller processes it.
+  std::queue<Chunk> queue_ GUARDED_BY(lock_);
+
+  // The |free_| queue contains the indices of the chunks that are neither in
+  // |queue_| nor being filled by the stream.
+  std::queue<int> free_ GUARDED_BY(lock_);
+
+  // Destroyed first, so that no compression is running while the other members
+  // are destroyed.
+  std::unique_ptr<ThreadPool<Array<std::uint8_t>>> compression_pool_;
 };
 
 }  // namespace internal
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/sink_source.hpp"
 
@@ -68,31 +69,57 @@ inline std::int64_t DelegatingArrayOutputStream::ByteCount() const {
 inline PullSerializer::PullSerializer(int const chunk_size,
                                       int const number_of_chunks,
                                       std::unique_ptr<Compressor> compressor)
-    : compressor_(std::move(compressor)),
-      chunk_size_(chunk_size),
+    : PullSerializer(chunk_size,
+                     number_of_chunks,
+                     /*compression_threads=*/1,
+                     [&compressor]() { return std::move(compressor); }) {}
+
+inline PullSerializer::PullSerializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    int const compression_threads,
+    CompressorFactory const& compressor_factory)
+    : PullSerializer(chunk_size, number_of_chunks, [&]() {
+        std::vector<std::unique_ptr<Compressor>> compressors;
+        for (int i = 0; i < compression_threads; ++i) {
+          auto compressor = compressor_factory();
+          if (compressor == nullptr) {
+            break;
+          }
+          compressors.push_back(std::move(compressor));
+        }
+        return compressors;
+      }()) {}
+
+inline PullSerializer::PullSerializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    std::vector<std::unique_ptr<Compressor>> compressors)
+    : chunk_size_(chunk_size),
       compressed_chunk_size_(
-          compressor_ == nullptr
+          compressors.empty()
               ? chunk_size_
-              : compressor_->MaxCompressedLength(chunk_size_)),
+              : compressors.front()->MaxCompressedLength(chunk_size_)),
       number_of_chunks_(number_of_chunks),
-      number_of_compression_chunks_(compressor_ == nullptr ? 0 : 1),
-      data_(std::make_unique<std::uint8_t[]>(compressed_chunk_size_ *
-                                             number_of_chunks_)),
+      data_(std::make_unique<std::uint8_t[]>(chunk_size_ * number_of_chunks_)),
+      compressed_data_(compressors.empty()
+                           ? nullptr
+                           : std::make_unique<std::uint8_t[]>(
+                                 compressed_chunk_size_ * number_of_chunks_)),
       stream_(Array<std::uint8_t>(data_.get(), chunk_size_),
-              std::bind(&PullSerializer::Push, this, _1)) {
-  // Check the compatibility of the wait conditions in Push and Pull.
-  CHECK_GT(number_of_chunks_ - number_of_compression_chunks_ - 1, 1);
-
-  // Mark all the chunks as free except the last one which is a sentinel for the
-  // |queue_|.  The 0th chunk has been passed to the stream, but it's still free
-  // until the first call to |on_full|.  Note that the last
-  // |compressed_chunk_size_ - chunk_size_| bytes of each chunk are not
-  // considered as free.
-  for (int i = 0; i < number_of_chunks_ - 1; ++i) {
-    free_.push(data_.get() + i * compressed_chunk_size_);
+              std::bind(&PullSerializer::Push, this, _1)),
+      idle_compressors_(std::move(compressors)),
+      compression_pool_(std::make_unique<ThreadPool<Array<std::uint8_t>>>(
+          idle_compressors_.size())) {
+  // We need one chunk for the stream and one for the client.
+  CHECK_LE(2, number_of_chunks_);
+
+  // The 0th chunk has been passed to the stream.  The sentinel at the front of
+  // |queue_| stands for the chunk last returned to the client.
+  for (int i = 1; i < number_of_chunks_; ++i) {
+    free_.push(i);
   }
-  queue_.push(Array<std::uint8_t>(
-      data_.get() + (number_of_chunks_ - 1) * compressed_chunk_size_, 0));
+  queue_.push({.index = -1, .bytes = Array<std::uint8_t>(data_.get(), 0)});
 }
 
 inline PullSerializer::~PullSerializer() {
@@ -114,18 +141,14 @@ inline void PullSerializer::Start(
   thread_ = std::make_unique<std::thread>([this](){
     CHECK(message_->SerializeToZeroCopyStream(&stream_));
     // Put a sentinel at the end of the serialized stream so that the client
-    // knows that this is the end.
-    Array<std::uint8_t> bytes;
-    {
-      absl::MutexLock l(&lock_);
-      CHECK(!free_.empty());
-      bytes = Array<std::uint8_t>(free_.front(), 0);
-    }
-    Push(bytes);
+    // knows that this is the end.  It doesn't hold a chunk.
+    absl::MutexLock l(&lock_);
+    queue_.push({.index = -1, .bytes = Array<std::uint8_t>(data_.get(), 0)});
   });
 }
 
 inline Array<std::uint8_t> PullSerializer::Pull() {
+  std::future<Array<std::uint8_t>> compressed_bytes;
   Array<std::uint8_t> result;
   {
     absl::MutexLock l(&lock_);
@@ -136,57 +159,62 @@ inline Array<std::uint8_t> PullSerializer::Pull() {
     lock_.Await(absl::Condition(&queue_has_elements));
 
     CHECK_LE(2, queue_.size());
-    free_.push(queue_.front().data);
+    if (queue_.front().index >= 0) {
+      free_.push(queue_.front().index);
+    }
     queue_.pop();
-    result = queue_.front();
-    CHECK_EQ(number_of_chunks_, queue_.size() + free_.size());
+    compressed_bytes = std::move(queue_.front().compressed_bytes);
+    result = queue_.front().bytes;
+  }
+  // Wait for the compression outside of the lock, so as to let the serializer
+  // proceed.  The chunk cannot be reused until the next call to |Pull|.
+  if (compressed_bytes.valid()) {
+    result = compressed_bytes.get();
   }
   return result;
 }
 
 inline Array<std::uint8_t> PullSerializer::Push(Array<std::uint8_t> bytes) {
-  Array<std::uint8_t> result;
   CHECK_GE(chunk_size_, bytes.size);
-  if (bytes.size > 0 && compressor_ != nullptr) {
-    Array<std::uint8_t> compressed_bytes;
-    {
-      absl::MutexLock l(&lock_);
-      CHECK_LE(1 + number_of_compression_chunks_, free_.size());
-      free_.pop();
-      compressed_bytes =
-          Array<std::uint8_t>(free_.front(), compressed_chunk_size_);
-      free_.push(bytes.data);
-    }
-    // We maintain the invariant that the chunk being filled is at the front of
-    // the |free_| queue.
-    ArraySource<std::uint8_t> source(bytes);
-    ArraySink<std::uint8_t> sink(compressed_bytes);
-    compressor_->CompressStream(&source, &sink);
-    {
-      absl::MutexLock l(&lock_);
-      bytes = sink.array();
-    }
+  int const index = (bytes.data - data_.get()) / chunk_size_;
+  Chunk chunk{.index = index};
+  if (compressed_data_ == nullptr) {
+    chunk.bytes = bytes;
+  } else {
+    chunk.compressed_bytes = compression_pool_->Add(
+        std::bind(&PullSerializer::Compress, this, index, bytes));
   }
+
+  absl::MutexLock l(&lock_);
+  queue_.push(std::move(chunk));
+  auto const has_free_chunk = [this]() { return !free_.empty(); };
+  lock_.Await(absl::Condition(&has_free_chunk));
+  int const free_index = free_.front();
+  free_.pop();
+  return Array<std::uint8_t>(data_.get() + free_index * chunk_size_,
+                             chunk_size_);
+}
+
+inline Array<std::uint8_t> PullSerializer::Compress(
+    int const index,
+    Array<std::uint8_t> const bytes) {
+  std::unique_ptr<Compressor> compressor;
   {
     absl::MutexLock l(&lock_);
-
-    auto const queue_has_room = [this]() {
-      // -1 here is because we want to ensure that there is an entry in the
-      // free list, in addition to |result| and to
-      // |number_of_compression_chunks_| (if present).
-      return queue_.size() < static_cast<std::size_t>(number_of_chunks_) -
-                                 number_of_compression_chunks_ - 1;
-    };
-    lock_.Await(absl::Condition(&queue_has_room));
-
-    queue_.emplace(bytes.data, bytes.size);
-    CHECK_LE(2 + number_of_compression_chunks_, free_.size());
-    CHECK_EQ(free_.front(), bytes.data);
-    free_.pop();
-    result = Array<std::uint8_t>(free_.front(), chunk_size_);
-    CHECK_EQ(number_of_chunks_, queue_.size() + free_.size());
+    CHECK(!idle_compressors_.empty());
+    compressor = std::move(idle_compressors_.back());
+    idle_compressors_.pop_back();
   }
-  return result;
+  ArraySource<std::uint8_t> source(bytes);
+  ArraySink<std::uint8_t> sink(Array<std::uint8_t>(
+      compressed_data_.get() + index * compressed_chunk_size_,
+      compressed_chunk_size_));
+  compressor->CompressStream(&source, &sink);
+  {
+    absl::MutexLock l(&lock_);
+    idle_compressors_.push_back(std::move(compressor));
+  }
+  return sink.array();
 }
 
 }  // namespace internal
@@ -178,6 +178,36 @@ TEST_F(PullSerializerTest, SerializationGipfeli) {
   EXPECT_EQ(uncompressed1, uncompressed2);
 }
 
+TEST_F(PullSerializerTest, SerializationParallelGipfeli) {
+  auto const trajectory = BuildTrajectory();
+  std::string const expected = trajectory->SerializePartialAsString();
+
+  auto const compressor = google::compression::NewGipfeliCompressor();
+  for (int i = 0; i < runs_per_test; ++i) {
+    auto const compressed_pull_serializer = std::make_unique<PullSerializer>(
+        chunk_size,
+        /*number_of_chunks=*/8,
+        /*compression_threads=*/4,
+        &google::compression::NewGipfeliCompressor);
+    compressed_pull_serializer->Start(BuildTrajectory());
+    std::string actual;
+    for (;;) {
+      Array<std::uint8_t> const bytes = compressed_pull_serializer->Pull();
+      if (bytes.size == 0) {
+        break;
+      }
+      // Each chunk must be uncompressible independently of the others.
+      std::string uncompressed;
+      ASSERT_TRUE(compressor->Uncompress(
+          std::string(reinterpret_cast<char const*>(bytes.data), bytes.size),
+          &uncompressed));
+      EXPECT_GE(chunk_size, uncompressed.size());
+      actual.append(uncompressed);
+    }
+    ASSERT_EQ(expected, actual);
+  }
+}
+
 TEST_F(PullSerializerTest, SerializationThreading) {
   DiscreteTrajectory read_trajectory;
   auto const trajectory = BuildTrajectory();
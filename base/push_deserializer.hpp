@@ -2,15 +2,18 @@
 
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <ostream>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "base/array.hpp"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "gipfeli/compression.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message.h"
@@ -22,6 +25,7 @@ namespace internal {
 
 using namespace principia::base::_array;
 using namespace principia::base::_not_null;
+using namespace principia::base::_thread_pool;
 
 using ::google::compression::Compressor;
 
@@ -66,13 +70,27 @@ std::ostream& operator<<(std::ostream& out,
 // deserialize.
 class PushDeserializer final {
  public:
+  using CompressorFactory = std::function<std::unique_ptr<Compressor>()>;
+
   // The |size| of the data chunks sent to |Pull| are never greater than
   // |chunk_size|.  The internal queue holds at most |number_of_chunks| chunks.
   // Therefore, this class uses at most
-  // |number_of_chunks * (chunk_size + O(1)) + O(1)| bytes.
+  // |number_of_chunks * (chunk_size + O(1)) + O(1)| bytes.  In the presence of
+  // compression, the chunks are uncompressed by a single thread distinct from
+  // the one that deserializes the message.
   PushDeserializer(int chunk_size,
                    int number_of_chunks,
                    std::unique_ptr<Compressor> compressor);
+
+  // Same as above, but the chunks are uncompressed by |compression_threads|
+  // threads, each of which uses a compressor returned by |compressor_factory|,
+  // as soon as they are pushed.  There is no compression if
+  // |compressor_factory| returns null.
+  PushDeserializer(int chunk_size,
+                   int number_of_chunks,
+                   int compression_threads,
+                   CompressorFactory const& compressor_factory);
+
   ~PushDeserializer();
 
   // Starts the deserializer, which will proceed to deserialize data into
@@ -98,17 +116,36 @@ class PushDeserializer final {
   void Push(UniqueArray<std::uint8_t> bytes);
 
  private:
+  // A chunk pushed by the client and not yet consumed by |Pull|.
+  struct Chunk {
+    // In the absence of compression, the bytes to return to the stream.
+    Array<std::uint8_t> bytes;
+    // In the presence of compression, the index of the chunk in
+    // |uncompressed_data_| and the result of the uncompression of the chunk.
+    int index = -1;
+    std::future<Array<std::uint8_t>> uncompressed_bytes;
+  };
+
+  PushDeserializer(int chunk_size,
+                   int number_of_chunks,
+                   std::vector<std::unique_ptr<Compressor>> compressors);
+
   // Obtains the next chunk of data from the internal queue.  Blocks if no data
   // is available.  Used as a callback for the underlying
   // |DelegatingArrayOutputStream|.
   Array<std::uint8_t> Pull();
 
+  // Uncompresses |bytes| into the chunk at |index| in |uncompressed_data_|.
+  // Runs on |compression_pool_|.
+  Array<std::uint8_t> Uncompress(int index, Array<std::uint8_t> bytes);
+
   // |owned_message_| is null if this object doesn't own the message.
   // |message_| is non-null after Start.
   std::unique_ptr<google::protobuf::Message> owned_message_;
   google::protobuf::Message* message_ = nullptr;
 
-  std::unique_ptr<Compressor> const compressor_;
+  // True if the chunks must be uncompressed.
+  bool const compressed_;
 
   // The chunk size passed at construction.  The stream consumes chunks of that
   // size.
@@ -122,6 +159,8 @@ class PushDeserializer final {
   // The number of chunks passed at construction, used to size |data_|.
   int const number_of_chunks_;
 
+  // In the presence of compression, |number_of_chunks_ + 1| chunks: one for
+  // each element of |queue_| and one for the stream.
   UniqueArray<std::uint8_t> uncompressed_data_;
 
   DelegatingArrayInputStream stream_;
@@ -129,13 +168,27 @@ class PushDeserializer final {
 
   absl::Mutex lock_;
 
-  // The |queue_| contains the |Array<std::uint8_t>| object filled by |Push| and
-  // not yet consumed by |Pull|.  The |done_| queue contains the callbacks.  The
-  // two queues are out of step: an element is removed from |queue_| by |Pull|
-  // when it returns a chunk to the stream, but the corresponding callback is
-  // removed from |done_| (and executed) when |Pull| returns.
-  std::queue<Array<std::uint8_t>> queue_ GUARDED_BY(lock_);
+  // The compressors not currently used by a thread of |compression_pool_|.
+  // Empty in the absence of compression.
+  std::vector<std::unique_ptr<Compressor>> idle_compressors_ GUARDED_BY(lock_);
+
+  // The |queue_| contains the chunks filled by |Push| and not yet consumed by
+  // |Pull|.  The |done_| queue contains the callbacks.  The two queues are out
+  // of step: an element is removed from |queue_| by |Pull| when it returns a
+  // chunk to the stream, but the corresponding callback is removed from
+  // |done_| (and executed) when |Pull| returns.
+  std::queue<Chunk> queue_ GUARDED_BY(lock_);
   std::queue<std::function<void()>> done_ GUARDED_BY(lock_);
+
+  // The indices of the chunks of |uncompressed_data_| that are neither in
+  // |queue_| nor being read by the stream.  |stream_index_| is the index of
+  // the chunk being read by the stream, or -1.
+  std::queue<int> free_ GUARDED_BY(lock_);
+  int stream_index_ GUARDED_BY(lock_) = -1;
+
+  // Destroyed first, so that no uncompression is running while the other
+  // members are destroyed.
+  std::unique_ptr<ThreadPool<Array<std::uint8_t>>> compression_pool_;
 };
 
 }  // namespace internal
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/sink_source.hpp"
 #include "glog/logging.h"
@@ -110,17 +111,51 @@ inline PushDeserializer::PushDeserializer(
     int const chunk_size,
     int const number_of_chunks,
     std::unique_ptr<Compressor> compressor)
-    : compressor_(std::move(compressor)),
+    : PushDeserializer(chunk_size,
+                       number_of_chunks,
+                       /*compression_threads=*/1,
+                       [&compressor]() { return std::move(compressor); }) {}
+
+inline PushDeserializer::PushDeserializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    int const compression_threads,
+    CompressorFactory const& compressor_factory)
+    : PushDeserializer(chunk_size, number_of_chunks, [&]() {
+        std::vector<std::unique_ptr<Compressor>> compressors;
+        for (int i = 0; i < compression_threads; ++i) {
+          auto compressor = compressor_factory();
+          if (compressor == nullptr) {
+            break;
+          }
+          compressors.push_back(std::move(compressor));
+        }
+        return compressors;
+      }()) {}
+
+inline PushDeserializer::PushDeserializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    std::vector<std::unique_ptr<Compressor>> compressors)
+    : compressed_(!compressors.empty()),
       chunk_size_(chunk_size),
       compressed_chunk_size_(
-          compressor_ == nullptr
-              ? chunk_size_
-              : compressor_->MaxCompressedLength(chunk_size_)),
+          compressed_ ? compressors.front()->MaxCompressedLength(chunk_size_)
+                      : chunk_size_),
       number_of_chunks_(number_of_chunks),
-      uncompressed_data_(chunk_size_),
-      stream_(std::bind(&PushDeserializer::Pull, this)) {
+      uncompressed_data_(compressed_ ? chunk_size_ * (number_of_chunks_ + 1)
+                                     : 0),
+      stream_(std::bind(&PushDeserializer::Pull, this)),
+      idle_compressors_(std::move(compressors)),
+      compression_pool_(std::make_unique<ThreadPool<Array<std::uint8_t>>>(
+          idle_compressors_.size())) {
   // This sentinel ensures that the two queues are correctly out of step.
   done_.push(nullptr);
+  if (compressed_) {
+    for (int i = 0; i <= number_of_chunks_; ++i) {
+      free_.push(i);
+    }
+  }
 }
 
 inline PushDeserializer::~PushDeserializer() {
@@ -180,7 +215,7 @@ inline void PushDeserializer::Push(Array<std::uint8_t> const bytes,
   // absence of compression we have a stream so we can cut into as many chunks
   // as we like.
   int queued_chunk_size;
-  if (compressor_ == nullptr) {
+  if (!compressed_) {
     queued_chunk_size = chunk_size_;
   } else {
     CHECK_LE(bytes.size, compressed_chunk_size_);
@@ -198,9 +233,23 @@ inline void PushDeserializer::Push(Array<std::uint8_t> const bytes,
       };
       lock_.Await(absl::Condition(&queue_has_room));
 
-      queue_.emplace(current.data,
-                     std::min(current.size,
-                              static_cast<std::int64_t>(queued_chunk_size)));
+      Chunk chunk{.bytes = Array<std::uint8_t>(
+                      current.data,
+                      std::min(current.size,
+                               static_cast<std::int64_t>(queued_chunk_size)))};
+      if (compressed_ && chunk.bytes.size > 0) {
+        // There is always a free chunk here: at most |number_of_chunks_ - 1|
+        // are in |queue_| and one is being read by the stream.
+        CHECK(!free_.empty());
+        chunk.index = free_.front();
+        free_.pop();
+        chunk.uncompressed_bytes = compression_pool_->Add(
+            std::bind(&PushDeserializer::Uncompress,
+                      this,
+                      chunk.index,
+                      chunk.bytes));
+      }
+      queue_.push(std::move(chunk));
       done_.emplace(is_last ? std::move(done) : nullptr);
     }
     current.data = &current.data[queued_chunk_size];
@@ -216,6 +265,7 @@ inline void PushDeserializer::Push(UniqueArray<std::uint8_t> bytes) {
 }
 
 inline Array<std::uint8_t> PushDeserializer::Pull() {
+  std::future<Array<std::uint8_t>> uncompressed_bytes;
   Array<std::uint8_t> result;
   {
     absl::MutexLock l(&lock_);
@@ -231,22 +281,47 @@ inline Array<std::uint8_t> PushDeserializer::Pull() {
       done();
     }
     done_.pop();
-    // Get the next |Array<std::uint8_t>| object to process and remove it from
-    // |queue_|.  Uncompress it if needed.
-    auto const& front = queue_.front();
-    if (front.size == 0 || compressor_ == nullptr) {
-      result = front;
-    } else {
-      ArraySource<std::uint8_t> source(front);
-      ArraySink<std::uint8_t> sink(uncompressed_data_.get());
-      CHECK(compressor_->UncompressStream(&source, &sink));
-      result = sink.array();
+    // The stream is done with the chunk that it was reading.
+    if (stream_index_ >= 0) {
+      free_.push(stream_index_);
     }
+    // Get the next |Array<std::uint8_t>| object to process and remove it from
+    // |queue_|.
+    Chunk& front = queue_.front();
+    stream_index_ = front.index;
+    uncompressed_bytes = std::move(front.uncompressed_bytes);
+    result = front.bytes;
     queue_.pop();
   }
+  // Wait for the uncompression outside of the lock, so as to let the client
+  // push more data.
+  if (uncompressed_bytes.valid()) {
+    result = uncompressed_bytes.get();
+  }
   return result;
 }
 
+inline Array<std::uint8_t> PushDeserializer::Uncompress(
+    int const index,
+    Array<std::uint8_t> const bytes) {
+  std::unique_ptr<Compressor> compressor;
+  {
+    absl::MutexLock l(&lock_);
+    CHECK(!idle_compressors_.empty());
+    compressor = std::move(idle_compressors_.back());
+    idle_compressors_.pop_back();
+  }
+  ArraySource<std::uint8_t> source(bytes);
+  ArraySink<std::uint8_t> sink(Array<std::uint8_t>(
+      uncompressed_data_.data.get() + index * chunk_size_, chunk_size_));
+  CHECK(compressor->UncompressStream(&source, &sink));
+  {
+    absl::MutexLock l(&lock_);
+    idle_compressors_.push_back(std::move(compressor));
+  }
+  return sink.array();
+}
+
 }  // namespace internal
 }  // namespace _push_deserializer
 }  // namespace base
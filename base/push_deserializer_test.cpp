@@ -313,6 +313,40 @@ TEST_F(PushDeserializerTest, SerializationDeserialization) {
       /*deserializer_compressor=*/google::compression::NewGipfeliCompressor());
 }
 
+TEST_F(PushDeserializerTest, ParallelSerializationDeserialization) {
+  for (int i = 0; i < runs_per_test; ++i) {
+    pull_serializer_ = std::make_unique<PullSerializer>(
+        serializer_chunk_size,
+        /*number_of_chunks=*/8,
+        /*compression_threads=*/4,
+        &google::compression::NewGipfeliCompressor);
+    push_deserializer_ = std::make_unique<PushDeserializer>(
+        deserializer_chunk_size,
+        /*number_of_chunks=*/8,
+        /*compression_threads=*/4,
+        &google::compression::NewGipfeliCompressor);
+
+    pull_serializer_->Start(BuildTrajectory());
+    push_deserializer_->Start(make_not_null_unique<DiscreteTrajectory>(),
+                              PushDeserializerTest::CheckSerialization);
+    for (;;) {
+      Array<std::uint8_t> const bytes = pull_serializer_->Pull();
+      // The deserializer takes ownership of a copy, since |bytes| is only
+      // valid until the next call to |Pull|.
+      UniqueArray<std::uint8_t> copy(bytes.size);
+      std::memcpy(copy.data.get(), bytes.data,
+                  static_cast<std::size_t>(bytes.size));
+      push_deserializer_->Push(std::move(copy));
+      if (bytes.size == 0) {
+        break;
+      }
+    }
+
+    pull_serializer_.reset();
+    push_deserializer_.reset();
+  }
+}
+
 // Check that deserialization fails if we stomp on one extra byte.
 TEST_F(PushDeserializerDeathTest, Stomp) {
   EXPECT_DEATH({
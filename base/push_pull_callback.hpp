@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <thread>
 #include <tuple>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "base/macros.hpp"  // 🧙 For GUARDED_BY.
@@ -21,15 +24,23 @@ namespace internal {
 // Instead we invert the flow of control (just like we do for serialization) and
 // expect the managed code to pull the arguments and push the result of the
 // computations that it is executing.
+// The unmanaged code may post several sets of arguments at once, in which case
+// the managed code pulls them and pushes their results one at a time without
+// any synchronization with the unmanaged code, which only resumes once all the
+// results have been pushed.
 // Note that calling the managed and unmanaged APIs from the same thread will
 // inevitably cause deadlocks.  See |PushPullExecutor| below for a solution to
 // this.
 template<typename Result, typename... Arguments>
 class PushPullCallback {
  public:
+  using BatchedFunction = std::function<std::vector<Result>(
+      std::vector<std::tuple<Arguments...>> const& arguments)>;
+
   // The managed API, called to extract the arguments for the unmanaged callback
   // and return its result.  |Pull| returns false if there are no more arguments
-  // to be processed and the managed code should stop its iteration.
+  // to be processed and the managed code should stop its iteration.  Each call
+  // to |Pull| must be followed by a call to |Push|.
   bool Pull(Arguments&... arguments);
   void Push(Result result);
 
@@ -37,23 +48,33 @@ class PushPullCallback {
   // function.
   std::function<Result(Arguments...)> ToStdFunction();
 
+  // Same as above, but the function posts all its arguments at once and
+  // returns the results in the same order.
+  BatchedFunction ToBatchedStdFunction();
+
   // Used on the unmanaged side to indicate that the computation has finished.
   // After a call to this method, |Pull| always returns false.
   void Shutdown();
 
  private:
-  // The unmanaged API, called by the function returned by |ToStdFunction|.
-  void Push(Arguments... arguments);
-  Result Pull();
+  // The unmanaged API, called by the functions returned by |ToStdFunction| and
+  // |ToBatchedStdFunction|.
+  void Push(std::vector<std::tuple<Arguments...>> const& arguments);
+  std::vector<Result> Pull();
 
   // These functions return a (held) |MutexLock| that the caller should use to
   // ensure proper release of |lock_|.
   std::unique_ptr<absl::MutexLock> WaitUntilHasArgumentsOrShuttingDownAndLock();
-  std::unique_ptr<absl::MutexLock> WaitUntilHasResultAndLock();
+  std::unique_ptr<absl::MutexLock> WaitUntilHasResultsAndLock();
 
   absl::Mutex lock_;
-  std::optional<std::tuple<Arguments...>> arguments_ GUARDED_BY(lock_);
-  std::optional<Result> result_ GUARDED_BY(lock_);
+  // The arguments posted by the unmanaged code and not yet pulled by the
+  // managed code.
+  std::deque<std::tuple<Arguments...>> arguments_ GUARDED_BY(lock_);
+  // The results pushed by the managed code for the current batch, and the size
+  // of that batch.
+  std::vector<Result> results_ GUARDED_BY(lock_);
+  std::int64_t expected_results_ GUARDED_BY(lock_) = 0;
   bool shutdown_ GUARDED_BY(lock_) = false;
 };
 
@@ -65,8 +86,12 @@ template<typename T,
 class PushPullExecutor {
  public:
   using Task = std::function<T(std::function<Result(Arguments...)>)>;
+  using BatchedTask = std::function<
+      T(typename PushPullCallback<Result, Arguments...>::BatchedFunction)>;
 
   explicit PushPullExecutor(Task task);
+  // The task is given a function that posts its arguments in batches.
+  explicit PushPullExecutor(BatchedTask task);
   ~PushPullExecutor();
 
   // Returns the internal |PushPullCallback| object that is used by the managed
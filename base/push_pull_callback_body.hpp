@@ -2,8 +2,12 @@
 
 #include "base/push_pull_callback.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
+
+#include "glog/logging.h"
 
 namespace principia {
 namespace base {
@@ -13,25 +17,38 @@ namespace internal {
 template<typename Result, typename... Arguments>
 bool PushPullCallback<Result, Arguments...>::Pull(Arguments&... arguments) {
   auto const mutex_lock = WaitUntilHasArgumentsOrShuttingDownAndLock();
-  if (shutdown_) {
+  if (arguments_.empty()) {
     return false;
   }
-  std::tie(arguments...) = std::move(arguments_.value());
-  arguments_.reset();
+  std::tie(arguments...) = std::move(arguments_.front());
+  arguments_.pop_front();
   return true;
 }
 
 template<typename Result, typename... Arguments>
 void PushPullCallback<Result, Arguments...>::Push(Result result) {
   absl::MutexLock l(&lock_);
-  result_ = std::move(result);
+  CHECK_LT(static_cast<std::int64_t>(results_.size()), expected_results_);
+  results_.push_back(std::move(result));
 }
 
 template<typename Result, typename... Arguments>
 std::function<Result(Arguments...)>
 PushPullCallback<Result, Arguments...>::ToStdFunction() {
   return [this](Arguments const&... arguments) {
-    Push(arguments...);
+    Push({std::tuple(arguments...)});
+    return std::move(Pull().front());
+  };
+}
+
+template<typename Result, typename... Arguments>
+typename PushPullCallback<Result, Arguments...>::BatchedFunction
+PushPullCallback<Result, Arguments...>::ToBatchedStdFunction() {
+  return [this](std::vector<std::tuple<Arguments...>> const& arguments) {
+    if (arguments.empty()) {
+      return std::vector<Result>();
+    }
+    Push(arguments);
     return Pull();
   };
 }
@@ -44,17 +61,21 @@ void PushPullCallback<Result, Arguments...>::Shutdown() {
 
 template<typename Result, typename... Arguments>
 void PushPullCallback<Result, Arguments...>::Push(
-    Arguments... arguments) {
+    std::vector<std::tuple<Arguments...>> const& arguments) {
   absl::MutexLock l(&lock_);
-  arguments_ = std::tuple(std::move(arguments)...);
+  CHECK(arguments_.empty());
+  CHECK_EQ(0, expected_results_);
+  arguments_.insert(arguments_.end(), arguments.begin(), arguments.end());
+  expected_results_ = arguments.size();
 }
 
 template<typename Result, typename... Arguments>
-Result PushPullCallback<Result, Arguments...>::Pull() {
-  auto const mutex_lock = WaitUntilHasResultAndLock();
-  Result result = result_.value();
-  result_.reset();
-  return std::move(result);
+std::vector<Result> PushPullCallback<Result, Arguments...>::Pull() {
+  auto const mutex_lock = WaitUntilHasResultsAndLock();
+  std::vector<Result> results = std::move(results_);
+  results_.clear();
+  expected_results_ = 0;
+  return results;
 }
 
 template<typename Result, typename... Arguments>
@@ -63,7 +84,7 @@ PushPullCallback<Result,
                  Arguments...>::WaitUntilHasArgumentsOrShuttingDownAndLock() {
   auto has_arguments_or_shutting_down = [this]() {
     lock_.AssertReaderHeld();
-    return shutdown_ || arguments_.has_value();
+    return shutdown_ || !arguments_.empty();
   };
 
   auto mutex_lock = std::make_unique<absl::MutexLock>(&lock_);
@@ -73,14 +94,14 @@ PushPullCallback<Result,
 
 template<typename Result, typename... Arguments>
 std::unique_ptr<absl::MutexLock>
-PushPullCallback<Result, Arguments...>::WaitUntilHasResultAndLock() {
-  auto has_result = [this]() {
+PushPullCallback<Result, Arguments...>::WaitUntilHasResultsAndLock() {
+  auto has_results = [this]() {
     lock_.AssertReaderHeld();
-    return result_.has_value();
+    return static_cast<std::int64_t>(results_.size()) == expected_results_;
   };
 
   auto mutex_lock = std::make_unique<absl::MutexLock>(&lock_);
-  lock_.Await(absl::Condition(&has_result));
+  lock_.Await(absl::Condition(&has_results));
   return mutex_lock;
 }
 
@@ -95,6 +116,17 @@ PushPullExecutor<T, Result, Arguments...>::PushPullExecutor(Task task)
         callback_.Shutdown();
       }) {}
 
+template<typename T, typename Result, typename... Arguments>
+PushPullExecutor<T, Result, Arguments...>::PushPullExecutor(BatchedTask task)
+    : thread_([this, task = std::move(task)]() {
+        auto const result = task(callback_.ToBatchedStdFunction());
+        {
+          absl::MutexLock l(&lock_);
+          result_ = result;
+        }
+        callback_.Shutdown();
+      }) {}
+
 template<typename T, typename Result, typename... Arguments>
 PushPullExecutor<T, Result, Arguments...>::~PushPullExecutor() {
   thread_.join();
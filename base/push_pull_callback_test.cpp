@@ -1,6 +1,8 @@
 #include "base/push_pull_callback.hpp"
 
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -38,5 +40,31 @@ TEST(PushPullCallback, Test) {
   EXPECT_EQ(8, executor.get());
 }
 
+TEST(PushPullCallback, Batched) {
+  auto task = [](std::function<std::vector<int>(
+                     std::vector<std::tuple<int, int>> const& arguments)> const&
+                     f) {
+    auto const first = f({{2, 4}, {3, 5}, {7, 1}});
+    EXPECT_EQ((std::vector<int>{6, 8, 8}), first);
+    auto const second = f({{1, 1}});
+    EXPECT_EQ((std::vector<int>{2}), second);
+    EXPECT_TRUE(f({}).empty());
+    return first[0] - second[0];
+  };
+
+  PushPullExecutor<double, int, int, int> executor(std::move(task));
+  auto& callback = executor.callback();
+
+  int left;
+  int right;
+  int count = 0;
+  while (callback.Pull(left, right)) {
+    callback.Push(left + right);
+    ++count;
+  }
+  EXPECT_EQ(4, count);
+  EXPECT_EQ(4, executor.get());
+}
+
 }  // namespace base
 }  // namespace principia
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
-#include <functional>
 #include <future>
 #include <list>
+#include <memory>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/mutex.h"
 
 namespace principia {
@@ -14,8 +21,133 @@ namespace base {
 namespace _thread_pool {
 namespace internal {
 
+// A move-only, type-erased call.  Callables that are small enough and nothrow
+// move-constructible are stored inline, so that constructing a |Task| from a
+// typical lambda doesn't allocate.  Unlike |std::function|, the callable may be
+// move-only (e.g., it may capture a |std::promise| or a |std::unique_ptr|).
+class Task final {
+ public:
+  Task() = default;
+
+  template<typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, Task>)
+  explicit Task(F&& function);
+
+  Task(Task&& other) noexcept;
+  Task& operator=(Task&& other) noexcept;
+  ~Task();
+
+  explicit operator bool() const;
+
+  // Executes the call.  The task must not be empty.
+  void operator()();
+
+ private:
+  static constexpr std::size_t inline_size = 64;
+
+  template<typename F>
+  static constexpr bool stored_inline =
+      sizeof(F) <= inline_size &&
+      alignof(F) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<F>;
+
+  // The operations on the callable stored in |storage_|.  |relocate| move-
+  // constructs the callable at |to| and destroys the one at |from|.
+  struct Operations {
+    void (*invoke)(void* storage);
+    void (*relocate)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template<typename F>
+  static Operations const operations;
+
+  void Reset();
+
+  alignas(std::max_align_t) std::byte storage_[inline_size];
+  Operations const* operations_ = nullptr;
+};
+
+// A bounded Chase-Lev deque of tasks, with the memory orderings of Lê, Pop,
+// Cohen and Zappa Nardelli, "Correct and efficient work-stealing for weak
+// memory models" (2013).  The owner thread pushes and takes at the bottom, in
+// last-in, first-out order, which is good for locality when tasks spawn other
+// tasks; other threads steal at the top, in first-in, first-out order.  The
+// operations are lock-free.
+// Because tasks are not trivially copyable, a thief claims a slot before it
+// moves the task out of it.  Each slot has a flag which is cleared when its
+// task has been moved out, and the owner doesn't reuse a slot until then.
+class WorkStealingDeque final {
+ public:
+  WorkStealingDeque();
+
+  // Called by the owner.  Returns false, leaving |task| unchanged, if the deque
+  // is full.
+  bool Push(Task& task);
+  // Called by the owner.  Returns false if the deque is empty.
+  bool Take(Task& task);
+  // Called by any thread.  Returns false if the deque is empty or if another
+  // thread took the oldest task concurrently.
+  bool Steal(Task& task);
+
+ private:
+  static constexpr std::int64_t capacity = 256;
+  static_assert((capacity & (capacity - 1)) == 0);
+
+  struct Slot {
+    // True from the time a task is pushed in |task| to the time it has been
+    // moved out.
+    std::atomic<bool> occupied = false;
+    Task task;
+  };
+
+  std::unique_ptr<Slot[]> const slots_;
+  alignas(64) std::atomic<std::int64_t> top_ = 0;
+  alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+};
+
+// A multiple-producer, multiple-consumer first-in, first-out queue of tasks.
+// The tasks are stored in a bounded lock-free ring, using the algorithm of
+// Vyukov's bounded MPMC queue; when the ring is full, they overflow to a
+// mutex-protected deque.
+class InjectionQueue final {
+ public:
+  InjectionQueue();
+
+  void Push(Task task);
+  // Returns false if the queue is empty.
+  bool Pop(Task& task);
+
+ private:
+  static constexpr std::uint64_t capacity = 1024;
+  static_assert((capacity & (capacity - 1)) == 0);
+
+  struct Slot {
+    std::atomic<std::uint64_t> sequence;
+    Task task;
+  };
+
+  bool TryPushToRing(Task& task);
+  bool TryPopFromRing(Task& task);
+
+  std::unique_ptr<Slot[]> const slots_;
+  alignas(64) std::atomic<std::uint64_t> push_position_ = 0;
+  alignas(64) std::atomic<std::uint64_t> pop_position_ = 0;
+
+  std::atomic<std::int64_t> overflow_size_ = 0;
+  absl::Mutex overflow_lock_;
+  std::deque<Task> overflow_ GUARDED_BY(overflow_lock_);
+};
+
 // A pool of threads that are created at construction and to which functions can
 // be added for asynchronous execution.  This class is thread-safe.
+// Each thread owns a |WorkStealingDeque|, to which it adds its own calls, and
+// which it executes newest first.  Calls added by other threads go to a shared
+// |InjectionQueue| and are executed in the order in which they were added.  A
+// thread that finds its deque and the shared queue empty steals the oldest call
+// of another deque, so that the load is balanced even if the calls have very
+// different durations.  Threads that find no call to execute sleep on an atomic
+// counter, which is only bumped when some thread is sleeping.
 template<typename T>
 class ThreadPool final {
  public:
@@ -26,30 +158,57 @@ class ThreadPool final {
 
   // Adds a call to the execution queue, and returns a future that the client
   // may use to wait until execution of |function| has completed and to extract
-  // the result.
-  std::future<T> Add(std::function<T()> function);
+  // the result.  |function| must be callable without arguments, and its result
+  // must be convertible to |T|.
+  template<typename F>
+  std::future<T> Add(F&& function);
+
+  // Same as |Add|, but the result of |function| is discarded and there is no
+  // way to wait for its completion.  This avoids the cost of the promise and
+  // future, and is intended for clients that track completion themselves.
+  template<typename F>
+  void AddDetached(F&& function);
+
+  // The number of threads in this pool.
+  std::int64_t pool_size() const;
 
  private:
-  // The queue element contains a |function| to execute and a |promise| used to
-  // communicate the result to the caller.
-  struct Call {
-    std::function<T()> function;
-    std::promise<T> promise;
-  };
+  void AddTask(Task task);
+
+  // Tries to extract a call for the thread at |index|, first from its own
+  // deque, then from the injection queue, then from the other deques.  Returns
+  // false if no call was found.
+  bool TryDequeue(std::int64_t index, Task& task);
+
+  // The loop executed on the thread at |index| to extract calls from the
+  // queues and execute them.
+  void DequeueCallAndExecute(std::int64_t index);
 
-  // The loop executed on each thread to extract an element from the queue,
-  // execute it, and set its result in the promise.
-  void DequeueCallAndExecute();
+  std::vector<std::unique_ptr<WorkStealingDeque>> deques_;
+  InjectionQueue injection_queue_;
 
-  absl::Mutex lock_;
-  bool shutdown_ GUARDED_BY(lock_) = false;
-  std::deque<Call> calls_ GUARDED_BY(lock_);
+  // The number of threads that are going to sleep or sleeping.  When it is
+  // positive, adding a call bumps |epoch_| and wakes up a thread.
+  std::atomic<std::int64_t> sleepers_ = 0;
+  std::atomic<std::uint64_t> epoch_ = 0;
+  std::atomic<bool> shutdown_ = false;
 
   std::list<std::thread> threads_;
+
+  // The pool and deque index of the current thread, if it belongs to a pool.
+  static thread_local ThreadPool const* current_pool_;
+  static thread_local std::int64_t current_index_;
 };
 
+// A process-wide pool with one thread per hardware thread, for computations
+// that are split in short, independent calls (e.g., fitting or compression).
+// It is created on first use and never destroyed.  The calls added to this pool
+// must not block waiting for other calls of this pool, lest they deadlock.
+ThreadPool<absl::Status>& SharedThreadPool();
+
 }  // namespace internal
 
+using internal::SharedThreadPool;
 using internal::ThreadPool;
 
 }  // namespace _thread_pool
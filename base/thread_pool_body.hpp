@@ -2,85 +2,385 @@
 
 #include "base/thread_pool.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <utility>
 
+#include "glog/logging.h"
+
 namespace principia {
 namespace base {
 namespace _thread_pool {
 namespace internal {
 
-// A helper function that is specialized for void because void is not really a
-// type.
-template<typename T>
-void ExecuteAndSetValue(std::function<T()> const& function,
-                        std::promise<T>& promise) {
-  promise.set_value(function());
+// A helper function that has a special case for void because void is not
+// really a type.
+template<typename T, typename F>
+void ExecuteAndSetValue(F& function, std::promise<T>& promise) {
+  if constexpr (std::is_void_v<T>) {
+    function();
+    promise.set_value();
+  } else {
+    promise.set_value(function());
+  }
+}
+
+template<typename F>
+Task::Operations const Task::operations = []() {
+  if constexpr (stored_inline<F>) {
+    return Operations{
+        .invoke = [](void* const storage) {
+          (*std::launder(static_cast<F*>(storage)))();
+        },
+        .relocate = [](void* const from, void* const to) {
+          F* const f = std::launder(static_cast<F*>(from));
+          new (to) F(std::move(*f));
+          f->~F();
+        },
+        .destroy = [](void* const storage) {
+          std::launder(static_cast<F*>(storage))->~F();
+        }};
+  } else {
+    // The callable is on the heap and |storage_| holds a pointer to it.
+    return Operations{
+        .invoke = [](void* const storage) {
+          (**static_cast<F**>(storage))();
+        },
+        .relocate = [](void* const from, void* const to) {
+          *static_cast<F**>(to) = *static_cast<F**>(from);
+        },
+        .destroy = [](void* const storage) {
+          delete *static_cast<F**>(storage);
+        }};
+  }
+}();
+
+template<typename F>
+  requires(!std::is_same_v<std::remove_cvref_t<F>, Task>)
+Task::Task(F&& function) {
+  using Callable = std::decay_t<F>;
+  if constexpr (stored_inline<Callable>) {
+    new (storage_) Callable(std::forward<F>(function));
+  } else {
+    *reinterpret_cast<Callable**>(storage_) =
+        new Callable(std::forward<F>(function));
+  }
+  operations_ = &operations<Callable>;
+}
+
+inline Task::Task(Task&& other) noexcept : operations_(other.operations_) {
+  if (operations_ != nullptr) {
+    operations_->relocate(other.storage_, storage_);
+    other.operations_ = nullptr;
+  }
+}
+
+inline Task& Task::operator=(Task&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    operations_ = other.operations_;
+    if (operations_ != nullptr) {
+      operations_->relocate(other.storage_, storage_);
+      other.operations_ = nullptr;
+    }
+  }
+  return *this;
+}
+
+inline Task::~Task() {
+  Reset();
+}
+
+inline Task::operator bool() const {
+  return operations_ != nullptr;
+}
+
+inline void Task::operator()() {
+  DCHECK(operations_ != nullptr);
+  operations_->invoke(storage_);
+}
+
+inline void Task::Reset() {
+  if (operations_ != nullptr) {
+    operations_->destroy(storage_);
+    operations_ = nullptr;
+  }
+}
+
+inline WorkStealingDeque::WorkStealingDeque()
+    : slots_(std::make_unique<Slot[]>(capacity)) {}
+
+inline bool WorkStealingDeque::Push(Task& task) {
+  std::int64_t const b = bottom_.load(std::memory_order_relaxed);
+  std::int64_t const t = top_.load(std::memory_order_acquire);
+  if (b - t >= capacity) {
+    return false;
+  }
+  // A thief may have claimed the previous task of this slot and still be
+  // moving it out.
+  Slot& slot = slots_[b & (capacity - 1)];
+  if (slot.occupied.load(std::memory_order_acquire)) {
+    return false;
+  }
+  slot.task = std::move(task);
+  slot.occupied.store(true, std::memory_order_relaxed);
+  // Publishes the task to the thieves.
+  bottom_.store(b + 1, std::memory_order_release);
+  return true;
 }
 
-template<>
-inline void ExecuteAndSetValue<void>(std::function<void()> const& function,
-                                     std::promise<void>& promise) {
-  function();
-  promise.set_value();
+inline bool WorkStealingDeque::Take(Task& task) {
+  // All the stores to |bottom_| are releases so that a thief that reads any of
+  // them synchronizes with the pushes that preceded it.
+  std::int64_t const b = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(b, std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t t = top_.load(std::memory_order_relaxed);
+  if (t > b) {
+    // Empty.
+    bottom_.store(b + 1, std::memory_order_release);
+    return false;
+  }
+  if (t == b) {
+    // Last task, race against the thieves.
+    bool const won = top_.compare_exchange_strong(t, t + 1,
+                                                  std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    if (!won) {
+      return false;
+    }
+  }
+  Slot& slot = slots_[b & (capacity - 1)];
+  task = std::move(slot.task);
+  slot.occupied.store(false, std::memory_order_release);
+  return true;
 }
 
+inline bool WorkStealingDeque::Steal(Task& task) {
+  std::int64_t t = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t const b = bottom_.load(std::memory_order_acquire);
+  if (t >= b) {
+    return false;
+  }
+  // Claim the slot before touching the task: if we lose the race, the task may
+  // be concurrently moved out by the owner or by another thief.
+  if (!top_.compare_exchange_strong(t, t + 1,
+                                    std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return false;
+  }
+  Slot& slot = slots_[t & (capacity - 1)];
+  task = std::move(slot.task);
+  slot.occupied.store(false, std::memory_order_release);
+  return true;
+}
+
+inline InjectionQueue::InjectionQueue()
+    : slots_(std::make_unique<Slot[]>(capacity)) {
+  for (std::uint64_t i = 0; i < capacity; ++i) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+inline void InjectionQueue::Push(Task task) {
+  // Once a task has overflowed, the next ones overflow too, until the overflow
+  // has been drained, to preserve the order.
+  if (overflow_size_.load(std::memory_order_acquire) == 0 &&
+      TryPushToRing(task)) {
+    return;
+  }
+  absl::MutexLock l(&overflow_lock_);
+  overflow_.push_back(std::move(task));
+  overflow_size_.fetch_add(1, std::memory_order_release);
+}
+
+inline bool InjectionQueue::Pop(Task& task) {
+  if (TryPopFromRing(task)) {
+    return true;
+  }
+  if (overflow_size_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  absl::MutexLock l(&overflow_lock_);
+  if (overflow_.empty()) {
+    return false;
+  }
+  task = std::move(overflow_.front());
+  overflow_.pop_front();
+  overflow_size_.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+inline bool InjectionQueue::TryPushToRing(Task& task) {
+  std::uint64_t position = push_position_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[position & (capacity - 1)];
+    std::uint64_t const sequence =
+        slot.sequence.load(std::memory_order_acquire);
+    std::int64_t const difference = static_cast<std::int64_t>(sequence) -
+                                    static_cast<std::int64_t>(position);
+    if (difference == 0) {
+      if (push_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        slot.task = std::move(task);
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // Full.
+      return false;
+    } else {
+      position = push_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+inline bool InjectionQueue::TryPopFromRing(Task& task) {
+  std::uint64_t position = pop_position_.load(std::memory_order_relaxed);
+  for (;;) {
+    Slot& slot = slots_[position & (capacity - 1)];
+    std::uint64_t const sequence =
+        slot.sequence.load(std::memory_order_acquire);
+    std::int64_t const difference = static_cast<std::int64_t>(sequence) -
+                                    static_cast<std::int64_t>(position + 1);
+    if (difference == 0) {
+      if (pop_position_.compare_exchange_weak(position, position + 1,
+                                              std::memory_order_relaxed)) {
+        task = std::move(slot.task);
+        slot.sequence.store(position + capacity, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // Empty.
+      return false;
+    } else {
+      position = pop_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template<typename T>
+thread_local ThreadPool<T> const* ThreadPool<T>::current_pool_ = nullptr;
+
+template<typename T>
+thread_local std::int64_t ThreadPool<T>::current_index_ = -1;
+
 template<typename T>
 ThreadPool<T>::ThreadPool(std::int64_t const pool_size) {
   for (std::int64_t i = 0; i < pool_size; ++i) {
-    threads_.emplace_back(std::bind(&ThreadPool::DequeueCallAndExecute, this));
+    deques_.push_back(std::make_unique<WorkStealingDeque>());
+  }
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    threads_.emplace_back(
+        std::bind(&ThreadPool::DequeueCallAndExecute, this, i));
   }
 }
 
 template<typename T>
 ThreadPool<T>::~ThreadPool() {
-  {
-    absl::MutexLock l(&lock_);
-    shutdown_ = true;
-  }
+  shutdown_.store(true, std::memory_order_release);
+  epoch_.fetch_add(1, std::memory_order_acq_rel);
+  epoch_.notify_all();
   for (auto& thread : threads_) {
     thread.join();
   }
 }
 
 template<typename T>
-std::future<T> ThreadPool<T>::Add(std::function<T()> function) {
-  std::future<T> result;
-  {
-    absl::MutexLock l(&lock_);
-    calls_.push_back({std::move(function), std::promise<T>()});
-    result = calls_.back().promise.get_future();
-  }
+template<typename F>
+std::future<T> ThreadPool<T>::Add(F&& function) {
+  std::promise<T> promise;
+  std::future<T> result = promise.get_future();
+  AddTask(Task([function = std::forward<F>(function),
+                promise = std::move(promise)]() mutable {
+    ExecuteAndSetValue(function, promise);
+  }));
   return result;
 }
 
 template<typename T>
-void ThreadPool<T>::DequeueCallAndExecute() {
-  for (;;) {
-    Call this_call;
+template<typename F>
+void ThreadPool<T>::AddDetached(F&& function) {
+  AddTask(Task(std::forward<F>(function)));
+}
 
-    // Wait until either the queue contains an element or this class is shutting
-    // down.
-    {
-      absl::MutexLock l(&lock_);
+template<typename T>
+std::int64_t ThreadPool<T>::pool_size() const {
+  return threads_.size();
+}
 
-      auto const has_calls_or_shutdown = [this] {
-        return shutdown_ || !calls_.empty();
-      };
-      lock_.Await(absl::Condition(&has_calls_or_shutdown));
+template<typename T>
+void ThreadPool<T>::AddTask(Task task) {
+  // A thread of this pool pushes to its own deque, unless it is full.
+  if (current_pool_ != this || !deques_[current_index_]->Push(task)) {
+    injection_queue_.Push(std::move(task));
+  }
+  // Pairs with the fence in |DequeueCallAndExecute|: either we see the sleeper,
+  // or the sleeper sees the call.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleepers_.load(std::memory_order_relaxed) > 0) {
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_one();
+  }
+}
 
-      if (shutdown_) {
-        break;
-      }
-      this_call = std::move(calls_.front());
-      calls_.pop_front();
+template<typename T>
+bool ThreadPool<T>::TryDequeue(std::int64_t const index, Task& task) {
+  if (deques_[index]->Take(task)) {
+    return true;
+  }
+  if (injection_queue_.Pop(task)) {
+    return true;
+  }
+  for (std::int64_t i = 1; i < deques_.size(); ++i) {
+    if (deques_[(index + i) % deques_.size()]->Steal(task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template<typename T>
+void ThreadPool<T>::DequeueCallAndExecute(std::int64_t const index) {
+  current_pool_ = this;
+  current_index_ = index;
+  for (;;) {
+    if (shutdown_.load(std::memory_order_acquire)) {
+      break;
     }
 
-    // Execute the function without holding the |lock_| as it might take some
-    // time.
-    ExecuteAndSetValue(this_call.function, this_call.promise);
+    Task task;
+    if (TryDequeue(index, task)) {
+      // Execute the task without holding any lock as it might take some time.
+      task();
+      continue;
+    }
+
+    // Read the epoch before announcing that we are going to sleep and looking
+    // at the queues a last time: if a call is added after we have looked at
+    // its queue, the epoch will have changed and we won't go to sleep.
+    std::uint64_t const epoch = epoch_.load(std::memory_order_acquire);
+    sleepers_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!shutdown_.load(std::memory_order_acquire) &&
+        !TryDequeue(index, task)) {
+      epoch_.wait(epoch, std::memory_order_acquire);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    if (task) {
+      task();
+    }
   }
 }
 
+inline ThreadPool<absl::Status>& SharedThreadPool() {
+  static auto* const pool = new ThreadPool<absl::Status>(
+      /*pool_size=*/std::max(1u, std::thread::hardware_concurrency()));
+  return *pool;
+}
+
 }  // namespace internal
 }  // namespace _thread_pool
 }  // namespace base
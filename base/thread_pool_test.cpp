@@ -1,11 +1,16 @@
 #include "base/thread_pool.hpp"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 
@@ -55,5 +60,112 @@ TEST_F(ThreadPoolTest, ParallelExecution) {
   EXPECT_FALSE(monotonically_increasing);
 }
 
+// Check that calls added by the threads of the pool are executed, including
+// when they are stolen by other threads.
+TEST_F(ThreadPoolTest, NestedCalls) {
+  constexpr int number_of_outer_calls = 100;
+  constexpr int number_of_inner_calls = 100;
+
+  absl::Mutex lock;
+  std::atomic<std::int64_t> count = 0;
+  std::vector<std::future<void>> inner_futures;
+  std::vector<std::future<void>> outer_futures;
+  for (int i = 0; i < number_of_outer_calls; ++i) {
+    outer_futures.push_back(pool_.Add([this, &count, &inner_futures, &lock]() {
+      for (int j = 0; j < number_of_inner_calls; ++j) {
+        auto future = pool_.Add([&count]() { ++count; });
+        absl::MutexLock l(&lock);
+        inner_futures.push_back(std::move(future));
+      }
+    }));
+  }
+
+  for (auto const& future : outer_futures) {
+    future.wait();
+  }
+  for (auto const& future : inner_futures) {
+    future.wait();
+  }
+  EXPECT_EQ(number_of_outer_calls * number_of_inner_calls, count);
+}
+
+// Check that calls added by a thread outside of the pool are executed in the
+// order in which they were added, including when they overflow the lock-free
+// ring of the injection queue.
+TEST(ThreadPoolNoFixtureTest, InjectionOrder) {
+  constexpr int number_of_calls = 3000;
+  ThreadPool<void> pool(/*pool_size=*/1);
+
+  // Block the only thread of the pool until all the calls have been added.
+  absl::Notification all_added;
+  auto blocker = pool.Add([&all_added]() { all_added.WaitForNotification(); });
+
+  std::vector<int> order;
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < number_of_calls; ++i) {
+    futures.push_back(pool.Add([i, &order]() { order.push_back(i); }));
+  }
+  all_added.Notify();
+  blocker.wait();
+  for (auto const& future : futures) {
+    future.wait();
+  }
+
+  ASSERT_EQ(number_of_calls, order.size());
+  for (int i = 0; i < number_of_calls; ++i) {
+    EXPECT_EQ(i, order[i]);
+  }
+}
+
+// Check that calls that are move-only or too large to be stored inline are
+// executed, and that their results are returned.
+TEST(ThreadPoolNoFixtureTest, MoveOnlyAndLargeCalls) {
+  ThreadPool<std::int64_t> pool(/*pool_size=*/2);
+  auto unique = std::make_unique<std::int64_t>(42);
+  std::array<std::int64_t, 100> large;
+  for (std::int64_t i = 0; i < large.size(); ++i) {
+    large[i] = i;
+  }
+  auto move_only = pool.Add([unique = std::move(unique)]() { return *unique; });
+  auto heap = pool.Add([large]() {
+    std::int64_t sum = 0;
+    for (std::int64_t const l : large) {
+      sum += l;
+    }
+    return sum;
+  });
+  EXPECT_EQ(42, move_only.get());
+  EXPECT_EQ(4950, heap.get());
+
+  std::atomic<int> detached = 0;
+  absl::Notification done;
+  pool.AddDetached([&detached, &done, large]() {
+    detached = large[99];
+    done.Notify();
+  });
+  done.WaitForNotification();
+  EXPECT_EQ(99, detached);
+}
+
+// Check that a thread of the pool may add more calls than fit in its deque,
+// and that they are all executed.
+TEST_F(ThreadPoolTest, DequeOverflow) {
+  constexpr int number_of_calls = 10'000;
+  std::atomic<int> count = 0;
+  absl::Mutex lock;
+  std::vector<std::future<void>> futures;
+  pool_.Add([this, &count, &futures, &lock]() {
+    for (int i = 0; i < number_of_calls; ++i) {
+      auto future = pool_.Add([&count]() { ++count; });
+      absl::MutexLock l(&lock);
+      futures.push_back(std::move(future));
+    }
+  }).wait();
+  for (auto const& future : futures) {
+    future.wait();
+  }
+  EXPECT_EQ(number_of_calls, count);
+}
+
 }  // namespace base
 }  // namespace principia
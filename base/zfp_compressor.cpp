@@ -5,7 +5,10 @@
 #include <string>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "base/array.hpp"
+#include "base/parallel_for.hpp"
+#include "base/thread_pool.hpp"
 
 namespace principia {
 namespace base {
@@ -13,6 +16,8 @@ namespace _zfp_compressor {
 namespace internal {
 
 using namespace principia::base::_array;
+using namespace principia::base::_parallel_for;
+using namespace principia::base::_thread_pool;
 
 // ZFP headers limit the dimensions to 2^(48 / N).  For N = 4, this is way too
 // small for our purposes.  Therefore, we must not include the bit
@@ -20,6 +25,14 @@ using namespace principia::base::_array;
 // parameters.
 static constexpr uint header_mask = ZFP_HEADER_MODE | ZFP_HEADER_MAGIC;
 
+// A trajectory segment has 7 components, one of which is processed by the
+// calling thread.
+constexpr int number_of_threads = 6;
+
+// The buffer used by |WriteToMessage|.  It only ever grows, so that repeated
+// serializations on the same thread don't allocate.
+thread_local UniqueArray<std::uint8_t> write_buffer;
+
 ZfpCompressor::ZfpCompressor(double const accuracy) : accuracy_(accuracy) {}
 
 void ZfpCompressor::WriteToMessage(const zfp_field* const field,
@@ -35,16 +48,19 @@ void ZfpCompressor::WriteToMessage(const zfp_field* const field,
     zfp_stream_set_accuracy(zfp.get(), *accuracy_);
   }
   size_t const buffer_size = zfp_stream_maximum_size(zfp.get(), field);
-  UniqueArray<std::uint8_t> const buffer(buffer_size);
-  not_null<bitstream*> const stream =
-      check_not_null(stream_open(buffer.data.get(), buffer_size));
-  zfp_stream_set_bit_stream(zfp.get(), &*stream);
+  if (write_buffer.size < buffer_size) {
+    write_buffer = UniqueArray<std::uint8_t>(buffer_size);
+  }
+  std::unique_ptr<bitstream, std::function<void(bitstream*)>> const stream(
+      check_not_null(stream_open(write_buffer.data.get(), buffer_size)),
+      [](bitstream* const stream) { stream_close(stream); });
+  zfp_stream_set_bit_stream(zfp.get(), stream.get());
 
   zfp_write_header(zfp.get(), field, header_mask);
   size_t const compressed_size = zfp_compress(zfp.get(), field);
   CHECK_LT(0, compressed_size);
-  message->append(static_cast<char const*>(stream_data(stream)),
-                  stream_size(stream));
+  message->append(static_cast<char const*>(stream_data(stream.get())),
+                  stream_size(stream.get()));
 }
 
 void ZfpCompressor::ReadFromMessage(zfp_field* const field,
@@ -53,9 +69,11 @@ void ZfpCompressor::ReadFromMessage(zfp_field* const field,
       zfp_stream_open(/*stream=*/nullptr),
       [](zfp_stream* const zfp) { zfp_stream_close(zfp); });
 
-  not_null<bitstream*> const stream = check_not_null(
-      stream_open(const_cast<char*>(&message.front()), message.size()));
-  zfp_stream_set_bit_stream(zfp.get(), &*stream);
+  std::unique_ptr<bitstream, std::function<void(bitstream*)>> const stream(
+      check_not_null(
+          stream_open(const_cast<char*>(&message.front()), message.size())),
+      [](bitstream* const stream) { stream_close(stream); });
+  zfp_stream_set_bit_stream(zfp.get(), stream.get());
   size_t const header_bits = zfp_read_header(zfp.get(), field, header_mask);
   CHECK_LT(0, header_bits);
 
@@ -64,6 +82,26 @@ void ZfpCompressor::ReadFromMessage(zfp_field* const field,
   message.remove_prefix(compressed_size);
 }
 
+void ZfpCompressor::RunForEach(
+    std::int64_t const size,
+    bool const parallel,
+    std::function<void(std::int64_t index)> const& body) {
+  if (parallel) {
+    static auto* const pool = new ThreadPool<void>(number_of_threads);
+    CHECK_OK(ParallelFor(*pool,
+                         /*begin=*/0,
+                         /*end=*/size,
+                         [&body](std::int64_t const index) {
+                           body(index);
+                           return absl::OkStatus();
+                         }));
+  } else {
+    for (std::int64_t i = 0; i < size; ++i) {
+      body(i);
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace _zfp_compressor
 }  // namespace base
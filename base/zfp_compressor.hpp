@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/not_null.hpp"
@@ -46,6 +49,27 @@ class ZfpCompressor {
   void ReadFromMessageMultidimensional(std::vector<double>& v,
                                        std::string_view& message) const;
 
+  // Same as above for several vectors, each of which is serialized with the
+  // corresponding element of |compressors|.  The encodings are appended to
+  // |message| in order, and are the same as if the vectors were serialized one
+  // after the other.  Their sizes are appended to |sizes|, which makes it
+  // possible to deserialize them concurrently.  Large vectors are serialized
+  // concurrently.
+  template<int D>
+  static void WriteToMessageMultidimensional(
+      std::vector<not_null<ZfpCompressor const*>> const& compressors,
+      std::vector<not_null<std::vector<double>*>> const& vs,
+      not_null<std::string*> message,
+      not_null<std::vector<std::int64_t>*> sizes);
+  // |sizes| must be the sizes of the encodings of the elements of |vs|, as
+  // returned by the above function.  Large vectors are deserialized
+  // concurrently.
+  template<int D>
+  void ReadFromMessageMultidimensional(
+      std::vector<not_null<std::vector<double>*>> const& vs,
+      std::vector<std::int64_t> const& sizes,
+      std::string_view& message) const;
+
   // Low-level API: serialization/deserialization of a field (allocated and
   // owned by the caller) into a message (which is expected to by a bytes field
   // of a proto).  When reading, the |message| parameter is updated to reflect
@@ -56,6 +80,12 @@ class ZfpCompressor {
                        std::string_view& message) const;
 
  private:
+  // Runs |body| for each index in [0, size[, concurrently if |parallel|.
+  static void RunForEach(
+      std::int64_t size,
+      bool parallel,
+      std::function<void(std::int64_t index)> const& body);
+
   std::optional<double> const accuracy_;
 };
 
@@ -2,6 +2,7 @@
 
 #include "base/zfp_compressor.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
@@ -13,6 +14,10 @@ namespace base {
 namespace _zfp_compressor {
 namespace internal {
 
+// Vectors shorter than this are not worth the synchronization needed to
+// serialize them concurrently.
+constexpr std::int64_t min_size_for_concurrency = 1024;
+
 template<int D>
 class NDimensionalHelper {
  public:
@@ -122,6 +127,53 @@ void ZfpCompressor::ReadFromMessageMultidimensional(
   ReadFromMessage(field.get(), message);
 }
 
+template<int D>
+void ZfpCompressor::WriteToMessageMultidimensional(
+    std::vector<not_null<ZfpCompressor const*>> const& compressors,
+    std::vector<not_null<std::vector<double>*>> const& vs,
+    not_null<std::string*> const message,
+    not_null<std::vector<std::int64_t>*> const sizes) {
+  CHECK_EQ(compressors.size(), vs.size());
+  std::int64_t max_size = 0;
+  for (auto const v : vs) {
+    max_size = std::max<std::int64_t>(max_size, v->size());
+  }
+
+  std::vector<std::string> encodings(vs.size());
+  RunForEach(vs.size(),
+             /*parallel=*/max_size >= min_size_for_concurrency,
+             [&compressors, &encodings, &vs](std::int64_t const i) {
+               compressors[i]->WriteToMessageMultidimensional<D>(
+                   *vs[i], &encodings[i]);
+             });
+  for (auto const& encoding : encodings) {
+    message->append(encoding);
+    sizes->push_back(encoding.size());
+  }
+}
+
+template<int D>
+void ZfpCompressor::ReadFromMessageMultidimensional(
+    std::vector<not_null<std::vector<double>*>> const& vs,
+    std::vector<std::int64_t> const& sizes,
+    std::string_view& message) const {
+  CHECK_EQ(vs.size(), sizes.size());
+  std::int64_t max_size = 0;
+  std::vector<std::string_view> encodings;
+  for (int i = 0; i < vs.size(); ++i) {
+    max_size = std::max<std::int64_t>(max_size, vs[i]->size());
+    CHECK_LE(sizes[i], message.size());
+    encodings.push_back(message.substr(0, sizes[i]));
+    message.remove_prefix(sizes[i]);
+  }
+
+  RunForEach(vs.size(),
+             /*parallel=*/max_size >= min_size_for_concurrency,
+             [this, &encodings, &vs](std::int64_t const i) {
+               ReadFromMessageMultidimensional<D>(*vs[i], encodings[i]);
+             });
+}
+
 }  // namespace internal
 }  // namespace _zfp_compressor
 }  // namespace base
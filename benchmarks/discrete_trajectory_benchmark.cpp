@@ -1,6 +1,8 @@
 // .\Release\x64\benchmarks.exe --benchmark_filter=DiscreteTrajectory --benchmark_repetitions=5  // NOLINT(whitespace/line_length)
 
+#include <algorithm>
 #include <optional>
+#include <random>
 #include <vector>
 
 #include "base/status_utilities.hpp"  // 🧙 For CHECK_OK.
@@ -67,6 +69,16 @@ DiscreteTrajectory<World> MakeTrajectory(Timeline<World> const& timeline,
   return trajectory;
 }
 
+// Constructs a timeline of the given type with the points of |timeline|.
+template<typename T>
+T MakeTimeline(Timeline<World> const& timeline) {
+  T result;
+  for (auto const& [t, degrees_of_freedom] : timeline) {
+    result.emplace_hint(result.end(), t, degrees_of_freedom);
+  }
+  return result;
+}
+
 // Constructs a trajectory beginning with many empty segments.
 DiscreteTrajectory<World> MakeTrajectoryWithEmptySegments(
     int const number_of_empty_segments) {
@@ -396,6 +408,181 @@ void BM_DiscreteTrajectoryEvaluateDegreesOfFreedomInterpolated(
   }
 }
 
+template<typename T>
+void BM_TimelineAppend(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const timeline =
+      NewMotionlessTrajectoryTimeline(World::origin,
+                                      /*Δt=*/1 * Second,
+                                      /*t1=*/t0,
+                                      /*t2=*/t0 + steps * Second);
+  for (auto _ : state) {
+    T appended;
+    for (auto const& [t, degrees_of_freedom] : timeline) {
+      appended.emplace_hint(appended.end(), t, degrees_of_freedom);
+    }
+    benchmark::DoNotOptimize(appended);
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+template<typename T>
+void BM_TimelineLowerBound(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const timeline = MakeTimeline<T>(
+      NewCircularTrajectoryTimeline<World>(/*ω=*/1 * Radian / Second,
+                                           /*r=*/1 * Metre,
+                                           /*Δt=*/1 * Second,
+                                           /*t1=*/t0,
+                                           /*t2=*/t0 + steps * Second));
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(0, steps);
+  std::vector<Instant> times;
+  for (int i = 0; i < 1000; ++i) {
+    times.push_back(t0 + distribution(random) * Second);
+  }
+  for (auto _ : state) {
+    for (Instant const& t : times) {
+      benchmark::DoNotOptimize(timeline.lower_bound(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * times.size());
+}
+
+template<typename T>
+void BM_TimelineIterate(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const timeline = MakeTimeline<T>(
+      NewMotionlessTrajectoryTimeline(World::origin,
+                                      /*Δt=*/1 * Second,
+                                      /*t1=*/t0,
+                                      /*t2=*/t0 + steps * Second));
+  for (auto _ : state) {
+    for (auto const& point : timeline) {
+      benchmark::DoNotOptimize(point);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Reproduces the pattern of insertions and erasures of downsampling: points
+// are appended, and when there are 100 dense points all but one in 10 are
+// erased, one interval at a time.
+template<typename T>
+void BM_TimelineDownsample(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const timeline =
+      NewMotionlessTrajectoryTimeline(World::origin,
+                                      /*Δt=*/1 * Second,
+                                      /*t1=*/t0,
+                                      /*t2=*/t0 + steps * Second);
+  constexpr int max_dense_intervals = 100;
+  constexpr int kept_one_in = 10;
+  for (auto _ : state) {
+    T downsampled;
+    std::vector<Instant> dense_times;
+    for (auto const& [t, degrees_of_freedom] : timeline) {
+      downsampled.emplace_hint(downsampled.end(), t, degrees_of_freedom);
+      dense_times.push_back(t);
+      if (dense_times.size() > max_dense_intervals) {
+        auto left_it = downsampled.find(dense_times.front());
+        for (int i = kept_one_in; i < dense_times.size(); i += kept_one_in) {
+          ++left_it;
+          left_it = downsampled.erase(left_it,
+                                      downsampled.find(dense_times[i]));
+        }
+        dense_times.erase(dense_times.begin(),
+                          std::prev(dense_times.end()));
+      }
+    }
+    benchmark::DoNotOptimize(downsampled);
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Reproduces the pattern of reanimation: chunks of |steps / 16| points are
+// merged at the beginning of the timeline, each one overlapping the current
+// first point.
+template<typename T>
+void BM_TimelineMergeReanimation(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  int const chunk = steps / 16;
+  std::vector<T> chunks;
+  for (int i = steps; i > 0; i -= chunk) {
+    chunks.push_back(MakeTimeline<T>(
+        NewMotionlessTrajectoryTimeline(World::origin,
+                                        /*Δt=*/1 * Second,
+                                        /*t1=*/t0 + (i - chunk) * Second,
+                                        /*t2=*/t0 + (i + 1) * Second)));
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    T merged;
+    std::vector<T> sources = chunks;
+    state.ResumeTiming();
+    for (auto& source : sources) {
+      merged.merge(source);
+    }
+    benchmark::DoNotOptimize(merged);
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Merges two timelines whose points alternate, the worst case for insertions
+// in the middle.
+template<typename T>
+void BM_TimelineMergeInterleaved(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const even = MakeTimeline<T>(
+      NewMotionlessTrajectoryTimeline(World::origin,
+                                      /*Δt=*/2 * Second,
+                                      /*t1=*/t0,
+                                      /*t2=*/t0 + steps * Second));
+  auto const odd = MakeTimeline<T>(
+      NewMotionlessTrajectoryTimeline(World::origin,
+                                      /*Δt=*/2 * Second,
+                                      /*t1=*/t0 + 1 * Second,
+                                      /*t2=*/t0 + steps * Second));
+  for (auto _ : state) {
+    state.PauseTiming();
+    T merged = even;
+    T source = odd;
+    state.ResumeTiming();
+    merged.merge(source);
+    benchmark::DoNotOptimize(merged);
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Same as above, but with the actual downsampling of a trajectory, using
+// whichever timeline is configured.
+void BM_DiscreteTrajectoryDownsampling(benchmark::State& state) {
+  Instant const t0;
+  int const steps = state.range(0);
+  auto const timeline =
+      NewCircularTrajectoryTimeline<World>(/*ω=*/1 * Radian / Second,
+                                           /*r=*/1 * Metre,
+                                           /*Δt=*/0.1 * Second,
+                                           /*t1=*/t0,
+                                           /*t2=*/t0 + steps * 0.1 * Second);
+  for (auto _ : state) {
+    DiscreteTrajectory<World> trajectory;
+    trajectory.segments().front().SetDownsampling(
+        {.max_dense_intervals = 100, .tolerance = 1 * Milli(Metre)});
+    for (auto const& [t, degrees_of_freedom] : timeline) {
+      CHECK_OK(trajectory.Append(t, degrees_of_freedom));
+    }
+    benchmark::DoNotOptimize(trajectory);
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
 BENCHMARK(BM_DiscreteTrajectoryFront);
 BENCHMARK(BM_DiscreteTrajectoryFrontEmpty);
 BENCHMARK(BM_DiscreteTrajectoryBack);
@@ -419,6 +606,31 @@ BENCHMARK(BM_DiscreteTrajectoryFind)->Range(8, 1024);
 BENCHMARK(BM_DiscreteTrajectoryLowerBound)->Range(8, 1024);
 BENCHMARK(BM_DiscreteTrajectoryEvaluateDegreesOfFreedomExact);
 BENCHMARK(BM_DiscreteTrajectoryEvaluateDegreesOfFreedomInterpolated);
+BENCHMARK(BM_DiscreteTrajectoryDownsampling)->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineAppend, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineAppend, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineLowerBound, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineLowerBound, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineIterate, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineIterate, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineDownsample, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineDownsample, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineMergeReanimation, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineMergeReanimation, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineMergeInterleaved, BTreeTimeline<World>)
+    ->Range(1024, 1 << 16);
+BENCHMARK_TEMPLATE(BM_TimelineMergeInterleaved, FlatTimeline<World>)
+    ->Range(1024, 1 << 16);
 
 }  // namespace physics
 }  // namespace principia
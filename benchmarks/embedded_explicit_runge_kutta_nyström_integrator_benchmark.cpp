@@ -4,15 +4,19 @@
 
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "base/status_utilities.hpp"  // 🧙 For CHECK_OK.
 #include "benchmark/benchmark.h"
 #include "geometry/frame.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/instant.hpp"
 #include "geometry/space.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_ensemble_integrator.hpp"  // NOLINT
 #include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/integrators.hpp"
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -31,7 +35,9 @@ using namespace principia::geometry::_frame;
 using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_instant;
 using namespace principia::geometry::_space;
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_ensemble_integrator;  // NOLINT
 using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_integrator;  // NOLINT
+using namespace principia::integrators::_integrators;
 using namespace principia::integrators::_methods;
 using namespace principia::integrators::_ordinary_differential_equations;
 using namespace principia::quantities::_elementary_functions;
@@ -216,6 +222,113 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
   state.SetLabel(ss.str());
 }
 
+// Integrates |state.range(0)| harmonic oscillators with different initial
+// conditions, either separately or as an ensemble.
+template<typename Method>
+void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillators(
+    benchmark::State& state) {
+  int const members = state.range(0);
+  Instant const t_initial;
+  Instant const t_final = t_initial + 100 * Second;
+  Length const length_tolerance = 1e-6 * Metre;
+  Speed const speed_tolerance = 1e-6 * Metre / Second;
+
+  ODE3D harmonic_oscillator;
+  harmonic_oscillator.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration3D<World>,
+                _1, _2, _3, /*evaluations=*/nullptr);
+  AdaptiveStepSizeIntegrator<ODE3D>::Parameters const parameters(
+      /*first_time_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio3D<ODE3D>,
+                _1, _2, _3, length_tolerance, speed_tolerance);
+  Length q_sum;
+  auto const append_state = [&q_sum](ODE3D::State const& state) {
+    q_sum += (state.positions[0].value - World::origin).Norm();
+  };
+
+  for (auto _ : state) {
+    for (int m = 0; m < members; ++m) {
+      InitialValueProblem<ODE3D> problem;
+      problem.equation = harmonic_oscillator;
+      problem.initial_state = {
+          t_initial,
+          {World::origin +
+           Displacement<World>({1 * Metre, m * Metre, 0 * Metre})},
+          {Velocity<World>()}};
+      auto const instance =
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, ODE3D>()
+              .NewInstance(
+                  problem, append_state, tolerance_to_error_ratio, parameters);
+      CHECK_OK(instance->Solve(t_final));
+    }
+    benchmark::DoNotOptimize(q_sum);
+  }
+}
+
+template<typename Method>
+void BM_EmbeddedExplicitRungeKuttaNyströmEnsembleIntegratorSolveHarmonicOscillators(  // NOLINT
+    benchmark::State& state) {
+  using Integrator =
+      std::remove_cvref_t<decltype(
+          EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method,
+                                                              ODE3D>())>;
+  int const members = state.range(0);
+  Instant const t_initial;
+  Instant const t_final = t_initial + 100 * Second;
+  Length const length_tolerance = 1e-6 * Metre;
+  Speed const speed_tolerance = 1e-6 * Metre / Second;
+
+  AdaptiveStepSizeIntegrator<ODE3D>::Parameters const parameters(
+      /*first_time_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio3D<ODE3D>,
+                _1, _2, _3, length_tolerance, speed_tolerance);
+  Length q_sum;
+  auto const append_state = [&q_sum](ODE3D::State const& state) {
+    q_sum += (state.positions[0].value - World::origin).Norm();
+  };
+  auto const compute_accelerations =
+      [](std::vector<int> const& members,
+         std::vector<Instant> const& times,
+         std::vector<std::vector<Position<World>>> const& positions,
+         std::vector<std::vector<Vector<Acceleration, World>>>& accelerations,
+         std::vector<absl::Status>& statuses) {
+        for (int const m : members) {
+          statuses[m] = ComputeHarmonicOscillatorAcceleration3D<World>(
+              times[m], positions[m], accelerations[m],
+              /*evaluations=*/nullptr);
+        }
+      };
+
+  std::vector<typename Integrator::Member> ensemble;
+  for (int m = 0; m < members; ++m) {
+    ensemble.push_back(
+        {.initial_state = {t_initial,
+                           {World::origin + Displacement<World>(
+                                                {1 * Metre,
+                                                 m * Metre,
+                                                 0 * Metre})},
+                           {Velocity<World>()}},
+         .append_state = append_state,
+         .tolerance_to_error_ratio = tolerance_to_error_ratio,
+         .parameters = parameters});
+  }
+  std::vector<Instant> const t_finals(members, t_final);
+
+  for (auto _ : state) {
+    auto const instance =
+        EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE3D>()
+            .NewInstance(ensemble, compute_accelerations);
+    for (auto const& status : instance->Solve(t_finals)) {
+      CHECK_OK(status);
+    }
+    benchmark::DoNotOptimize(q_sum);
+  }
+}
+
 // Keep each argument on a single line below, lest it breaks benchmark parsing.
 
 BENCHMARK_TEMPLATE2(
@@ -228,5 +341,17 @@ BENCHMARK_TEMPLATE2(
     methods::DormandالمكاوىPrince1986RKN434FM, ODE3D)
     ->Unit(benchmark::kMillisecond);
 
+BENCHMARK_TEMPLATE(
+    BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillators,
+    methods::DormandالمكاوىPrince1986RKN434FM)
+    ->Arg(1)->Arg(8)->Arg(64)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(
+    BM_EmbeddedExplicitRungeKuttaNyströmEnsembleIntegratorSolveHarmonicOscillators,  // NOLINT
+    methods::DormandالمكاوىPrince1986RKN434FM)
+    ->Arg(1)->Arg(8)->Arg(64)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace integrators
 }  // namespace principia
@@ -1,13 +1,21 @@
 // .\Release\x64\benchmarks.exe --benchmark_repetitions=10 --benchmark_filter=(Encode|Decode)  // NOLINT(whitespace/line_length)
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <numbers>
 #include <random>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "base/array.hpp"
 #include "base/base32768.hpp"
 #include "base/base64.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/macros.hpp"  // 🧙 For PRINCIPIA_COMPILER_MSVC.
+#include "base/not_null.hpp"
+#include "base/zfp_compressor.hpp"
 #include "benchmark/benchmark.h"
 
 // Clang doesn't have a correct |std::array| yet, and we don't actually use this
@@ -21,6 +29,8 @@ using namespace principia::base::_array;
 using namespace principia::base::_base32768;
 using namespace principia::base::_base64;
 using namespace principia::base::_hexadecimal;
+using namespace principia::base::_not_null;
+using namespace principia::base::_zfp_compressor;
 
 template<typename Encoder>
 void BM_Encode(benchmark::State& state) {
@@ -116,6 +126,135 @@ BENCHMARK_TEMPLATE(BM_Encode, Encoder32768);
 BENCHMARK_TEMPLATE(BM_Decode, Encoder32768);
 #endif
 
+// The timeline of a vessel in low orbit, with |size| points spaced irregularly
+// as they would be after downsampling, in the order t, qx, qy, qz, px, py, pz.
+// The maximum spacing is returned in |max_Δt|.
+std::vector<std::vector<double>> NewDownsampledHistory(int const size,
+                                                       double& max_Δt) {
+  constexpr double r = 7.0e6;
+  constexpr double ω = 2 * std::numbers::pi / 5'800;
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> Δt_distribution(10, 60);
+
+  std::vector<std::vector<double>> history(7);
+  max_Δt = 0;
+  double t = 0;
+  for (int i = 0; i < size; ++i) {
+    double const Δt = Δt_distribution(random);
+    max_Δt = std::max(max_Δt, Δt);
+    t += Δt;
+    history[0].push_back(t);
+    history[1].push_back(r * std::cos(ω * t));
+    history[2].push_back(r * std::sin(ω * t));
+    history[3].push_back(0.1 * r * std::sin(ω * t));
+    history[4].push_back(-r * ω * std::sin(ω * t));
+    history[5].push_back(r * ω * std::cos(ω * t));
+    history[6].push_back(0.1 * r * ω * std::cos(ω * t));
+  }
+  return history;
+}
+
+// The compressors used by a downsampled |DiscreteTrajectorySegment|.
+std::vector<ZfpCompressor> NewSegmentCompressors(double const max_Δt) {
+  constexpr double length_tolerance = 10;
+  std::vector<ZfpCompressor> compressors;
+  compressors.emplace_back(0);
+  for (int i = 0; i < 3; ++i) {
+    compressors.emplace_back(length_tolerance);
+  }
+  for (int i = 0; i < 3; ++i) {
+    compressors.emplace_back(length_tolerance / max_Δt);
+  }
+  return compressors;
+}
+
+// Benchmarks the serialization of a segment with |state.range(0)| points.  The
+// components are compressed concurrently iff |state.range(1)| is nonzero.
+void BM_ZfpEncode(benchmark::State& state) {
+  int const size = state.range(0);
+  bool const concurrent = state.range(1) != 0;
+  double max_Δt;
+  auto history = NewDownsampledHistory(size, max_Δt);
+  auto const compressors = NewSegmentCompressors(max_Δt);
+  std::vector<not_null<ZfpCompressor const*>> compressor_pointers;
+  std::vector<not_null<std::vector<double>*>> component_pointers;
+  for (int i = 0; i < history.size(); ++i) {
+    compressor_pointers.push_back(&compressors[i]);
+    component_pointers.push_back(&history[i]);
+  }
+
+  std::string message;
+  std::vector<std::int64_t> sizes;
+  for (auto _ : state) {
+    message.clear();
+    sizes.clear();
+    if (concurrent) {
+      ZfpCompressor::WriteToMessageMultidimensional<2>(
+          compressor_pointers, component_pointers, &message, &sizes);
+    } else {
+      for (int i = 0; i < history.size(); ++i) {
+        compressors[i].WriteToMessageMultidimensional<2>(history[i], &message);
+      }
+    }
+    benchmark::DoNotOptimize(message);
+  }
+  state.SetBytesProcessed(state.iterations() * history.size() * size *
+                          sizeof(double));
+  state.SetLabel(std::to_string(message.size()) + " bytes");
+}
+
+// Same as above for deserialization.
+void BM_ZfpDecode(benchmark::State& state) {
+  int const size = state.range(0);
+  bool const concurrent = state.range(1) != 0;
+  double max_Δt;
+  auto history = NewDownsampledHistory(size, max_Δt);
+  auto const compressors = NewSegmentCompressors(max_Δt);
+  std::vector<not_null<ZfpCompressor const*>> compressor_pointers;
+  std::vector<not_null<std::vector<double>*>> component_pointers;
+  for (int i = 0; i < history.size(); ++i) {
+    compressor_pointers.push_back(&compressors[i]);
+    component_pointers.push_back(&history[i]);
+  }
+  std::string message;
+  std::vector<std::int64_t> sizes;
+  ZfpCompressor::WriteToMessageMultidimensional<2>(
+      compressor_pointers, component_pointers, &message, &sizes);
+
+  ZfpCompressor const decompressor;
+  for (auto _ : state) {
+    std::string_view encoded = message;
+    if (concurrent) {
+      decompressor.ReadFromMessageMultidimensional<2>(
+          component_pointers, sizes, encoded);
+    } else {
+      for (auto& component : history) {
+        decompressor.ReadFromMessageMultidimensional<2>(component, encoded);
+      }
+    }
+    benchmark::DoNotOptimize(history);
+  }
+  state.SetBytesProcessed(state.iterations() * history.size() * size *
+                          sizeof(double));
+}
+
+BENCHMARK(BM_ZfpEncode)
+    ->ArgPair(1'000, 0)
+    ->ArgPair(1'000, 1)
+    ->ArgPair(10'000, 0)
+    ->ArgPair(10'000, 1)
+    ->ArgPair(100'000, 0)
+    ->ArgPair(100'000, 1)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ZfpDecode)
+    ->ArgPair(1'000, 0)
+    ->ArgPair(1'000, 1)
+    ->ArgPair(10'000, 0)
+    ->ArgPair(10'000, 1)
+    ->ArgPair(100'000, 0)
+    ->ArgPair(100'000, 1)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace base
 }  // namespace principia
 
@@ -393,6 +393,92 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
   state.SetLabel(ss.str());
 }
 
+// Flows, for one day, |state.range(0)| probes in a constellation around the
+// Earth, either one at a time or as an ensemble.
+template<bool ensemble>
+void BM_EphemerisConstellation(benchmark::State& state) {
+  auto const at_спутник_1_launch = SolarSystemAtСпутник1Launch(
+      SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  Instant const epoch = at_спутник_1_launch->epoch();
+  Instant const final_time = epoch + 1 * Day;
+  auto const ephemeris =
+      at_спутник_1_launch->MakeEphemeris(
+          /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                                   /*geopotential_tolerance=*/0x1p-24},
+          EphemerisParameters());
+  CHECK_OK(ephemeris->Prolong(final_time));
+  std::string const& earth_name =
+      SolarSystemFactory::name(SolarSystemFactory::Earth);
+  auto const earth_massive_body =
+      at_спутник_1_launch->massive_body(*ephemeris, earth_name);
+  auto const earth_degrees_of_freedom =
+      at_спутник_1_launch->degrees_of_freedom(earth_name);
+  Ephemeris<Barycentric>::AdaptiveStepParameters const parameters(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Ephemeris<Barycentric>::NewtonianMotionEquation>(),
+      /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+      /*length_integration_tolerance=*/1 * Metre,
+      /*speed_integration_tolerance=*/1 * Metre / Second);
+
+  MasslessBody probe;
+  std::int64_t steps = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::list<DiscreteTrajectory<Barycentric>> trajectories;
+    std::vector<not_null<DiscreteTrajectory<Barycentric>*>>
+        trajectory_pointers;
+    for (int i = 0; i < state.range(0); ++i) {
+      KeplerianElements<Barycentric> elements;
+      elements.eccentricity = 0;
+      elements.semimajor_axis = 10'000 * Kilo(Metre);
+      elements.inclination = 0 * Radian;
+      elements.longitude_of_ascending_node = 0 * Radian;
+      elements.argument_of_periapsis = 0 * Radian;
+      elements.true_anomaly = i * 2 * π * Radian / state.range(0);
+      KeplerOrbit<Barycentric> const orbit(
+          *earth_massive_body, probe, elements, epoch);
+      trajectories.emplace_back();
+      auto& trajectory = trajectories.back();
+      CHECK_OK(trajectory.Append(
+          epoch, earth_degrees_of_freedom + orbit.StateVectors(epoch)));
+      trajectory_pointers.push_back(&trajectory);
+    }
+    state.ResumeTiming();
+
+    if constexpr (ensemble) {
+      auto const statuses =
+          ephemeris->FlowEnsembleWithAdaptiveStep<
+              DormandالمكاوىPrince1986RKN434FM>(
+              trajectory_pointers,
+              Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+              final_time,
+              std::vector(trajectory_pointers.size(), parameters));
+      for (auto const& status : statuses) {
+        CHECK_OK(status);
+      }
+    } else {
+      for (auto const trajectory : trajectory_pointers) {
+        CHECK_OK(ephemeris->FlowWithAdaptiveStep(
+            trajectory,
+            Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+            final_time,
+            parameters));
+      }
+    }
+
+    state.PauseTiming();
+    steps = 0;
+    for (auto const& trajectory : trajectories) {
+      steps += trajectory.size();
+    }
+    state.ResumeTiming();
+  }
+  std::stringstream ss;
+  ss << steps;
+  state.SetLabel(ss.str() + " steps");
+}
+
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
 void EphemerisL4ProbeBenchmark(Time const integration_duration,
                                benchmark::State& state) {
@@ -687,6 +773,19 @@ BENCHMARK_TEMPLATE(BM_EphemerisL4Probe1Year,
     ->Arg(-3)
     ->Unit(benchmark::kSecond);
 
+BENCHMARK_TEMPLATE(BM_EphemerisConstellation, /*ensemble=*/false)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EphemerisConstellation, /*ensemble=*/true)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_TEMPLATE(BM_EphemerisFittingTolerance, &FlowEphemerisWithAdaptiveStep)
     ->DenseRange(-4, 4)
     ->Unit(benchmark::kMillisecond);
@@ -86,10 +86,24 @@ GeneralSphericalHarmonicsAccelerationF90(
   return from_surface_frame(acceleration_surface);
 }
 
+// If |zonal| is true, the tesseral and sectoral coefficients of the Earth are
+// dropped.
 OblateBody<ICRS> MakeEarthBody(SolarSystem<ICRS>& solar_system,
-                               int const max_degree) {
+                               int const max_degree,
+                               bool const zonal = false) {
   solar_system.LimitOblatenessToDegree("Earth", max_degree);
   auto earth_message = solar_system.gravity_model_message("Earth");
+  if (zonal) {
+    for (auto& row : *earth_message.mutable_geopotential()->mutable_row()) {
+      auto const columns = row.column();
+      row.clear_column();
+      for (auto const& column : columns) {
+        if (column.order() == 0) {
+          *row.add_column() = column;
+        }
+      }
+    }
+  }
 
   Angle const earth_right_ascension_of_pole = 0 * Degree;
   Angle const earth_declination_of_pole = 90 * Degree;
@@ -142,6 +156,68 @@ void BM_ComputeGeopotentialCpp(benchmark::State& state) {
   }
 }
 
+void BM_ComputeGeopotentialCppZonal(benchmark::State& state) {
+  int const max_degree = state.range(0);
+
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+
+  auto const earth =
+      MakeEarthBody(solar_system_2000, max_degree, /*zonal=*/true);
+  Geopotential<ICRS> const geopotential(&earth, /*tolerance=*/0);
+
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-1e7, 1e7);
+  std::vector<Displacement<ICRS>> displacements;
+  for (int i = 0; i < 1e3; ++i) {
+    displacements.push_back(earth.FromSurfaceFrame<ITRS>(Instant())(
+        Displacement<ITRS>({distribution(random) * Metre,
+                            distribution(random) * Metre,
+                            distribution(random) * Metre})));
+  }
+
+  for (auto _ : state) {
+    Vector<Exponentiation<Length, -2>, ICRS> acceleration;
+    for (auto const& displacement : displacements) {
+      acceleration = GeneralSphericalHarmonicsAccelerationCpp(
+                         geopotential, Instant(), displacement);
+    }
+    benchmark::DoNotOptimize(acceleration);
+  }
+}
+
+void BM_ComputeGeopotentialCppBatched(benchmark::State& state) {
+  int const max_degree = state.range(0);
+
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+
+  auto const earth = MakeEarthBody(solar_system_2000, max_degree);
+  Geopotential<ICRS> const geopotential(&earth, /*tolerance=*/0);
+
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-1e7, 1e7);
+  std::vector<Displacement<ICRS>> displacements;
+  for (int i = 0; i < 1e3; ++i) {
+    displacements.push_back(earth.FromSurfaceFrame<ITRS>(Instant())(
+        Displacement<ITRS>({distribution(random) * Metre,
+                            distribution(random) * Metre,
+                            distribution(random) * Metre})));
+  }
+
+  std::vector<Vector<Exponentiation<Length, -2>, ICRS>> accelerations(
+      displacements.size());
+  for (auto _ : state) {
+    geopotential.GeneralSphericalHarmonicsAccelerations(
+        Instant(), displacements, accelerations);
+    benchmark::DoNotOptimize(accelerations);
+  }
+}
+
 void BM_ComputeGeopotentialDistance(benchmark::State& state) {
   // Check the performance around this distance.  May be used to tell apart the
   // various contributions.
@@ -248,6 +324,17 @@ BENCHMARK(BM_ComputeGeopotentialCpp)
     ->Arg(5)
     ->Arg(10)
     ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComputeGeopotentialCppZonal)
+    ->Arg(2)   // J₂.
+    ->Arg(4)
+    ->Arg(10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComputeGeopotentialCppBatched)
+    ->Arg(2)
+    ->Arg(3)
+    ->Arg(5)
+    ->Arg(10)
+    ->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_ComputeGeopotentialF90)
     ->Arg(2)
     ->Arg(3)
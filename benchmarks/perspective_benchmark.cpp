@@ -139,7 +139,8 @@ void BM_VisibleSegmentsOrbit(benchmark::State& state) {
                                 static_cast<double>(visible_segments_count)));
 }
 
-void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
+void OrbitMultipleSpheresBenchmark(bool const use_sphere_hierarchy,
+                                   benchmark::State& state) {
   // The camera is slightly above the x-y plane and looks towards the positive
   // x-axis.
   Position<World> const camera_origin(
@@ -189,12 +190,25 @@ void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
 
   int visible_segments_count = 0;
   int visible_segments_size = 0;
-  for (auto _ : state) {
-    for (auto const& segment : segments) {
-      auto const visible_segments =
-          perspective.VisibleSegments(segment, spheres);
-      ++visible_segments_count;
-      visible_segments_size += visible_segments.size();
+  if (use_sphere_hierarchy) {
+    for (auto _ : state) {
+      // The hierarchy is rebuilt for each plot, so include it in the timing.
+      auto const sphere_hierarchy = perspective.MakeSphereHierarchy(spheres);
+      for (auto const& segment : segments) {
+        auto const visible_segments =
+            perspective.VisibleSegments(segment, sphere_hierarchy);
+        ++visible_segments_count;
+        visible_segments_size += visible_segments.size();
+      }
+    }
+  } else {
+    for (auto _ : state) {
+      for (auto const& segment : segments) {
+        auto const visible_segments =
+            perspective.VisibleSegments(segment, spheres);
+        ++visible_segments_count;
+        visible_segments_size += visible_segments.size();
+      }
     }
   }
 
@@ -203,6 +217,14 @@ void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
                                 static_cast<double>(visible_segments_count)));
 }
 
+void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
+  OrbitMultipleSpheresBenchmark(/*use_sphere_hierarchy=*/false, state);
+}
+
+void BM_VisibleSegmentsOrbitSphereHierarchy(benchmark::State& state) {
+  OrbitMultipleSpheresBenchmark(/*use_sphere_hierarchy=*/true, state);
+}
+
 void BM_VisibleSegmentsRandomEverywhere(benchmark::State& state) {
   // Generate random segments in the cube [-10, 10[³.
   std::uniform_real_distribution<> distribution(-10.0, 10.0);
@@ -223,7 +245,12 @@ void BM_VisibleSegmentsRandomNoIntersection(benchmark::State& state) {
 BENCHMARK(BM_VisibleSegmentsOrbit)->Arg(10)->Arg(100)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomEverywhere)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomNoIntersection)->Arg(1000);
-BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)->Args({1000, 20});
+BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)
+    ->Args({1000, 20})
+    ->Args({1000, 100});
+BENCHMARK(BM_VisibleSegmentsOrbitSphereHierarchy)
+    ->Args({1000, 20})
+    ->Args({1000, 100});
 
 }  // namespace geometry
 }  // namespace principia
@@ -236,6 +236,7 @@ class Satellites {
         perspective,
         ephemeris_.get(),
         plotting_frame,
+        /*plotting_frame_generation=*/0,
         [plotting_to_gcrs](Position<Navigation> const& plotted_point) {
           constexpr auto inverse_scale_factor = 1 / (6000 * Metre);
           return ScaledSpacePoint::FromCoordinates(
@@ -187,6 +187,57 @@ void BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
   state.SetLabel(ss.str());
 }
 
+// Solves |state.range(0)| independent harmonic oscillators, to measure the
+// cost of the stage updates as a function of the dimension of the system.
+template<typename Method>
+void BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillators3D(
+    benchmark::State& state) {
+  int const dimension = state.range(0);
+  Instant const t_initial;
+  Instant const t_final = t_initial + 1 * Second;
+  Time const step = 3.0e-4 * Second;
+
+  std::vector<Position<World>> q_initial;
+  std::vector<Velocity<World>> v_initial;
+  for (int k = 0; k < dimension; ++k) {
+    q_initial.push_back(
+        World::origin +
+        Displacement<World>({(k + 1) * Metre, -k * Metre, 0.5 * Metre}));
+    v_initial.push_back(Velocity<World>({0.1 * Metre / Second,
+                                         k * Metre / Second,
+                                         -0.2 * Metre / Second}));
+  }
+
+  ODE3D harmonic_oscillators;
+  harmonic_oscillators.compute_acceleration =
+      [](Instant const& t,
+         std::vector<Position<World>> const& q,
+         std::vector<Vector<Acceleration, World>>& result) {
+        for (int k = 0; k < q.size(); ++k) {
+          result[k] = (World::origin - q[k]) *
+                      (si::Unit<Stiffness> / si::Unit<Mass>);
+        }
+        return absl::OkStatus();
+      };
+  InitialValueProblem<ODE3D> problem;
+  problem.equation = harmonic_oscillators;
+  problem.initial_state = {t_initial, q_initial, v_initial};
+  Length q_sum;
+  auto const append_state = [&q_sum](ODE3D::State const& state) {
+    q_sum += (state.positions.back().value - World::origin).Norm();
+  };
+
+  for (auto _ : state) {
+    auto const instance =
+        SymplecticRungeKuttaNyströmIntegrator<Method, ODE3D>().NewInstance(
+            problem, append_state, step);
+    CHECK_OK(instance->Solve(t_final));
+    benchmark::DoNotOptimize(q_sum);
+  }
+  state.SetItemsProcessed(state.iterations() * dimension *
+                          static_cast<int>((t_final - t_initial) / step));
+}
+
 BENCHMARK_TEMPLATE2(
     BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D,
     methods::McLachlanAtela1992Order4Optimal, ODE1D)
@@ -253,5 +304,16 @@ BENCHMARK_TEMPLATE2(
     methods::BlanesMoan2002SRKN14A, ODE3D)
     ->Unit(benchmark::kMillisecond);
 
+BENCHMARK_TEMPLATE(
+    BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillators3D,
+    methods::McLachlanAtela1992Order4Optimal)
+    ->Arg(1)->Arg(8)->Arg(64)->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(
+    BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillators3D,
+    methods::BlanesMoan2002SRKN14A)
+    ->Arg(1)->Arg(8)->Arg(64)->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace integrators
 }  // namespace principia
@@ -6,6 +6,7 @@
 #include <random>
 #include <vector>
 
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
 #include "base/thread_pool.hpp"
 #include "benchmark/benchmark.h"
@@ -49,6 +50,62 @@ double ComsumeCpuExclusiveLock(std::int64_t const n) {
   return result;
 }
 
+// Many tiny tasks, typical of the catch-up of small pile-ups.  The time per
+// iteration is dominated by the overhead of the pool.
+void BM_ThreadPoolTinyTasks(benchmark::State& state) {
+  ThreadPool<void> pool(/*pool_size=*/state.range(0));
+  std::int64_t const number_of_tasks = state.range(1);
+  for (auto _ : state) {
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_tasks);
+    for (int i = 0; i < number_of_tasks; ++i) {
+      futures.push_back(pool.Add([i]() {
+        double result = i;
+        for (int j = 0; j < 100; ++j) {
+          result += std::sqrt(j);
+        }
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& future : futures) {
+      future.wait();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_tasks);
+}
+
+// Same as above, but the tasks are detached and their completion is tracked by
+// a counter, which avoids the cost of the promises and futures.
+void BM_ThreadPoolTinyTasksDetached(benchmark::State& state) {
+  ThreadPool<void> pool(/*pool_size=*/state.range(0));
+  std::int64_t const number_of_tasks = state.range(1);
+  for (auto _ : state) {
+    absl::BlockingCounter remaining(number_of_tasks);
+    for (int i = 0; i < number_of_tasks; ++i) {
+      pool.AddDetached([i, &remaining]() {
+        double result = i;
+        for (int j = 0; j < 100; ++j) {
+          result += std::sqrt(j);
+        }
+        benchmark::DoNotOptimize(result);
+        remaining.DecrementCount();
+      });
+    }
+    remaining.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * number_of_tasks);
+}
+
+// Empty tasks, to measure the cost of adding a call, executing it and waiting
+// for its completion.
+void BM_ThreadPoolPerTaskOverhead(benchmark::State& state) {
+  ThreadPool<void> pool(/*pool_size=*/state.range(0));
+  for (auto _ : state) {
+    pool.Add([]() {}).wait();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
 void BM_ThreadPoolNoLock(benchmark::State& state) {
   ThreadPool<void> pool(/*pool_size=*/state.range(0));
   std::vector<std::int64_t> results;
@@ -100,6 +157,17 @@ void BM_ThreadPoolExclusiveLock(benchmark::State& state) {
   }
 }
 
+BENCHMARK(BM_ThreadPoolTinyTasks)
+    ->ArgsProduct({{1, 2, 4, 8, 16, 32, 64}, {100, 500}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ThreadPoolTinyTasksDetached)
+    ->ArgsProduct({{1, 2, 4, 8, 16, 32, 64}, {100, 500}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ThreadPoolPerTaskOverhead)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Unit(benchmark::kMicrosecond);
 BENCHMARK(BM_ThreadPoolNoLock)
     ->Arg(1)
     ->Arg(2)
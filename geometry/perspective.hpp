@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "base/array.hpp"
+#include "geometry/grassmann.hpp"
 #include "geometry/rp2_point.hpp"
 #include "geometry/space.hpp"
 #include "geometry/space_transformations.hpp"
@@ -18,6 +20,7 @@ namespace _perspective {
 namespace internal {
 
 using namespace principia::base::_array;
+using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_rp2_point;
 using namespace principia::geometry::_space;
 using namespace principia::geometry::_space_transformations;
@@ -31,6 +34,65 @@ using Segment = std::pair<Position<Frame>, Position<Frame>>;
 template<typename Frame>
 using Segments = std::vector<Segment<Frame>>;
 
+// A set of spheres that may hide segments as seen from a |camera|.  Each
+// sphere is enclosed in a cone with its apex at the camera, and the cones are
+// organized in a bounding volume hierarchy.  This makes it possible to only
+// consider the spheres whose cone intersects the cone under which a segment is
+// seen, which is much cheaper than considering all the spheres when there are
+// many of them and they are scattered across the sky.
+template<typename Frame>
+class SphereHierarchy final {
+ public:
+  SphereHierarchy(Position<Frame> const& camera,
+                  std::vector<Sphere<Frame>> spheres);
+
+  Position<Frame> const& camera() const;
+  std::vector<Sphere<Frame>> const& spheres() const;
+
+  // Returns the indices in |spheres()| of the spheres that may hide some part
+  // of |segment|, in increasing order.  The other spheres are guaranteed not
+  // to hide any part of |segment|.
+  std::vector<std::int32_t> Candidates(Segment<Frame> const& segment) const;
+
+ private:
+  // A circular cone with its apex at |camera_|.  A |half_angle| of π denotes
+  // the entire space.
+  struct Cone {
+    Vector<double, Frame> axis;
+    Angle half_angle;
+  };
+
+  // A node of the hierarchy.  Its |cone| encloses the cones of the spheres
+  // |indices_[begin]|, ..., |indices_[end - 1]|.  A node with a single sphere
+  // is a leaf, other nodes have two children.
+  struct Node {
+    Cone cone;
+    std::int32_t begin;
+    std::int32_t end;
+    std::int32_t first_child = -1;
+    std::int32_t second_child = -1;
+  };
+
+  // Builds the subtree for the spheres |indices_[begin]|, ...,
+  // |indices_[end - 1]| and returns the index of its root in |nodes_|.
+  std::int32_t Build(std::int32_t begin, std::int32_t end);
+
+  void AddCandidates(Node const& node,
+                     Cone const& segment_cone,
+                     std::vector<std::int32_t>& candidates) const;
+
+  static bool Intersect(Cone const& cone1, Cone const& cone2);
+
+  Position<Frame> const camera_;
+  std::vector<Sphere<Frame>> const spheres_;
+  // The cone under which each sphere is seen, indexed like |spheres_|.
+  std::vector<Cone> sphere_cones_;
+  // A permutation of the indices of |spheres_| such that the spheres below a
+  // node have consecutive positions.
+  std::vector<std::int32_t> indices_;
+  std::vector<Node> nodes_;
+};
+
 // A perspective using the pinhole camera model.  It project a point of
 // |FromFrame| to an element of ℝP².  |ToFrame| is the frame of the camera.  In
 // that frame the camera is located at the origin and looking at the positive
@@ -82,7 +144,27 @@ class Perspective final {
       Segment<FromFrame> const& segment,
       std::vector<Sphere<FromFrame>> const& spheres) const;
 
+  // Returns a hierarchy of the |spheres| as seen from the camera of this
+  // perspective.
+  SphereHierarchy<FromFrame> MakeSphereHierarchy(
+      std::vector<Sphere<FromFrame>> spheres) const;
+
+  // Same as above, but only considers the spheres of |spheres| that may hide
+  // |segment|.  The result is the same as that of the previous function with
+  // |spheres.spheres()|.  |spheres| must have been built by
+  // |MakeSphereHierarchy| on this perspective.
+  Segments<FromFrame> VisibleSegments(
+      Segment<FromFrame> const& segment,
+      SphereHierarchy<FromFrame> const& spheres) const;
+
  private:
+  // The implementation of the above functions.  |Spheres| is a container of
+  // objects convertible to |Sphere<FromFrame> const&|.
+  template<typename Spheres>
+  Segments<FromFrame> VisibleSegmentsForSpheres(
+      Segment<FromFrame> const& segment,
+      Spheres const& spheres) const;
+
   Similarity<ToFrame, FromFrame> const from_camera_;
   Similarity<FromFrame, ToFrame> const to_camera_;
   Position<FromFrame> const camera_;
@@ -103,6 +185,7 @@ std::ostream& operator<<(
 using internal::Perspective;
 using internal::Segment;
 using internal::Segments;
+using internal::SphereHierarchy;
 
 }  // namespace _perspective
 }  // namespace geometry
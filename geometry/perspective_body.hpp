@@ -3,15 +3,16 @@
 #include "geometry/perspective.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <utility>
 #include <vector>
 
 #include "geometry/barycentre_calculator.hpp"
-#include "geometry/grassmann.hpp"
 #include "geometry/r3_element.hpp"
 #include "numerics/root_finders.hpp"
 #include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace geometry {
@@ -19,10 +20,171 @@ namespace _perspective {
 namespace internal {
 
 using namespace principia::geometry::_barycentre_calculator;
-using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_r3_element;
 using namespace principia::numerics::_root_finders;
 using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_si;
+
+template<typename Frame>
+SphereHierarchy<Frame>::SphereHierarchy(Position<Frame> const& camera,
+                                        std::vector<Sphere<Frame>> spheres)
+    : camera_(camera),
+      spheres_(std::move(spheres)) {
+  sphere_cones_.reserve(spheres_.size());
+  indices_.reserve(spheres_.size());
+  for (std::int32_t i = 0; i < spheres_.size(); ++i) {
+    auto const& sphere = spheres_[i];
+    Displacement<Frame> const camera_to_centre = sphere.centre() - camera_;
+    auto const camera_to_centre² = camera_to_centre.Norm²();
+    if (camera_to_centre² <= sphere.radius²()) {
+      // The camera is inside the sphere, which hides everything.
+      sphere_cones_.push_back({.axis = Vector<double, Frame>({1, 0, 0}),
+                               .half_angle = π * Radian});
+    } else {
+      sphere_cones_.push_back(
+          {.axis = Normalize(camera_to_centre),
+           .half_angle = ArcSin(Sqrt(sphere.radius²() / camera_to_centre²))});
+    }
+    indices_.push_back(i);
+  }
+  if (!spheres_.empty()) {
+    nodes_.reserve(2 * spheres_.size() - 1);
+    Build(/*begin=*/0, /*end=*/spheres_.size());
+  }
+}
+
+template<typename Frame>
+Position<Frame> const& SphereHierarchy<Frame>::camera() const {
+  return camera_;
+}
+
+template<typename Frame>
+std::vector<Sphere<Frame>> const& SphereHierarchy<Frame>::spheres() const {
+  return spheres_;
+}
+
+template<typename Frame>
+std::vector<std::int32_t> SphereHierarchy<Frame>::Candidates(
+    Segment<Frame> const& segment) const {
+  std::vector<std::int32_t> candidates;
+  if (nodes_.empty()) {
+    return candidates;
+  }
+
+  // The segment is seen under the arc of great circle between the directions
+  // of its extremities, which is enclosed in the cone whose axis is the
+  // bisector of these directions.
+  Displacement<Frame> const camera_to_first = segment.first - camera_;
+  Displacement<Frame> const camera_to_second = segment.second - camera_;
+  Cone segment_cone{.axis = Vector<double, Frame>({1, 0, 0}),
+                    .half_angle = π * Radian};
+  if (camera_to_first != Displacement<Frame>{} &&
+      camera_to_second != Displacement<Frame>{}) {
+    Vector<double, Frame> const first_direction = Normalize(camera_to_first);
+    Vector<double, Frame> const second_direction = Normalize(camera_to_second);
+    Vector<double, Frame> const bisector = first_direction + second_direction;
+    if (bisector != Vector<double, Frame>{}) {
+      segment_cone = {
+          .axis = Normalize(bisector),
+          .half_angle = AngleBetween(first_direction, second_direction) / 2};
+    }
+  }
+
+  // The root is the first node built.
+  AddCandidates(nodes_.front(), segment_cone, candidates);
+  std::sort(candidates.begin(), candidates.end());
+  return candidates;
+}
+
+template<typename Frame>
+std::int32_t SphereHierarchy<Frame>::Build(std::int32_t const begin,
+                                           std::int32_t const end) {
+  std::int32_t const index = nodes_.size();
+  nodes_.push_back({.begin = begin, .end = end});
+
+  // The axis of the enclosing cone is the mean of the axes of the cones of the
+  // spheres, and it is wide enough to contain all of them.
+  Vector<double, Frame> sum_of_axes;
+  for (std::int32_t i = begin; i < end; ++i) {
+    sum_of_axes += sphere_cones_[indices_[i]].axis;
+  }
+  Cone cone{.axis = Vector<double, Frame>({1, 0, 0}),
+            .half_angle = π * Radian};
+  if (sum_of_axes != Vector<double, Frame>{}) {
+    cone = {.axis = Normalize(sum_of_axes), .half_angle = 0 * Radian};
+    for (std::int32_t i = begin; i < end; ++i) {
+      Cone const& sphere_cone = sphere_cones_[indices_[i]];
+      cone.half_angle = std::min(
+          π * Radian,
+          std::max(cone.half_angle,
+                   AngleBetween(cone.axis, sphere_cone.axis) +
+                       sphere_cone.half_angle));
+    }
+  }
+  nodes_[index].cone = cone;
+
+  if (end - begin > 1) {
+    // Split the spheres at the median of the coordinate of the axes of their
+    // cones that has the largest spread.
+    R3Element<double> lower_bounds{+1, +1, +1};
+    R3Element<double> upper_bounds{-1, -1, -1};
+    for (std::int32_t i = begin; i < end; ++i) {
+      auto const& axis = sphere_cones_[indices_[i]].axis.coordinates();
+      for (int c = 0; c < 3; ++c) {
+        lower_bounds[c] = std::min(lower_bounds[c], axis[c]);
+        upper_bounds[c] = std::max(upper_bounds[c], axis[c]);
+      }
+    }
+    R3Element<double> const spreads = upper_bounds - lower_bounds;
+    int split_coordinate = 0;
+    for (int c = 1; c < 3; ++c) {
+      if (spreads[c] > spreads[split_coordinate]) {
+        split_coordinate = c;
+      }
+    }
+    std::int32_t const middle = begin + (end - begin) / 2;
+    std::nth_element(indices_.begin() + begin,
+                     indices_.begin() + middle,
+                     indices_.begin() + end,
+                     [this, split_coordinate](std::int32_t const left,
+                                              std::int32_t const right) {
+                       return sphere_cones_[left].axis.coordinates()
+                                  [split_coordinate] <
+                              sphere_cones_[right].axis.coordinates()
+                                  [split_coordinate];
+                     });
+    std::int32_t const first_child = Build(begin, middle);
+    std::int32_t const second_child = Build(middle, end);
+    nodes_[index].first_child = first_child;
+    nodes_[index].second_child = second_child;
+  }
+  return index;
+}
+
+template<typename Frame>
+void SphereHierarchy<Frame>::AddCandidates(
+    Node const& node,
+    Cone const& segment_cone,
+    std::vector<std::int32_t>& candidates) const {
+  if (!Intersect(node.cone, segment_cone)) {
+    return;
+  }
+  if (node.first_child < 0) {
+    candidates.push_back(indices_[node.begin]);
+  } else {
+    AddCandidates(nodes_[node.first_child], segment_cone, candidates);
+    AddCandidates(nodes_[node.second_child], segment_cone, candidates);
+  }
+}
+
+template<typename Frame>
+bool SphereHierarchy<Frame>::Intersect(Cone const& cone1, Cone const& cone2) {
+  // Two cones intersect iff the angle between their axes is at most the sum of
+  // their half angles.
+  Angle const sum_of_half_angles = cone1.half_angle + cone2.half_angle;
+  return sum_of_half_angles >= π * Radian ||
+         InnerProduct(cone1.axis, cone2.axis) >= Cos(sum_of_half_angles);
+}
 
 template<typename FromFrame, typename ToFrame>
 Perspective<FromFrame, ToFrame>::Perspective(
@@ -366,6 +528,34 @@ template<typename FromFrame, typename ToFrame>
 Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
     Segment<FromFrame> const& segment,
     std::vector<Sphere<FromFrame>> const& spheres) const {
+  return VisibleSegmentsForSpheres(segment, spheres);
+}
+
+template<typename FromFrame, typename ToFrame>
+SphereHierarchy<FromFrame> Perspective<FromFrame, ToFrame>::MakeSphereHierarchy(
+    std::vector<Sphere<FromFrame>> spheres) const {
+  return SphereHierarchy<FromFrame>(camera_, std::move(spheres));
+}
+
+template<typename FromFrame, typename ToFrame>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    SphereHierarchy<FromFrame> const& spheres) const {
+  CHECK_EQ(camera_, spheres.camera());
+  // The spheres that are not candidates leave the segments unchanged, so
+  // skipping them doesn't change the result.
+  std::vector<std::reference_wrapper<Sphere<FromFrame> const>> candidates;
+  for (std::int32_t const i : spheres.Candidates(segment)) {
+    candidates.push_back(spheres.spheres()[i]);
+  }
+  return VisibleSegmentsForSpheres(segment, candidates);
+}
+
+template<typename FromFrame, typename ToFrame>
+template<typename Spheres>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegmentsForSpheres(
+    Segment<FromFrame> const& segment,
+    Spheres const& spheres) const {
   // This algorithm takes the input segment, applies the hiding by the first
   // sphere (which can result in 0, 1, or 2 segments), applies the hiding by the
   // second sphere to the resulting segments, and so on.  To reduce memory
@@ -396,7 +586,7 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // are stored in a contiguous slice of the vector segments.  That slice
   // doesn't start at 0 iff at least one call to VisibleSegments returned 0
   // segments.
-  for (auto const& sphere : spheres) {
+  for (Sphere<FromFrame> const& sphere : spheres) {
     for (int i = in_end - 1; i >= in_begin; --i) {
       auto const& old_segment = segments[i];
       auto const new_segments_for_sphere = VisibleSegments(old_segment, sphere);
@@ -1,6 +1,9 @@
 #include "geometry/perspective.hpp"
 
+#include <cstdint>
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "geometry/frame.hpp"
 #include "geometry/orthogonal_map.hpp"
@@ -23,6 +26,7 @@ namespace geometry {
 using ::testing::Eq;
 using ::testing::ElementsAre;
 using ::testing::IsEmpty;
+using ::testing::Lt;
 using ::testing::Pair;
 using ::testing::SizeIs;
 using ::testing::_;
@@ -622,5 +626,53 @@ TEST_F(VisibleSegmentsTest, MultipleSpheres) {
               SizeIs(3));
 }
 
+TEST_F(VisibleSegmentsTest, SphereHierarchy) {
+  Sphere<World> const sphere2(
+    World::origin + Displacement<World>({0 * Metre, 0 * Metre, 5 * Metre}),
+      /*radius=*/1 * Metre);
+  // A sphere far away from the line of sight of the segment.
+  Sphere<World> const sphere3(
+    World::origin + Displacement<World>({0 * Metre, 20 * Metre, 0 * Metre}),
+      /*radius=*/1 * Metre);
+  auto const spheres =
+      perspective_.MakeSphereHierarchy({sphere_, sphere2, sphere3});
+  Position<World> const p1 =
+      World::origin + Displacement<World>({2 * Metre, 0 * Metre, -10 * Metre});
+  Position<World> const p2 =
+      World::origin + Displacement<World>({2 * Metre, 0 * Metre, 10 * Metre});
+  Segment<World> segment{p1, p2};
+  EXPECT_THAT(spheres.Candidates(segment), ElementsAre(0, 1));
+  EXPECT_THAT(perspective_.VisibleSegments(segment, spheres),
+              Eq(perspective_.VisibleSegments(segment,
+                                              {sphere_, sphere2, sphere3})));
+}
+
+TEST_F(VisibleSegmentsTest, SphereHierarchyRandom) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-10.0, 10.0);
+  auto random_position = [&distribution, &random]() {
+    return World::origin + Displacement<World>({distribution(random) * Metre,
+                                                distribution(random) * Metre,
+                                                distribution(random) * Metre});
+  };
+
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 100; ++i) {
+    spheres.emplace_back(random_position(),
+                         /*radius=*/0.5 * Metre);
+  }
+  auto const sphere_hierarchy = perspective_.MakeSphereHierarchy(spheres);
+
+  std::int64_t number_of_candidates = 0;
+  for (int i = 0; i < 1000; ++i) {
+    Segment<World> const segment{random_position(), random_position()};
+    number_of_candidates += sphere_hierarchy.Candidates(segment).size();
+    EXPECT_THAT(perspective_.VisibleSegments(segment, sphere_hierarchy),
+                Eq(perspective_.VisibleSegments(segment, spheres)));
+  }
+  // Most spheres are culled.
+  EXPECT_THAT(number_of_candidates, Lt(1000 * spheres.size() / 2));
+}
+
 }  // namespace geometry
 }  // namespace principia
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/not_null.hpp"
+#include "base/traits.hpp"
+#include "geometry/instant.hpp"
+#include "integrators/integrators.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace integrators {
+namespace _embedded_explicit_runge_kutta_nyström_ensemble_integrator {
+namespace internal {
+
+using namespace principia::base::_not_null;
+using namespace principia::base::_traits;
+using namespace principia::geometry::_instant;
+using namespace principia::integrators::_integrators;
+using namespace principia::integrators::_ordinary_differential_equations;
+using namespace principia::quantities::_quantities;
+
+// This class solves an ensemble of independent ordinary differential equations
+// of the form q″ = f(t, q) using an embedded Runge-Kutta-Nyström method.  Each
+// member of the ensemble has its own time, step size, tolerance and
+// parameters, and its steps are accepted or rejected independently of the
+// other members.  The members go through the stages of the method together,
+// and the right-hand sides of all the members that need an evaluation at a
+// given stage are computed by a single call to a batched function.  This makes
+// it possible to share the computations that don't depend on the member (e.g.,
+// the positions of the massive bodies of an ephemeris) and to vectorize the
+// evaluation.
+// For each member, the states passed to |append_state|, the final state, the
+// step size and the status are identical to those that the
+// |EmbeddedExplicitRungeKuttaNyströmIntegrator| would produce for that member
+// alone, provided that the batched function computes, for each member, the
+// same accelerations as the right-hand side of that member.
+// The notation follows that of |EmbeddedExplicitRungeKuttaNyströmIntegrator|.
+template<typename Method, typename ODE_>
+class EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator {
+ public:
+  using ODE = ODE_;
+  static_assert(is_instance_of_v<SpecialSecondOrderDifferentialEquation, ODE>);
+  using AppendState = typename Integrator<ODE>::AppendState;
+  using Parameters = typename AdaptiveStepSizeIntegrator<ODE>::Parameters;
+  using ToleranceToErrorRatio =
+      typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio;
+
+  // Computes the accelerations of the members whose indices are in |members|.
+  // For each index m in |members|, the accelerations of member m at time
+  // |times[m]| and positions |positions[m]| must be stored in
+  // |accelerations[m]|, which has the same size as |positions[m]|.  The
+  // entries of |times|, |positions| and |accelerations| for the members that
+  // are not in |members| must not be used.  |statuses| is OK on entry; the
+  // entry for a member whose computation fails must be set to an error, which
+  // is reported by |Solve| as it would be by the single-member integrator.
+  using BatchedAccelerationComputation = std::function<void(
+      std::vector<int> const& members,
+      std::vector<Instant> const& times,
+      std::vector<typename ODE::DependentVariables> const& positions,
+      std::vector<typename ODE::DependentVariableDerivatives2>& accelerations,
+      std::vector<absl::Status>& statuses)>;
+
+  // The definition of a member of the ensemble.  The arguments have the same
+  // meaning as those of |AdaptiveStepSizeIntegrator::NewInstance|.
+  struct Member final {
+    typename ODE::State initial_state;
+    AppendState append_state;
+    ToleranceToErrorRatio tolerance_to_error_ratio;
+    Parameters parameters;
+  };
+
+  static constexpr auto higher_order = Method::higher_order;
+  static constexpr auto lower_order = Method::lower_order;
+  static constexpr auto first_same_as_last = Method::first_same_as_last;
+
+  EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator();
+
+  EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator(
+      EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const&) = delete;
+  EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator(
+      EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator&&) = delete;
+  EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator& operator=(
+      EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const&) = delete;
+  EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator& operator=(
+      EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator&&) = delete;
+
+  class Instance final {
+   public:
+    // Integrates each member m up to |t_final[m]|, which must be in the
+    // direction of its first step.  Returns the status of each member, which
+    // is what |EmbeddedExplicitRungeKuttaNyströmIntegrator::Instance::Solve|
+    // would return for that member.  The integration of a member stops when
+    // it fails, without affecting the other members.
+    std::vector<absl::Status> Solve(std::vector<Instant> const& t_final);
+
+    // The number of members of the ensemble.
+    int size() const;
+
+    // The current state and step size of |member|.
+    typename ODE::State const& state(int member) const;
+    Time const& time_step(int member) const;
+
+    EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const& integrator()
+        const;
+
+   private:
+    // The state of a member of the ensemble.
+    struct MemberState final {
+      explicit MemberState(Member const& member);
+
+      typename ODE::State current_state;
+      AppendState const append_state;
+      ToleranceToErrorRatio const tolerance_to_error_ratio;
+      Parameters const parameters;
+      Time step;
+      bool first_use = true;
+
+      // The following members are only meaningful during a call to |Solve|.
+
+      // State before the last, truncated step.  Only meaningful if
+      // |has_final_state| is true.
+      typename ODE::State final_state;
+      bool has_final_state;
+      bool at_end;
+      // Whether the step size must be adapted before the next attempt.
+      bool adapt_step;
+      double tolerance_to_error_ratio_value;
+      // The first stage of the Runge-Kutta-Nyström iteration, see the
+      // single-member integrator.
+      int first_stage;
+      std::int64_t step_count;
+      absl::Status status;
+      absl::Status step_status;
+
+      // Scratch storage, kept across calls so that repeated short
+      // integrations don't allocate.
+      std::vector<typename ODE::DependentVariableDifference> Δq̂;
+      std::vector<typename ODE::DependentVariableDerivative> Δv̂;
+      typename ODE::State::Error error_estimate;
+    };
+
+    Instance(std::vector<Member> const& members,
+             BatchedAccelerationComputation compute_accelerations,
+             EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const&
+                 integrator);
+
+    BatchedAccelerationComputation const compute_accelerations_;
+    EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const& integrator_;
+    std::vector<MemberState> members_;
+
+    // Scratch storage for |Solve|.  |running_members_| and |evaluated_members_|
+    // are lists of member indices, the other vectors are indexed by member
+    // (and by stage for |g_|).
+    std::vector<int> running_members_;
+    std::vector<int> evaluated_members_;
+    std::vector<Instant> t_stage_;
+    std::vector<typename ODE::DependentVariables> q_stage_;
+    std::vector<std::vector<typename ODE::DependentVariableDerivatives2>> g_;
+    std::vector<absl::Status> statuses_;
+
+    friend class EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator;
+  };
+
+  not_null<std::unique_ptr<Instance>> NewInstance(
+      std::vector<Member> const& members,
+      BatchedAccelerationComputation const& compute_accelerations) const;
+
+ private:
+  static constexpr auto stages_ = Method::stages;
+  static constexpr auto c_ = Method::c;
+  static constexpr auto a_ = Method::a;
+  static constexpr auto b̂_ = Method::b̂;
+  static constexpr auto b̂ʹ_ = Method::b̂ʹ;
+  static constexpr auto b_ = Method::b;
+  static constexpr auto bʹ_ = Method::bʹ;
+};
+
+}  // namespace internal
+
+template<typename Method, typename ODE_>
+internal::EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method,
+                                                              ODE_> const&
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator();
+
+}  // namespace _embedded_explicit_runge_kutta_nyström_ensemble_integrator
+}  // namespace integrators
+}  // namespace principia
+
+#include "integrators/embedded_explicit_runge_kutta_nyström_ensemble_integrator_body.hpp"  // NOLINT
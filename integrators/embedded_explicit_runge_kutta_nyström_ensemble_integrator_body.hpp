@@ -0,0 +1,394 @@
+#pragma once
+
+#include "integrators/embedded_explicit_runge_kutta_nyström_ensemble_integrator.hpp"  // NOLINT
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/jthread.hpp"
+#include "geometry/sign.hpp"
+#include "glog/logging.h"
+#include "integrators/methods.hpp"
+#include "numerics/double_precision.hpp"
+
+namespace principia {
+namespace integrators {
+namespace _embedded_explicit_runge_kutta_nyström_ensemble_integrator {
+namespace internal {
+
+using namespace principia::base::_jthread;
+using namespace principia::geometry::_sign;
+using namespace principia::numerics::_double_precision;
+
+template<typename Method, typename ODE_>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator() {
+  // The first node is always 0 in an explicit method.
+  CHECK_EQ(0.0, c_[0]);
+  if (first_same_as_last) {
+    // Check that the conditions for the FSAL property are satisfied, see for
+    // instance [DEP87a], equation 3.1.
+    CHECK_EQ(1.0, c_[stages_ - 1]);
+    CHECK_EQ(0.0, b̂_[stages_ - 1]);
+    for (int j = 0; j < stages_ - 1; ++j) {
+      CHECK_EQ(b̂_[j], a_(stages_ - 1, j));
+    }
+  }
+}
+
+template<typename Method, typename ODE_>
+std::vector<absl::Status>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::Solve(std::vector<Instant> const& t_final) {
+  using Position = typename ODE::DependentVariable;
+  using Displacement = typename ODE::DependentVariableDifference;
+  using Velocity = typename ODE::DependentVariableDerivative;
+  using Acceleration = typename ODE::DependentVariableDerivative2;
+
+  auto const& a = integrator_.a_;
+  auto const& b̂ = integrator_.b̂_;
+  auto const& b̂ʹ = integrator_.b̂ʹ_;
+  auto const& b = integrator_.b_;
+  auto const& bʹ = integrator_.bʹ_;
+  auto const& c = integrator_.c_;
+
+  int const size = members_.size();
+  CHECK_EQ(size, t_final.size());
+
+  // The structure of this function mirrors that of
+  // |EmbeddedExplicitRungeKuttaNyströmIntegrator::Instance::Solve|, with the
+  // loop over the attempted steps turned inside out: each iteration of the
+  // main loop below makes one attempt for each running member.  The members
+  // are removed from |running| when their integration terminates, at which
+  // point their status is stored in |statuses|.
+  std::vector<absl::Status> statuses(size);
+  std::vector<int>& running = running_members_;
+  running.clear();
+
+  t_stage_.resize(size);
+  q_stage_.resize(size);
+  statuses_.resize(size);
+  g_.resize(stages_);
+  for (auto& g_stage : g_) {
+    g_stage.resize(size);
+  }
+
+  // Argument checks and initialization of the members.
+  for (int m = 0; m < size; ++m) {
+    MemberState& member = members_[m];
+    auto const& parameters = member.parameters;
+    auto const& current_state = member.current_state;
+    int const dimension = current_state.positions.size();
+    Sign const integration_direction = Sign(parameters.first_step);
+    if (integration_direction.is_positive()) {
+      // Integrating forward.
+      CHECK_LT(current_state.time.value, t_final[m]);
+    } else {
+      // Integrating backward.
+      CHECK_GT(current_state.time.value, t_final[m]);
+    }
+    CHECK(member.first_use || !parameters.last_step_is_exact)
+        << "Cannot reuse an instance where the last step is exact";
+    member.first_use = false;
+
+    member.has_final_state = false;
+    member.at_end = false;
+    // No step size control on the first step.  If this instance is being
+    // restarted we already have a value of |h| suitable for the next step,
+    // based on the computation of |tolerance_to_error_ratio_value| during the
+    // last invocation.
+    member.adapt_step = false;
+    member.first_stage = 0;
+    member.step_count = 0;
+    member.status = absl::OkStatus();
+    member.step_status = absl::OkStatus();
+
+    member.Δq̂.resize(dimension);
+    member.Δv̂.resize(dimension);
+    member.error_estimate.position_error.resize(dimension);
+    member.error_estimate.velocity_error.resize(dimension);
+    q_stage_[m].resize(dimension);
+    for (auto& g_stage : g_) {
+      g_stage[m].resize(dimension);
+    }
+
+    running.push_back(m);
+  }
+
+  while (!running.empty()) {
+    // Step size adaptation and termination condition.
+    {
+      int r = 0;
+      for (int const m : running) {
+        MemberState& member = members_[m];
+        auto const& parameters = member.parameters;
+        Time& h = member.step;
+        DoublePrecision<Instant> const& t = member.current_state.time;
+        Sign const integration_direction = Sign(parameters.first_step);
+
+        if (member.adapt_step) {
+          // Reset the status as any error returned by a force computation for
+          // a rejected step is now moot.
+          member.step_status = absl::OkStatus();
+
+          // Adapt step size.
+          h *= parameters.safety_factor *
+               std::pow(member.tolerance_to_error_ratio_value,
+                        1.0 / (lower_order + 1));
+          if (t.value + (t.error + h) == t.value) {
+            statuses[m] = absl::Status(
+                termination_condition::VanishingStepSize,
+                "At time " + DebugString(t.value) +
+                    ", step size is effectively zero.  "
+                    "Singularity or stiff system suspected.");
+            continue;
+          }
+        }
+        member.adapt_step = true;
+
+        // Termination condition.
+        if (parameters.last_step_is_exact) {
+          Time const time_to_end = (t_final[m] - t.value) - t.error;
+          member.at_end = integration_direction * h >=
+                          integration_direction * time_to_end;
+          if (member.at_end) {
+            // The chosen step size will overshoot.  Clip it to just reach the
+            // end, and terminate if the step is accepted.
+            h = time_to_end;
+            member.final_state = member.current_state;
+            member.has_final_state = true;
+          }
+        }
+        running[r++] = m;
+      }
+      running.resize(r);
+    }
+
+    // Runge-Kutta-Nyström iteration; fills |g_|.  All the members that need an
+    // evaluation at stage i are evaluated by a single call.
+    for (int i = 0; i < stages_; ++i) {
+      evaluated_members_.clear();
+      for (int const m : running) {
+        MemberState const& member = members_[m];
+        if (i < member.first_stage) {
+          continue;
+        }
+        auto const& parameters = member.parameters;
+        Time const& h = member.step;
+        auto const h² = h * h;
+        DoublePrecision<Instant> const& t = member.current_state.time;
+        auto const& q̂ = member.current_state.positions;
+        auto const& v̂ = member.current_state.velocities;
+        std::vector<Position>& q_stage = q_stage_[m];
+        int const dimension = q_stage.size();
+
+        t_stage_[m] =
+            (parameters.last_step_is_exact && member.at_end && c[i] == 1.0)
+                ? t_final[m]
+                : t.value + (t.error + c[i] * h);
+        for (int k = 0; k < dimension; ++k) {
+          Acceleration Σⱼ_aᵢⱼ_gⱼₖ{};
+          for (int j = 0; j < i; ++j) {
+            Σⱼ_aᵢⱼ_gⱼₖ += a(i, j) * g_[j][m][k];
+          }
+          q_stage[k] = q̂[k].value + h * c[i] * v̂[k].value + h² * Σⱼ_aᵢⱼ_gⱼₖ;
+        }
+        statuses_[m] = absl::OkStatus();
+        evaluated_members_.push_back(m);
+      }
+      if (!evaluated_members_.empty()) {
+        compute_accelerations_(
+            evaluated_members_, t_stage_, q_stage_, g_[i], statuses_);
+        for (int const m : evaluated_members_) {
+          members_[m].step_status.Update(statuses_[m]);
+        }
+      }
+    }
+
+    // Increment computation, step size control, and update of the members
+    // whose step is accepted.
+    {
+      int r = 0;
+      for (int const m : running) {
+        MemberState& member = members_[m];
+        auto const& parameters = member.parameters;
+        Time const& h = member.step;
+        auto const h² = h * h;
+        auto& current_state = member.current_state;
+        DoublePrecision<Instant>& t = current_state.time;
+        std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
+        std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
+        std::vector<Displacement>& Δq̂ = member.Δq̂;
+        std::vector<Velocity>& Δv̂ = member.Δv̂;
+        auto& error_estimate = member.error_estimate;
+        int const dimension = q̂.size();
+
+        for (int k = 0; k < dimension; ++k) {
+          Acceleration Σᵢ_b̂ᵢ_gᵢₖ{};
+          Acceleration Σᵢ_bᵢ_gᵢₖ{};
+          Acceleration Σᵢ_b̂ʹᵢ_gᵢₖ{};
+          Acceleration Σᵢ_bʹᵢ_gᵢₖ{};
+          // Please keep the eight assigments below aligned, they become
+          // illegible otherwise.
+          for (int i = 0; i < stages_; ++i) {
+            Σᵢ_b̂ᵢ_gᵢₖ  += b̂[i] * g_[i][m][k];
+            Σᵢ_bᵢ_gᵢₖ  += b[i] * g_[i][m][k];
+            Σᵢ_b̂ʹᵢ_gᵢₖ += b̂ʹ[i] * g_[i][m][k];
+            Σᵢ_bʹᵢ_gᵢₖ += bʹ[i] * g_[i][m][k];
+          }
+          // The hat-less Δq and Δv are the low-order increments.
+          Δq̂[k]                  = h * v̂[k].value + h² * Σᵢ_b̂ᵢ_gᵢₖ;
+          Displacement const Δqₖ = h * v̂[k].value + h² * Σᵢ_bᵢ_gᵢₖ;
+          Δv̂[k]                  = h * Σᵢ_b̂ʹᵢ_gᵢₖ;
+          Velocity const Δvₖ     = h * Σᵢ_bʹᵢ_gᵢₖ;
+
+          error_estimate.position_error[k] = Δqₖ - Δq̂[k];
+          error_estimate.velocity_error[k] = Δvₖ - Δv̂[k];
+        }
+        member.tolerance_to_error_ratio_value =
+            member.tolerance_to_error_ratio(h, current_state, error_estimate);
+        if (member.tolerance_to_error_ratio_value < 1.0) {
+          // Rejected, try again with a smaller step.
+          running[r++] = m;
+          continue;
+        }
+
+        member.status.Update(member.step_status);
+
+        if (!parameters.last_step_is_exact &&
+            t.value + (t.error + h) > t_final[m]) {
+          // We did overshoot.  Drop the point that we just computed and exit.
+          // The resolution is restartable from the last non-truncated state.
+          statuses[m] = member.status;
+          continue;
+        }
+
+        if (first_same_as_last) {
+          using std::swap;
+          swap(g_.front()[m], g_.back()[m]);
+          member.first_stage = 1;
+        }
+
+        // Increment the solution with the high-order approximation.
+        t.Increment(h);
+        for (int k = 0; k < dimension; ++k) {
+          q̂[k].Increment(Δq̂[k]);
+          v̂[k].Increment(Δv̂[k]);
+        }
+        member.append_state(current_state);
+        // After the state has been updated.
+        if (this_stoppable_thread::get_stop_token().stop_requested()) {
+          statuses[m] = absl::CancelledError("Cancelled by stop token");
+          continue;
+        }
+        ++member.step_count;
+        if (member.step_count == parameters.max_steps && !member.at_end) {
+          statuses[m] = absl::Status(
+              termination_condition::ReachedMaximalStepCount,
+              "Reached maximum step count " +
+                  std::to_string(parameters.max_steps) + " at time " +
+                  DebugString(t.value) + "; requested t_final is " +
+                  DebugString(t_final[m]) + ".");
+          continue;
+        }
+        if (member.at_end) {
+          // The resolution is restartable from the last non-truncated state.
+          CHECK(member.has_final_state);
+          current_state = member.final_state;
+          statuses[m] = member.status;
+          continue;
+        }
+        running[r++] = m;
+      }
+      running.resize(r);
+    }
+  }
+  return statuses;
+}
+
+template<typename Method, typename ODE_>
+int EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::size() const {
+  return members_.size();
+}
+
+template<typename Method, typename ODE_>
+typename ODE_::State const&
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::state(int const member) const {
+  return members_[member].current_state;
+}
+
+template<typename Method, typename ODE_>
+Time const& EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::time_step(int const member) const {
+  return members_[member].step;
+}
+
+template<typename Method, typename ODE_>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_> const&
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::integrator() const {
+  return integrator_;
+}
+
+template<typename Method, typename ODE_>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::MemberState::MemberState(Member const& member)
+    : current_state(member.initial_state),
+      append_state(member.append_state),
+      tolerance_to_error_ratio(member.tolerance_to_error_ratio),
+      parameters(member.parameters),
+      step(member.parameters.first_step) {}
+
+template<typename Method, typename ODE_>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+Instance::Instance(
+    std::vector<Member> const& members,
+    BatchedAccelerationComputation compute_accelerations,
+    EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator const& integrator)
+    : compute_accelerations_(std::move(compute_accelerations)),
+      integrator_(integrator) {
+  members_.reserve(members.size());
+  for (auto const& member : members) {
+    members_.emplace_back(member);
+  }
+}
+
+template<typename Method, typename ODE_>
+not_null<std::unique_ptr<
+    typename EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method,
+                                                                 ODE_>::
+        Instance>>
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE_>::
+NewInstance(std::vector<Member> const& members,
+            BatchedAccelerationComputation const& compute_accelerations)
+    const {
+  // Cannot use |make_not_null_unique| because the constructor of |Instance| is
+  // private.
+  return std::unique_ptr<Instance>(
+      new Instance(members, compute_accelerations, *this));
+}
+
+}  // namespace internal
+
+template<typename Method, typename ODE_>
+internal::EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method,
+                                                              ODE_> const&
+EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator() {
+  static_assert(
+      std::is_base_of<_methods::EmbeddedExplicitRungeKuttaNyström,
+                      Method>::value,
+      "Method must be derived from EmbeddedExplicitRungeKuttaNyström");
+  static internal::EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<
+      Method, ODE_> const integrator;
+  return integrator;
+}
+
+}  // namespace _embedded_explicit_runge_kutta_nyström_ensemble_integrator
+}  // namespace integrators
+}  // namespace principia
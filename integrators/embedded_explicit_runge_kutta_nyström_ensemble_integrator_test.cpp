@@ -0,0 +1,324 @@
+#include "integrators/embedded_explicit_runge_kutta_nyström_ensemble_integrator.hpp"  // NOLINT
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "base/status_utilities.hpp"  // 🧙 For RETURN_IF_ERROR.
+#include "geometry/instant.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/integrators.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/ordinary_differential_equations.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/matchers.hpp"
+
+namespace principia {
+namespace integrators {
+
+using ::testing::ElementsAreArray;
+using ::testing::Lt;
+using namespace principia::geometry::_instant;
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_ensemble_integrator;  // NOLINT
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_integrator;  // NOLINT
+using namespace principia::integrators::_integrators;
+using namespace principia::integrators::_methods;
+using namespace principia::integrators::_ordinary_differential_equations;
+using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+using namespace principia::testing_utilities::_matchers;
+
+using ODE = SpecialSecondOrderDifferentialEquation<Length>;
+using Method = methods::DormandالمكاوىPrince1986RKN434FM;
+using EnsembleIntegrator = std::remove_cvref_t<
+    decltype(EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE>())>;
+
+class EmbeddedExplicitRungeKuttaNyströmEnsembleIntegratorTest
+    : public ::testing::Test {
+ protected:
+  // The description of a member of the ensemble.
+  struct MemberProblem {
+    ODE equation;
+    ODE::State initial_state;
+    Length length_tolerance;
+    Speed speed_tolerance;
+    AdaptiveStepSizeIntegrator<ODE>::Parameters parameters;
+    Instant t_final;
+  };
+
+  // The outcome of the integration of a member.
+  struct MemberSolution {
+    std::vector<ODE::State> appended_states;
+    absl::Status status;
+    ODE::State final_state;
+  };
+
+  static ODE HarmonicOscillator(AngularFrequency const& ω) {
+    ODE harmonic_oscillator;
+    harmonic_oscillator.compute_acceleration =
+        [ω](Instant const& t,
+            std::vector<Length> const& q,
+            std::vector<Acceleration>& result) {
+          for (int i = 0; i < q.size(); ++i) {
+            result[i] = -q[i] * ω * ω / (Radian * Radian);
+          }
+          return absl::OkStatus();
+        };
+    return harmonic_oscillator;
+  }
+
+  static AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio
+  ToleranceToErrorRatio(Length const& length_tolerance,
+                        Speed const& speed_tolerance) {
+    return [length_tolerance, speed_tolerance](
+               Time const& h,
+               ODE::State const& /*state*/,
+               ODE::State::Error const& error) {
+      double r = std::numeric_limits<double>::infinity();
+      for (int i = 0; i < error.position_error.size(); ++i) {
+        r = std::min({r,
+                      length_tolerance / Abs(error.position_error[i]),
+                      speed_tolerance / Abs(error.velocity_error[i])});
+      }
+      return r;
+    };
+  }
+
+  // Integrates each problem separately with the single-member integrator,
+  // calling |Solve| once for each element of |t_finals|.
+  static std::vector<MemberSolution> SolveSeparately(
+      std::vector<MemberProblem> const& problems,
+      std::vector<std::vector<Instant>> const& t_finals) {
+    std::vector<MemberSolution> solutions(problems.size());
+    for (int m = 0; m < problems.size(); ++m) {
+      auto const& problem = problems[m];
+      auto& solution = solutions[m];
+      auto const instance =
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, ODE>()
+              .NewInstance({problem.equation, problem.initial_state},
+                           [&solution](ODE::State const& state) {
+                             solution.appended_states.push_back(state);
+                           },
+                           ToleranceToErrorRatio(problem.length_tolerance,
+                                                 problem.speed_tolerance),
+                           problem.parameters);
+      for (auto const& t_final : t_finals) {
+        solution.status = instance->Solve(t_final[m]);
+      }
+      solution.final_state = instance->state();
+    }
+    return solutions;
+  }
+
+  // Integrates the problems as an ensemble, calling |Solve| once for each
+  // element of |t_finals|.  Sets |batched_calls| to the number of calls to the
+  // batched acceleration computation and |evaluations| to the total number of
+  // member evaluations.
+  static std::vector<MemberSolution> SolveTogether(
+      std::vector<MemberProblem> const& problems,
+      std::vector<std::vector<Instant>> const& t_finals,
+      int& batched_calls,
+      int& evaluations) {
+    std::vector<MemberSolution> solutions(problems.size());
+    std::vector<EnsembleIntegrator::Member> members;
+    for (int m = 0; m < problems.size(); ++m) {
+      auto const& problem = problems[m];
+      auto& solution = solutions[m];
+      members.push_back(
+          {.initial_state = problem.initial_state,
+           .append_state =
+               [&solution](ODE::State const& state) {
+                 solution.appended_states.push_back(state);
+               },
+           .tolerance_to_error_ratio = ToleranceToErrorRatio(
+               problem.length_tolerance, problem.speed_tolerance),
+           .parameters = problem.parameters});
+    }
+    batched_calls = 0;
+    evaluations = 0;
+    auto const compute_accelerations =
+        [&problems, &batched_calls, &evaluations](
+            std::vector<int> const& members,
+            std::vector<Instant> const& times,
+            std::vector<std::vector<Length>> const& positions,
+            std::vector<std::vector<Acceleration>>& accelerations,
+            std::vector<absl::Status>& statuses) {
+          ++batched_calls;
+          for (int const m : members) {
+            ++evaluations;
+            statuses[m] = problems[m].equation.compute_acceleration(
+                times[m], positions[m], accelerations[m]);
+          }
+        };
+    auto const instance =
+        EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<Method, ODE>()
+            .NewInstance(members, compute_accelerations);
+    EXPECT_EQ(problems.size(), instance->size());
+    for (auto const& t_final : t_finals) {
+      auto const statuses = instance->Solve(t_final);
+      for (int m = 0; m < problems.size(); ++m) {
+        solutions[m].status = statuses[m];
+      }
+    }
+    for (int m = 0; m < problems.size(); ++m) {
+      solutions[m].final_state = instance->state(m);
+    }
+    return solutions;
+  }
+
+  static void ExpectSameSolutions(
+      std::vector<MemberSolution> const& expected,
+      std::vector<MemberSolution> const& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int m = 0; m < expected.size(); ++m) {
+      EXPECT_THAT(actual[m].appended_states,
+                  ElementsAreArray(expected[m].appended_states)) << m;
+      EXPECT_EQ(expected[m].status, actual[m].status) << m;
+      EXPECT_EQ(expected[m].final_state, actual[m].final_state) << m;
+    }
+  }
+
+  Instant const t0_;
+};
+
+TEST_F(EmbeddedExplicitRungeKuttaNyströmEnsembleIntegratorTest,
+       MatchesSingleMemberIntegrator) {
+  Time const period = 2 * π * Second;
+  // A rocket as in the Singularity test of the single-member integrator, with
+  // a singularity at t0_ + 1 s.
+  ODE rocket_equation;
+  rocket_equation.compute_acceleration =
+      [t0 = t0_](Instant const& t,
+                 std::vector<Length> const& position,
+                 std::vector<Acceleration>& acceleration) {
+        acceleration.back() =
+            1 * Metre / Second / (1 * Second - (t - t0));
+        return absl::OkStatus();
+      };
+  // A harmonic oscillator whose right-hand side reports an error after some
+  // time.
+  ODE failing_oscillator = HarmonicOscillator(1 * Radian / Second);
+  failing_oscillator.compute_acceleration =
+      [t0 = t0_, compute = failing_oscillator.compute_acceleration](
+          Instant const& t,
+          std::vector<Length> const& q,
+          std::vector<Acceleration>& result) {
+        RETURN_IF_ERROR(compute(t, q, result));
+        if (t > t0 + 3 * Second) {
+          return absl::OutOfRangeError("Collision");
+        }
+        return absl::OkStatus();
+      };
+
+  std::vector<MemberProblem> const problems{
+      // Last step exact.
+      {HarmonicOscillator(1 * Radian / Second),
+       {t0_, {1 * Metre}, {0 * Metre / Second}},
+       1 * Milli(Metre),
+       1 * Milli(Metre) / Second,
+       {/*first_step=*/10 * period, /*safety_factor=*/0.9},
+       t0_ + 10 * period},
+      // Last step not exact, different frequency and tolerance.
+      {HarmonicOscillator(3 * Radian / Second),
+       {t0_, {0 * Metre}, {2 * Metre / Second}},
+       1 * Micro(Metre),
+       1 * Micro(Metre) / Second,
+       {/*first_step=*/5 * Second,
+        /*safety_factor=*/0.9,
+        /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+        /*last_step_is_exact=*/false},
+       t0_ + 5 * Second},
+      // Backward, two dimensions.
+      {HarmonicOscillator(0.5 * Radian / Second),
+       {t0_, {1 * Metre, -2 * Metre}, {1 * Metre / Second, 0 * Metre / Second}},
+       1 * Milli(Metre),
+       1 * Milli(Metre) / Second,
+       {/*first_step=*/-20 * Second, /*safety_factor=*/0.8},
+       t0_ - 20 * Second},
+      // Maximal step count.
+      {HarmonicOscillator(1 * Radian / Second),
+       {t0_, {1 * Metre}, {0 * Metre / Second}},
+       1 * Milli(Metre),
+       1 * Milli(Metre) / Second,
+       {/*first_step=*/10 * period,
+        /*safety_factor=*/0.9,
+        /*max_steps=*/20,
+        /*last_step_is_exact=*/true},
+       t0_ + 10 * period},
+      // Singularity.
+      {rocket_equation,
+       {t0_, {0 * Metre}, {0 * Metre / Second}},
+       1 * Milli(Metre),
+       1 * Milli(Metre) / Second,
+       {/*first_step=*/2 * Second, /*safety_factor=*/0.9},
+       t0_ + 2 * Second},
+      // Error in the right-hand side.
+      {failing_oscillator,
+       {t0_, {1 * Metre}, {0 * Metre / Second}},
+       1 * Milli(Metre),
+       1 * Milli(Metre) / Second,
+       {/*first_step=*/period, /*safety_factor=*/0.9},
+       t0_ + period}};
+  std::vector<std::vector<Instant>> t_finals(1);
+  for (auto const& problem : problems) {
+    t_finals[0].push_back(problem.t_final);
+  }
+
+  auto const expected = SolveSeparately(problems, t_finals);
+  int batched_calls;
+  int evaluations;
+  auto const actual =
+      SolveTogether(problems, t_finals, batched_calls, evaluations);
+  ExpectSameSolutions(expected, actual);
+
+  EXPECT_OK(actual[0].status);
+  EXPECT_OK(actual[1].status);
+  EXPECT_OK(actual[2].status);
+  EXPECT_THAT(actual[3].status,
+              StatusIs(termination_condition::ReachedMaximalStepCount));
+  EXPECT_THAT(actual[4].status,
+              StatusIs(termination_condition::VanishingStepSize));
+  EXPECT_THAT(actual[5].status, StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_EQ(t0_ - 20 * Second, actual[2].appended_states.back().time.value);
+
+  // The evaluations of the members are batched.
+  EXPECT_THAT(batched_calls, Lt(evaluations / 2));
+}
+
+TEST_F(EmbeddedExplicitRungeKuttaNyströmEnsembleIntegratorTest, Restart) {
+  std::vector<MemberProblem> problems;
+  std::vector<std::vector<Instant>> t_finals(2);
+  for (int m = 0; m < 10; ++m) {
+    problems.push_back(
+        {HarmonicOscillator((1 + 0.1 * m) * Radian / Second),
+         {t0_, {1 * Metre}, {m * Metre / Second}},
+         (m + 1) * Milli(Metre),
+         (m + 1) * Milli(Metre) / Second,
+         {/*first_step=*/10 * Second,
+          /*safety_factor=*/0.9,
+          /*max_steps=*/std::numeric_limits<std::int64_t>::max(),
+          /*last_step_is_exact=*/false},
+         t0_ + (10 + m) * Second});
+    t_finals[0].push_back(t0_ + (10 + m) * Second);
+    t_finals[1].push_back(t0_ + (30 - m) * Second);
+  }
+
+  int batched_calls;
+  int evaluations;
+  ExpectSameSolutions(SolveSeparately(problems, t_finals),
+                      SolveTogether(problems, t_finals,
+                                    batched_calls, evaluations));
+}
+
+}  // namespace integrators
+}  // namespace principia
@@ -10,6 +10,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "base/concepts.hpp"
@@ -121,6 +122,17 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
              EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator);
 
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator_;
+
+    // Scratch storage for |Solve|, kept across calls so that repeated short
+    // integrations don't allocate.  Not part of the state of the integration:
+    // it is not serialized and its contents are meaningless between calls.
+    std::vector<typename ODE::DependentVariableDifference> Δq̂_;
+    std::vector<typename ODE::DependentVariableDerivative> Δv̂_;
+    typename ODE::State::Error error_estimate_;
+    std::vector<typename ODE::DependentVariable> q_stage_;
+    std::vector<std::vector<typename ODE::DependentVariableDerivative2>> g_;
+    typename ODE::State final_state_;
+
     friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
   };
 
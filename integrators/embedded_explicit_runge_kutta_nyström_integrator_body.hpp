@@ -6,7 +6,6 @@
 #include <cmath>
 #include <ctime>
 #include <memory>
-#include <optional>
 #include <utility>
 #include <vector>
 
@@ -62,8 +61,10 @@ Instance::Solve(Instant const& t_final) {
   // |current_state| gets updated as the integration progresses to allow
   // restartability.
 
-  // State before the last, truncated step.
-  std::optional<typename ODE::State> final_state;
+  // State before the last, truncated step.  Only meaningful if
+  // |has_final_state| is true.
+  typename ODE::State& final_state = final_state_;
+  bool has_final_state = false;
 
   // Argument checks.
   int const dimension = current_state.positions.size();
@@ -86,9 +87,11 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
+  Δq̂.resize(dimension);
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
+  Δv̂.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -97,15 +100,17 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::State::Error error_estimate;
+  typename ODE::State::Error& error_estimate = error_estimate_;
   error_estimate.position_error.resize(dimension);
   error_estimate.velocity_error.resize(dimension);
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
   // Accelerations at each stage.
   // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
+  std::vector<std::vector<Acceleration>>& g = g_;
+  g.resize(stages_);
   for (auto& g_stage : g) {
     g_stage.resize(dimension);
   }
@@ -167,6 +172,7 @@ Instance::Solve(Instant const& t_final) {
           // last stage below.
           h = time_to_end;
           final_state = current_state;
+          has_final_state = true;
         }
       }
 
@@ -221,6 +227,7 @@ Instance::Solve(Instant const& t_final) {
     if (!parameters.last_step_is_exact && t.value + (t.error + h) > t_final) {
       // We did overshoot.  Drop the point that we just computed and exit.
       final_state = current_state;
+      has_final_state = true;
       break;
     }
 
@@ -249,8 +256,8 @@ Instance::Solve(Instant const& t_final) {
     }
   }
   // The resolution is restartable from the last non-truncated state.
-  CHECK(final_state);
-  current_state = *final_state;
+  CHECK(has_final_state);
+  current_state = final_state;
   return status;
 }
 
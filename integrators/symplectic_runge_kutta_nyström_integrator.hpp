@@ -9,6 +9,7 @@
 #define PRINCIPIA_INTEGRATORS_SYMPLECTIC_RUNGE_KUTTA_NYSTRÖM_INTEGRATOR_HPP_
 
 #include <memory>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "base/not_null.hpp"
@@ -107,6 +108,15 @@ class SymplecticRungeKuttaNyströmIntegrator
              SymplecticRungeKuttaNyströmIntegrator const& integrator);
 
     SymplecticRungeKuttaNyströmIntegrator const& integrator_;
+
+    // Scratch storage for |Solve|, kept across calls so that repeated short
+    // integrations don't allocate.  Not part of the state of the integration:
+    // it is not serialized and its contents are meaningless between calls.
+    std::vector<typename ODE::DependentVariableDifference> Δq_;
+    std::vector<typename ODE::DependentVariableDerivative> Δv_;
+    std::vector<typename ODE::DependentVariable> q_stage_;
+    std::vector<typename ODE::DependentVariableDerivative2> g_;
+
     friend class SymplecticRungeKuttaNyströmIntegrator;
   };
 
@@ -61,9 +61,11 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment.
-  std::vector<Displacement> Δq(dimension);
+  std::vector<Displacement>& Δq = Δq_;
+  Δq.resize(dimension);
   // Velocity increment.
-  std::vector<Velocity> Δv(dimension);
+  std::vector<Velocity>& Δv = Δv_;
+  Δv.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q = current_state.positions;
@@ -72,9 +74,11 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
   // Accelerations at the current stage.
-  std::vector<Acceleration> g(dimension);
+  std::vector<Acceleration>& g = g_;
+  g.resize(dimension);
 
   // The first full stage of the step, i.e. the first stage where
   // exp(bᵢ h B) exp(aᵢ h A) must be entirely computed.
@@ -98,32 +102,44 @@ Instance::Solve(Instant const& t_final) {
     std::fill(Δq.begin(), Δq.end(), Displacement{});
     std::fill(Δv.begin(), Δv.end(), Velocity{});
 
+    // Each stage q + Δq is computed in the same pass as the increments that
+    // precede it, so that the state is traversed only once per evaluation.
     if (first_stage == 1) {
+      Time const hb₀ = h * b[0];
+      Time const ha₀ = h * a[0];
       for (int k = 0; k < dimension; ++k) {
         if (composition == BAB) {
           // exp(b₀ h B)
-          Δv[k] += h * b[0] * g[k];
+          Δv[k] += hb₀ * g[k];
         }
         // exp(a₀ h A)
-        Δq[k] += h * a[0] * (v[k].value + Δv[k]);
+        Δq[k] += ha₀ * (v[k].value + Δv[k]);
+        q_stage[k] = q[k].value + Δq[k];
       }
-    }
-
-    for (int i = first_stage; i < stages_; ++i) {
+    } else {
       for (int k = 0; k < dimension; ++k) {
         q_stage[k] = q[k].value + Δq[k];
       }
+    }
+
+    for (int i = first_stage; i < stages_; ++i) {
       status.Update(
           equation.compute_acceleration(
               t.value + (t.error + c[i] * h), q_stage, g));
+      Time const hbᵢ = h * b[i];
+      Time const haᵢ = h * a[i];
+      bool const is_last_stage = i == stages_ - 1;
       for (int k = 0; k < dimension; ++k) {
         // exp(bᵢ h B)
-        Δv[k] += h * b[i] * g[k];
+        Δv[k] += hbᵢ * g[k];
         // NOTE(egg): in the BAB case, at the last stage, this will be an
         // exercise in adding 0.  I don't think the optimizer can know that.  Do
         // we care?
         // exp(aᵢ h A)
-        Δq[k] += h * a[i] * (v[k].value + Δv[k]);
+        Δq[k] += haᵢ * (v[k].value + Δv[k]);
+        if (!is_last_stage) {
+          q_stage[k] = q[k].value + Δq[k];
+        }
       }
     }
 
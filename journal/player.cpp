@@ -1,17 +1,26 @@
 #include "journal/player.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/match.h"
 #include "base/array.hpp"
 #include "base/get_line.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/version.hpp"
+#include "gipfeli/gipfeli.h"
 #include "glog/logging.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "journal/profiles.hpp"  // 🧙 For generated profiles.
+#include "journal/recorder.hpp"
 
 #define PRINCIPIA_PLAYER_ALLOW_VERSION_MISMATCH 0
 
@@ -20,18 +29,54 @@ namespace journal {
 namespace _player {
 namespace internal {
 
+using ::google::protobuf::Descriptor;
+using ::google::protobuf::FieldDescriptor;
+using ::google::protobuf::FieldOptions;
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::io::CodedOutputStream;
 using interface::principia__ActivatePlayer;
 using namespace principia::base::_array;
 using namespace principia::base::_get_line;
 using namespace principia::base::_hexadecimal;
 using namespace principia::base::_version;
+using namespace principia::journal::_recorder;
 
 using namespace std::chrono_literals;
 
+// The index file starts with |index_magic|, followed by the size of the
+// journal, the number of method types, the method types (each one a size
+// followed by the characters), the number of entries and the entries (each one
+// an offset, a position in block and a method type).  All the integers are
+// little-endian 64-bit integers.
+constexpr std::string_view index_magic = "PrincipiaJournalIndex1";
+
 Player::Player(std::filesystem::path const& path)
-    : stream_(path, std::ios::in) {
+    : path_(path),
+      stream_(path, std::ios::in | std::ios::binary) {
   principia__ActivatePlayer();
   CHECK(!stream_.fail());
+
+  // Binary journals start with a magic string and the compression byte.
+  // Anything else is a hexadecimal journal, which is read in text mode.
+  std::string magic(Recorder::binary_magic.size() + 1, '\0');
+  stream_.read(magic.data(), magic.size());
+  if (stream_.gcount() == static_cast<std::streamsize>(magic.size()) &&
+      magic.starts_with(Recorder::binary_magic)) {
+    binary_ = true;
+    switch (magic.back()) {
+      case 0:
+        break;
+      case 1:
+        compressor_ = google::compression::NewGipfeliCompressor();
+        break;
+      default:
+        LOG(FATAL) << "Unknown compression " << static_cast<int>(magic.back());
+    }
+  } else {
+    stream_.close();
+    stream_.open(path, std::ios::in);
+    CHECK(!stream_.fail());
+  }
 }
 
 bool Player::Play(int const index) {
@@ -50,7 +95,245 @@ serialization::Method const& Player::last_method_out_return() const {
   return *last_method_out_return_;
 }
 
+void Player::LoadOrBuildIndex() {
+  std::filesystem::path index_path = path_;
+  index_path += ".index";
+  Position const start = Tell();
+  if (ReadIndex(index_path)) {
+    return;
+  }
+
+  std::map<std::string, std::uint32_t> type_to_index;
+  for (;;) {
+    Position const position = Tell();
+    std::unique_ptr<serialization::Method> const method_in = Read();
+    if (method_in == nullptr || Read() == nullptr) {
+      break;
+    }
+    auto const [it, _] = type_to_index.emplace(MethodType(*method_in),
+                                               method_types_.size());
+    if (it->second == method_types_.size()) {
+      method_types_.push_back(it->first);
+    }
+    index_.push_back({.position = position, .type = it->second});
+  }
+  Seek(start);
+  WriteIndex(index_path);
+}
+
+void Player::SeekTo(int const index) {
+  CHECK_LE(0, index);
+  CHECK_LT(index, index_.size());
+  if (has_played_) {
+    CHECK_LE(next_index_, index) << "Cannot seek backwards after playing";
+    std::vector<bool> type_uses_pointers;
+    for (auto const& method_type : method_types_) {
+      type_uses_pointers.push_back(ProducesOrConsumesPointers(method_type));
+    }
+    for (int i = next_index_; i < index; ++i) {
+      CHECK(!type_uses_pointers[index_[i].type])
+          << "Cannot seek over method pair " << i << " of type "
+          << method_types_[index_[i].type] << " after playing";
+    }
+  }
+  Seek(index_[index].position);
+  next_index_ = index;
+}
+
+int Player::size() const {
+  return index_.size();
+}
+
+std::map<std::string, std::int64_t> Player::MethodHistogram() const {
+  std::vector<std::int64_t> counts(method_types_.size());
+  for (auto const& entry : index_) {
+    ++counts[entry.type];
+  }
+  std::map<std::string, std::int64_t> histogram;
+  for (int i = 0; i < method_types_.size(); ++i) {
+    histogram.emplace(method_types_[i], counts[i]);
+  }
+  return histogram;
+}
+
+void Player::SkipMethodTypes(std::set<std::string> types) {
+  for (auto const& type : types) {
+    CHECK(!ProducesOrConsumesPointers(type))
+        << "Cannot skip methods of type " << type;
+  }
+  skipped_method_types_ = std::move(types);
+}
+
+void Player::EnableTimingStatistics() {
+  timing_statistics_enabled_ = true;
+}
+
+void Player::LogTimingStatistics() const {
+  std::vector<std::pair<std::string, Timing>> timings(timings_.begin(),
+                                                      timings_.end());
+  std::sort(timings.begin(),
+            timings.end(),
+            [](auto const& left, auto const& right) {
+              return left.second.total > right.second.total;
+            });
+  for (auto const& [type, timing] : timings) {
+    LOG(ERROR) << type << ": " << timing.count << " calls, "
+               << timing.total / 1ms << " ms total, "
+               << (timing.total / timing.count) / 1us << " µs mean";
+  }
+}
+
+Player::Position Player::Tell() {
+  if (binary_ && block_position_ < block_.size()) {
+    return {.offset = block_offset_,
+            .position_in_block = static_cast<std::uint32_t>(block_position_)};
+  } else {
+    return {.offset = static_cast<std::uint64_t>(stream_.tellg()),
+            .position_in_block = 0};
+  }
+}
+
+void Player::Seek(Position const& position) {
+  stream_.clear();
+  stream_.seekg(position.offset);
+  CHECK(!stream_.fail()) << position.offset;
+  if (binary_) {
+    block_.clear();
+    block_position_ = 0;
+    if (position.position_in_block > 0) {
+      CHECK(ReadBlock()) << position.offset;
+      block_position_ = position.position_in_block;
+    }
+  }
+}
+
+bool Player::ReadIndex(std::filesystem::path const& index_path) {
+  std::error_code error;
+  auto const index_size = std::filesystem::file_size(index_path, error);
+  if (error) {
+    return false;
+  }
+  std::string bytes(index_size, '\0');
+  std::ifstream index_stream(index_path, std::ios::in | std::ios::binary);
+  index_stream.read(bytes.data(), bytes.size());
+  if (index_stream.gcount() != static_cast<std::streamsize>(bytes.size()) ||
+      !bytes.starts_with(index_magic)) {
+    return false;
+  }
+
+  // Extracts the next integer from |bytes|, returns false if there is none.
+  std::size_t cursor = index_magic.size();
+  auto read = [&bytes, &cursor](std::uint64_t& value) {
+    if (cursor + sizeof(value) > bytes.size()) {
+      return false;
+    }
+    CodedInputStream::ReadLittleEndian64FromArray(
+        reinterpret_cast<std::uint8_t const*>(&bytes[cursor]), &value);
+    cursor += sizeof(value);
+    return true;
+  };
+
+  std::uint64_t journal_size;
+  std::uint64_t number_of_types;
+  if (!read(journal_size) ||
+      journal_size != std::filesystem::file_size(path_) ||
+      !read(number_of_types)) {
+    return false;
+  }
+  std::vector<std::string> method_types;
+  for (std::uint64_t i = 0; i < number_of_types; ++i) {
+    std::uint64_t type_size;
+    if (!read(type_size) || cursor + type_size > bytes.size()) {
+      return false;
+    }
+    method_types.push_back(bytes.substr(cursor, type_size));
+    cursor += type_size;
+  }
+  std::uint64_t number_of_entries;
+  if (!read(number_of_entries)) {
+    return false;
+  }
+  std::vector<IndexEntry> index;
+  index.reserve(number_of_entries);
+  for (std::uint64_t i = 0; i < number_of_entries; ++i) {
+    std::uint64_t offset;
+    std::uint64_t position_in_block;
+    std::uint64_t type;
+    if (!read(offset) || !read(position_in_block) || !read(type) ||
+        type >= number_of_types) {
+      return false;
+    }
+    index.push_back(
+        {.position = {.offset = offset,
+                      .position_in_block =
+                          static_cast<std::uint32_t>(position_in_block)},
+         .type = static_cast<std::uint32_t>(type)});
+  }
+
+  method_types_ = std::move(method_types);
+  index_ = std::move(index);
+  return true;
+}
+
+void Player::WriteIndex(std::filesystem::path const& index_path) const {
+  std::string bytes(index_magic);
+  auto write = [&bytes](std::uint64_t const value) {
+    std::uint8_t little_endian[sizeof(value)];
+    CodedOutputStream::WriteLittleEndian64ToArray(value, little_endian);
+    bytes.append(reinterpret_cast<char const*>(little_endian),
+                 sizeof(little_endian));
+  };
+
+  write(std::filesystem::file_size(path_));
+  write(method_types_.size());
+  for (auto const& method_type : method_types_) {
+    write(method_type.size());
+    bytes.append(method_type);
+  }
+  write(index_.size());
+  for (auto const& entry : index_) {
+    write(entry.position.offset);
+    write(entry.position.position_in_block);
+    write(entry.type);
+  }
+
+  std::ofstream index_stream(index_path, std::ios::out | std::ios::binary);
+  index_stream.write(bytes.data(), bytes.size());
+  LOG_IF(ERROR, index_stream.fail()) << "Unable to write " << index_path;
+}
+
+std::string Player::MethodType(serialization::Method const& method) {
+  std::vector<FieldDescriptor const*> fields;
+  method.GetReflection()->ListFields(method, &fields);
+  CHECK_EQ(1, fields.size()) << method.DebugString();
+  return fields.front()->extension_scope()->name();
+}
+
+bool Player::ProducesOrConsumesPointers(std::string const& type) {
+  Descriptor const* const method_descriptor =
+      serialization::Method::descriptor()->file()->FindMessageTypeByName(type);
+  CHECK(method_descriptor != nullptr) << "Unknown method type " << type;
+  for (int i = 0; i < method_descriptor->nested_type_count(); ++i) {
+    Descriptor const* const message_descriptor =
+        method_descriptor->nested_type(i);
+    for (int j = 0; j < message_descriptor->field_count(); ++j) {
+      FieldOptions const& options = message_descriptor->field(j)->options();
+      if (options.GetExtension(serialization::is_produced) ||
+          options.GetExtension(serialization::is_consumed) ||
+          options.HasExtension(serialization::is_produced_if) ||
+          options.HasExtension(serialization::is_consumed_if)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 std::unique_ptr<serialization::Method> Player::Read() {
+  return binary_ ? ReadBinary() : ReadHexadecimal();
+}
+
+std::unique_ptr<serialization::Method> Player::ReadHexadecimal() {
   std::string const line = GetLine(stream_);
   if (line.empty()) {
     return nullptr;
@@ -64,6 +347,59 @@ std::unique_ptr<serialization::Method> Player::Read() {
   return method;
 }
 
+std::unique_ptr<serialization::Method> Player::ReadBinary() {
+  if (block_position_ == block_.size() && !ReadBlock()) {
+    return nullptr;
+  }
+
+  CHECK_LE(block_position_ + sizeof(std::uint32_t), block_.size());
+  std::uint32_t size;
+  CodedInputStream::ReadLittleEndian32FromArray(
+      reinterpret_cast<std::uint8_t const*>(&block_[block_position_]), &size);
+  block_position_ += sizeof(std::uint32_t);
+  CHECK_LE(block_position_ + size, block_.size());
+
+  auto method = std::make_unique<serialization::Method>();
+  CHECK(method->ParseFromArray(&block_[block_position_], size));
+  block_position_ += size;
+
+  return method;
+}
+
+bool Player::ReadBlock() {
+  block_offset_ = stream_.tellg();
+  std::uint8_t header[2 * sizeof(std::uint32_t)];
+  stream_.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (stream_.gcount() == 0) {
+    return false;
+  } else if (stream_.gcount() < static_cast<std::streamsize>(sizeof(header))) {
+    LOG(ERROR) << "Truncated block header";
+    return false;
+  }
+  std::uint32_t stored_size;
+  std::uint32_t uncompressed_size;
+  CodedInputStream::ReadLittleEndian32FromArray(&header[0], &stored_size);
+  CodedInputStream::ReadLittleEndian32FromArray(&header[sizeof(std::uint32_t)],
+                                                &uncompressed_size);
+
+  std::string stored(stored_size, '\0');
+  stream_.read(stored.data(), stored_size);
+  if (stream_.gcount() < static_cast<std::streamsize>(stored_size)) {
+    LOG(ERROR) << "Truncated block of size " << stored_size;
+    return false;
+  }
+
+  if (compressor_ == nullptr) {
+    block_ = std::move(stored);
+  } else {
+    block_.clear();
+    CHECK(compressor_->Uncompress(stored, &block_));
+  }
+  CHECK_EQ(uncompressed_size, block_.size());
+  block_position_ = 0;
+  return true;
+}
+
 bool Player::Process(std::unique_ptr<serialization::Method> method_in,
                      int const index, bool const play) {
   if (method_in == nullptr) {
@@ -108,15 +444,29 @@ bool Player::Process(std::unique_ptr<serialization::Method> method_in,
                                  << method_out_return->ShortDebugString();
 #endif
 
+  ++next_index_;
   if (play) {
-    auto const before = std::chrono::system_clock::now();
+    // Finding the type of the method uses reflection, so only do it if needed.
+    std::string type;
+    if (timing_statistics_enabled_ || !skipped_method_types_.empty()) {
+      type = MethodType(*method_in);
+    }
+    if (!skipped_method_types_.contains(type)) {
+      has_played_ = true;
+      auto const before = std::chrono::system_clock::now();
 
 #include "journal/player.generated.cc"
 
-    auto const after = std::chrono::system_clock::now();
-    if (after - before > 100ms) {
-      LOG(ERROR) << "Long method (" << (after - before) / 1ms << " ms):\n"
-                 << method_in->DebugString();
+      auto const after = std::chrono::system_clock::now();
+      if (after - before > 100ms) {
+        LOG(ERROR) << "Long method (" << (after - before) / 1ms << " ms):\n"
+                   << method_in->DebugString();
+      }
+      if (timing_statistics_enabled_) {
+        Timing& timing = timings_[type];
+        ++timing.count;
+        timing.total += after - before;
+      }
     }
   }
 
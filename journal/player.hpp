@@ -1,10 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
+#include "gipfeli/compression.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -16,10 +22,14 @@ class RecorderTest;
 namespace _player {
 namespace internal {
 
+using ::google::compression::Compressor;
+
 class Player final {
  public:
   using PointerMap = std::map<std::uint64_t, void*>;
 
+  // |path| may designate a journal in any of the formats written by the
+  // |Recorder|.
   explicit Player(std::filesystem::path const& path);
 
   // Replays the next message in the journal.  Returns false at end of journal.
@@ -33,10 +43,90 @@ class Player final {
   serialization::Method const& last_method_in() const;
   serialization::Method const& last_method_out_return() const;
 
+  // Loads the index of the method pairs of the journal from the file
+  // |path| + ".index", or, if that file doesn't exist or doesn't match the
+  // journal, builds the index by scanning the journal and writes it to that
+  // file.  Must be called before the first call to |Play| or |Scan|.
+  void LoadOrBuildIndex();
+
+  // Requires an index.  The next call to |Play| or |Scan| processes the method
+  // pair at |index|, which must be passed to that call.  The methods that are
+  // jumped over are not executed, so they don't update the pointer map.
+  // Therefore, once a method has been played, it is only possible to seek
+  // forward, over methods that neither produce nor consume pointers.  Before
+  // that, any seek is possible, but the methods played afterwards must not use
+  // the pointers produced by the methods before |index|.
+  void SeekTo(int index);
+
+  // The number of method pairs in the journal.  Requires an index.
+  int size() const;
+
+  // Requires an index.  Returns the number of method pairs of each type in the
+  // journal.  The types are the names of the messages, e.g., "AdvanceTime".
+  std::map<std::string, std::int64_t> MethodHistogram() const;
+
+  // The methods of the given types are parsed by |Play|, but not executed.
+  // Since skipped methods don't update the pointer map, the types must be
+  // those of methods that neither produce nor consume pointers.
+  void SkipMethodTypes(std::set<std::string> types);
+
+  // Starts recording the number of executions and the execution times for
+  // each type of method executed by |Play|.  This is off by default, as it
+  // requires finding the type of each method using reflection.
+  void EnableTimingStatistics();
+
+  // Logs the number of executions and the total and mean execution times for
+  // each type of method executed by |Play| since |EnableTimingStatistics| was
+  // called.
+  void LogTimingStatistics() const;
+
  private:
+  // The position of a method in the journal.  For a hexadecimal journal,
+  // |offset| is that of the line of the method and |position_in_block| is 0.
+  // For a binary journal, |offset| is that of the block containing the method
+  // and |position_in_block| is that of the frame in the uncompressed block.
+  struct Position {
+    std::uint64_t offset;
+    std::uint32_t position_in_block;
+  };
+
+  struct IndexEntry {
+    Position position;
+    // An index in |method_types_|.
+    std::uint32_t type;
+  };
+
+  struct Timing {
+    std::int64_t count = 0;
+    std::chrono::nanoseconds total{};
+  };
+
+  // The position of the next method to be read.
+  Position Tell();
+  void Seek(Position const& position);
+
+  // Returns false if the index file doesn't exist or doesn't match the journal.
+  bool ReadIndex(std::filesystem::path const& index_path);
+  void WriteIndex(std::filesystem::path const& index_path) const;
+
+  // The name of the message of the extension present in |method|.
+  static std::string MethodType(serialization::Method const& method);
+
+  // Whether the methods of the given |type| produce or consume pointers, i.e.,
+  // update the pointer map when they are played.
+  static bool ProducesOrConsumesPointers(std::string const& type);
+
   // Reads one message from the stream.  Returns a |nullptr| at end of stream.
   std::unique_ptr<serialization::Method> Read();
 
+  std::unique_ptr<serialization::Method> ReadHexadecimal();
+  std::unique_ptr<serialization::Method> ReadBinary();
+
+  // Reads the next block of a binary journal into |block_|.  Returns false at
+  // end of stream, including if the last block is truncated, as happens if the
+  // game died while the block was being written.
+  bool ReadBlock();
+
   // Implementation of |Play| and |Scan|.
   bool Process(std::unique_ptr<serialization::Method> method_in,
                int const index, bool const play);
@@ -45,9 +135,32 @@ class Player final {
   bool RunIfAppropriate(serialization::Method const& method_in,
                         serialization::Method const& method_out_return);
 
+  std::filesystem::path const path_;
   PointerMap pointer_map_;
   std::ifstream stream_;
 
+  // Only used for binary journals.  |block_position_| is the position of the
+  // next frame in |block_|.
+  bool binary_ = false;
+  std::unique_ptr<Compressor> compressor_;
+  std::string block_;
+  std::size_t block_position_ = 0;
+  // The offset in |stream_| of the block currently in |block_|.
+  std::uint64_t block_offset_ = 0;
+
+  // Empty if there is no index.
+  std::vector<std::string> method_types_;
+  std::vector<IndexEntry> index_;
+
+  // The index of the next method pair to be processed.
+  int next_index_ = 0;
+  // Whether a method has been executed.
+  bool has_played_ = false;
+
+  std::set<std::string> skipped_method_types_;
+  bool timing_statistics_enabled_ = false;
+  std::map<std::string, Timing> timings_;
+
   std::unique_ptr<serialization::Method> last_method_in_;
   std::unique_ptr<serialization::Method> last_method_out_return_;
 
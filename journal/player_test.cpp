@@ -1,26 +1,37 @@
 #include "journal/player.hpp"
 
 #include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
 
 #include "benchmark/benchmark.h"
 #include "glog/logging.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"  // 🧙 For generated profiles.
 #include "journal/recorder.hpp"
+#include "ksp_plugin/interface.hpp"
 #include "ksp_plugin/plugin.hpp"
 #include "serialization/journal.pb.h"
+#include "testing_utilities/string_log_sink.hpp"
 
 namespace principia {
 namespace journal {
 
+using ::testing::AllOf;
+using ::testing::HasSubstr;
+using ::testing::Not;
 using namespace principia::journal::_method;
 using namespace principia::journal::_player;
 using namespace principia::journal::_recorder;
 using namespace principia::ksp_plugin::_plugin;
+using namespace principia::testing_utilities::_string_log_sink;
 using namespace std::chrono_literals;
 
 void BM_PlayForReal(benchmark::State& state) {
@@ -53,6 +64,27 @@ class PlayerTest : public ::testing::Test {
     return player.RunIfAppropriate<Profile>(method_in, method_out_return);
   }
 
+  // Records a journal where |plugin_| is created, the buffered logging is set
+  // twice, and |plugin_| is deleted.
+  void RecordBufferedLoggingJournal(std::filesystem::path const& path) {
+    Recorder* const r(new Recorder(path));
+    Recorder::Activate(r);
+    {
+      Method<NewPlugin> m({"MJD1", "MJD2", 3});
+      m.Return(plugin_.get());
+    }
+    for (int const max_severity : {1, 2}) {
+      Method<SetBufferedLogging> m({max_severity});
+      m.Return();
+    }
+    {
+      const Plugin* plugin = plugin_.get();
+      Method<DeletePlugin> m({&plugin}, {&plugin});
+      m.Return();
+    }
+    Recorder::Deactivate();
+  }
+
   ::testing::TestInfo const* const test_info_;
   std::string const test_case_name_;
   std::string const test_name_;
@@ -86,6 +118,247 @@ TEST_F(PlayerTest, PlayTiny) {
   EXPECT_EQ(3, count);
 }
 
+TEST_F(PlayerTest, PlayTinyBinary) {
+  for (auto const format : {Recorder::Format::Binary,
+                            Recorder::Format::CompressedBinary}) {
+    {
+      Recorder* const r(new Recorder(test_name_ + ".journal", format));
+      Recorder::Activate(r);
+
+      {
+        Method<NewPlugin> m({"MJD1", "MJD2", 3});
+        m.Return(plugin_.get());
+      }
+      {
+        const Plugin* plugin = plugin_.get();
+        Method<DeletePlugin> m({&plugin}, {&plugin});
+        m.Return();
+      }
+      Recorder::Deactivate();
+    }
+
+    Player player(test_name_ + ".journal");
+
+    // Replay the journal.
+    int count = 0;
+    while (player.Play(count)) {
+      ++count;
+    }
+    EXPECT_EQ(3, count);
+  }
+}
+
+// Enough methods to wrap around the queue of the recorder and to fill several
+// blocks.
+TEST_F(PlayerTest, ScanBinary) {
+  constexpr int methods = 10'000;
+  {
+    Recorder* const r(new Recorder(test_name_ + ".journal",
+                                   Recorder::Format::CompressedBinary));
+    Recorder::Activate(r);
+    for (int i = 0; i < methods; ++i) {
+      Method<NewPlugin> m({"MJD1", "MJD2", 3});
+      m.Return(plugin_.get());
+    }
+    Recorder::Deactivate();
+  }
+
+  Player player(test_name_ + ".journal");
+  int count = 0;
+  while (player.Scan(count)) {
+    ++count;
+  }
+  EXPECT_EQ(methods + 1, count);
+  EXPECT_EQ("MJD1",
+            player.last_method_in()
+                .GetExtension(serialization::NewPlugin::extension)
+                .in()
+                .game_epoch());
+}
+
+TEST_F(PlayerTest, Index) {
+  for (auto const format : {Recorder::Format::Hexadecimal,
+                            Recorder::Format::CompressedBinary}) {
+    std::filesystem::path const path = test_name_ + ".journal";
+    std::filesystem::remove(path.string() + ".index");
+    {
+      Recorder* const r(new Recorder(path, format));
+      Recorder::Activate(r);
+      for (int i = 0; i < 5'000; ++i) {
+        std::string const game_epoch = "MJD" + std::to_string(i);
+        Method<NewPlugin> m({game_epoch.c_str(), "MJD2", 3});
+        m.Return(plugin_.get());
+      }
+      Recorder::Deactivate();
+    }
+
+    // The first player builds the index, the second one reads it.
+    for (int pass = 0; pass < 2; ++pass) {
+      Player player(path);
+      player.LoadOrBuildIndex();
+      EXPECT_TRUE(std::filesystem::exists(path.string() + ".index"));
+      EXPECT_EQ(5'001, player.size());
+      EXPECT_EQ((std::map<std::string, std::int64_t>{{"GetVersion", 1},
+                                                     {"NewPlugin", 5'000}}),
+                player.MethodHistogram());
+
+      player.SeekTo(4'000);
+      int count = 4'000;
+      EXPECT_TRUE(player.Scan(count));
+      ++count;
+      EXPECT_EQ("MJD3999",
+                player.last_method_in()
+                    .GetExtension(serialization::NewPlugin::extension)
+                    .in()
+                    .game_epoch());
+      while (player.Scan(count)) {
+        ++count;
+      }
+      EXPECT_EQ(5'001, count);
+
+      player.SeekTo(0);
+      EXPECT_TRUE(player.Scan(0));
+      EXPECT_TRUE(player.last_method_in().HasExtension(
+          serialization::GetVersion::extension));
+    }
+  }
+}
+
+TEST_F(PlayerTest, SkipMethodTypes) {
+  std::filesystem::path const path = test_name_ + ".journal.hex";
+  RecordBufferedLoggingJournal(path);
+  int const buffered_logging = interface::principia__GetBufferedLogging();
+  {
+    Player player(path);
+    player.SkipMethodTypes({"SetBufferedLogging"});
+    int count = 0;
+    while (player.Play(count)) {
+      ++count;
+    }
+    EXPECT_EQ(5, count);
+    EXPECT_EQ(buffered_logging, interface::principia__GetBufferedLogging());
+  }
+  {
+    Player player(path);
+    int count = 0;
+    while (player.Play(count)) {
+      ++count;
+    }
+    EXPECT_EQ(5, count);
+    EXPECT_EQ(2, interface::principia__GetBufferedLogging());
+  }
+  interface::principia__SetBufferedLogging(buffered_logging);
+}
+
+TEST_F(PlayerTest, LogTimingStatistics) {
+  std::filesystem::path const path = test_name_ + ".journal.hex";
+  RecordBufferedLoggingJournal(path);
+  int const buffered_logging = interface::principia__GetBufferedLogging();
+  {
+    Player player(path);
+    EXPECT_TRUE(player.Play(0));
+    player.EnableTimingStatistics();
+    int count = 1;
+    while (player.Play(count)) {
+      ++count;
+    }
+    EXPECT_EQ(5, count);
+
+    StringLogSink log_error(google::ERROR);
+    player.LogTimingStatistics();
+    EXPECT_THAT(log_error.string(),
+                AllOf(HasSubstr("NewPlugin: 1 calls"),
+                      HasSubstr("SetBufferedLogging: 2 calls"),
+                      HasSubstr("DeletePlugin: 1 calls"),
+                      Not(HasSubstr("GetVersion"))));
+  }
+  {
+    Player player(path);
+    int count = 0;
+    while (player.Play(count)) {
+      ++count;
+    }
+    StringLogSink log_error(google::ERROR);
+    player.LogTimingStatistics();
+    EXPECT_THAT(log_error.string(), Not(HasSubstr("calls")));
+  }
+  interface::principia__SetBufferedLogging(buffered_logging);
+}
+
+using PlayerDeathTest = PlayerTest;
+
+TEST_F(PlayerDeathTest, SkipPointerMethodTypes) {
+  std::filesystem::path const path = test_name_ + ".journal.hex";
+  RecordBufferedLoggingJournal(path);
+  Player player(path);
+  EXPECT_DEATH({
+    player.SkipMethodTypes({"SetBufferedLogging", "NewPlugin"});
+  }, "skip methods of type NewPlugin");
+  EXPECT_DEATH({
+    player.SkipMethodTypes({"DeletePlugin"});
+  }, "skip methods of type DeletePlugin");
+  EXPECT_DEATH({
+    player.SkipMethodTypes({"NoSuchMethod"});
+  }, "Unknown method type NoSuchMethod");
+}
+
+// The methods that are still queued when the process crashes are written to a
+// binary journal.
+TEST_F(PlayerDeathTest, FlushBinaryOnSignal) {
+  for (int const signal : {SIGABRT, SIGSEGV}) {
+    for (auto const format : {Recorder::Format::Binary,
+                              Recorder::Format::CompressedBinary}) {
+      std::filesystem::path const path = test_name_ + ".journal";
+      std::filesystem::remove(path);
+      EXPECT_DEATH({
+        Recorder* const r(new Recorder(path, format));
+        Recorder::Activate(r);
+        {
+          Method<NewPlugin> m({"MJD1", "MJD2", 3});
+          m.Return(plugin_.get());
+        }
+        std::raise(signal);
+      }, "");
+
+      // The journal contains GetVersion and NewPlugin.
+      Player player(path);
+      int count = 0;
+      while (player.Play(count)) {
+        ++count;
+      }
+      EXPECT_EQ(2, count);
+    }
+  }
+}
+
+TEST_F(PlayerDeathTest, SeekAfterPlaying) {
+  std::filesystem::path const path = test_name_ + ".journal.hex";
+  std::filesystem::remove(path.string() + ".index");
+  RecordBufferedLoggingJournal(path);
+  int const buffered_logging = interface::principia__GetBufferedLogging();
+
+  Player player(path);
+  player.LoadOrBuildIndex();
+  // Seeking is unrestricted before playing.
+  player.SeekTo(3);
+  player.SeekTo(0);
+  EXPECT_TRUE(player.Play(0));
+  EXPECT_DEATH({
+    player.SeekTo(2);
+  }, "seek over method pair 1 of type NewPlugin");
+  EXPECT_TRUE(player.Play(1));
+  // Seeking over methods that don't use pointers is fine.
+  player.SeekTo(3);
+  EXPECT_TRUE(player.Play(3));
+  EXPECT_EQ(2, interface::principia__GetBufferedLogging());
+  EXPECT_DEATH({
+    player.SeekTo(1);
+  }, "seek backwards");
+  EXPECT_TRUE(player.Play(4));
+  EXPECT_FALSE(player.Play(5));
+  interface::principia__SetBufferedLogging(buffered_logging);
+}
+
 TEST_F(PlayerTest, DISABLED_SECULAR_Benchmarks) {
   benchmark::RunSpecifiedBenchmarks();
 }
@@ -1,26 +1,67 @@
 #include "journal/recorder.hpp"
 
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
 #include <filesystem>
+#include <thread>
 
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/serialization.hpp"
 #include "base/version.hpp"
+#include "gipfeli/gipfeli.h"
 #include "glog/logging.h"
+#include "google/protobuf/io/coded_stream.h"
 
 namespace principia {
 namespace journal {
 namespace _recorder {
 namespace internal {
 
+using ::google::protobuf::io::CodedOutputStream;
 using namespace principia::base::_array;
 using namespace principia::base::_hexadecimal;
 using namespace principia::base::_serialization;
 using namespace principia::base::_version;
 
-Recorder::Recorder(std::filesystem::path const& path)
-    : stream_(path, std::ios::out) {
+using namespace std::chrono_literals;
+
+// The number of methods that may be waiting for the writer thread before the
+// game thread blocks.
+constexpr int queue_capacity = 1 << 12;
+// The size above which a block is written out (and compressed, if needed).
+constexpr std::size_t block_size = 1 << 16;
+// The maximum time during which the methods may stay in memory.
+constexpr std::chrono::milliseconds flush_period = 100ms;
+
+Recorder::Recorder(std::filesystem::path const& path, Format const format)
+    : format_(format),
+      compressor_(format == Format::CompressedBinary
+                      ? google::compression::NewGipfeliCompressor()
+                      : nullptr),
+      stream_(path,
+              format == Format::Hexadecimal
+                  ? std::ios::out
+                  : std::ios::out | std::ios::binary) {
   CHECK(!stream_.fail()) << path;
+  if (format_ != Format::Hexadecimal) {
+    stream_.write(binary_magic.data(), binary_magic.size());
+    stream_.put(format_ == Format::CompressedBinary ? '\1' : '\0');
+    queue_.resize(queue_capacity);
+    writer_ = MakeStoppableThread([this]() { WriteBehind(); });
+  }
+}
+
+Recorder::~Recorder() {
+  if (format_ != Format::Hexadecimal) {
+    {
+      absl::MutexLock l(&writer_lock_);
+      writer_.request_stop();
+    }
+    writer_wakeup_.Signal();
+    writer_.join();
+  }
 }
 
 void Recorder::WriteAtConstruction(serialization::Method const& method) {
@@ -36,6 +77,15 @@ void Recorder::WriteAtDestruction(serialization::Method const& method) {
 void Recorder::Activate(not_null<Recorder*> const recorder) {
   CHECK(active_recorder_ == nullptr);
   active_recorder_ = recorder;
+  if (recorder->format_ != Format::Hexadecimal) {
+    flushed_.clear();
+    previous_failure_function_ =
+        google::InstallFailureFunction(&FlushAndAbort);
+    previous_sigabrt_handler_ = std::signal(SIGABRT, &FlushAndReraise);
+    previous_sigsegv_handler_ = std::signal(SIGSEGV, &FlushAndReraise);
+    CHECK(previous_sigabrt_handler_ != SIG_ERR);
+    CHECK(previous_sigsegv_handler_ != SIG_ERR);
+  }
 
   // When the recorder gets activated, pretend that we got a GetVersion call.
   // This will record the version at the beginning of the journal, which is
@@ -53,6 +103,14 @@ void Recorder::Activate(not_null<Recorder*> const recorder) {
 
 void Recorder::Deactivate() {
   CHECK(active_recorder_ != nullptr);
+  if (active_recorder_->format_ != Format::Hexadecimal) {
+    google::InstallFailureFunction(previous_failure_function_);
+    previous_failure_function_ = nullptr;
+    std::signal(SIGABRT, previous_sigabrt_handler_);
+    std::signal(SIGSEGV, previous_sigsegv_handler_);
+    previous_sigabrt_handler_ = SIG_DFL;
+    previous_sigsegv_handler_ = SIG_DFL;
+  }
   delete active_recorder_;
   active_recorder_ = nullptr;
 }
@@ -62,14 +120,148 @@ bool Recorder::IsActivated() {
 }
 
 void Recorder::WriteLocked(serialization::Method const& method) {
-  static auto* const encoder = new HexadecimalEncoder</*null_terminated=*/true>;
   CHECK_LT(0, method.ByteSize()) << method.DebugString();
-  auto const hexadecimal = encoder->Encode(SerializeAsBytes(method).get());
-  stream_ << hexadecimal.data.get() << "\n";
+  if (format_ == Format::Hexadecimal) {
+    static auto* const encoder =
+        new HexadecimalEncoder</*null_terminated=*/true>;
+    auto const hexadecimal = encoder->Encode(SerializeAsBytes(method).get());
+    stream_ << hexadecimal.data.get() << "\n";
+    stream_.flush();
+    return;
+  }
+
+  auto bytes = SerializeAsBytes(method);
+  std::uint64_t const end = queue_end_.load(std::memory_order_relaxed);
+  std::uint64_t const begin = queue_begin_.load(std::memory_order_acquire);
+  if (end - begin == queue_.size()) {
+    // The writer is lagging behind, wake it up and wait until it has released
+    // a slot.  The writer only releases |writer_lock_| when it waits on
+    // |writer_wakeup_|, so the signal cannot be lost, and it only pops while
+    // holding |writer_lock_|, so the condition is reevaluated when needed.
+    auto const queue_has_room = [this, end]() {
+      return end - queue_begin_.load(std::memory_order_acquire) <
+             queue_.size();
+    };
+    absl::MutexLock l(&writer_lock_);
+    writer_wakeup_.Signal();
+    writer_lock_.Await(absl::Condition(&queue_has_room));
+  }
+  queue_[end % queue_.size()] = std::move(bytes);
+  queue_end_.store(end + 1, std::memory_order_release);
+  if (end + 1 - begin == queue_.size() / 2) {
+    writer_wakeup_.Signal();
+  }
+}
+
+void Recorder::WriteBehind() {
+  absl::MutexLock l(&writer_lock_);
+  auto next_flush = std::chrono::steady_clock::now() + flush_period;
+  for (;;) {
+    // Everything pushed before the stop request must be drained below.
+    bool const stop_requested =
+        this_stoppable_thread::get_stop_token().stop_requested();
+    DrainLocked();
+    if (stop_requested) {
+      FlushLocked();
+      return;
+    }
+    auto const now = std::chrono::steady_clock::now();
+    if (now >= next_flush) {
+      FlushLocked();
+      next_flush = now + flush_period;
+    }
+    writer_wakeup_.WaitWithTimeout(&writer_lock_,
+                                   absl::FromChrono(next_flush - now));
+  }
+}
+
+void Recorder::DrainLocked() {
+  std::uint64_t begin = queue_begin_.load(std::memory_order_relaxed);
+  std::uint64_t const end = queue_end_.load(std::memory_order_acquire);
+  for (; begin < end; ++begin) {
+    UniqueArray<std::uint8_t> const bytes =
+        std::move(queue_[begin % queue_.size()]);
+    // Release the slot as early as possible.
+    queue_begin_.store(begin + 1, std::memory_order_release);
+
+    std::uint8_t size[sizeof(std::uint32_t)];
+    CodedOutputStream::WriteLittleEndian32ToArray(bytes.size, size);
+    block_.append(reinterpret_cast<char const*>(size), sizeof(size));
+    block_.append(reinterpret_cast<char const*>(bytes.data.get()),
+                  bytes.size);
+    if (block_.size() >= block_size) {
+      WriteBlockLocked();
+    }
+  }
+}
+
+void Recorder::FlushLocked() {
+  WriteBlockLocked();
   stream_.flush();
 }
 
+void Recorder::WriteBlockLocked() {
+  if (block_.empty()) {
+    return;
+  }
+  std::string compressed;
+  std::string const* stored = &block_;
+  if (compressor_ != nullptr) {
+    compressor_->Compress(block_, &compressed);
+    stored = &compressed;
+  }
+  std::uint8_t header[2 * sizeof(std::uint32_t)];
+  CodedOutputStream::WriteLittleEndian32ToArray(stored->size(), &header[0]);
+  CodedOutputStream::WriteLittleEndian32ToArray(block_.size(),
+                                                &header[sizeof(std::uint32_t)]);
+  stream_.write(reinterpret_cast<char const*>(header), sizeof(header));
+  stream_.write(stored->data(), stored->size());
+  CHECK(!stream_.fail());
+  block_.clear();
+}
+
+void Recorder::FlushAndAbort() {
+  FlushActiveRecorder();
+  // Chain to the failure function that was installed before ours, e.g., for
+  // crash reporting.  Failure functions are not supposed to return, but abort
+  // if it does.
+  if (previous_failure_function_ != nullptr) {
+    previous_failure_function_();
+  }
+  std::abort();
+}
+
+void Recorder::FlushAndReraise(int const signal) {
+  FlushActiveRecorder();
+  std::signal(signal,
+              signal == SIGABRT ? previous_sigabrt_handler_
+                                : previous_sigsegv_handler_);
+  std::raise(signal);
+}
+
+void Recorder::FlushActiveRecorder() {
+  if (active_recorder_ == nullptr || flushed_.test_and_set()) {
+    return;
+  }
+  // The writer thread may be in the middle of a write, give it some time to
+  // complete.  If the failure happened on the writer thread, there is nothing
+  // we can do.
+  for (int i = 0; i < 100; ++i) {
+    if (active_recorder_->writer_lock_.TryLock()) {
+      active_recorder_->DrainLocked();
+      active_recorder_->FlushLocked();
+      active_recorder_->writer_lock_.Unlock();
+      return;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+}
+
 Recorder* Recorder::active_recorder_ = nullptr;
+google::logging_fail_func_t Recorder::previous_failure_function_ = nullptr;
+Recorder::SignalHandler Recorder::previous_sigabrt_handler_ = SIG_DFL;
+Recorder::SignalHandler Recorder::previous_sigsegv_handler_ = SIG_DFL;
+std::atomic_flag Recorder::flushed_ = ATOMIC_FLAG_INIT;
 
 }  // namespace internal
 }  // namespace _recorder
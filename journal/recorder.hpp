@@ -1,11 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <csignal>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "base/array.hpp"
+#include "base/jthread.hpp"
 #include "base/macros.hpp"  // 🧙 For forward declarations.
 #include "base/not_null.hpp"
+#include "gipfeli/compression.h"
+#include "glog/logging.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -18,11 +29,38 @@ class RecorderTest;
 namespace _recorder {
 namespace internal {
 
+using ::google::compression::Compressor;
+using namespace principia::base::_array;
+using namespace principia::base::_jthread;
 using namespace principia::base::_not_null;
 
 class Recorder final {
  public:
-  explicit Recorder(std::filesystem::path const& path);
+  enum class Format {
+    // One hexadecimal-encoded method per line.  The methods are written and
+    // flushed synchronously by the thread that calls them.
+    Hexadecimal,
+    // Length-prefixed binary frames, written by a background thread (see
+    // below).
+    Binary,
+    // Same as |Binary|, but the blocks are compressed with gipfeli.
+    CompressedBinary,
+  };
+
+  // A binary journal starts with |binary_magic|, which cannot occur at the
+  // beginning of a hexadecimal journal, followed by one byte which is 0 for
+  // |Binary| and 1 for |CompressedBinary|.  It is then made of blocks, each
+  // starting with two little-endian 32-bit integers, the stored size and the
+  // uncompressed size of the block, followed by the stored bytes.  An
+  // uncompressed block is a sequence of frames, each made of a little-endian
+  // 32-bit size followed by a serialized |serialization::Method|.
+  static constexpr std::string_view binary_magic = "PrincipiaJournal";
+
+  explicit Recorder(std::filesystem::path const& path,
+                    Format format = Format::Hexadecimal);
+
+  // In the binary formats, writes whatever is still queued.
+  ~Recorder();
 
   // Locking is used to ensure that the pairs of writes don't get intermixed.
   void WriteAtConstruction(serialization::Method const& method);
@@ -33,12 +71,77 @@ class Recorder final {
   static bool IsActivated();
 
  private:
+  // In the hexadecimal format, writes |method| to |stream_|.  In the binary
+  // formats, serializes |method| and pushes it to |queue_|.  Only blocks if
+  // |queue_| is full.
   void WriteLocked(serialization::Method const& method);
 
+  // The body of |writer_|: pops the methods from |queue_| and flushes the
+  // stream at least every |flush_period|, until stopped.
+  void WriteBehind();
+
+  // Pops all the methods currently in |queue_| and appends them to |block_|,
+  // writing |block_| each time it exceeds |block_size|.
+  void DrainLocked() EXCLUSIVE_LOCKS_REQUIRED(writer_lock_);
+
+  // Writes the (possibly incomplete) |block_| and flushes the stream.
+  void FlushLocked() EXCLUSIVE_LOCKS_REQUIRED(writer_lock_);
+
+  void WriteBlockLocked() EXCLUSIVE_LOCKS_REQUIRED(writer_lock_);
+
+  // Installed as the glog failure function while a binary recorder is active,
+  // so that a crash doesn't lose the methods that are still queued.  After
+  // flushing, calls the previous failure function if there was one, and
+  // aborts otherwise.
+  [[noreturn]] static void FlushAndAbort();
+
+  // Installed as the handler of SIGABRT and SIGSEGV while a binary recorder is
+  // active, for the crashes that don't go through glog.  After flushing,
+  // reinstates the previous handler and raises |signal| again.  This is not
+  // async-signal-safe, but the process is dying anyway.
+  static void FlushAndReraise(int signal);
+
+  // Drains and flushes the queue of the active recorder, if any.  Only the
+  // first call after activation has an effect, so that we don't flush again
+  // when |FlushAndAbort| ends up raising SIGABRT.
+  static void FlushActiveRecorder();
+
+  Format const format_;
+  std::unique_ptr<Compressor> const compressor_;
+
   absl::Mutex lock_;
   std::ofstream stream_;
 
+  // A single-producer, single-consumer ring buffer.  Only one thread pushes at
+  // a time, as the producers hold |lock_|, and only the holder of
+  // |writer_lock_| pops, so the two indices are sufficient to synchronize the
+  // accesses to the elements.  The indices increase monotonically and are
+  // reduced modulo the size of |queue_| when accessing it.
+  std::vector<UniqueArray<std::uint8_t>> queue_;
+  std::atomic<std::uint64_t> queue_begin_ = 0;
+  std::atomic<std::uint64_t> queue_end_ = 0;
+
+  // In the binary formats, |stream_| is only accessed by the holder of this
+  // lock.
+  absl::Mutex writer_lock_;
+  // Signalled to wake up |writer_| early.  When |queue_| is half full, the
+  // signal is sent without holding |writer_lock_|, and a lost signal only
+  // delays the writes until the next periodic flush.  When |queue_| is full,
+  // the signal is sent while holding |writer_lock_|, and the producer then
+  // waits for a slot to be released.
+  absl::CondVar writer_wakeup_;
+  std::string block_ GUARDED_BY(writer_lock_);
+  jthread writer_;
+
   static Recorder* active_recorder_;
+  // The glog failure function that was installed when a binary recorder was
+  // activated, restored when it is deactivated.
+  static google::logging_fail_func_t previous_failure_function_;
+  // Same as above for the signal handlers.
+  using SignalHandler = void (*)(int);
+  static SignalHandler previous_sigabrt_handler_;
+  static SignalHandler previous_sigsegv_handler_;
+  static std::atomic_flag flushed_;
 
   template<typename>
   friend class _method::Method;
@@ -59,6 +59,10 @@ void Celestial::set_parent(not_null<Celestial const*> const parent) {
   parent_ = parent;
 }
 
+TerrainRadiusCache& Celestial::terrain_radius_cache() {
+  return terrain_radius_cache_;
+}
+
 }  // namespace internal
 }  // namespace _celestial
 }  // namespace ksp_plugin
@@ -6,6 +6,7 @@
 #include "geometry/instant.hpp"
 #include "geometry/space.hpp"
 #include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/terrain_radius_cache.hpp"
 #include "physics/body.hpp"
 #include "physics/continuous_trajectory.hpp"
 #include "physics/degrees_of_freedom.hpp"
@@ -22,6 +23,7 @@ using namespace principia::base::_not_null;
 using namespace principia::geometry::_instant;
 using namespace principia::geometry::_space;
 using namespace principia::ksp_plugin::_frames;
+using namespace principia::ksp_plugin::_terrain_radius_cache;
 using namespace principia::physics::_body;
 using namespace principia::physics::_continuous_trajectory;
 using namespace principia::physics::_degrees_of_freedom;
@@ -53,12 +55,16 @@ class Celestial {
   Celestial const* parent() const;  // Null for the Sun.
   void set_parent(not_null<Celestial const*> parent);
 
+  // The radii of the terrain sampled by the collision computations.
+  TerrainRadiusCache& terrain_radius_cache();
+
  private:
   not_null<RotatingBody<Barycentric> const*> body_;
   // The parent body for the 2-body approximation. Not owning, must only
   // be null for the sun.
   Celestial const* parent_ = nullptr;
   ContinuousTrajectory<Barycentric> const* trajectory_ = nullptr;
+  TerrainRadiusCache terrain_radius_cache_;
 };
 
 }  // namespace internal
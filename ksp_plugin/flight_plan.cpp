@@ -271,6 +271,15 @@ DiscreteTrajectory<Barycentric> const& FlightPlan::GetAllSegments() const {
   return trajectory_;
 }
 
+Planetarium::PlottingCache& FlightPlan::plotting_cache(int const index) {
+  CHECK_LE(0, index);
+  CHECK_LT(index, number_of_segments());
+  if (plotting_caches_.size() < segments_.size()) {
+    plotting_caches_.resize(segments_.size());
+  }
+  return plotting_caches_[index];
+}
+
 DiscreteTrajectorySegmentIterator<Barycentric>
 FlightPlan::GetSegmentAvoidingDeadlines(int index) {
   auto const status = RecomputeSegmentsAvoidingDeadlineIfNeeded();
@@ -597,6 +606,9 @@ void FlightPlan::AddLastSegment() {
 void FlightPlan::ResetLastSegment() {
   auto const& last_segment = segments_.back();
   trajectory_.ForgetAfter(std::next(last_segment->begin()));
+  if (plotting_caches_.size() >= segments_.size()) {
+    plotting_caches_.resize(segments_.size() - 1);
+  }
   if (anomalous_segments_ == 1) {
     anomalous_segments_ = 0;
   }
@@ -606,6 +618,9 @@ void FlightPlan::PopLastSegment() {
   auto& last_segment = segments_.back();
   trajectory_.DeleteSegments(last_segment);
   segments_.pop_back();
+  if (plotting_caches_.size() > segments_.size()) {
+    plotting_caches_.resize(segments_.size());
+  }
   if (anomalous_segments_ > 0) {
     --anomalous_segments_;
   }
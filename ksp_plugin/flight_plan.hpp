@@ -10,6 +10,7 @@
 #include "geometry/instant.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/orbit_analyser.hpp"
+#include "ksp_plugin/planetarium.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/discrete_trajectory_segment_iterator.hpp"
@@ -27,6 +28,7 @@ using namespace principia::base::_not_null;
 using namespace principia::geometry::_instant;
 using namespace principia::ksp_plugin::_frames;
 using namespace principia::ksp_plugin::_orbit_analyser;
+using namespace principia::ksp_plugin::_planetarium;
 using namespace principia::physics::_degrees_of_freedom;
 using namespace principia::physics::_discrete_trajectory;
 using namespace principia::physics::_discrete_trajectory_segment_iterator;
@@ -127,6 +129,11 @@ class FlightPlan {
   GetSegment(int index) const;
   virtual DiscreteTrajectory<Barycentric> const& GetAllSegments() const;
 
+  // The cache used to plot the segment with the given |index|, which must be in
+  // [0, number_of_segments()[.  It is cleared when the segment is recomputed.
+  // Only accessed by the main thread.
+  Planetarium::PlottingCache& plotting_cache(int index);
+
   // Same as above, but if the flight plan is anomalous because of a deadline,
   // tries to recompute it in case the ephemeris is long enough.  This can still
   // run into a deadline.
@@ -248,6 +255,9 @@ class FlightPlan {
   // either end prematurely or follow an anomalous segment; in the latter case
   // they are empty.
   int anomalous_segments_ = 0;
+  // Parallel to |segments_|, but may be shorter, in which case the missing
+  // caches are created empty by |plotting_cache|.
+  std::vector<Planetarium::PlottingCache> plotting_caches_;
   // The status of the first anomalous segment.  Set and used exclusively by
   // |ComputeSegments|.
   absl::Status anomalous_status_;
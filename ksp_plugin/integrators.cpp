@@ -85,7 +85,7 @@ DefaultPsychohistoryParameters() {
 Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPredictionParameters() {
   return Ephemeris<Barycentric>::AdaptiveStepParameters(
       EmbeddedExplicitRungeKuttaNyströmIntegrator<
-          DormandالمكاوىPrince1986RKN434FM,
+          DefaultPredictionMethod,
           Ephemeris<Barycentric>::NewtonianMotionEquation>(),
       /*max_steps=*/1000,
       /*length_integration_tolerance=*/1 * Metre,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "integrators/methods.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "physics/discrete_trajectory_segment.hpp"
 #include "physics/ephemeris.hpp"
@@ -11,6 +12,7 @@ namespace ksp_plugin {
 namespace _integrators {
 namespace internal {
 
+using namespace principia::integrators::_methods;
 using namespace principia::ksp_plugin::_frames;
 using namespace principia::physics::_discrete_trajectory_segment;
 using namespace principia::physics::_ephemeris;
@@ -38,6 +40,10 @@ Ephemeris<Barycentric>::FixedStepParameters DefaultHistoryParameters();
 Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPredictionParameters();
 Ephemeris<Barycentric>::AdaptiveStepParameters DefaultPsychohistoryParameters();
 
+// The method of the integrator of |DefaultPredictionParameters|.  The
+// predictions that use it may be flowed as an ensemble.
+using DefaultPredictionMethod = DormandالمكاوىPrince1986RKN434FM;
+
 }  // namespace internal
 
 using internal::DefaultBurnParameters;
@@ -45,6 +51,7 @@ using internal::DefaultDownsamplingParameters;
 using internal::DefaultEphemerisAccuracyParameters;
 using internal::DefaultEphemerisFixedStepParameters;
 using internal::DefaultHistoryParameters;
+using internal::DefaultPredictionMethod;
 using internal::DefaultPredictionParameters;
 using internal::DefaultPsychohistoryParameters;
 using internal::OrbitAnalyserDownsamplingParameters;
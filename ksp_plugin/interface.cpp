@@ -136,6 +136,9 @@ constexpr char hexadecimal_encoder[] = "hexadecimal";
 
 constexpr int chunk_size = 64 << 10;
 constexpr int number_of_chunks = 8;
+// The chunks of a compressed save are (un)compressed in parallel.  At most
+// |number_of_chunks - 2| of them can be in flight.
+constexpr int number_of_compression_threads = 4;
 
 not_null<Arena*> arena = []() {
   ArenaOptions options;
@@ -323,7 +326,8 @@ void __cdecl principia__ActivatePlayer() {
 // deactivate it.  Does nothing if there is already a journal in the desired
 // state.  |verbose| causes methods to be output in the INFO log before being
 // executed.
-void __cdecl principia__ActivateRecorder(bool const activate) {
+void __cdecl principia__ActivateRecorder(bool const activate,
+                                         bool const binary) {
   // NOTE: Do not journal!  You'd end up with half a message in the journal and
   // that would cause trouble.
   if (activate && !Recorder::IsActivated()) {
@@ -334,7 +338,9 @@ void __cdecl principia__ActivateRecorder(bool const activate) {
     std::stringstream name;
     name << std::put_time(localtime, "JOURNAL.%Y%m%d-%H%M%S");
     Recorder* const recorder = new Recorder(
-        std::filesystem::path("glog") / "Principia" / name.str());
+        std::filesystem::path("glog") / "Principia" / name.str(),
+        binary ? Recorder::Format::CompressedBinary
+               : Recorder::Format::Hexadecimal);
     Vessel::MakeSynchronous();
     Recorder::Activate(recorder);
   } else if (!activate && Recorder::IsActivated()) {
@@ -555,9 +561,11 @@ void __cdecl principia__DeserializePlugin(
   // Create and start a deserializer if the caller didn't provide one.
   if (*deserializer == nullptr) {
     LOG(INFO) << "Begin plugin deserialization";
-    *deserializer = new PushDeserializer(chunk_size,
-                                         number_of_chunks,
-                                         NewCompressor(compressor));
+    *deserializer = new PushDeserializer(
+        chunk_size,
+        number_of_chunks,
+        number_of_compression_threads,
+        [compressor]() { return NewCompressor(compressor); });
     CHECK_NOTNULL(arena);
     not_null<serialization::Plugin*> const message =
         Arena::CreateMessage<serialization::Plugin>(arena);
@@ -1118,9 +1126,11 @@ char const* __cdecl principia__SerializePlugin(
   // Create and start a serializer if the caller didn't provide one.
   if (*serializer == nullptr) {
     LOG(INFO) << "Begin plugin serialization";
-    *serializer = new PullSerializer(chunk_size,
-                                     number_of_chunks,
-                                     NewCompressor(compressor));
+    *serializer = new PullSerializer(
+        chunk_size,
+        number_of_chunks,
+        number_of_compression_threads,
+        [compressor]() { return NewCompressor(compressor); });
     not_null<serialization::Plugin*> const message =
         Arena::CreateMessage<serialization::Plugin>(arena);
     plugin->WriteToMessage(message);
@@ -1248,7 +1258,7 @@ void __cdecl principia__UpdateCelestialHierarchy(Plugin const* const plugin,
 }
 
 void __cdecl principia__UpdatePrediction(
-    Plugin const* const plugin,
+    Plugin* const plugin,
     char const* const* const vessel_guids) {
   journal::Method<journal::UpdatePrediction> m({plugin, vessel_guids});
   CHECK_NOTNULL(plugin);
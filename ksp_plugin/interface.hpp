@@ -82,7 +82,7 @@ extern "C" PRINCIPIA_DLL
 void __cdecl principia__ActivatePlayer();
 
 extern "C" PRINCIPIA_DLL
-void __cdecl principia__ActivateRecorder(bool activate);
+void __cdecl principia__ActivateRecorder(bool activate, bool binary);
 
 extern "C" PRINCIPIA_DLL
 void __cdecl principia__InitGoogleLogging();
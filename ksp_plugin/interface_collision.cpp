@@ -40,15 +40,15 @@ NewExecutor(Plugin const* const plugin,
                sun_world_position =
                    FromXYZ<Position<World>>(sun_world_position),
                &vessel_trajectory](
-                  std::function<Length(Angle const& latitude,
-                                       Angle const& longitude)> const& radius) {
+                  PushPullCallback<Length, Angle, Angle>::BatchedFunction const&
+                      radii) {
     return plugin->ComputeAndRenderFirstCollision(celestial_index,
                                                   vessel_trajectory,
                                                   vessel_trajectory.begin(),
                                                   vessel_trajectory.end(),
                                                   sun_world_position,
                                                   max_points,
-                                                  radius);
+                                                  radii);
   };
 
   return make_not_null_unique<
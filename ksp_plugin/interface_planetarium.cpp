@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <limits>
+#include <vector>
 
+#include "base/thread_pool.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/orthogonal_map.hpp"
@@ -24,6 +26,7 @@
 namespace principia {
 namespace interface {
 
+using namespace principia::base::_thread_pool;
 using namespace principia::geometry::_affine_map;
 using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_orthogonal_map;
@@ -141,7 +144,8 @@ void __cdecl principia__PlanetariumPlotFlightPlanSegment(
 
   Vessel const& vessel = *plugin->GetVessel(vessel_guid);
   CHECK(vessel.has_flight_plan()) << vessel_guid;
-  auto const segment = vessel.flight_plan().GetSegment(index);
+  FlightPlan& flight_plan = vessel.flight_plan();
+  auto const segment = flight_plan.GetSegment(index);
   // TODO(egg): this is ugly; we should centralize rendering.
   // If this is a burn and we cannot render the beginning of the burn, we
   // render none of it, otherwise we try to render the Frenet trihedron at the
@@ -156,8 +160,51 @@ void __cdecl principia__PlanetariumPlotFlightPlanSegment(
         [vertices, vertex_count](ScaledSpacePoint const& vertex) {
           vertices[(*vertex_count)++] = vertex;
         },
-        vertices_size);
+        vertices_size,
+        flight_plan.plotting_cache(index));
+  }
+  return m.Return();
+}
+
+// Plots concurrently the segments of the flight plan of the vessel with the
+// given GUID, without returning any vertices: this fills the plotting caches of
+// the segments so that the subsequent calls to
+// |principia__PlanetariumPlotFlightPlanSegment| with the same |planetarium| and
+// |vertices_size| don't have to evaluate the trajectories nor the plotting
+// frame.
+void __cdecl principia__PlanetariumPrepareFlightPlanSegments(
+    Planetarium const* const planetarium,
+    Plugin const* const plugin,
+    char const* const vessel_guid,
+    int const vertices_size) {
+  journal::Method<journal::PlanetariumPrepareFlightPlanSegments> m(
+      {planetarium, plugin, vessel_guid, vertices_size});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(planetarium);
+
+  Vessel const& vessel = *plugin->GetVessel(vessel_guid);
+  CHECK(vessel.has_flight_plan()) << vessel_guid;
+  FlightPlan& flight_plan = vessel.flight_plan();
+  auto const& plotting_frame = *plugin->renderer().GetPlottingFrame();
+
+  std::vector<Planetarium::PlottingRequest> requests;
+  for (int index = 0; index < flight_plan.number_of_segments(); ++index) {
+    auto const segment = flight_plan.GetSegment(index);
+    // See |principia__PlanetariumPlotFlightPlanSegment| for the burns.
+    if (segment->empty() ||
+        (index % 2 == 1 && segment->front().time < plotting_frame.t_min())) {
+      continue;
+    }
+    requests.push_back(
+        {.trajectory = &*segment,
+         .first_time = std::max(segment->front().time, plotting_frame.t_min()),
+         .last_time = std::min(segment->back().time, plotting_frame.t_max()),
+         .reverse = false,
+         .add_point = [](ScaledSpacePoint const&) {},
+         .max_points = vertices_size,
+         .cache = &flight_plan.plotting_cache(index)});
   }
+  planetarium->PlotMethod3(requests, plugin->CurrentTime(), SharedThreadPool());
   return m.Return();
 }
 
@@ -177,7 +224,8 @@ void __cdecl principia__PlanetariumPlotPrediction(
   CHECK_NOTNULL(planetarium);
   *vertex_count = 0;
 
-  auto const prediction = plugin->GetVessel(vessel_guid)->prediction();
+  Vessel& vessel = *plugin->GetVessel(vessel_guid);
+  auto const prediction = vessel.prediction();
   planetarium->PlotMethod3(
       *prediction, prediction->begin(), prediction->end(),
       plugin->CurrentTime(),
@@ -185,7 +233,8 @@ void __cdecl principia__PlanetariumPlotPrediction(
       [vertices, vertex_count](ScaledSpacePoint const& vertex) {
         vertices[(*vertex_count)++] = vertex;
       },
-      vertices_size);
+      vertices_size,
+      vessel.prediction_plotting_cache());
   return m.Return();
 }
 
@@ -177,6 +177,10 @@ DiscreteTrajectory<Barycentric>::iterator Part::psychohistory_end() {
   return psychohistory_->end();
 }
 
+std::int64_t Part::history_size() const {
+  return history_->size();
+}
+
 void Part::AppendToHistory(
     Instant const& time,
     DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
@@ -123,6 +124,10 @@ class Part final {
   DiscreteTrajectory<Barycentric>::iterator psychohistory_begin();
   DiscreteTrajectory<Barycentric>::iterator psychohistory_end();
 
+  // The number of points in the history of the part.  Doesn't include the
+  // psychohistory.
+  std::int64_t history_size() const;
+
   // Appends a point to the history or psychohistory of this part.  These
   // temporarily hold the trajectory of the part and are constructed by
   // |PileUp::AdvanceTime|.  They are consumed by |Vessel::AdvanceTime| for the
@@ -5,6 +5,8 @@
 #include <utility>
 #include <vector>
 
+#include "base/parallel_for.hpp"
+#include "base/status_utilities.hpp"  // 🧙 For CHECK_OK.
 #include "geometry/sign.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/similar_motion.hpp"
@@ -16,6 +18,7 @@ namespace ksp_plugin {
 namespace _planetarium {
 namespace internal {
 
+using namespace principia::base::_parallel_for;
 using namespace principia::geometry::_sign;
 using namespace principia::physics::_massive_body;
 using namespace principia::physics::_similar_motion;
@@ -24,8 +27,40 @@ using namespace principia::quantities::_named_quantities;
 
 namespace {
 constexpr int max_plot_method_2_steps = 10'000;
+// Above this number of points the |PlottingCache| is cleared, to avoid growing
+// it without bound as the camera zooms in and out.
+constexpr std::int64_t max_plotting_cache_size = 16 * max_plot_method_2_steps;
 }  // namespace
 
+void Planetarium::PlottingCache::Clear() {
+  plotting_frame_generation_ = std::nullopt;
+  degrees_of_freedom_.clear();
+}
+
+void Planetarium::PlottingCache::ForgetBefore(Instant const& time) {
+  degrees_of_freedom_.erase(degrees_of_freedom_.begin(),
+                            degrees_of_freedom_.lower_bound(time));
+}
+
+std::int64_t Planetarium::PlottingCache::size() const {
+  return degrees_of_freedom_.size();
+}
+
+void Planetarium::PlottingCache::Prepare(
+    std::int64_t const plotting_frame_generation,
+    Instant const& first_time,
+    Instant const& last_time) {
+  if (plotting_frame_generation_ != plotting_frame_generation ||
+      degrees_of_freedom_.size() > max_plotting_cache_size) {
+    Clear();
+    plotting_frame_generation_ = plotting_frame_generation;
+  }
+  degrees_of_freedom_.erase(degrees_of_freedom_.begin(),
+                            degrees_of_freedom_.lower_bound(first_time));
+  degrees_of_freedom_.erase(degrees_of_freedom_.upper_bound(last_time),
+                            degrees_of_freedom_.end());
+}
+
 Planetarium::Parameters::Parameters(double const sphere_radius_multiplier,
                                     Angle const& angular_resolution,
                                     Angle const& field_of_view)
@@ -39,11 +74,13 @@ Planetarium::Planetarium(
     Perspective<Navigation, Camera> perspective,
     not_null<Ephemeris<Barycentric> const*> const ephemeris,
     not_null<PlottingFrame const*> const plotting_frame,
+    std::int64_t const plotting_frame_generation,
     PlottingToScaledSpaceConversion plotting_to_scaled_space)
     : parameters_(parameters),
       perspective_(std::move(perspective)),
       ephemeris_(ephemeris),
       plotting_frame_(plotting_frame),
+      plotting_frame_generation_(plotting_frame_generation),
       plotting_to_scaled_space_(std::move(plotting_to_scaled_space)) {}
 
 RP2Lines<Length, Camera> Planetarium::PlotMethod0(
@@ -156,6 +193,40 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     Instant const& now,
     bool const reverse,
     Length* const minimal_distance) const {
+  return PlotMethod2(trajectory,
+                     first_time,
+                     last_time,
+                     now,
+                     reverse,
+                     /*cache=*/nullptr,
+                     minimal_distance);
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    Trajectory<Barycentric> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    Instant const& now,
+    bool const reverse,
+    PlottingCache& cache,
+    Length* const minimal_distance) const {
+  return PlotMethod2(trajectory,
+                     first_time,
+                     last_time,
+                     now,
+                     reverse,
+                     &cache,
+                     minimal_distance);
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    Trajectory<Barycentric> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    Instant const& now,
+    bool const reverse,
+    PlottingCache* const cache,
+    Length* const minimal_distance) const {
   RP2Lines<Length, Camera> lines;
   auto const plottable_spheres = ComputePlottableSpheres(now);
   double const tan²_angular_resolution =
@@ -171,11 +242,28 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   if (direction * (final_time - previous_time) <= Time{}) {
     return lines;
   }
-  SimilarMotion<Barycentric, Navigation> to_plotting_frame_at_t =
-      plotting_frame_->ToThisFrameAtTimeSimilarly(previous_time);
+  std::optional<DegreesOfFreedom<Navigation>> cached_initial_degrees_of_freedom;
+  if (cache != nullptr) {
+    cache->Prepare(plotting_frame_generation_, first_time, last_time);
+    if (auto const it = cache->degrees_of_freedom_.find(previous_time);
+        it != cache->degrees_of_freedom_.end()) {
+      cached_initial_degrees_of_freedom = it->second;
+    }
+  }
+  std::optional<SimilarMotion<Barycentric, Navigation>> to_plotting_frame_at_t;
+  if (!cached_initial_degrees_of_freedom.has_value()) {
+    to_plotting_frame_at_t =
+        plotting_frame_->ToThisFrameAtTimeSimilarly(previous_time);
+  }
   DegreesOfFreedom<Navigation> const initial_degrees_of_freedom =
-      to_plotting_frame_at_t(
-          trajectory.EvaluateDegreesOfFreedom(previous_time));
+      cached_initial_degrees_of_freedom.has_value()
+          ? *cached_initial_degrees_of_freedom
+          : (*to_plotting_frame_at_t)(
+                trajectory.EvaluateDegreesOfFreedom(previous_time));
+  if (cache != nullptr) {
+    cache->degrees_of_freedom_.emplace(previous_time,
+                                       initial_degrees_of_freedom);
+  }
   Position<Navigation> previous_position =
       initial_degrees_of_freedom.position();
   Velocity<Navigation> previous_velocity =
@@ -187,44 +275,73 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   std::optional<DegreesOfFreedom<Barycentric>>
       degrees_of_freedom_in_barycentric;
   Position<Navigation> position;
+  Velocity<Navigation> velocity;
   Square<Length> minimal_squared_distance = Infinity<Square<Length>>;
 
   std::optional<Position<Navigation>> last_endpoint;
 
   int steps_accepted = 0;
-
-  goto estimate_tan²_error;
+  // The first step is attempted with the entire interval, the next ones with
+  // a step size derived from the previous error estimate.
+  bool adjust_Δt = false;
 
   while (steps_accepted < max_plot_method_2_steps &&
          direction * (previous_time - final_time) < Time{}) {
-    do {
-      // One square root because we have squared errors, another one because the
-      // errors are quadratic in time (in other words, two square roots because
-      // the squared errors are quartic in time).
-      // A safety factor prevents catastrophic retries.
-      Δt *= 0.9 * Sqrt(Sqrt(tan²_angular_resolution / estimated_tan²_error));
-    estimate_tan²_error:
-      t = previous_time + Δt;
-      if (direction * (t - final_time) > Time{}) {
-        t = final_time;
-        Δt = t - previous_time;
+    auto const* const cached_point =
+        cache == nullptr ? nullptr
+                         : FarthestCachedPoint(*cache,
+                                               direction,
+                                               previous_time,
+                                               previous_position,
+                                               previous_velocity,
+                                               final_time,
+                                               &estimated_tan²_error);
+    if (cached_point != nullptr) {
+      t = cached_point->first;
+      Δt = t - previous_time;
+      position = cached_point->second.position();
+      velocity = cached_point->second.velocity();
+    } else {
+      do {
+        if (adjust_Δt) {
+          // One square root because we have squared errors, another one
+          // because the errors are quadratic in time (in other words, two
+          // square roots because the squared errors are quartic in time).
+          // A safety factor prevents catastrophic retries.
+          Δt *=
+              0.9 * Sqrt(Sqrt(tan²_angular_resolution / estimated_tan²_error));
+        }
+        adjust_Δt = true;
+        t = previous_time + Δt;
+        if (direction * (t - final_time) > Time{}) {
+          t = final_time;
+          Δt = t - previous_time;
+        }
+        Position<Navigation> const extrapolated_position =
+            previous_position + previous_velocity * Δt;
+        to_plotting_frame_at_t =
+            plotting_frame_->ToThisFrameAtTimeSimilarly(t);
+        degrees_of_freedom_in_barycentric =
+            trajectory.EvaluateDegreesOfFreedom(t);
+        position = to_plotting_frame_at_t->similarity()(
+                       degrees_of_freedom_in_barycentric->position());
+
+        // The quadratic term of the error between the linear interpolation
+        // and the actual function is maximized halfway through the segment,
+        // so it is 1/2 (Δt/2)² f″(t-Δt) = (1/2 Δt² f″(t-Δt)) / 4; the squared
+        // error is thus (1/2 Δt² f″(t-Δt))² / 16.
+        estimated_tan²_error =
+            perspective_.Tan²AngularDistance(extrapolated_position, position) /
+            16;
+      } while (estimated_tan²_error > tan²_angular_resolution);
+      velocity = (*to_plotting_frame_at_t)(*degrees_of_freedom_in_barycentric)
+                     .velocity();
+      if (cache != nullptr) {
+        cache->degrees_of_freedom_.emplace(
+            t, DegreesOfFreedom<Navigation>(position, velocity));
       }
-      Position<Navigation> const extrapolated_position =
-          previous_position + previous_velocity * Δt;
-      to_plotting_frame_at_t = plotting_frame_->ToThisFrameAtTimeSimilarly(t);
-      degrees_of_freedom_in_barycentric =
-          trajectory.EvaluateDegreesOfFreedom(t);
-      position = to_plotting_frame_at_t.similarity()(
-                     degrees_of_freedom_in_barycentric->position());
-
-      // The quadratic term of the error between the linear interpolation and
-      // the actual function is maximized halfway through the segment, so it is
-      // 1/2 (Δt/2)² f″(t-Δt) = (1/2 Δt² f″(t-Δt)) / 4; the squared error is
-      // thus (1/2 Δt² f″(t-Δt))² / 16.
-      estimated_tan²_error =
-          perspective_.Tan²AngularDistance(extrapolated_position, position) /
-          16;
-    } while (estimated_tan²_error > tan²_angular_resolution);
+    }
+    adjust_Δt = true;
     ++steps_accepted;
 
     // TODO(egg): also limit to field of view.
@@ -234,8 +351,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
 
     previous_time = t;
     previous_position = position;
-    previous_velocity =
-        to_plotting_frame_at_t(*degrees_of_freedom_in_barycentric).velocity();
+    previous_velocity = velocity;
 
     if (!segment_behind_focal_plane) {
       continue;
@@ -283,7 +399,104 @@ void Planetarium::PlotMethod3(
       trajectory, begin_time, last_time, now, reverse, add_point, max_points);
 }
 
-std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
+void Planetarium::PlotMethod3(
+    Trajectory<Barycentric> const& trajectory,
+    DiscreteTrajectory<Barycentric>::iterator begin,
+    DiscreteTrajectory<Barycentric>::iterator end,
+    Instant const& now,
+    bool const reverse,
+    std::function<void(ScaledSpacePoint const&)> const& add_point,
+    int const max_points,
+    PlottingCache& cache) const {
+  if (begin == end) {
+    return;
+  }
+  auto last = std::prev(end);
+  auto const begin_time = std::max(begin->time, plotting_frame_->t_min());
+  auto const last_time = std::min(last->time, plotting_frame_->t_max());
+  PlotMethod3(trajectory,
+              begin_time,
+              last_time,
+              now,
+              reverse,
+              add_point,
+              max_points,
+              cache);
+}
+
+void Planetarium::PlotMethod3(std::vector<PlottingRequest> const& requests,
+                              Instant const& now,
+                              ThreadPool<absl::Status>& pool) const {
+  // The trajectories are plotted in parallel.  No locking is needed because
+  // the evaluation of the trajectories and of the plotting frame is
+  // thread-safe and each request writes to its own buffer.
+  CHECK_OK(ParallelFor(
+      pool,
+      /*begin=*/0,
+      /*end=*/requests.size(),
+      [this, &now, &requests](std::int64_t const i) {
+        auto const& request = requests[i];
+        PlotMethod3(*request.trajectory,
+                    request.first_time,
+                    request.last_time,
+                    now,
+                    request.reverse,
+                    request.add_point,
+                    request.max_points,
+                    request.cache,
+                    request.minimal_distance);
+        return absl::OkStatus();
+      }));
+}
+
+std::pair<Instant const, DegreesOfFreedom<Navigation>> const*
+Planetarium::FarthestCachedPoint(
+    PlottingCache const& cache,
+    Sign const direction,
+    Instant const& previous_time,
+    Position<Navigation> const& previous_position,
+    Velocity<Navigation> const& previous_velocity,
+    Instant const& final_time,
+    not_null<double*> const estimated_tan²_error) const {
+  double const tan²_angular_resolution =
+      Pow<2>(parameters_.tan_angular_resolution_);
+  std::pair<Instant const, DegreesOfFreedom<Navigation>> const* farthest =
+      nullptr;
+  auto const& cached_points = cache.degrees_of_freedom_;
+  auto it = cached_points.find(previous_time);
+  CHECK(it != cached_points.end()) << previous_time;
+  for (;;) {
+    if (direction.is_positive()) {
+      ++it;
+      if (it == cached_points.end()) {
+        break;
+      }
+    } else {
+      if (it == cached_points.begin()) {
+        break;
+      }
+      --it;
+    }
+    auto const& [cached_t, cached_degrees_of_freedom_at_t] = *it;
+    if (direction * (cached_t - final_time) > Time{}) {
+      break;
+    }
+    Position<Navigation> const extrapolated_position =
+        previous_position + previous_velocity * (cached_t - previous_time);
+    double const cached_estimated_tan²_error =
+        perspective_.Tan²AngularDistance(
+            extrapolated_position, cached_degrees_of_freedom_at_t.position()) /
+        16;
+    if (cached_estimated_tan²_error > tan²_angular_resolution) {
+      break;
+    }
+    farthest = &*it;
+    *estimated_tan²_error = cached_estimated_tan²_error;
+  }
+  return farthest;
+}
+
+SphereHierarchy<Navigation> Planetarium::ComputePlottableSpheres(
     Instant const& now) const {
   SimilarMotion<Barycentric, Navigation> const similar_motion_at_now =
       plotting_frame_->ToThisFrameAtTimeSimilarly(now);
@@ -305,11 +518,11 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
       plottable_spheres.emplace_back(std::move(plottable_sphere));
     }
   }
-  return plottable_spheres;
+  return perspective_.MakeSphereHierarchy(std::move(plottable_spheres));
 }
 
 Segments<Navigation> Planetarium::ComputePlottableSegments(
-    const std::vector<Sphere<Navigation>>& plottable_spheres,
+    SphereHierarchy<Navigation> const& plottable_spheres,
     DiscreteTrajectory<Barycentric>::iterator const begin,
     DiscreteTrajectory<Barycentric>::iterator const end) const {
   Segments<Navigation> all_segments;
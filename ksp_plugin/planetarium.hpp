@@ -1,13 +1,21 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
 #include <vector>
 
+#include "absl/container/btree_map.h"
+#include "absl/status/status.h"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/instant.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/perspective.hpp"
 #include "geometry/r3_element.hpp"
 #include "geometry/rp2_point.hpp"
+#include "geometry/sign.hpp"
 #include "geometry/space.hpp"
 #include "geometry/sphere.hpp"
 #include "ksp_plugin/frames.hpp"
@@ -24,11 +32,13 @@ namespace _planetarium {
 namespace internal {
 
 using namespace principia::base::_not_null;
+using namespace principia::base::_thread_pool;
 using namespace principia::geometry::_instant;
 using namespace principia::geometry::_orthogonal_map;
 using namespace principia::geometry::_perspective;
 using namespace principia::geometry::_r3_element;
 using namespace principia::geometry::_rp2_point;
+using namespace principia::geometry::_sign;
 using namespace principia::geometry::_space;
 using namespace principia::geometry::_sphere;
 using namespace principia::ksp_plugin::_frames;
@@ -75,15 +85,51 @@ class Planetarium {
     friend class Planetarium;
   };
 
+  // The points of a trajectory in the plotting frame computed by |PlotMethod2|
+  // or |PlotMethod3| for a camera, which may be reused for the next cameras.
+  // A cache is owned by the caller and must only be used with one trajectory.
+  // It is cleared when it is used with another generation of the plotting
+  // frame, but the caller must call |Clear| if the trajectory changes in other
+  // ways than by appending or forgetting points.  This class is not
+  // thread-safe.
+  class PlottingCache final {
+   public:
+    void Clear();
+
+    // Drops the points strictly before |time|, for use when the trajectory
+    // changed before that time.
+    void ForgetBefore(Instant const& time);
+
+    // The number of points in the cache.
+    std::int64_t size() const;
+
+   private:
+    // Prepares the cache for plotting over [|first_time|, |last_time|] in the
+    // plotting frame identified by |plotting_frame_generation|, dropping the
+    // points that are outside of that interval.
+    void Prepare(std::int64_t plotting_frame_generation,
+                 Instant const& first_time,
+                 Instant const& last_time);
+
+    std::optional<std::int64_t> plotting_frame_generation_;
+    absl::btree_map<Instant, DegreesOfFreedom<Navigation>> degrees_of_freedom_;
+
+    friend class Planetarium;
+  };
+
   using PlottingToScaledSpaceConversion =
       std::function<ScaledSpacePoint(Position<Navigation> const&)>;
 
   // TODO(phl): All this Navigation is weird.  Should it be named Plotting?
   // In particular Navigation vs. NavigationFrame is a mess.
+  // The |plotting_frame_generation| identifies the state of the
+  // |plotting_frame| for the purpose of the |PlottingCache|, see
+  // |Renderer::plotting_frame_generation|.
   Planetarium(Parameters const& parameters,
               Perspective<Navigation, Camera> perspective,
               not_null<Ephemeris<Barycentric> const*> ephemeris,
               not_null<PlottingFrame const*> plotting_frame,
+              std::int64_t plotting_frame_generation,
               PlottingToScaledSpaceConversion plotting_to_scaled_space);
 
   // A no-op method that just returns all the points in the trajectory defined
@@ -123,6 +169,20 @@ class Planetarium {
       bool reverse,
       Length* minimal_distance = nullptr) const;
 
+  // The same method, but the points of the trajectory in the plotting frame are
+  // taken from |cache| when they are precise enough for the current camera,
+  // and the points that had to be computed are added to |cache|.  When only
+  // the camera changes, this avoids most of the evaluations of the trajectory
+  // and of the plotting frame.
+  RP2Lines<Length, Camera> PlotMethod2(
+      Trajectory<Barycentric> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      Instant const& now,
+      bool reverse,
+      PlottingCache& cache,
+      Length* minimal_distance = nullptr) const;
+
   // A method similar to PlotMethod2, but which produces a three-dimensional
   // trajectory in scaled space instead of projecting and hiding.
   void PlotMethod3(
@@ -134,6 +194,18 @@ class Planetarium {
       std::function<void(ScaledSpacePoint const&)> const& add_point,
       int max_points) const;
 
+  // The same method, but the points of the trajectory in the plotting frame are
+  // taken from and added to |cache|, as for |PlotMethod2|.
+  void PlotMethod3(
+      Trajectory<Barycentric> const& trajectory,
+      DiscreteTrajectory<Barycentric>::iterator begin,
+      DiscreteTrajectory<Barycentric>::iterator end,
+      Instant const& now,
+      bool reverse,
+      std::function<void(ScaledSpacePoint const&)> const& add_point,
+      int max_points,
+      PlottingCache& cache) const;
+
   // The same method, operating on the |Trajectory| interface for any frame that
   // can be converted to |Navigation|.
   template<typename Frame>
@@ -147,16 +219,91 @@ class Planetarium {
       int max_points,
       Length* minimal_distance = nullptr) const;
 
+  // The same method, with a |cache|.
+  template<typename Frame>
+  void PlotMethod3(
+      Trajectory<Frame> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      Instant const& now,
+      bool reverse,
+      std::function<void(ScaledSpacePoint const&)> const& add_point,
+      int max_points,
+      PlottingCache& cache,
+      Length* minimal_distance = nullptr) const;
+
+  // The arguments of a call to |PlotMethod3| for one of the trajectories
+  // plotted by the batched method below.
+  struct PlottingRequest {
+    not_null<Trajectory<Barycentric> const*> trajectory;
+    Instant first_time;
+    Instant last_time;
+    bool reverse;
+    std::function<void(ScaledSpacePoint const&)> add_point;
+    int max_points;
+    Length* minimal_distance = nullptr;
+    // May be null.  Distinct requests must not share a cache.
+    PlottingCache* cache = nullptr;
+  };
+
+  // Plots the trajectories of the |requests| as if by calling |PlotMethod3| for
+  // each of them, but concurrently on the threads of |pool|.  The |add_point|
+  // functions of different requests may be called concurrently, so each
+  // request must have its own output buffer.  The trajectories must not be
+  // modified until this function returns.
+  void PlotMethod3(std::vector<PlottingRequest> const& requests,
+                   Instant const& now,
+                   ThreadPool<absl::Status>& pool) const;
+
  private:
   // Computes the coordinates of the spheres that represent the |ephemeris_|
-  // bodies.  These coordinates are in the |plotting_frame_| at time |now|.
-  std::vector<Sphere<Navigation>> ComputePlottableSpheres(
+  // bodies.  These coordinates are in the |plotting_frame_| at time |now|.  The
+  // spheres are organized in a hierarchy so that each segment is only tested
+  // against the spheres that may hide it.
+  SphereHierarchy<Navigation> ComputePlottableSpheres(
       Instant const& now) const;
 
+  // The implementation of the above methods, |cache| may be null.
+  RP2Lines<Length, Camera> PlotMethod2(
+      Trajectory<Barycentric> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      Instant const& now,
+      bool reverse,
+      PlottingCache* cache,
+      Length* minimal_distance) const;
+
+  // The implementation of the above methods, |cache| may be null.
+  template<typename Frame>
+  void PlotMethod3(
+      Trajectory<Frame> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      Instant const& now,
+      bool reverse,
+      std::function<void(ScaledSpacePoint const&)> const& add_point,
+      int max_points,
+      PlottingCache* cache,
+      Length* minimal_distance) const;
+
+  // Returns the farthest point of |cache| that may be reached in one step from
+  // |previous_time| in the given |direction| without going past |final_time|,
+  // stopping at the first point that is not precise enough.  Sets
+  // |estimated_tan²_error| to the error of that step.  Returns null if no
+  // cached point may be reached.
+  std::pair<Instant const, DegreesOfFreedom<Navigation>> const*
+  FarthestCachedPoint(PlottingCache const& cache,
+                      Sign direction,
+                      Instant const& previous_time,
+                      Position<Navigation> const& previous_position,
+                      Velocity<Navigation> const& previous_velocity,
+                      Instant const& final_time,
+                      not_null<double*> estimated_tan²_error) const;
+
   // Computes the segments of the trajectory defined by |begin| and |end| that
   // are not hidden by the |plottable_spheres|.
   Segments<Navigation> ComputePlottableSegments(
-      const std::vector<Sphere<Navigation>>& plottable_spheres,
+      SphereHierarchy<Navigation> const& plottable_spheres,
       DiscreteTrajectory<Barycentric>::iterator begin,
       DiscreteTrajectory<Barycentric>::iterator end) const;
 
@@ -164,6 +311,7 @@ class Planetarium {
   Perspective<Navigation, Camera> const perspective_;
   not_null<Ephemeris<Barycentric> const*> const ephemeris_;
   not_null<PlottingFrame const*> const plotting_frame_;
+  std::int64_t const plotting_frame_generation_;
   PlottingToScaledSpaceConversion plotting_to_scaled_space_;
 };
 
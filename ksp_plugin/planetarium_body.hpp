@@ -3,6 +3,7 @@
 #include "ksp_plugin/planetarium.hpp"
 
 #include <algorithm>
+#include <optional>
 
 #include "geometry/sign.hpp"
 #include "physics/similar_motion.hpp"
@@ -58,6 +59,50 @@ void Planetarium::PlotMethod3(
     std::function<void(ScaledSpacePoint const&)> const& add_point,
     int const max_points,
     Length* const minimal_distance) const {
+  PlotMethod3(trajectory,
+              first_time,
+              last_time,
+              now,
+              reverse,
+              add_point,
+              max_points,
+              /*cache=*/nullptr,
+              minimal_distance);
+}
+
+template<typename Frame>
+void Planetarium::PlotMethod3(
+    Trajectory<Frame> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    Instant const& now,
+    bool const reverse,
+    std::function<void(ScaledSpacePoint const&)> const& add_point,
+    int const max_points,
+    PlottingCache& cache,
+    Length* const minimal_distance) const {
+  PlotMethod3(trajectory,
+              first_time,
+              last_time,
+              now,
+              reverse,
+              add_point,
+              max_points,
+              &cache,
+              minimal_distance);
+}
+
+template<typename Frame>
+void Planetarium::PlotMethod3(
+    Trajectory<Frame> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    Instant const& now,
+    bool const reverse,
+    std::function<void(ScaledSpacePoint const&)> const& add_point,
+    int const max_points,
+    PlottingCache* const cache,
+    Length* const minimal_distance) const {
   double const tan²_angular_resolution =
       Pow<2>(parameters_.tan_angular_resolution_);
   auto const final_time = reverse ? first_time : last_time;
@@ -71,13 +116,26 @@ void Planetarium::PlotMethod3(
   if (direction * (final_time - previous_time) <= Time{}) {
     return;
   }
-  DegreesOfFreedom<Navigation> const initial_degrees_of_freedom =
-      EvaluateDegreesOfFreedomInNavigation<Frame>(
-          *plotting_frame_, trajectory, previous_time);
+  std::optional<DegreesOfFreedom<Navigation>> initial_degrees_of_freedom;
+  if (cache != nullptr) {
+    cache->Prepare(plotting_frame_generation_, first_time, last_time);
+    if (auto const it = cache->degrees_of_freedom_.find(previous_time);
+        it != cache->degrees_of_freedom_.end()) {
+      initial_degrees_of_freedom = it->second;
+    }
+  }
+  if (!initial_degrees_of_freedom.has_value()) {
+    initial_degrees_of_freedom = EvaluateDegreesOfFreedomInNavigation<Frame>(
+        *plotting_frame_, trajectory, previous_time);
+    if (cache != nullptr) {
+      cache->degrees_of_freedom_.emplace(previous_time,
+                                         *initial_degrees_of_freedom);
+    }
+  }
   Position<Navigation> previous_position =
-      initial_degrees_of_freedom.position();
+      initial_degrees_of_freedom->position();
   Velocity<Navigation> previous_velocity =
-      initial_degrees_of_freedom.velocity();
+      initial_degrees_of_freedom->velocity();
   Time Δt = final_time - previous_time;
 
   add_point(plotting_to_scaled_space_(previous_position));
@@ -89,36 +147,61 @@ void Planetarium::PlotMethod3(
   Position<Navigation> position;
   Square<Length> minimal_squared_distance = Infinity<Square<Length>>;
 
-  goto estimate_tan²_error;
+  // The first step is attempted with the entire interval, the next ones with
+  // a step size derived from the previous error estimate.
+  bool adjust_Δt = false;
 
   while (points_added < max_points &&
          direction * (previous_time - final_time) < Time{}) {
-    do {
-      // One square root because we have squared errors, another one because the
-      // errors are quadratic in time (in other words, two square roots because
-      // the squared errors are quartic in time).
-      // A safety factor prevents catastrophic retries.
-      Δt *= 0.9 * Sqrt(Sqrt(tan²_angular_resolution / estimated_tan²_error));
-    estimate_tan²_error:
-      t = previous_time + Δt;
-      if (direction * (t - final_time) > Time{}) {
-        t = final_time;
-        Δt = t - previous_time;
-      }
-      Position<Navigation> const extrapolated_position =
-          previous_position + previous_velocity * Δt;
-      degrees_of_freedom = EvaluateDegreesOfFreedomInNavigation<Frame>(
-          *plotting_frame_, trajectory, t);
+    auto const* const cached_point =
+        cache == nullptr ? nullptr
+                         : FarthestCachedPoint(*cache,
+                                               direction,
+                                               previous_time,
+                                               previous_position,
+                                               previous_velocity,
+                                               final_time,
+                                               &estimated_tan²_error);
+    if (cached_point != nullptr) {
+      t = cached_point->first;
+      Δt = t - previous_time;
+      degrees_of_freedom = cached_point->second;
       position = degrees_of_freedom->position();
-
-      // The quadratic term of the error between the linear interpolation and
-      // the actual function is maximized halfway through the segment, so it is
-      // 1/2 (Δt/2)² f″(t-Δt) = (1/2 Δt² f″(t-Δt)) / 4; the squared error is
-      // thus (1/2 Δt² f″(t-Δt))² / 16.
-      estimated_tan²_error =
-          perspective_.Tan²AngularDistance(extrapolated_position, position) /
-          16;
-    } while (estimated_tan²_error > tan²_angular_resolution);
+    } else {
+      do {
+        if (adjust_Δt) {
+          // One square root because we have squared errors, another one
+          // because the errors are quadratic in time (in other words, two
+          // square roots because the squared errors are quartic in time).
+          // A safety factor prevents catastrophic retries.
+          Δt *=
+              0.9 * Sqrt(Sqrt(tan²_angular_resolution / estimated_tan²_error));
+        }
+        adjust_Δt = true;
+        t = previous_time + Δt;
+        if (direction * (t - final_time) > Time{}) {
+          t = final_time;
+          Δt = t - previous_time;
+        }
+        Position<Navigation> const extrapolated_position =
+            previous_position + previous_velocity * Δt;
+        degrees_of_freedom = EvaluateDegreesOfFreedomInNavigation<Frame>(
+            *plotting_frame_, trajectory, t);
+        position = degrees_of_freedom->position();
+
+        // The quadratic term of the error between the linear interpolation
+        // and the actual function is maximized halfway through the segment,
+        // so it is 1/2 (Δt/2)² f″(t-Δt) = (1/2 Δt² f″(t-Δt)) / 4; the squared
+        // error is thus (1/2 Δt² f″(t-Δt))² / 16.
+        estimated_tan²_error =
+            perspective_.Tan²AngularDistance(extrapolated_position, position) /
+            16;
+      } while (estimated_tan²_error > tan²_angular_resolution);
+      if (cache != nullptr) {
+        cache->degrees_of_freedom_.emplace(t, *degrees_of_freedom);
+      }
+    }
+    adjust_Δt = true;
 
     previous_time = t;
     previous_position = position;
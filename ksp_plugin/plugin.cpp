@@ -13,6 +13,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "base/flags.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/map_util.hpp"
+#include "base/parallel_for.hpp"
 #include "base/serialization.hpp"
 #include "geometry/barycentre_calculator.hpp"
 #include "geometry/frame.hpp"
@@ -65,6 +67,7 @@ using namespace principia::base::_fingerprint2011;
 using namespace principia::base::_flags;
 using namespace principia::base::_hexadecimal;
 using namespace principia::base::_map_util;
+using namespace principia::base::_parallel_for;
 using namespace principia::base::_serialization;
 using namespace principia::geometry::_barycentre_calculator;
 using namespace principia::geometry::_frame;
@@ -794,13 +797,18 @@ void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
     WaitForVesselToCatchUp(pile_up_future, collided_vessels);
   }
 
-  // Update the vessels.
+  // Update the vessels.  The loaded vessels were caught up by |CatchUpVessel|,
+  // so the lagging ones are not being looked at.  If their history is still
+  // held lazily, don't deserialize it, it will catch up when a caller needs it.
+  // The collided vessels need their history to disable downsampling.
   for (auto const& [_, vessel] : vessels_) {
-    if (vessel->psychohistory()->back().time < current_time_) {
+    if (vessel->psychohistory_t_max() < current_time_) {
       if (Contains(collided_vessels, vessel.get())) {
         vessel->DisableDownsampling();
+        vessel->AdvanceTime();
+      } else {
+        vessel->AdvanceTimeLazily();
       }
-      vessel->AdvanceTime();
     }
   }
 }
@@ -919,7 +927,7 @@ void Plugin::SetPredictionAdaptiveStepParameters(
       prediction_adaptive_step_parameters);
 }
 
-void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) const {
+void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) {
   CHECK(!initializing_);
   std::set<not_null<Vessel*>> predicted_vessels;
   for (auto const& guid : vessel_guids) {
@@ -927,19 +935,42 @@ void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) const {
   }
   Vessel* target_vessel = nullptr;
 
+  // The vessels are independent, so their predictions are refreshed in
+  // parallel.  In synchronous mode the prognostications are computed on this
+  // thread, and they are flowed as an ensemble to share the evaluations of the
+  // ephemeris.
+  std::vector<not_null<Vessel*>> const vessels(predicted_vessels.begin(),
+                                               predicted_vessels.end());
+
   // If there is a target vessel, ensure that the prediction of the
   // |predicted_vessels| is not longer than that of the target vessel.  This is
   // necessary to build the targeting frame.
   if (renderer_->HasTargetVessel()) {
     target_vessel = &renderer_->GetTargetVessel();
     target_vessel->RefreshPrediction();
-    for (auto const vessel : predicted_vessels) {
-      vessel->RefreshPrediction(target_vessel->prediction()->back().time);
+    Instant const target_final_time = target_vessel->prediction()->back().time;
+    if (Vessel::synchronous()) {
+      Vessel::RefreshPredictions(vessels, target_final_time);
+    } else {
+      CHECK_OK(ParallelFor(
+          vessel_thread_pool_,
+          /*begin=*/0,
+          /*end=*/vessels.size(),
+          [&vessels, &target_final_time](std::int64_t const i) {
+            vessels[i]->RefreshPrediction(target_final_time);
+            return absl::OkStatus();
+          }));
     }
+  } else if (Vessel::synchronous()) {
+    Vessel::RefreshPredictions(vessels);
   } else {
-    for (auto const vessel : predicted_vessels) {
-      vessel->RefreshPrediction();
-    }
+    CHECK_OK(ParallelFor(vessel_thread_pool_,
+                         /*begin=*/0,
+                         /*end=*/vessels.size(),
+                         [&vessels](std::int64_t const i) {
+                           vessels[i]->RefreshPrediction();
+                           return absl::OkStatus();
+                         }));
   }
   for (auto const& [guid, vessel] : vessels_) {
     if (!Contains(predicted_vessels, vessel.get()) &&
@@ -1025,8 +1056,9 @@ Plugin::ComputeAndRenderFirstCollision(
     DiscreteTrajectory<Barycentric>::iterator const& end,
     Position<World> const& sun_world_position,
     int max_points,
-    std::function<Length(Angle const& latitude,
-                         Angle const& longitude)> const& radius) const {
+    std::function<std::vector<Length>(
+        std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes)>
+        const& radii) const {
   auto const& celestial = FindOrDie(celestials_, celestial_index);
   auto const& celestial_body = *celestial->body();
   auto const& celestial_trajectory = celestial->trajectory();
@@ -1048,6 +1080,20 @@ Plugin::ComputeAndRenderFirstCollision(
                                                    apoapsides_trajectory,
                                                    periapsides_trajectory);
 
+  // The error budget is split between the interpolation of the radii by the
+  // cache of the celestial and the search of the collision, so that their
+  // errors don't add up to more than |MaxCollisionError()|.
+  Length const max_collision_error = MaxCollisionError() / 2;
+  Length const max_terrain_radius_error = MaxCollisionError() / 2;
+  auto& terrain_radius_cache = celestial->terrain_radius_cache();
+  std::function<std::vector<Length>(
+      std::vector<std::tuple<Angle, Angle>> const&)> const cached_radii =
+      [max_terrain_radius_error, &radii, &terrain_radius_cache](
+          std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes) {
+        return terrain_radius_cache.Radii(
+            latitudes_longitudes, max_terrain_radius_error, radii);
+      };
+
   VLOG(1) << "Found " << intervals.size() << " collision intervals";
   for (auto const& interval : intervals) {
     VLOG(1) << "Collision interval: " << interval;
@@ -1055,8 +1101,8 @@ Plugin::ComputeAndRenderFirstCollision(
                                                        celestial_trajectory,
                                                        trajectory,
                                                        interval,
-                                                       MaxCollisionError(),
-                                                       radius);
+                                                       max_collision_error,
+                                                       cached_radii);
     if (maybe_collision.has_value()) {
       auto const& collision = maybe_collision.value();
 
@@ -1190,11 +1236,13 @@ not_null<std::unique_ptr<Planetarium>> Plugin::NewPlanetarium(
     std::function<ScaledSpacePoint(Position<Navigation> const&)>
         plotting_to_scaled_space)
     const {
-  return make_not_null_unique<Planetarium>(parameters,
-                                           perspective,
-                                           ephemeris_.get(),
-                                           renderer_->GetPlottingFrame(),
-                                           std::move(plotting_to_scaled_space));
+  return make_not_null_unique<Planetarium>(
+      parameters,
+      perspective,
+      ephemeris_.get(),
+      renderer_->GetPlottingFrame(),
+      renderer_->plotting_frame_generation(),
+      std::move(plotting_to_scaled_space));
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
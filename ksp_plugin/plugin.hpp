@@ -8,6 +8,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -346,7 +347,7 @@ class Plugin {
           prediction_adaptive_step_parameters) const;
 
   // Updates the prediction for the vessels with guids in |vessel_guids|.
-  void UpdatePrediction(std::vector<GUID> const& vessel_guids) const;
+  void UpdatePrediction(std::vector<GUID> const& vessel_guids);
 
   virtual void CreateFlightPlan(GUID const& vessel_guid,
                                 Instant const& final_time,
@@ -369,7 +370,8 @@ class Plugin {
       DiscreteTrajectory<World>& periapsides) const;
 
   // Computes the first collision between the trajectory defined by |begin| and
-  // |end| and the celestial with index |celestial_index|.
+  // |end| and the celestial with index |celestial_index|.  |radii| returns the
+  // radii of the celestial at a batch of latitudes and longitudes.
   virtual std::optional<DiscreteTrajectory<World>::value_type>
   ComputeAndRenderFirstCollision(
       Index celestial_index,
@@ -378,8 +380,9 @@ class Plugin {
       DiscreteTrajectory<Barycentric>::iterator const& end,
       Position<World> const& sun_world_position,
       int max_points,
-      std::function<Length(Angle const& latitude,
-                           Angle const& longitude)> const& radius) const;
+      std::function<std::vector<Length>(
+          std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes)>
+          const& radii) const;
 
   // Computes the closest approaches of the trajectory defined by |begin| and
   // |end| with respect to the trajectory of the targetted vessel.
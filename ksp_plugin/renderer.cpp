@@ -30,6 +30,7 @@ Renderer::Renderer(not_null<Celestial const*> const sun,
 void Renderer::SetPlottingFrame(
     not_null<std::unique_ptr<PlottingFrame>> plotting_frame) {
   plotting_frame_ = std::move(plotting_frame);
+  ++plotting_frame_generation_;
 }
 
 not_null<PlottingFrame const*> Renderer::GetPlottingFrame() const {
@@ -37,6 +38,18 @@ not_null<PlottingFrame const*> Renderer::GetPlottingFrame() const {
                  : plotting_frame_.get();
 }
 
+std::int64_t Renderer::plotting_frame_generation() const {
+  if (target_) {
+    std::int64_t const prediction_generation =
+        target_->vessel->prediction_generation();
+    if (target_->prediction_generation != prediction_generation) {
+      target_->prediction_generation = prediction_generation;
+      ++plotting_frame_generation_;
+    }
+  }
+  return plotting_frame_generation_;
+}
+
 void Renderer::SetTargetVessel(
     not_null<Vessel*> const vessel,
     not_null<Celestial const*> const celestial,
@@ -45,16 +58,21 @@ void Renderer::SetTargetVessel(
       target_->vessel != vessel ||
       target_->celestial != celestial) {
     target_.emplace(vessel, celestial, ephemeris);
+    ++plotting_frame_generation_;
   }
 }
 
 void Renderer::ClearTargetVessel() {
-  target_ = std::nullopt;
+  if (target_) {
+    target_ = std::nullopt;
+    ++plotting_frame_generation_;
+  }
 }
 
 void Renderer::ClearTargetVesselIf(not_null<Vessel*> const vessel) {
   if (target_ && target_->vessel == vessel) {
     target_ = std::nullopt;
+    ++plotting_frame_generation_;
   }
 }
 
@@ -327,7 +345,8 @@ Renderer::Target::Target(
               BodyCentredBodyDirectionReferenceFrame<Barycentric, Navigation>>(
               ephemeris,
               [this]() -> auto& { return *this->vessel->prediction(); },
-              celestial->body())) {}
+              celestial->body())),
+      prediction_generation(vessel->prediction_generation()) {}
 
 }  // namespace internal
 }  // namespace _renderer
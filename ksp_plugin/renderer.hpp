@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -62,6 +63,13 @@ class Renderer {
   // |SetPlottingFrame| if it is overridden by a target vessel.
   virtual not_null<PlottingFrame const*> GetPlottingFrame() const;
 
+  // Returns a number that changes whenever the frame returned by
+  // |GetPlottingFrame| changes, either because it is replaced or because the
+  // prediction of the target vessel that defines it is replaced.  Computations
+  // in the plotting frame must be cached under this number, not under the
+  // address of the frame, which doesn't change with the target prediction.
+  virtual std::int64_t plotting_frame_generation() const;
+
   // Overrides the current plotting frame with one that is centred on the given
   // |vessel|.
   virtual void SetTargetVessel(
@@ -192,6 +200,9 @@ class Renderer {
     not_null<Vessel*> const vessel;
     not_null<Celestial const*> const celestial;
     not_null<std::unique_ptr<PlottingFrame>> const target_frame;
+    // The |prediction_generation| of the |vessel| when the
+    // |plotting_frame_generation_| was last incremented.
+    mutable std::int64_t prediction_generation;
   };
 
   not_null<Celestial const*> const sun_;
@@ -199,6 +210,10 @@ class Renderer {
   not_null<std::unique_ptr<PlottingFrame>> plotting_frame_;
 
   std::optional<Target> target_;
+
+  // Incremented when the plotting frame changes, lazily in the case of a change
+  // of the target prediction.
+  mutable std::int64_t plotting_frame_generation_ = 0;
 };
 
 }  // namespace internal
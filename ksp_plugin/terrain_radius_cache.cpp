@@ -0,0 +1,220 @@
+#include "ksp_plugin/terrain_radius_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include "absl/container/flat_hash_set.h"
+#include "glog/logging.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"  // 🧙 For π.
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace _terrain_radius_cache {
+namespace internal {
+
+using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_si;
+
+// The cells at level 0 are 45° × 45°.
+constexpr int longitude_root_cells = 8;
+constexpr int latitude_root_cells = 4;
+constexpr Angle root_cell_size = π / 4 * Radian;
+
+std::vector<Length> TerrainRadiusCache::Radii(
+    std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes,
+    Length const& tolerance,
+    BatchedRadii const& radii) {
+  std::vector<Length> result(latitudes_longitudes.size());
+
+  // The points for which we must call |radii|, and what to do with the radii
+  // that we get: either return them as the radius of the point at index
+  // |point| or store them as the sample |sample_key|.
+  struct Request {
+    std::optional<std::int64_t> point;
+    std::optional<std::int64_t> sample_key;
+  };
+  std::vector<std::tuple<Angle, Angle>> requested_latitudes_longitudes;
+  std::vector<Request> requests;
+  absl::flat_hash_set<std::int64_t> requested_sample_keys;
+  // The cells that will be fully sampled once |radii| has returned.
+  std::vector<std::tuple<std::int64_t, std::array<std::int64_t, 9>>> new_cells;
+
+  {
+    absl::ReaderMutexLock l(&lock_);
+    for (std::int64_t k = 0; k < latitudes_longitudes.size(); ++k) {
+      auto const& [latitude, longitude] = latitudes_longitudes[k];
+      GridCoordinates const grid = ToGridCoordinates(latitude, longitude);
+
+      bool hit = false;
+      // A cell is only used if its parent is also estimated to be within the
+      // tolerance, which catches some of the relief that the samples of a
+      // single cell miss.
+      bool parent_within_tolerance = false;
+      for (int level = min_level; level <= max_level; ++level) {
+        double const cell_size = 1 << (sample_level - level);
+        double const u = grid.longitude / cell_size;
+        double const v = grid.latitude / cell_size;
+        std::int64_t const i = std::min<std::int64_t>(
+            u, (longitude_root_cells << level) - 1);
+        std::int64_t const j = std::min<std::int64_t>(
+            v, (latitude_root_cells << level) - 1);
+        std::int64_t const cell_key = CellKey(level, i, j);
+        auto const sample_keys = SampleKeys(level, i, j);
+
+        auto const it = cell_errors_.find(cell_key);
+        if (it == cell_errors_.end()) {
+          // Sample this cell, it may be good enough for the next call.
+          for (std::int64_t const sample_key : sample_keys) {
+            if (!samples_.contains(sample_key) &&
+                requested_sample_keys.insert(sample_key).second) {
+              requested_latitudes_longitudes.push_back(
+                  LatitudeLongitude(sample_key));
+              requests.push_back({.sample_key = sample_key});
+            }
+          }
+          new_cells.emplace_back(cell_key, sample_keys);
+          break;
+        } else if (it->second <= tolerance && parent_within_tolerance) {
+          // Bilinear interpolation.
+          double const s = std::clamp(u - i, 0.0, 1.0);
+          double const t = std::clamp(v - j, 0.0, 1.0);
+          result[k] = (1 - s) * (1 - t) * samples_.at(sample_keys[0]) +
+                      s * (1 - t) * samples_.at(sample_keys[1]) +
+                      (1 - s) * t * samples_.at(sample_keys[2]) +
+                      s * t * samples_.at(sample_keys[3]);
+          hit = true;
+          break;
+        }
+        parent_within_tolerance = it->second <= tolerance;
+      }
+      if (!hit) {
+        requested_latitudes_longitudes.push_back(latitudes_longitudes[k]);
+        requests.push_back({.point = k});
+      }
+    }
+  }
+
+  if (requests.empty()) {
+    return result;
+  }
+
+  std::vector<Length> const requested_radii =
+      radii(requested_latitudes_longitudes);
+  CHECK_EQ(requests.size(), requested_radii.size());
+
+  absl::MutexLock l(&lock_);
+  for (std::int64_t r = 0; r < requests.size(); ++r) {
+    auto const& [point, sample_key] = requests[r];
+    if (point.has_value()) {
+      result[*point] = requested_radii[r];
+    } else {
+      samples_[*sample_key] = requested_radii[r];
+    }
+  }
+
+  for (auto const& [cell_key, sample_keys] : new_cells) {
+    // Some samples may be missing if another thread cleared the cache while we
+    // were calling |radii|.
+    std::array<Length, 9> cell_samples;
+    bool complete = true;
+    for (int s = 0; s < sample_keys.size(); ++s) {
+      auto const it = samples_.find(sample_keys[s]);
+      if (it == samples_.end()) {
+        complete = false;
+        break;
+      }
+      cell_samples[s] = it->second;
+    }
+    if (complete) {
+      // The bilinear interpolation at the centre and at the midpoints of the
+      // edges.
+      std::array<Length, 5> const interpolated_samples = {
+          (cell_samples[0] + cell_samples[1] +
+           cell_samples[2] + cell_samples[3]) / 4,
+          (cell_samples[0] + cell_samples[1]) / 2,
+          (cell_samples[0] + cell_samples[2]) / 2,
+          (cell_samples[1] + cell_samples[3]) / 2,
+          (cell_samples[2] + cell_samples[3]) / 2};
+      Length error;
+      for (int s = 0; s < interpolated_samples.size(); ++s) {
+        error = std::max(error,
+                         Abs(cell_samples[4 + s] - interpolated_samples[s]));
+      }
+      cell_errors_[cell_key] = error;
+    }
+  }
+
+  if (samples_.size() > max_samples) {
+    LOG(INFO) << "Clearing terrain radius cache with " << samples_.size()
+              << " samples";
+    samples_.clear();
+    cell_errors_.clear();
+  }
+
+  return result;
+}
+
+std::int64_t TerrainRadiusCache::number_of_samples() const {
+  absl::ReaderMutexLock l(&lock_);
+  return samples_.size();
+}
+
+TerrainRadiusCache::GridCoordinates TerrainRadiusCache::ToGridCoordinates(
+    Angle const& latitude,
+    Angle const& longitude) {
+  double const grid_cell_size = root_cell_size / Radian / (1 << sample_level);
+  Angle const positive_longitude = Mod(longitude, 2 * π * Radian);
+  return {.longitude = positive_longitude / Radian / grid_cell_size,
+          .latitude = std::clamp(latitude / Radian + π / 2, 0.0, π) /
+                      grid_cell_size};
+}
+
+std::int64_t TerrainRadiusCache::SampleKey(std::int64_t const i,
+                                           std::int64_t const j) {
+  return (i << 32) | j;
+}
+
+std::int64_t TerrainRadiusCache::CellKey(int const level,
+                                         std::int64_t const i,
+                                         std::int64_t const j) {
+  return (static_cast<std::int64_t>(level) << 48) | (i << 24) | j;
+}
+
+std::array<std::int64_t, 9> TerrainRadiusCache::SampleKeys(
+    int const level,
+    std::int64_t const i,
+    std::int64_t const j) {
+  int const shift = sample_level - level;
+  std::int64_t const longitude_samples =
+      static_cast<std::int64_t>(longitude_root_cells) << sample_level;
+  std::int64_t const i₀ = i << shift;
+  std::int64_t const i₁ = ((i + 1) << shift) % longitude_samples;
+  std::int64_t const j₀ = j << shift;
+  std::int64_t const j₁ = (j + 1) << shift;
+  std::int64_t const half = std::int64_t{1} << (shift - 1);
+  return {SampleKey(i₀, j₀),
+          SampleKey(i₁, j₀),
+          SampleKey(i₀, j₁),
+          SampleKey(i₁, j₁),
+          SampleKey(i₀ + half, j₀ + half),
+          SampleKey(i₀ + half, j₀),
+          SampleKey(i₀, j₀ + half),
+          SampleKey(i₁, j₀ + half),
+          SampleKey(i₀ + half, j₁)};
+}
+
+std::tuple<Angle, Angle> TerrainRadiusCache::LatitudeLongitude(
+    std::int64_t const sample_key) {
+  Angle const grid_cell_size = root_cell_size / (1 << sample_level);
+  std::int64_t const i = sample_key >> 32;
+  std::int64_t const j = sample_key & 0xFFFF'FFFF;
+  return {j * grid_cell_size - π / 2 * Radian, i * grid_cell_size};
+}
+
+}  // namespace internal
+}  // namespace _terrain_radius_cache
+}  // namespace ksp_plugin
+}  // namespace principia
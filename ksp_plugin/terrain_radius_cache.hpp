@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace _terrain_radius_cache {
+namespace internal {
+
+using namespace principia::quantities::_quantities;
+
+// A cache of the radius of the terrain of a celestial, as a function of the
+// latitude and longitude in the surface frame.  The surface is covered by a
+// quadtree of cells, starting with cells of 45° × 45° and halving their size at
+// each level.  The cells above |min_level| are too large to see the relief and
+// are never sampled.  The radius in a cell is obtained by bilinear
+// interpolation between its corners.  The radius is also sampled at the centre
+// and at the midpoints of the edges of the cell, i.e., at the corners of its
+// children, and the largest difference between the interpolated and the
+// sampled radii at these points is used as an estimate of the interpolation
+// error in the cell.  A cell is only used for interpolation if the estimated
+// errors of the cell and of its parent are both below the tolerance, so the
+// cells at |min_level| only serve as parents.  The estimate is still not a
+// bound: a feature of the terrain that falls between the samples of two levels
+// may be missed, in which case the radius may be underestimated by more than
+// the tolerance.  Samples are shared between adjacent cells and between
+// levels.
+// This class is thread-safe.
+class TerrainRadiusCache {
+ public:
+  // Returns the radii of the celestial at the given latitudes and longitudes,
+  // in the same order.  Must be deterministic.
+  using BatchedRadii = std::function<std::vector<Length>(
+      std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes)>;
+
+  TerrainRadiusCache() = default;
+
+  // Returns the radii at |latitudes_longitudes|.  A radius is interpolated in
+  // the largest cell that contains its point and that, together with its
+  // parent, has an estimated error below |tolerance|, if that cell and all the
+  // larger ones that contain the point are in the cache.  The caller must
+  // account for |tolerance| in its own error budget.  Otherwise the radius is
+  // obtained from |radii|, and the first cell containing the point that is not
+  // in the cache is sampled so that subsequent calls may hit the cache.
+  // |radii| is called at most once.
+  std::vector<Length> Radii(
+      std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes,
+      Length const& tolerance,
+      BatchedRadii const& radii);
+
+  // The number of radii sampled by the cache.
+  std::int64_t number_of_samples() const;
+
+ private:
+  // The position of a point in units of the cells at |sample_level|.
+  struct GridCoordinates {
+    double longitude;
+    double latitude;
+  };
+
+  static GridCoordinates ToGridCoordinates(Angle const& latitude,
+                                           Angle const& longitude);
+
+  // A sample is identified by its integer coordinates at |sample_level|, a
+  // cell by its level and its integer coordinates at that level.
+  static std::int64_t SampleKey(std::int64_t i, std::int64_t j);
+  static std::int64_t CellKey(int level, std::int64_t i, std::int64_t j);
+
+  // The keys of the samples of the cell at |level| with coordinates |i|, |j|:
+  // the corners in the order (0, 0), (1, 0), (0, 1), (1, 1), followed by the
+  // centre, followed by the midpoints of the edges in the order (½, 0),
+  // (0, ½), (1, ½), (½, 1).
+  static std::array<std::int64_t, 9> SampleKeys(int level,
+                                                std::int64_t i,
+                                                std::int64_t j);
+
+  static std::tuple<Angle, Angle> LatitudeLongitude(std::int64_t sample_key);
+
+  // The minimum and maximum levels of a cell.  The centres of the cells at the
+  // maximum level are on the grid of |sample_level|.
+  static constexpr int min_level = 4;
+  static constexpr int max_level = 20;
+  static constexpr int sample_level = max_level + 1;
+
+  // Above this number of samples the cache is cleared to bound its memory
+  // usage.
+  static constexpr std::int64_t max_samples = 1 << 20;
+
+  mutable absl::Mutex lock_;
+  absl::flat_hash_map<std::int64_t, Length> samples_ GUARDED_BY(lock_);
+  // The estimated interpolation error of the cells that have been sampled.
+  absl::flat_hash_map<std::int64_t, Length> cell_errors_ GUARDED_BY(lock_);
+};
+
+}  // namespace internal
+
+using internal::TerrainRadiusCache;
+
+}  // namespace _terrain_radius_cache
+}  // namespace ksp_plugin
+}  // namespace principia
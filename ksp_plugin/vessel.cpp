@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -31,6 +32,33 @@ using namespace std::chrono_literals;
 
 // TODO(phl): Move this to some kind of parameters.
 constexpr std::int64_t max_points_to_serialize = 20'000;
+// The maximum number of points that |AdvanceTimeLazily| leaves in the history
+// of each part.  These points are not downsampled.
+constexpr std::int64_t max_deferred_points = 1'000;
+
+// Returns the times of the first and last points of the trajectory serialized
+// in |message| without decompressing it, or nullopt if it is empty.  This
+// relies on the extremities of the segments being serialized exactly.
+std::optional<std::pair<Instant, Instant>> SerializedTimeRange(
+    serialization::DiscreteTrajectory const& message) {
+  std::optional<Instant> t_min;
+  std::optional<Instant> t_max;
+  for (auto const& segment : message.segment()) {
+    if (segment.exact_size() > 0) {
+      Instant const first =
+          Instant::ReadFromMessage(segment.exact(0).instant());
+      Instant const last = Instant::ReadFromMessage(
+          segment.exact(segment.exact_size() - 1).instant());
+      t_min = t_min.has_value() ? std::min(*t_min, first) : first;
+      t_max = t_max.has_value() ? std::max(*t_max, last) : last;
+    }
+  }
+  if (t_min.has_value()) {
+    return std::pair{*t_min, *t_max};
+  } else {
+    return std::nullopt;
+  }
+}
 
 bool operator!=(Vessel::PrognosticatorParameters const& left,
                 Vessel::PrognosticatorParameters const& right) {
@@ -118,12 +146,14 @@ void Vessel::set_parent(not_null<Celestial const*> const parent) {
 }
 
 void Vessel::AddPart(not_null<std::unique_ptr<Part>> part) {
+  ReadHistoryFromMessageIfPointsDeferred();
   LOG(INFO) << "Adding part " << part->ShortDebugString() << " to vessel "
             << ShortDebugString();
   parts_.emplace(part->part_id(), std::move(part));
 }
 
 not_null<std::unique_ptr<Part>> Vessel::ExtractPart(PartId const id) {
+  ReadHistoryFromMessageIfPointsDeferred();
   CHECK_LE(kept_parts_.size(), parts_.size());
   auto const it = parts_.find(id);
   CHECK(it != parts_.end()) << id;
@@ -147,6 +177,9 @@ bool Vessel::WillKeepPart(PartId const id) const {
 
 void Vessel::FreeParts() {
   CHECK_LE(kept_parts_.size(), parts_.size());
+  if (kept_parts_.size() < parts_.size()) {
+    ReadHistoryFromMessageIfPointsDeferred();
+  }
   for (auto it = parts_.begin(); it != parts_.end();) {
     not_null<Part*> const part = it->second.get();
     if (Contains(kept_parts_, part->part_id())) {
@@ -169,6 +202,12 @@ void Vessel::ClearAllIntrinsicForcesAndTorques() {
 
 void Vessel::DetectCollapsibilityChange() {
   bool const will_be_collapsible = IsCollapsible();
+  bool const collapsibility_changes = is_collapsible_ != will_be_collapsible;
+  if (!collapsibility_changes) {
+    // Don't deserialize the history of a vessel that nobody looks at.
+    return;
+  }
+  ReadHistoryFromMessage();
 
   // It is always correct to mark as non-collapsible a collapsible segment or to
   // append collapsible points to a non-collapsible segment (but not
@@ -176,14 +215,11 @@ void Vessel::DetectCollapsibilityChange() {
   // short, we don't actually close it but keep appending points to it until it
   // is long enough to have been downsampled.  If downsampling is disabled,
   // surely this is not going to happen so no point in waiting for Godot.
-  bool const collapsibility_changes = is_collapsible_ != will_be_collapsible;
-  bool const becomes_non_collapsible = collapsibility_changes &&
-                                       !will_be_collapsible;
+  bool const becomes_non_collapsible = !will_be_collapsible;
   bool const awaits_first_downsampling = downsampling_parameters_.has_value() &&
                                          !backstory_->was_downsampled();
 
-  if (collapsibility_changes &&
-      (becomes_non_collapsible || !awaits_first_downsampling)) {
+  if (becomes_non_collapsible || !awaits_first_downsampling) {
     // If collapsibility changes, we create a new history segment.  This ensures
     // that downsampling does not change collapsibility boundaries.
 
@@ -260,7 +296,8 @@ void Vessel::DetectCollapsibilityChange() {
 
 void Vessel::CreateTrajectoryIfNeeded(Instant const& t) {
   CHECK(!parts_.empty());
-  if (trajectory_.empty()) {
+  // A serialized history is never empty.
+  if (!has_serialized_history() && trajectory_.empty()) {
     LOG(INFO) << "Preparing history of vessel " << ShortDebugString()
               << " at " << t;
     BarycentreCalculator<DegreesOfFreedom<Barycentric>, Mass> calculator;
@@ -280,6 +317,7 @@ void Vessel::CreateTrajectoryIfNeeded(Instant const& t) {
 }
 
 void Vessel::DisableDownsampling() {
+  ReadHistoryFromMessage();
   backstory_->ClearDownsampling();
   // From now on, no downsampling will happen.
   downsampling_parameters_ = std::nullopt;
@@ -301,17 +339,40 @@ void Vessel::ForAllParts(std::function<void(Part&)> action) const {
 }
 
 DiscreteTrajectory<Barycentric> const& Vessel::trajectory() const {
+  ReadHistoryFromMessageIfNeeded();
   return trajectory_;
 }
 
 DiscreteTrajectorySegmentIterator<Barycentric> Vessel::psychohistory() const {
+  ReadHistoryFromMessageIfNeeded();
   return psychohistory_;
 }
 
 DiscreteTrajectorySegmentIterator<Barycentric> Vessel::prediction() const {
+  ReadHistoryFromMessageIfNeeded();
   return prediction_;
 }
 
+Planetarium::PlottingCache& Vessel::prediction_plotting_cache() {
+  return prediction_plotting_cache_;
+}
+
+std::int64_t Vessel::prediction_generation() const {
+  return prediction_generation_.load(std::memory_order_acquire);
+}
+
+Instant Vessel::psychohistory_t_max() const {
+  {
+    absl::ReaderMutexLock l(&history_lock_);
+    if (serialized_history_.has_value()) {
+      // The serialized history ends at the first point of the prediction, which
+      // is the last point of the psychohistory.
+      return SerializedTimeRange(*serialized_history_)->second;
+    }
+  }
+  return psychohistory_->back().time;
+}
+
 void Vessel::set_prediction_adaptive_step_parameters(
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         prediction_adaptive_step_parameters) {
@@ -408,54 +469,55 @@ void Vessel::ReadFlightPlanFromMessage() {
   }
 }
 
+void Vessel::ReadHistoryFromMessage() {
+  ReadHistoryFromMessageIfNeeded();
+}
+
+bool Vessel::has_serialized_history() const {
+  return has_serialized_history_.load(std::memory_order_acquire);
+}
+
 void Vessel::AdvanceTime() {
+  ReadHistoryFromMessage();
   // Squirrel away the prediction so that we can reattach it if we don't have a
   // prognostication.
-  auto prediction = trajectory_.DetachSegments(prediction_);
-  prediction_ = trajectory_.segments().end();
-
-  // Read the wall of text below and realize that this can happen for the
-  // history as well as the psychohistory, if the history of the part was
-  // obtained using an adaptive step integrator, which is the case during a
-  // burn.  See #2931.
-  trajectory_.DeleteSegments(psychohistory_);
-  AppendToVesselTrajectory(&Part::history_begin,
-                           &Part::history_end,
-                           *backstory_);
-  psychohistory_ = trajectory_.NewSegment();
-
-  // The reason why we may want to skip the start of the psychohistory is
-  // subtle.  Say that we have a vessel A with points at t₀, t₀ + 10 s,
-  // t₀ + 20 s in its history.  Say that a vessel B is created at t₀ + 23 s,
-  // maybe because of an undocking or a staging, and (some) of the parts of A
-  // are transfered to B.  Now time moves a bit and at t₀ = 24 s we want to
-  // attach the psychohistory of these parts (their centre of mass, really) to
-  // vessel B.  Most of the time the psychohistory will have a *single* point at
-  // t₀ + 24 s and everything will be fine.  However, because the psychohistory
-  // is integrated using an adaptive step, it is possible that it would have
-  // multiple points, say one at t₀ + 21 s and one at t₀ + 24 s.  In this case
-  // trying to insert the point at t₀ + 21 s would put us before the last point
-  // of the history of B and would fail a check.  Therefore, we just ignore that
-  // point.  See #2507 and the |last_time| in AppendToVesselTrajectory.
-  AppendToVesselTrajectory(&Part::psychohistory_begin,
-                           &Part::psychohistory_end,
-                           *psychohistory_);
+  auto prediction = AppendPartTrajectories();
 
   // Attach the prognostication, if there is one.  Otherwise fall back to the
   // pre-existing prediction.
   auto optional_prognostication = prognosticator_.Get();
   if (optional_prognostication.has_value()) {
     AttachPrediction(std::move(optional_prognostication.value()));
+    prediction_plotting_cache_.Clear();
   } else {
     AttachPrediction(std::move(prediction));
+    // The prediction now starts at the end of the psychohistory, which changes
+    // its first interval but not the rest.
+    if (prediction_->size() < 2) {
+      prediction_plotting_cache_.Clear();
+    } else {
+      prediction_plotting_cache_.ForgetBefore(
+          std::next(prediction_->begin())->time);
+    }
   }
+}
 
-  for (auto const& [_, part] : parts_) {
-    part->ClearHistory();
+void Vessel::AdvanceTimeLazily() {
+  CHECK(!parts_.empty());
+  {
+    absl::MutexLock l(&history_lock_);
+    // All the parts have the same history, so it is sufficient to look at one.
+    if (serialized_history_.has_value() &&
+        parts_.begin()->second->history_size() < max_deferred_points) {
+      has_deferred_points_ = true;
+      return;
+    }
   }
+  AdvanceTime();
 }
 
 void Vessel::RequestReanimation(Instant const& desired_t_min) {
+  ReadHistoryFromMessage();
   reanimator_.Start();
 
   // No locking here because vessel reanimation is only invoked from the main
@@ -513,6 +575,7 @@ void Vessel::CreateFlightPlan(
         flight_plan_adaptive_step_parameters,
     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
         flight_plan_generalized_adaptive_step_parameters) {
+  ReadHistoryFromMessage();
   auto const& flight_plan_start = backstory_->back();
   flight_plans_.emplace_back(OptimizableFlightPlan{
       .flight_plan = make_not_null_unique<FlightPlan>(
@@ -561,6 +624,7 @@ void Vessel::DeleteFlightPlan() {
 
 absl::Status Vessel::RebaseFlightPlan(Mass const& initial_mass) {
   CHECK(has_deserialized_flight_plan());
+  ReadHistoryFromMessage();
   auto& flight_plan =
       std::get<OptimizableFlightPlan>(selected_flight_plan()).flight_plan;
   Instant const new_initial_time = backstory_->back().time;
@@ -600,13 +664,19 @@ absl::Status Vessel::RebaseFlightPlan(Mass const& initial_mass) {
 }
 
 void Vessel::RefreshPrediction() {
+  ReadHistoryFromMessage();
   // The |prognostication| is a trajectory which is computed asynchronously and
   // may be used as a prediction;
   std::optional<DiscreteTrajectory<Barycentric>> prognostication;
 
-  // Note that we know that |RefreshPrediction| is called on the main thread,
-  // therefore the ephemeris currently covers the last time of the
-  // psychohistory.  Were this to change, this code might have to change.
+  // Note that we know that |RefreshPrediction| is called either on the main
+  // thread or, by |Plugin::UpdatePrediction|, on a thread of the vessel pool
+  // while the main thread waits for it.  In both cases the main thread doesn't
+  // concurrently extend the psychohistory or forget the ephemeris, therefore
+  // the ephemeris currently covers the last time of the psychohistory.  Other
+  // vessels may concurrently prolong the ephemeris, which is thread-safe, but
+  // they don't touch the trajectories of this vessel.  Were this to change,
+  // this code might have to change.
   PrognosticatorParameters prognosticator_parameters{
       psychohistory_->back().time,
       psychohistory_->back().degrees_of_freedom,
@@ -624,6 +694,7 @@ void Vessel::RefreshPrediction() {
   }
   if (prognostication.has_value()) {
     AttachPrediction(std::move(prognostication).value());
+    prediction_plotting_cache_.Clear();
   }
 }
 
@@ -632,11 +703,64 @@ void Vessel::RefreshPrediction(Instant const& time) {
   trajectory_.ForgetAfter(trajectory_.upper_bound(time));
 }
 
+void Vessel::RefreshPredictions(std::vector<not_null<Vessel*>> const& vessels) {
+  CHECK(synchronous_);
+  auto const& ensemble_integrator =
+      DefaultPredictionParameters().integrator();
+  std::vector<not_null<Vessel*>> ensemble_vessels;
+  for (auto const vessel : vessels) {
+    if (&vessel->prediction_adaptive_step_parameters_.integrator() ==
+        &ensemble_integrator) {
+      ensemble_vessels.push_back(vessel);
+    } else {
+      vessel->RefreshPrediction();
+    }
+  }
+
+  // An ensemble of one vessel doesn't share anything.
+  if (ensemble_vessels.size() < 2) {
+    for (auto const vessel : ensemble_vessels) {
+      vessel->RefreshPrediction();
+    }
+    return;
+  }
+
+  // See |RefreshPrediction| for why it is safe to read the psychohistories and
+  // to prolong the ephemeris here.
+  std::vector<PrognosticatorParameters> prognosticator_parameters;
+  for (auto const vessel : ensemble_vessels) {
+    CHECK_EQ(vessel->ephemeris_, ensemble_vessels.front()->ephemeris_);
+    vessel->ReadHistoryFromMessage();
+    prognosticator_parameters.push_back(
+        {vessel->psychohistory_->back().time,
+         vessel->psychohistory_->back().degrees_of_freedom,
+         vessel->prediction_adaptive_step_parameters_});
+  }
+  auto prognostications =
+      FlowPrognostications(ensemble_vessels, prognosticator_parameters);
+  for (int i = 0; i < ensemble_vessels.size(); ++i) {
+    auto const vessel = ensemble_vessels[i];
+    if (prognostications[i].ok()) {
+      vessel->AttachPrediction(std::move(prognostications[i]).value());
+      vessel->prediction_plotting_cache_.Clear();
+    }
+  }
+}
+
+void Vessel::RefreshPredictions(std::vector<not_null<Vessel*>> const& vessels,
+                                Instant const& time) {
+  RefreshPredictions(vessels);
+  for (auto const vessel : vessels) {
+    vessel->trajectory_.ForgetAfter(vessel->trajectory_.upper_bound(time));
+  }
+}
+
 void Vessel::StopPrognosticator() {
   prognosticator_.Stop();
 }
 
 void Vessel::RequestOrbitAnalysis(Time const& mission_duration) {
+  ReadHistoryFromMessage();
   if (!orbit_analyser_.has_value()) {
     // TODO(egg): perhaps we should get the history parameters from the plugin;
     // on the other hand, these are probably overkill for high orbits anyway,
@@ -705,27 +829,36 @@ void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
     message->add_kept_parts(part_id);
   }
 
-  // If the vessel is collapsible, we serialize at most the last
-  // |max_points_to_serialize| of the part of the trajectory that ends at the
-  // |backstory_|.  If it is not, however, we must serialize at least the entire
-  // |backstory_| otherwise we'd lose the beginning of a non-collapsible
-  // segment.
-  std::int64_t const history_size = backstory_->end() - trajectory_.begin();
-  std::int64_t const max_points_to_serialize_present_in_history =
-      std::min(max_points_to_serialize, history_size);
-  std::int64_t const serialized_points =
-      is_collapsible_ ? max_points_to_serialize_present_in_history
-                      : std::max(max_points_to_serialize_present_in_history,
-                                 backstory_->size());
-
-  // Starting with Gateaux we don't save the prediction, see #2685.  Instead we
-  // just save its first point and re-read as if it was the whole prediction.
-  trajectory_.WriteToMessage(
-      message->mutable_history(),
-      /*begin=*/backstory_->end() - serialized_points,
-      /*end=*/std::next(prediction_->begin()),
-      /*tracked=*/{backstory_, psychohistory_, prediction_},
-      /*exact=*/{});
+  {
+    absl::ReaderMutexLock l(&history_lock_);
+    if (serialized_history_.has_value()) {
+      // The history hasn't changed since it was read, write it back verbatim.
+      *message->mutable_history() = *serialized_history_;
+    } else {
+      // If the vessel is collapsible, we serialize at most the last
+      // |max_points_to_serialize| of the part of the trajectory that ends at
+      // the |backstory_|.  If it is not, however, we must serialize at least
+      // the entire |backstory_| otherwise we'd lose the beginning of a
+      // non-collapsible segment.
+      std::int64_t const history_size = backstory_->end() - trajectory_.begin();
+      std::int64_t const max_points_to_serialize_present_in_history =
+          std::min(max_points_to_serialize, history_size);
+      std::int64_t const serialized_points =
+          is_collapsible_ ? max_points_to_serialize_present_in_history
+                          : std::max(max_points_to_serialize_present_in_history,
+                                     backstory_->size());
+
+      // Starting with Gateaux we don't save the prediction, see #2685.
+      // Instead we just save its first point and re-read as if it was the
+      // whole prediction.
+      trajectory_.WriteToMessage(
+          message->mutable_history(),
+          /*begin=*/backstory_->end() - serialized_points,
+          /*end=*/std::next(prediction_->begin()),
+          /*tracked=*/{backstory_, psychohistory_, prediction_},
+          /*exact=*/{});
+    }
+  }
   for (auto const& flight_plan : flight_plans_) {
     if (std::holds_alternative<serialization::FlightPlan>(flight_plan)) {
       *message->add_flight_plans() =
@@ -759,6 +892,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
   bool const is_pre_hamilton = message.history().segment_size() == 0;
   bool const is_pre_हरीश_चंद्र = !message.has_is_collapsible();
   bool const is_pre_hilbert = !message.has_selected_flight_plan_index();
+  // Only set if the history is deserialized lazily.
+  std::optional<std::pair<Instant, Instant>> serialized_time_range;
   LOG_IF(WARNING, is_pre_hilbert)
       << "Reading pre-"
       << (is_pre_cesàro     ? "Cesàro"
@@ -839,11 +974,21 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
     vessel->backstory_ = std::prev(vessel->psychohistory_);
     vessel->downsampling_parameters_ = DefaultDownsamplingParameters();
   } else {
-    vessel->trajectory_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
-        message.history(),
-        /*tracked=*/{&vessel->backstory_,
-                     &vessel->psychohistory_,
-                     &vessel->prediction_});
+    // Starting with हरीश चंद्र we deserialize the history lazily if it is not
+    // empty, as it is expensive to decompress and many vessels are never
+    // looked at.
+    serialized_time_range = SerializedTimeRange(message.history());
+    if (serialized_time_range.has_value()) {
+      absl::MutexLock l(&vessel->history_lock_);
+      vessel->serialized_history_ = message.history();
+      vessel->has_serialized_history_.store(true, std::memory_order_release);
+    } else {
+      vessel->trajectory_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+          message.history(),
+          /*tracked=*/{&vessel->backstory_,
+                       &vessel->psychohistory_,
+                       &vessel->prediction_});
+    }
     vessel->is_collapsible_ = message.is_collapsible();
 
     vessel->checkpointer_ =
@@ -865,7 +1010,9 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
 
   // Necessary after Εὔδοξος because the ephemeris has not been prolonged
   // during deserialization.
-  ephemeris->Prolong(vessel->prediction_->back().time).IgnoreError();
+  ephemeris->Prolong(serialized_time_range.has_value()
+                         ? serialized_time_range->second
+                         : vessel->prediction_->back().time).IgnoreError();
 
   if (is_pre_陈景润) {
     vessel->backstory_->SetDownsamplingUnconditionally(
@@ -881,41 +1028,12 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
                      : message.selected_flight_plan_index();
 
   // Figure out which was the last checkpoint to be "reanimated" by reading the
-  // end of the trajectory from the serialized form.  Interestingly enough, that
-  // checkpoint (that is, the non-collapsible segment) may overlap the beginning
-  // of the trajectory that we just deserialized, in which case we must rebuild
-  // the front part of the non-collapsible segment to make sure that the
-  // trajectory doesn't start in the middle of a non-collapsible segment (the
-  // integration of the preceding collapsible segment would not end at the right
-  // time if it did).
-  Instant const checkpoint =
-      vessel->checkpointer_->checkpoint_at_or_after(
-          vessel->trajectory().t_min());
-  if (checkpoint != InfiniteFuture) {
-    CHECK_OK(vessel->checkpointer_->ReadFromCheckpointAt(
-        checkpoint,
-        [checkpoint, &vessel](
-            serialization::Vessel::Checkpoint const& message) {
-          // This code is similar to the one in ReanimateOneCheckpoint except
-          // that (1) we never need to reconstruct a collapsible segment; (2) we
-          // may actually have to truncate the non-collapsible segment obtained
-          // from the checkpoint.
-          LOG(INFO) << "Restoring " << vessel->ShortDebugString()
-                    << " to initial checkpoint at " << checkpoint;
-
-          DiscreteTrajectorySegmentIterator<Barycentric> unused;
-          auto reanimated_trajectory =
-              DiscreteTrajectory<Barycentric>::ReadFromMessage(
-                  message.non_collapsible_segment(),
-                  /*tracked=*/{&unused});
-          CHECK(!reanimated_trajectory.empty());
-          CHECK_EQ(checkpoint, reanimated_trajectory.back().time);
-          reanimated_trajectory.ForgetAfter(vessel->trajectory().t_min());
-          if (!reanimated_trajectory.empty()) {
-            vessel->trajectory_.Merge(std::move(reanimated_trajectory));
-          }
-          return absl::OkStatus();
-        }));
+  // end of the trajectory from the serialized form.
+  Instant const checkpoint = vessel->checkpointer_->checkpoint_at_or_after(
+      serialized_time_range.has_value() ? serialized_time_range->first
+                                        : vessel->trajectory_.t_min());
+  if (!serialized_time_range.has_value()) {
+    vessel->ReadInitialCheckpoint(checkpoint);
   }
   vessel->oldest_reanimated_checkpoint_ = checkpoint;
 
@@ -933,6 +1051,87 @@ void Vessel::FillContainingPileUpsFromMessage(
   }
 }
 
+void Vessel::ReadInitialCheckpoint(Instant const& checkpoint) const {
+  // Interestingly enough, the checkpoint (that is, the non-collapsible segment)
+  // may overlap the beginning of the trajectory, in which case we must rebuild
+  // the front part of the non-collapsible segment to make sure that the
+  // trajectory doesn't start in the middle of a non-collapsible segment (the
+  // integration of the preceding collapsible segment would not end at the right
+  // time if it did).
+  if (checkpoint == InfiniteFuture) {
+    return;
+  }
+  CHECK_OK(checkpointer_->ReadFromCheckpointAt(
+      checkpoint,
+      [this, checkpoint](serialization::Vessel::Checkpoint const& message) {
+        // This code is similar to the one in ReanimateOneCheckpoint except
+        // that (1) we never need to reconstruct a collapsible segment; (2) we
+        // may actually have to truncate the non-collapsible segment obtained
+        // from the checkpoint.
+        LOG(INFO) << "Restoring " << ShortDebugString()
+                  << " to initial checkpoint at " << checkpoint;
+
+        DiscreteTrajectorySegmentIterator<Barycentric> unused;
+        auto reanimated_trajectory =
+            DiscreteTrajectory<Barycentric>::ReadFromMessage(
+                message.non_collapsible_segment(),
+                /*tracked=*/{&unused});
+        CHECK(!reanimated_trajectory.empty());
+        CHECK_EQ(checkpoint, reanimated_trajectory.back().time);
+        reanimated_trajectory.ForgetAfter(trajectory_.t_min());
+        if (!reanimated_trajectory.empty()) {
+          trajectory_.Merge(std::move(reanimated_trajectory));
+        }
+        return absl::OkStatus();
+      }));
+}
+
+void Vessel::ReadHistoryFromMessageIfNeeded() const {
+  // Once deserialized, the history is never serialized again, so the accessors
+  // only pay for an atomic load.
+  if (!has_serialized_history_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // The lock is held during the deserialization so that concurrent callers
+  // wait until it is complete.
+  absl::MutexLock l(&history_lock_);
+  if (!serialized_history_.has_value()) {
+    return;
+  }
+  LOG(INFO) << "Deserializing history of " << ShortDebugString();
+  trajectory_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+      *serialized_history_,
+      /*tracked=*/{&backstory_, &psychohistory_, &prediction_});
+  serialized_history_.reset();
+
+  Instant checkpoint;
+  {
+    absl::ReaderMutexLock l(&lock_);
+    checkpoint = oldest_reanimated_checkpoint_;
+  }
+  ReadInitialCheckpoint(checkpoint);
+
+  // Catch up with the points left in the parts by |AdvanceTimeLazily|.  The
+  // prediction was not refreshed in the meantime, so it is merely trimmed.
+  if (has_deferred_points_) {
+    AttachPrediction(AppendPartTrajectories());
+    has_deferred_points_ = false;
+  }
+  has_serialized_history_.store(false, std::memory_order_release);
+}
+
+void Vessel::ReadHistoryFromMessageIfPointsDeferred() {
+  bool points_deferred;
+  {
+    absl::ReaderMutexLock l(&history_lock_);
+    points_deferred = has_deferred_points_;
+  }
+  if (points_deferred) {
+    ReadHistoryFromMessage();
+  }
+}
+
 void Vessel::MakeAsynchronous() {
   synchronous_ = false;
 }
@@ -941,6 +1140,10 @@ void Vessel::MakeSynchronous() {
   synchronous_ = true;
 }
 
+bool Vessel::synchronous() {
+  return synchronous_;
+}
+
 Vessel::Vessel()
     : body_(),
       prediction_adaptive_step_parameters_(DefaultPredictionParameters()),
@@ -1135,10 +1338,122 @@ absl::StatusOr<DiscreteTrajectory<Barycentric>> Vessel::FlowPrognostication(
   }
 }
 
+std::vector<absl::StatusOr<DiscreteTrajectory<Barycentric>>>
+Vessel::FlowPrognostications(
+    std::vector<not_null<Vessel*>> const& vessels,
+    std::vector<PrognosticatorParameters> const& prognosticator_parameters) {
+  CHECK(!vessels.empty());
+  CHECK_EQ(vessels.size(), prognosticator_parameters.size());
+  Ephemeris<Barycentric>& ephemeris = *vessels.front()->ephemeris_;
+  int const size = vessels.size();
+
+  std::vector<DiscreteTrajectory<Barycentric>> prognostications(size);
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> trajectories;
+  std::vector<Ephemeris<Barycentric>::AdaptiveStepParameters>
+      adaptive_step_parameters;
+  for (int i = 0; i < size; ++i) {
+    auto const& parameters = prognosticator_parameters[i];
+    prognostications[i].Append(
+        parameters.first_time,
+        parameters.first_degrees_of_freedom).IgnoreError();
+    trajectories.push_back(&prognostications[i]);
+    adaptive_step_parameters.push_back(parameters.adaptive_step_parameters);
+  }
+  auto statuses =
+      ephemeris.FlowEnsembleWithAdaptiveStep<DefaultPredictionMethod>(
+          trajectories,
+          Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+          ephemeris.t_max(),
+          adaptive_step_parameters,
+          FlightPlan::max_ephemeris_steps_per_frame);
+
+  // As in |FlowPrognostication|, the prognostications that reached |t_max| are
+  // flowed further.  This will prolong the ephemeris by
+  // |max_ephemeris_steps_per_frame|, once for the entire ensemble.
+  std::vector<int> reached_t_max;
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> further_trajectories;
+  std::vector<Ephemeris<Barycentric>::AdaptiveStepParameters>
+      further_adaptive_step_parameters;
+  for (int i = 0; i < size; ++i) {
+    if (statuses[i].ok()) {
+      reached_t_max.push_back(i);
+      further_trajectories.push_back(trajectories[i]);
+      further_adaptive_step_parameters.push_back(adaptive_step_parameters[i]);
+    }
+  }
+  if (!reached_t_max.empty()) {
+    auto const further_statuses =
+        ephemeris.FlowEnsembleWithAdaptiveStep<DefaultPredictionMethod>(
+            further_trajectories,
+            Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+            InfiniteFuture,
+            further_adaptive_step_parameters,
+            FlightPlan::max_ephemeris_steps_per_frame);
+    for (int j = 0; j < reached_t_max.size(); ++j) {
+      statuses[reached_t_max[j]] = further_statuses[j];
+    }
+  }
+
+  std::vector<absl::StatusOr<DiscreteTrajectory<Barycentric>>> result;
+  result.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    auto const& status = statuses[i];
+    LOG_IF_EVERY_N(INFO, !status.ok(), 50)
+        << "Prognostication from " << prognosticator_parameters[i].first_time
+        << " finished at " << prognostications[i].back().time << " with "
+        << status.ToString() << " for " << vessels[i]->ShortDebugString();
+    if (absl::IsCancelled(status)) {
+      result.push_back(status);
+    } else {
+      // Unless we were stopped, ignore the status, which indicates a failure
+      // to reach |t_max|, and provide a short prognostication.
+      result.push_back(std::move(prognostications[i]));
+    }
+  }
+  return result;
+}
+
+DiscreteTrajectory<Barycentric> Vessel::AppendPartTrajectories() const {
+  auto prediction = trajectory_.DetachSegments(prediction_);
+  prediction_ = trajectory_.segments().end();
+
+  // Read the wall of text below and realize that this can happen for the
+  // history as well as the psychohistory, if the history of the part was
+  // obtained using an adaptive step integrator, which is the case during a
+  // burn.  See #2931.
+  trajectory_.DeleteSegments(psychohistory_);
+  AppendToVesselTrajectory(&Part::history_begin,
+                           &Part::history_end,
+                           *backstory_);
+  psychohistory_ = trajectory_.NewSegment();
+
+  // The reason why we may want to skip the start of the psychohistory is
+  // subtle.  Say that we have a vessel A with points at t₀, t₀ + 10 s,
+  // t₀ + 20 s in its history.  Say that a vessel B is created at t₀ + 23 s,
+  // maybe because of an undocking or a staging, and (some) of the parts of A
+  // are transfered to B.  Now time moves a bit and at t₀ = 24 s we want to
+  // attach the psychohistory of these parts (their centre of mass, really) to
+  // vessel B.  Most of the time the psychohistory will have a *single* point at
+  // t₀ + 24 s and everything will be fine.  However, because the psychohistory
+  // is integrated using an adaptive step, it is possible that it would have
+  // multiple points, say one at t₀ + 21 s and one at t₀ + 24 s.  In this case
+  // trying to insert the point at t₀ + 21 s would put us before the last point
+  // of the history of B and would fail a check.  Therefore, we just ignore that
+  // point.  See #2507 and the |last_time| in AppendToVesselTrajectory.
+  AppendToVesselTrajectory(&Part::psychohistory_begin,
+                           &Part::psychohistory_end,
+                           *psychohistory_);
+
+  for (auto const& [_, part] : parts_) {
+    part->ClearHistory();
+  }
+  return prediction;
+}
+
 void Vessel::AppendToVesselTrajectory(
     TrajectoryIterator const part_trajectory_begin,
     TrajectoryIterator const part_trajectory_end,
-    DiscreteTrajectorySegment<Barycentric> const& segment) {
+    DiscreteTrajectorySegment<Barycentric> const& segment) const {
   CHECK(!parts_.empty());
   std::vector<DiscreteTrajectory<Barycentric>::iterator> its;
   std::vector<DiscreteTrajectory<Barycentric>::iterator> ends;
@@ -1149,7 +1464,8 @@ void Vessel::AppendToVesselTrajectory(
     ends.push_back((*part.*part_trajectory_end)());
   }
 
-  // We cannot append a point before this time, see the comments in AdvanceTime.
+  // We cannot append a point before this time, see the comments in
+  // AppendPartTrajectories.
   Instant const last_time =
       segment.empty() ? InfinitePast : segment.back().time;
 
@@ -1189,7 +1505,8 @@ void Vessel::AppendToVesselTrajectory(
   }
 }
 
-void Vessel::AttachPrediction(DiscreteTrajectory<Barycentric>&& trajectory) {
+void Vessel::AttachPrediction(
+    DiscreteTrajectory<Barycentric>&& trajectory) const {
   trajectory.ForgetBefore(psychohistory_->back().time);
   if (trajectory.empty()) {
     prediction_ = trajectory_.NewSegment();
@@ -1199,6 +1516,7 @@ void Vessel::AttachPrediction(DiscreteTrajectory<Barycentric>&& trajectory) {
     }
     prediction_ = trajectory_.AttachSegments(std::move(trajectory));
   }
+  prediction_generation_.fetch_add(1, std::memory_order_release);
 }
 
 bool Vessel::IsCollapsible() const {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <variant>
@@ -24,6 +27,7 @@
 #include "ksp_plugin/orbit_analyser.hpp"
 #include "ksp_plugin/part.hpp"
 #include "ksp_plugin/pile_up.hpp"
+#include "ksp_plugin/planetarium.hpp"
 #include "physics/checkpointer.hpp"
 #include "physics/clientele.hpp"
 #include "physics/degrees_of_freedom.hpp"
@@ -59,6 +63,7 @@ using namespace principia::ksp_plugin::_manœuvre;
 using namespace principia::ksp_plugin::_orbit_analyser;
 using namespace principia::ksp_plugin::_part;
 using namespace principia::ksp_plugin::_pile_up;
+using namespace principia::ksp_plugin::_planetarium;
 using namespace principia::physics::_checkpointer;
 using namespace principia::physics::_clientele;
 using namespace principia::physics::_degrees_of_freedom;
@@ -160,6 +165,19 @@ class Vessel {
   virtual DiscreteTrajectorySegmentIterator<Barycentric> psychohistory() const;
   virtual DiscreteTrajectorySegmentIterator<Barycentric> prediction() const;
 
+  // The cache used to plot the |prediction|.  It is cleared or trimmed by this
+  // object when the prediction is replaced.  Only accessed by the main thread.
+  Planetarium::PlottingCache& prediction_plotting_cache();
+
+  // A number that changes whenever a prediction is attached to this vessel,
+  // for use by the clients that compute things relative to the prediction.
+  virtual std::int64_t prediction_generation() const;
+
+  // The time of the last point of the psychohistory.  Unlike |psychohistory|,
+  // doesn't deserialize the history if it is held lazily, in which case the
+  // points deferred by |AdvanceTimeLazily| are not taken into account.
+  Instant psychohistory_t_max() const EXCLUDES(history_lock_);
+
   virtual void set_prediction_adaptive_step_parameters(
       Ephemeris<Barycentric>::AdaptiveStepParameters const&
           prediction_adaptive_step_parameters);
@@ -209,11 +227,27 @@ class Vessel {
   // accessed by |flight_plan|.  This method is idempotent.
   void ReadFlightPlanFromMessage();
 
+  // Deserializes the history if it is held lazily by this object, i.e., if the
+  // vessel was read from a message and its trajectory hasn't been accessed
+  // since.  This method is idempotent and thread-safe.  Note that all the
+  // accessors to the trajectory call it.
+  void ReadHistoryFromMessage() EXCLUDES(history_lock_);
+
+  // Returns true if the history is held lazily by this object.
+  bool has_serialized_history() const EXCLUDES(history_lock_);
+
   // Extends the history and psychohistory of this vessel by computing the
   // centre of mass of its parts at every point in their history and
   // psychohistory.  Clears the parts' history and psychohistory.
   virtual void AdvanceTime();
 
+  // Same as |AdvanceTime|, except that if the history is held lazily it is not
+  // deserialized: the points stay in the history and psychohistory of the parts
+  // and are appended to the history of this vessel when it is deserialized.
+  // The parts only hold a bounded number of points, beyond which this method
+  // behaves like |AdvanceTime|.
+  void AdvanceTimeLazily() EXCLUDES(history_lock_);
+
   // Asks the reanimator thread to asynchronously reconstruct the past so that
   // the |t_min()| of the vessel ultimately ends up at or before
   // |desired_t_min|.
@@ -259,13 +293,26 @@ class Vessel {
 
   // Tries to replace the current prediction with a more recently computed one.
   // No guarantees that this happens.  No guarantees regarding the end time of
-  // the prediction when this call returns.
+  // the prediction when this call returns.  This function and the one below
+  // may be called concurrently for distinct vessels, but not concurrently with
+  // a change to the psychohistory or with a call that forgets the ephemeris.
   virtual void RefreshPrediction();
 
   // Same as above, but when this call returns the prediction is guaranteed to
   // have a last time at or before |time|.
   virtual void RefreshPrediction(Instant const& time);
 
+  // Same as calling |RefreshPrediction| on each of the |vessels|, which must
+  // share the same ephemeris.  Must only be called when |synchronous()|.  The
+  // prognostications of the vessels that use the default prediction integrator
+  // are flowed as an ensemble, so that they share the evaluations of the
+  // ephemeris.
+  static void RefreshPredictions(std::vector<not_null<Vessel*>> const& vessels);
+
+  // Same as above, but calls |RefreshPrediction(time)|.
+  static void RefreshPredictions(std::vector<not_null<Vessel*>> const& vessels,
+                                 Instant const& time);
+
   // Stop the asynchronous prognosticator as soon as convenient.
   void StopPrognosticator();
 
@@ -307,6 +354,7 @@ class Vessel {
 
   static void MakeAsynchronous();
   static void MakeSynchronous();
+  static bool synchronous();
 
  protected:
   // For mocking.
@@ -364,17 +412,30 @@ class Vessel {
   absl::StatusOr<DiscreteTrajectory<Barycentric>>
   FlowPrognostication(PrognosticatorParameters prognosticator_parameters);
 
+  // Same as |FlowPrognostication| for each of the |vessels| and the
+  // corresponding |prognosticator_parameters|, but the prognostications are
+  // flowed as an ensemble.  The integrator of all the parameters must be that
+  // of |DefaultPredictionParameters|.
+  static std::vector<absl::StatusOr<DiscreteTrajectory<Barycentric>>>
+  FlowPrognostications(
+      std::vector<not_null<Vessel*>> const& vessels,
+      std::vector<PrognosticatorParameters> const& prognosticator_parameters);
+
   // Appends to |trajectory_| the centre of mass of the trajectories of the
   // parts denoted by |part_trajectory_begin| and |part_trajectory_end|.  Only
   // the points that are strictly after the start of the |segment| are used.
   void AppendToVesselTrajectory(
       TrajectoryIterator part_trajectory_begin,
       TrajectoryIterator part_trajectory_end,
-      DiscreteTrajectorySegment<Barycentric> const& segment);
+      DiscreteTrajectorySegment<Barycentric> const& segment) const;
+
+  // Detaches the |prediction_|, appends the history and psychohistory of the
+  // parts to |trajectory_| and clears them.  Returns the detached prediction.
+  DiscreteTrajectory<Barycentric> AppendPartTrajectories() const;
 
   // Attaches the given |trajectory| to the end of the |psychohistory_| to
   // become the new |prediction_|.  If |prediction_| is not null, it is deleted.
-  void AttachPrediction(DiscreteTrajectory<Barycentric>&& trajectory);
+  void AttachPrediction(DiscreteTrajectory<Barycentric>&& trajectory) const;
 
   // A vessel is collapsible if it is alone in its pile-up and is in inertial
   // motion.
@@ -383,6 +444,19 @@ class Vessel {
   // Returns true if this object holds a non-null deserialized flight plan.
   bool has_deserialized_flight_plan() const;
 
+  // Merges into |trajectory_| the part of the non-collapsible segment stored in
+  // the given |checkpoint| that precedes the beginning of |trajectory_|.  Does
+  // nothing if |checkpoint| is |InfiniteFuture|.
+  void ReadInitialCheckpoint(Instant const& checkpoint) const;
+
+  // Same as |ReadHistoryFromMessage|, for use by the const accessors.  Cheap if
+  // the history has already been deserialized.
+  void ReadHistoryFromMessageIfNeeded() const EXCLUDES(history_lock_);
+
+  // Deserializes the history if |AdvanceTimeLazily| left points in the parts,
+  // which must be done before the parts change.
+  void ReadHistoryFromMessageIfPointsDeferred() EXCLUDES(history_lock_);
+
   LazilyDeserializedFlightPlan& selected_flight_plan();
   LazilyDeserializedFlightPlan const& selected_flight_plan() const;
 
@@ -412,8 +486,30 @@ class Vessel {
   // The vessel trajectory is made of a number of history segments ending at the
   // backstory and (most of the time) the psychohistory and prediction.  The
   // prediction is periodically recomputed by the prognosticator.  Only grows
-  // "backwards" under |lock_|.
-  DiscreteTrajectory<Barycentric> trajectory_;
+  // "backwards" under |lock_|.  Mutable because it is materialized by the
+  // const accessors if the history is held lazily.
+  mutable DiscreteTrajectory<Barycentric> trajectory_;
+
+  // Held while the history is deserialized, which may be triggered by the
+  // const accessors on any thread.  Lock order: |history_lock_| is acquired
+  // before |lock_|, never the other way around.
+  mutable absl::Mutex history_lock_;
+
+  // If set, the history as read from a message, in which case |trajectory_|
+  // and the iterators below are not meaningful.  Cleared by
+  // |ReadHistoryFromMessageIfNeeded|.
+  mutable std::optional<serialization::DiscreteTrajectory> serialized_history_
+      GUARDED_BY(history_lock_);
+
+  // True iff |serialized_history_| is set.  Cleared with release semantics
+  // once |trajectory_| and the iterators below are materialized, so that the
+  // accessors may skip |history_lock_| afterwards.
+  mutable std::atomic<bool> has_serialized_history_ = false;
+
+  // True if |AdvanceTimeLazily| left in the parts points that must be appended
+  // to |trajectory_| when it is deserialized.  Since this touches the parts,
+  // the deserialization must not race with the integration of the pile-ups.
+  mutable bool has_deferred_points_ GUARDED_BY(history_lock_) = false;
 
   not_null<std::unique_ptr<Checkpointer<serialization::Vessel>>> checkpointer_;
 
@@ -436,12 +532,17 @@ class Vessel {
   // The last (most recent) segment of the |history_| prior to the
   // |psychohistory_|.  May be identical to |history_|.  Always identical to
   // |std::prev(psychohistory_)|.
-  DiscreteTrajectorySegmentIterator<Barycentric> backstory_;
+  mutable DiscreteTrajectorySegmentIterator<Barycentric> backstory_;
 
   // The |psychohistory_| is the segment following the |backstory_| and the
   // |prediction_| is the segment following the |psychohistory_|.
-  DiscreteTrajectorySegmentIterator<Barycentric> psychohistory_;
-  DiscreteTrajectorySegmentIterator<Barycentric> prediction_;
+  mutable DiscreteTrajectorySegmentIterator<Barycentric> psychohistory_;
+  mutable DiscreteTrajectorySegmentIterator<Barycentric> prediction_;
+
+  Planetarium::PlottingCache prediction_plotting_cache_;
+  // Incremented by |AttachPrediction|, which may run on any thread as part of
+  // the deserialization of the history.
+  mutable std::atomic<std::int64_t> prediction_generation_ = 0;
 
   RecurringThread<PrognosticatorParameters,
                   DiscreteTrajectory<Barycentric>> prognosticator_;
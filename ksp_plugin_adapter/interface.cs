@@ -241,7 +241,7 @@ internal static partial class Interface {
   [DllImport(dllName           : dll_path,
              EntryPoint        = "principia__ActivateRecorder",
              CallingConvention = CallingConvention.Cdecl)]
-  internal static extern void ActivateRecorder(bool activate);
+  internal static extern void ActivateRecorder(bool activate, bool binary);
 
   [DllImport(dllName           : dll_path,
              EntryPoint        = "principia__InitGoogleLogging",
@@ -17,8 +17,8 @@ internal static class Log {
     Interface.InitGoogleLogging();
   }
 
-  internal static void ActivateRecorder(bool activate) {
-    Interface.ActivateRecorder(activate);
+  internal static void ActivateRecorder(bool activate, bool binary) {
+    Interface.ActivateRecorder(activate, binary);
   }
 
   internal static void SetBufferedLogging(int max_severity) {
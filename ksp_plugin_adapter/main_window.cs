@@ -99,6 +99,12 @@ internal class MainWindow : VesselSupervisedWindowRenderer {
     if (must_record_journal_value != null) {
       must_record_journal_ = Convert.ToBoolean(must_record_journal_value);
     }
+    string must_record_binary_journal_value =
+        node.GetAtMostOneValue("must_record_binary_journal");
+    if (must_record_binary_journal_value != null) {
+      must_record_binary_journal_ =
+          Convert.ToBoolean(must_record_binary_journal_value);
+    }
 
     Log.SetBufferedLogging(buffered_logging_);
     Log.SetSuppressedLogging(suppressed_logging_);
@@ -107,7 +113,7 @@ internal class MainWindow : VesselSupervisedWindowRenderer {
 
     if (must_record_journal_) {
       journaling_ = true;
-      Log.ActivateRecorder(true);
+      Log.ActivateRecorder(true, binary : must_record_binary_journal_);
     }
   }
 
@@ -134,6 +140,9 @@ internal class MainWindow : VesselSupervisedWindowRenderer {
     node.SetValue("must_record_journal",
                   must_record_journal_,
                   createIfNotFound : true);
+    node.SetValue("must_record_binary_journal",
+                  must_record_binary_journal_,
+                  createIfNotFound : true);
   }
 
   protected override string Title => "Principia";
@@ -402,7 +411,7 @@ internal class MainWindow : VesselSupervisedWindowRenderer {
       // We can deactivate a recorder at any time, but in order for replaying to
       // work, we should only activate one before creating a plugin.
       journaling_ = false;
-      Interface.ActivateRecorder(false);
+      Interface.ActivateRecorder(false, binary : false);
     }
   }
 
@@ -582,6 +591,10 @@ internal class MainWindow : VesselSupervisedWindowRenderer {
 
   // Whether a journal will be recorded when the plugin is next constructed.
   private bool must_record_journal_ = false;
+  // Whether that journal will be in the binary format, which is faster to
+  // write but cannot be read with a text editor.  Only set from the
+  // configuration.
+  private bool must_record_binary_journal_ = false;
   // Whether a journal is currently being recorded.
   private static bool journaling_ = false;
 }
@@ -116,6 +116,11 @@ class Plotter {
            ++i) {
         flight_plan_segment_meshes_.Add(MakeDynamicMesh());
       }
+      // The segments are first plotted in parallel to fill their plotting
+      // caches, and then each of them is retrieved into the |VertexBuffer|.
+      planetarium.PlanetariumPrepareFlightPlanSegments(Plugin,
+                                                       main_vessel_guid,
+                                                       VertexBuffer.size);
       for (int i = 0; i < number_of_segments; ++i) {
         bool is_burn = i % 2 == 1;
         planetarium.PlanetariumPlotFlightPlanSegment(
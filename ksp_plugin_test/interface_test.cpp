@@ -213,7 +213,7 @@ TEST_F(InterfaceDeathTest, ActivateRecorder) {
   EXPECT_DEATH({
     Recorder::Deactivate();
     // Fails because the glog directory doesn't exist.
-    principia__ActivateRecorder(true);
+    principia__ActivateRecorder(true, /*binary=*/false);
   }, "glog.*Principia.*JOURNAL");
 }
 
@@ -32,6 +32,7 @@ class MockPlanetarium : public Planetarium {
                 1 * Metre),
             make_not_null<Ephemeris<Barycentric> const*>(),
             make_not_null<NavigationFrame const*>(),
+            /*plotting_frame_generation=*/0,
             [](Position<Navigation> const& plotted_point) {
               constexpr auto inverse_scale_factor = 1 / (6000 * Metre);
               return ScaledSpacePoint::FromCoordinates(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <list>
 
 #include "gmock/gmock.h"
@@ -31,6 +32,8 @@ class MockVessel : public Vessel {
               (),
               (const, override));
 
+  MOCK_METHOD(std::int64_t, prediction_generation, (), (const, override));
+
   MOCK_METHOD(FlightPlan&, flight_plan, (), (const, override));
   MOCK_METHOD(bool, has_flight_plan, (), (const, override));
 
@@ -1,10 +1,13 @@
 #include "ksp_plugin/planetarium.hpp"
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "base/not_null.hpp"
 #include "base/serialization.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/frame.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/instant.hpp"
@@ -40,13 +43,16 @@ namespace ksp_plugin {
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::AtLeast;
 using ::testing::Ge;
 using ::testing::Le;
+using ::testing::Lt;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::SizeIs;
 using namespace principia::base::_not_null;
 using namespace principia::base::_serialization;
+using namespace principia::base::_thread_pool;
 using namespace principia::geometry::_frame;
 using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_instant;
@@ -158,6 +164,7 @@ TEST_F(PlanetariumTest, PlotMethod0) {
                           perspective_,
                           &ephemeris_,
                           &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
                           plotting_to_scaled_space_);
   auto const rp2_lines =
       planetarium.PlotMethod0(discrete_trajectory,
@@ -207,6 +214,7 @@ TEST_F(PlanetariumTest, PlotMethod1) {
                           perspective_,
                           &ephemeris_,
                           &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
                           plotting_to_scaled_space_);
   auto const rp2_lines =
       planetarium.PlotMethod1(discrete_trajectory,
@@ -246,6 +254,7 @@ TEST_F(PlanetariumTest, PlotMethod2) {
                           perspective_,
                           &ephemeris_,
                           &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
                           plotting_to_scaled_space_);
   auto const rp2_lines =
       planetarium.PlotMethod2(discrete_trajectory,
@@ -264,6 +273,280 @@ TEST_F(PlanetariumTest, PlotMethod2) {
   }
 }
 
+TEST_F(PlanetariumTest, PlotMethod2Cached) {
+  // Same trajectory as above.
+  DiscreteTrajectory<Barycentric> discrete_trajectory;
+  AppendTrajectoryTimeline(/*from=*/NewCircularTrajectoryTimeline<Barycentric>(
+                                        /*period=*/100'000 * Second,
+                                        /*r=*/10 * Metre,
+                                        /*Δt=*/1 * Second,
+                                        /*t1=*/t0_,
+                                        /*t2=*/t0_ + 25'000 * Second),
+                           /*to=*/discrete_trajectory);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(parameters,
+                          perspective_,
+                          &ephemeris_,
+                          &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
+                          plotting_to_scaled_space_);
+  Planetarium::PlottingCache cache;
+
+  // With an empty cache, the result is the same as without a cache.
+  auto const rp2_lines =
+      planetarium.PlotMethod2(discrete_trajectory,
+                              discrete_trajectory.front().time,
+                              discrete_trajectory.back().time,
+                              t0_ + 10 * Second,
+                              /*reverse=*/false,
+                              cache);
+  EXPECT_THAT(rp2_lines, SizeIs(1));
+  EXPECT_THAT(rp2_lines[0], SizeIs(43));
+  EXPECT_EQ(43, cache.size());
+
+  // When plotting again, the plotting frame is only evaluated to compute the
+  // spheres, and the cached points are sufficient.
+  ::testing::Mock::VerifyAndClearExpectations(&plotting_frame_);
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_))
+      .WillOnce(Return(RigidMotion<Barycentric, Navigation>(
+          RigidTransformation<Barycentric, Navigation>::Identity(),
+          Barycentric::nonrotating,
+          Barycentric::unmoving)));
+  auto const cached_rp2_lines =
+      planetarium.PlotMethod2(discrete_trajectory,
+                              discrete_trajectory.front().time,
+                              discrete_trajectory.back().time,
+                              t0_ + 10 * Second,
+                              /*reverse=*/false,
+                              cache);
+  EXPECT_THAT(cached_rp2_lines, SizeIs(1));
+  EXPECT_THAT(cached_rp2_lines[0], SizeIs(Le(43)));
+  EXPECT_EQ(43, cache.size());
+  for (auto const& rp2_point : cached_rp2_lines[0]) {
+    EXPECT_THAT(rp2_point.x(),
+                AllOf(Ge(0 * Metre),
+                      Le((5.0 / Sqrt(3.0)) * Metre)));
+    EXPECT_THAT(rp2_point.y(), VanishesBefore(1 * Metre, 0, 14));
+  }
+  ::testing::Mock::VerifyAndClearExpectations(&plotting_frame_);
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_))
+      .WillRepeatedly(Return(RigidMotion<Barycentric, Navigation>(
+          RigidTransformation<Barycentric, Navigation>::Identity(),
+          Barycentric::nonrotating,
+          Barycentric::unmoving)));
+
+  // The points outside of the plotted interval are forgotten.
+  planetarium.PlotMethod2(discrete_trajectory,
+                          t0_ + 12'500 * Second,
+                          discrete_trajectory.back().time,
+                          t0_ + 10 * Second,
+                          /*reverse=*/false,
+                          cache);
+  EXPECT_THAT(cache.size(), AllOf(Ge(20), Le(24)));
+}
+
+TEST_F(PlanetariumTest, PlotMethod3Cached) {
+  // Same trajectory as above.
+  DiscreteTrajectory<Barycentric> discrete_trajectory;
+  AppendTrajectoryTimeline(/*from=*/NewCircularTrajectoryTimeline<Barycentric>(
+                                        /*period=*/100'000 * Second,
+                                        /*r=*/10 * Metre,
+                                        /*Δt=*/1 * Second,
+                                        /*t1=*/t0_,
+                                        /*t2=*/t0_ + 25'000 * Second),
+                           /*to=*/discrete_trajectory);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(parameters,
+                          perspective_,
+                          &ephemeris_,
+                          &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
+                          plotting_to_scaled_space_);
+
+  auto const equal = [](ScaledSpacePoint const& left,
+                        ScaledSpacePoint const& right) {
+    return left.x == right.x && left.y == right.y && left.z == right.z;
+  };
+
+  std::vector<ScaledSpacePoint> expected_line;
+  planetarium.PlotMethod3(
+      discrete_trajectory,
+      discrete_trajectory.front().time,
+      discrete_trajectory.back().time,
+      t0_ + 10 * Second,
+      /*reverse=*/false,
+      [&expected_line](ScaledSpacePoint const& point) {
+        expected_line.push_back(point);
+      },
+      /*max_points=*/1000);
+  EXPECT_THAT(expected_line, SizeIs(Ge(2)));
+  std::int64_t const expected_size = expected_line.size();
+
+  // With an empty cache, the result is the same as without a cache.
+  Planetarium::PlottingCache cache;
+  std::vector<ScaledSpacePoint> line;
+  planetarium.PlotMethod3(
+      discrete_trajectory,
+      discrete_trajectory.front().time,
+      discrete_trajectory.back().time,
+      t0_ + 10 * Second,
+      /*reverse=*/false,
+      [&line](ScaledSpacePoint const& point) { line.push_back(point); },
+      /*max_points=*/1000,
+      cache);
+  EXPECT_TRUE(std::equal(line.begin(),
+                         line.end(),
+                         expected_line.begin(),
+                         expected_line.end(),
+                         equal));
+  EXPECT_EQ(expected_size, cache.size());
+
+  // When plotting again, the plotting frame is not evaluated and the cached
+  // points are sufficient.
+  ::testing::Mock::VerifyAndClearExpectations(&plotting_frame_);
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_)).Times(0);
+  std::vector<ScaledSpacePoint> cached_line;
+  planetarium.PlotMethod3(
+      discrete_trajectory,
+      discrete_trajectory.front().time,
+      discrete_trajectory.back().time,
+      t0_ + 10 * Second,
+      /*reverse=*/false,
+      [&cached_line](ScaledSpacePoint const& point) {
+        cached_line.push_back(point);
+      },
+      /*max_points=*/1000,
+      cache);
+  EXPECT_THAT(cached_line, SizeIs(AllOf(Ge(2), Le(expected_line.size()))));
+  EXPECT_EQ(expected_size, cache.size());
+  EXPECT_TRUE(equal(expected_line.front(), cached_line.front()));
+  EXPECT_TRUE(equal(expected_line.back(), cached_line.back()));
+  ::testing::Mock::VerifyAndClearExpectations(&plotting_frame_);
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_))
+      .WillRepeatedly(Return(RigidMotion<Barycentric, Navigation>(
+          RigidTransformation<Barycentric, Navigation>::Identity(),
+          Barycentric::nonrotating,
+          Barycentric::unmoving)));
+
+  // Forgetting the start of the cache only drops the points before the given
+  // time.
+  cache.ForgetBefore(t0_ + 12'500 * Second);
+  EXPECT_THAT(cache.size(), AllOf(Ge(1), Lt(expected_size)));
+
+  // A new generation of the plotting frame, e.g., after the prediction of the
+  // target vessel has changed, causes the points to be recomputed even though
+  // the plotting frame is the same object.
+  Planetarium const new_generation_planetarium(parameters,
+                                               perspective_,
+                                               &ephemeris_,
+                                               &plotting_frame_,
+                                               /*plotting_frame_generation=*/1,
+                                               plotting_to_scaled_space_);
+  ::testing::Mock::VerifyAndClearExpectations(&plotting_frame_);
+  EXPECT_CALL(plotting_frame_, ToThisFrameAtTime(_))
+      .Times(AtLeast(1))
+      .WillRepeatedly(Return(RigidMotion<Barycentric, Navigation>(
+          RigidTransformation<Barycentric, Navigation>::Identity(),
+          Barycentric::nonrotating,
+          Barycentric::unmoving)));
+  std::vector<ScaledSpacePoint> recomputed_line;
+  new_generation_planetarium.PlotMethod3(
+      discrete_trajectory,
+      discrete_trajectory.front().time,
+      discrete_trajectory.back().time,
+      t0_ + 10 * Second,
+      /*reverse=*/false,
+      [&recomputed_line](ScaledSpacePoint const& point) {
+        recomputed_line.push_back(point);
+      },
+      /*max_points=*/1000,
+      cache);
+  EXPECT_TRUE(std::equal(recomputed_line.begin(),
+                         recomputed_line.end(),
+                         expected_line.begin(),
+                         expected_line.end(),
+                         equal));
+  EXPECT_EQ(expected_size, cache.size());
+}
+
+TEST_F(PlanetariumTest, PlotMethod3Batched) {
+  // Circular trajectories with different radii and periods.
+  std::vector<DiscreteTrajectory<Barycentric>> discrete_trajectories(8);
+  for (int i = 0; i < discrete_trajectories.size(); ++i) {
+    AppendTrajectoryTimeline(
+        /*from=*/NewCircularTrajectoryTimeline<Barycentric>(
+            /*period=*/(10'000 + 1'000 * i) * Second,
+            /*r=*/(2 + i) * Metre,
+            /*Δt=*/10 * Second,
+            /*t1=*/t0_,
+            /*t2=*/t0_ + 5'000 * Second),
+        /*to=*/discrete_trajectories[i]);
+  }
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(parameters,
+                          perspective_,
+                          &ephemeris_,
+                          &plotting_frame_,
+                          /*plotting_frame_generation=*/0,
+                          plotting_to_scaled_space_);
+
+  auto const equal = [](ScaledSpacePoint const& left,
+                        ScaledSpacePoint const& right) {
+    return left.x == right.x && left.y == right.y && left.z == right.z;
+  };
+
+  std::vector<std::vector<ScaledSpacePoint>> expected_lines;
+  std::vector<std::vector<ScaledSpacePoint>> lines(
+      discrete_trajectories.size());
+  std::vector<Planetarium::PlottingRequest> requests;
+  for (int i = 0; i < discrete_trajectories.size(); ++i) {
+    auto const& discrete_trajectory = discrete_trajectories[i];
+    auto& expected_line = expected_lines.emplace_back();
+    planetarium.PlotMethod3(
+        discrete_trajectory,
+        discrete_trajectory.front().time,
+        discrete_trajectory.back().time,
+        /*now=*/t0_,
+        /*reverse=*/false,
+        [&expected_line](ScaledSpacePoint const& point) {
+          expected_line.push_back(point);
+        },
+        /*max_points=*/1000);
+    requests.push_back(
+        {.trajectory = &discrete_trajectory,
+         .first_time = discrete_trajectory.front().time,
+         .last_time = discrete_trajectory.back().time,
+         .reverse = false,
+         .add_point = [&line = lines[i]](ScaledSpacePoint const& point) {
+           line.push_back(point);
+         },
+         .max_points = 1000});
+  }
+
+  ThreadPool<absl::Status> pool(/*pool_size=*/4);
+  planetarium.PlotMethod3(requests, /*now=*/t0_, pool);
+  for (int i = 0; i < discrete_trajectories.size(); ++i) {
+    EXPECT_THAT(expected_lines[i], SizeIs(Ge(2)));
+    EXPECT_TRUE(std::equal(lines[i].begin(),
+                           lines[i].end(),
+                           expected_lines[i].begin(),
+                           expected_lines[i].end(),
+                           equal)) << i;
+  }
+}
+
 #if !defined(_DEBUG)
 TEST_F(PlanetariumTest, RealSolarSystem) {
   auto const discrete_trajectory =
@@ -303,6 +586,7 @@ TEST_F(PlanetariumTest, RealSolarSystem) {
                                       /*focal=*/1 * Metre),
       ephemeris.get(),
       plotting_frame.get(),
+      /*plotting_frame_generation=*/0,
       plotting_to_scaled_space_);
   auto const rp2_lines =
       planetarium.PlotMethod2(discrete_trajectory,
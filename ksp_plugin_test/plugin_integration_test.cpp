@@ -47,6 +47,7 @@ using ::testing::AnyOf;
 using ::testing::Eq;
 using ::testing::Ge;
 using ::testing::Gt;
+using ::testing::IsEmpty;
 using ::testing::Le;
 using ::testing::Lt;
 using ::testing::SizeIs;
@@ -185,6 +186,80 @@ TEST_F(PluginIntegrationTest, AdvanceTimeWithCelestialsOnly) {
       Lt(0.01));
 }
 
+// Checks that the vessels that nobody looks at don't deserialize their history
+// when time advances after a load.
+TEST_F(PluginIntegrationTest, LazyHistoriesAfterLoad) {
+  InsertAllSolarSystemBodies();
+  plugin_->EndInitialization();
+
+  constexpr int vessel_count = 3;
+  std::vector<GUID> vessel_guids;
+  for (int i = 0; i < vessel_count; ++i) {
+    GUID const guid = vessel_guid + std::to_string(i);
+    vessel_guids.push_back(guid);
+    bool inserted;
+    plugin_->InsertOrKeepVessel(guid,
+                                vessel_name,
+                                SolarSystemFactory::Earth,
+                                /*loaded=*/false,
+                                inserted);
+    plugin_->InsertUnloadedPart(
+        part_id + i,
+        part_name,
+        guid,
+        RelativeDegreesOfFreedom<AliceSun>(
+            (1 + 0.1 * i) * satellite_initial_displacement_,
+            satellite_initial_velocity_));
+  }
+  plugin_->PrepareToReportCollisions();
+  plugin_->FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+
+  Time const δt = 10 * Minute;
+  Instant t = ParseTT(initial_time_);
+  for (int i = 0; i < 6; ++i) {
+    t += δt;
+    plugin_->AdvanceTime(t, planetarium_rotation_);
+    VesselSet collided_vessels;
+    plugin_->CatchUpLaggingVessels(collided_vessels);
+  }
+
+  serialization::Plugin plugin_message;
+  plugin_->WriteToMessage(&plugin_message);
+  plugin_ = Plugin::ReadFromMessage(plugin_message);
+  for (auto const& guid : vessel_guids) {
+    EXPECT_TRUE(plugin_->GetVessel(guid)->has_serialized_history());
+  }
+
+  // Advancing time leaves the new points in the parts.
+  t += δt;
+  plugin_->AdvanceTime(t, planetarium_rotation_);
+  VesselSet collided_vessels;
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_THAT(collided_vessels, IsEmpty());
+  for (auto const& guid : vessel_guids) {
+    auto const vessel = plugin_->GetVessel(guid);
+    EXPECT_TRUE(vessel->has_serialized_history());
+    EXPECT_THAT(vessel->psychohistory_t_max(), Lt(t));
+  }
+
+  // Looking at a vessel deserializes its history and appends these points.
+  auto const vessel = plugin_->GetVessel(vessel_guids.front());
+  EXPECT_EQ(t, vessel->psychohistory()->back().time);
+  EXPECT_FALSE(vessel->has_serialized_history());
+  EXPECT_EQ(t, vessel->psychohistory_t_max());
+  EXPECT_TRUE(
+      plugin_->GetVessel(vessel_guids.back())->has_serialized_history());
+
+  // The other vessels are not affected by another step.
+  t += δt;
+  plugin_->AdvanceTime(t, planetarium_rotation_);
+  plugin_->CatchUpLaggingVessels(collided_vessels);
+  EXPECT_EQ(t, vessel->psychohistory()->back().time);
+  for (int i = 1; i < vessel_count; ++i) {
+    EXPECT_TRUE(plugin_->GetVessel(vessel_guids[i])->has_serialized_history());
+  }
+}
+
 TEST_F(PluginIntegrationTest, BodyCentredNonrotatingNavigationIntegration) {
   InsertAllSolarSystemBodies();
   plugin_->EndInitialization();
@@ -32,6 +32,7 @@
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/identification.hpp"
+#include "ksp_plugin/vessel.hpp"
 #include "physics/continuous_trajectory.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/ephemeris.hpp"
@@ -97,6 +98,7 @@ using namespace principia::integrators::_symmetric_linear_multistep_integrator;
 using namespace principia::ksp_plugin::_frames;
 using namespace principia::ksp_plugin::_identification;
 using namespace principia::ksp_plugin::_plugin;
+using namespace principia::ksp_plugin::_vessel;
 using namespace principia::physics::_continuous_trajectory;
 using namespace principia::physics::_degrees_of_freedom;
 using namespace principia::physics::_ephemeris;
@@ -444,6 +446,13 @@ TEST_F(PluginTest, Serialization) {
   serialization::Plugin second_message;
   plugin->WriteToMessage(&second_message);
 
+  // The history of the vessel has not been looked at, so it was neither
+  // deserialized nor reserialized.
+  not_null<Vessel*> const vessel = plugin->GetVessel(satellite);
+  EXPECT_TRUE(vessel->has_serialized_history());
+  EXPECT_EQ(message.vessel(0).vessel().history().SerializeAsString(),
+            second_message.vessel(0).vessel().history().SerializeAsString());
+
   // The zfp serialization is not idempotent because we exactly preserve the
   // bounds of each segment.  Ignore it for the purposes of comparing the
   // messages.
@@ -452,6 +461,12 @@ TEST_F(PluginTest, Serialization) {
   second_message.mutable_vessel(0)->mutable_vessel()
       ->mutable_history()->mutable_segment(0)->clear_zfp();
   EXPECT_THAT(message, EqualsProto(second_message));
+
+  // Looking at the vessel deserializes its history.
+  Instant const psychohistory_t_max = vessel->psychohistory_t_max();
+  EXPECT_EQ(psychohistory_t_max, vessel->psychohistory()->back().time);
+  EXPECT_FALSE(vessel->has_serialized_history());
+  EXPECT_EQ(psychohistory_t_max, vessel->psychohistory_t_max());
 }
 
 TEST_F(PluginTest, Initialization) {
@@ -1,5 +1,6 @@
 #include "ksp_plugin/renderer.hpp"
 
+#include <cstdint>
 #include <memory>
 
 #include "base/not_null.hpp"
@@ -104,6 +105,39 @@ TEST_F(RendererTest, TargetVessel) {
   EXPECT_FALSE(renderer_.HasTargetVessel());
 }
 
+TEST_F(RendererTest, PlottingFrameGeneration) {
+  MockEphemeris<Barycentric> ephemeris;
+  MockContinuousTrajectory<Barycentric> celestial_trajectory;
+  EXPECT_CALL(ephemeris, trajectory(_))
+      .WillRepeatedly(Return(&celestial_trajectory));
+  MockVessel vessel;
+  EXPECT_CALL(vessel, prediction_generation()).WillRepeatedly(Return(3));
+
+  std::int64_t generation = renderer_.plotting_frame_generation();
+  EXPECT_EQ(generation, renderer_.plotting_frame_generation());
+
+  renderer_.SetPlottingFrame(
+      std::make_unique<MockRigidReferenceFrame<Barycentric, Navigation>>());
+  EXPECT_NE(generation, renderer_.plotting_frame_generation());
+  generation = renderer_.plotting_frame_generation();
+
+  renderer_.SetTargetVessel(&vessel, &celestial_, &ephemeris);
+  EXPECT_NE(generation, renderer_.plotting_frame_generation());
+  generation = renderer_.plotting_frame_generation();
+  EXPECT_EQ(generation, renderer_.plotting_frame_generation());
+
+  // The target frame is the same object, but the target prediction changes.
+  auto const target_frame = renderer_.GetPlottingFrame();
+  EXPECT_CALL(vessel, prediction_generation()).WillRepeatedly(Return(4));
+  EXPECT_EQ(target_frame, renderer_.GetPlottingFrame());
+  EXPECT_NE(generation, renderer_.plotting_frame_generation());
+  generation = renderer_.plotting_frame_generation();
+  EXPECT_EQ(generation, renderer_.plotting_frame_generation());
+
+  renderer_.ClearTargetVessel();
+  EXPECT_NE(generation, renderer_.plotting_frame_generation());
+}
+
 TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithoutTargetVessel) {
   auto const vx = 6 * Metre / Second;
   auto const vy = 5 * Metre / Second;
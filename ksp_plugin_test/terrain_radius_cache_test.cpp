@@ -0,0 +1,159 @@
+#include "ksp_plugin/terrain_radius_cache.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"  // 🧙 For π.
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/almost_equals.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+
+using ::testing::Each;
+using ::testing::Eq;
+using ::testing::Lt;
+using namespace principia::ksp_plugin::_terrain_radius_cache;
+using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+using namespace principia::testing_utilities::_almost_equals;
+
+class TerrainRadiusCacheTest : public ::testing::Test {
+ protected:
+  TerrainRadiusCacheTest()
+      : radii_([this](std::vector<std::tuple<Angle, Angle>> const&
+                          latitudes_longitudes) {
+          ++number_of_calls_;
+          std::vector<Length> result;
+          for (auto const& [latitude, longitude] : latitudes_longitudes) {
+            result.push_back(Radius(latitude, longitude));
+          }
+          return result;
+        }) {
+    for (int k = 0; k < 100; ++k) {
+      latitudes_longitudes_.emplace_back((-45 + 0.3 * k) * Degree,
+                                         (170 + 0.2 * k) * Degree);
+    }
+  }
+
+  static Length Radius(Angle const& latitude, Angle const& longitude) {
+    return 600 * Kilo(Metre) +
+           1 * Kilo(Metre) * Sin(3 * longitude) * Cos(2 * latitude);
+  }
+
+  std::vector<Length> ExactRadii() const {
+    std::vector<Length> result;
+    for (auto const& [latitude, longitude] : latitudes_longitudes_) {
+      result.push_back(Radius(latitude, longitude));
+    }
+    return result;
+  }
+
+  TerrainRadiusCache cache_;
+  std::vector<std::tuple<Angle, Angle>> latitudes_longitudes_;
+  std::int64_t number_of_calls_ = 0;
+  TerrainRadiusCache::BatchedRadii const radii_;
+};
+
+TEST_F(TerrainRadiusCacheTest, Convergence) {
+  Length const tolerance = 10 * Metre;
+
+  // The first call can only return exact radii, and samples the cells at the
+  // minimum level that contain the points.
+  EXPECT_THAT(cache_.Radii(latitudes_longitudes_, tolerance, radii_),
+              Eq(ExactRadii()));
+  EXPECT_EQ(1, number_of_calls_);
+  EXPECT_EQ(111, cache_.number_of_samples());
+
+  // Each call refines the cells by one level until the error of a cell and of
+  // its parent is below the tolerance, at which point |radii| is no longer
+  // called.
+  for (int i = 0; i < 20; ++i) {
+    auto const radii = cache_.Radii(latitudes_longitudes_, tolerance, radii_);
+    auto const exact_radii = ExactRadii();
+    for (int k = 0; k < radii.size(); ++k) {
+      EXPECT_THAT(Abs(radii[k] - exact_radii[k]), Lt(tolerance));
+    }
+  }
+  EXPECT_EQ(2, number_of_calls_);
+  EXPECT_EQ(247, cache_.number_of_samples());
+
+  // A tighter tolerance causes further refinement.
+  std::int64_t const previous_number_of_calls = number_of_calls_;
+  cache_.Radii(latitudes_longitudes_, 1 * Metre, radii_);
+  EXPECT_EQ(previous_number_of_calls + 1, number_of_calls_);
+}
+
+// A relief that is periodic on the cells at the minimum level and vanishes at
+// their corners and centres, so that it cannot be seen by sampling only these
+// points.
+TEST_F(TerrainRadiusCacheTest, Relief) {
+  Angle const cell_size = 45 * Degree / 16;
+  auto const relief = [cell_size](Angle const& latitude,
+                                  Angle const& longitude) {
+    return 600 * Kilo(Metre) +
+           1 * Kilo(Metre) *
+               (Pow<2>(Sin(π * Radian * longitude / cell_size)) -
+                Pow<2>(Sin(π * Radian * (latitude + 90 * Degree) / cell_size)));
+  };
+  TerrainRadiusCache::BatchedRadii const radii =
+      [this, &relief](std::vector<std::tuple<Angle, Angle>> const&
+                          latitudes_longitudes) {
+        ++number_of_calls_;
+        std::vector<Length> result;
+        for (auto const& [latitude, longitude] : latitudes_longitudes) {
+          result.push_back(relief(latitude, longitude));
+        }
+        return result;
+      };
+
+  Length const tolerance = 10 * Metre;
+  for (int i = 0; i < 20; ++i) {
+    auto const cached_radii =
+        cache_.Radii(latitudes_longitudes_, tolerance, radii);
+    for (int k = 0; k < cached_radii.size(); ++k) {
+      auto const& [latitude, longitude] = latitudes_longitudes_[k];
+      EXPECT_THAT(Abs(cached_radii[k] - relief(latitude, longitude)),
+                  Lt(tolerance));
+    }
+  }
+  EXPECT_EQ(7, number_of_calls_);
+}
+
+TEST_F(TerrainRadiusCacheTest, FlatTerrain) {
+  TerrainRadiusCache::BatchedRadii const flat =
+      [this](std::vector<std::tuple<Angle, Angle>> const&
+                 latitudes_longitudes) {
+        ++number_of_calls_;
+        return std::vector<Length>(latitudes_longitudes.size(), 1 * Metre);
+      };
+  // The first call samples the cells at the minimum level, which only serve as
+  // parents, and the second one their children.
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(cache_.Radii(latitudes_longitudes_, 1 * Milli(Metre), flat),
+                Each(AlmostEquals(1 * Metre, 0, 1)));
+  }
+  EXPECT_EQ(2, number_of_calls_);
+
+  // The longitudes wrap around and the poles are included.
+  std::vector<std::tuple<Angle, Angle>> const extreme_latitudes_longitudes = {
+      {90 * Degree, 0 * Degree},
+      {-90 * Degree, 360 * Degree},
+      {0 * Degree, -180 * Degree},
+      {0 * Degree, 720 * Degree}};
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(
+        cache_.Radii(extreme_latitudes_longitudes, 1 * Milli(Metre), flat),
+        Each(AlmostEquals(1 * Metre, 0, 1)));
+  }
+  EXPECT_EQ(4, number_of_calls_);
+}
+
+}  // namespace ksp_plugin
+}  // namespace principia
@@ -4,6 +4,7 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -49,6 +50,7 @@ namespace ksp_plugin {
 using ::testing::AllOf;
 using ::testing::AnyNumber;
 using ::testing::DoAll;
+using ::testing::Each;
 using ::testing::ElementsAre;
 using ::testing::Ge;
 using ::testing::Le;
@@ -846,6 +848,95 @@ TEST_F(VesselTest, SerializationSuccess) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+TEST_F(VesselTest, LazyHistoryDeserialization) {
+  MockFunction<int(not_null<PileUp const*>)>
+      serialization_index_for_pile_up;
+  EXPECT_CALL(serialization_index_for_pile_up, Call(_)).Times(0);
+
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(t0_ + 2 * Second));
+  EXPECT_CALL(ephemeris_,
+              FlowWithAdaptiveStep(_, _, InfiniteFuture, _, _))
+      .Times(AnyNumber());
+  EXPECT_CALL(ephemeris_,
+              FlowWithAdaptiveStep(_, _, t0_ + 2 * Second, _, _))
+      .Times(AnyNumber());
+  EXPECT_CALL(ephemeris_, Prolong(_, _))
+      .WillRepeatedly(Return(absl::OkStatus()));
+  vessel_.CreateTrajectoryIfNeeded(t0_);
+
+  AppendTrajectoryTimeline<Barycentric>(
+      NewLinearTrajectoryTimeline<Barycentric>(p1_dof_,
+                                               /*Δt=*/0.5 * Second,
+                                               /*t0=*/t0_,
+                                               /*t1=*/t0_ + 0.5 * Second,
+                                               /*t2=*/t0_ + 1.5 * Second),
+      [this](Instant const& time,
+             DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
+        p1_->AppendToHistory(time, degrees_of_freedom);
+      });
+  AppendTrajectoryTimeline<Barycentric>(
+      NewLinearTrajectoryTimeline<Barycentric>(p2_dof_,
+                                               /*Δt=*/0.5 * Second,
+                                               /*t0=*/t0_,
+                                               /*t1=*/t0_ + 0.5 * Second,
+                                               /*t2=*/t0_ + 1.5 * Second),
+      [this](Instant const& time,
+             DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
+        p2_->AppendToHistory(time, degrees_of_freedom);
+      });
+  vessel_.AdvanceTime();
+
+  serialization::Vessel message;
+  vessel_.WriteToMessage(&message,
+                         serialization_index_for_pile_up.AsStdFunction());
+
+  // The history is not deserialized by reading the vessel, and an untouched
+  // vessel writes it back byte for byte.
+  auto const v1 = Vessel::ReadFromMessage(
+      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  EXPECT_TRUE(v1->has_serialized_history());
+  EXPECT_EQ(vessel_.psychohistory()->back().time, v1->psychohistory_t_max());
+  serialization::Vessel second_message;
+  v1->WriteToMessage(&second_message,
+                     serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_TRUE(v1->has_serialized_history());
+  EXPECT_EQ(message.SerializeAsString(), second_message.SerializeAsString());
+
+  // Accessing the trajectory deserializes the history.
+  EXPECT_EQ(vessel_.trajectory().size(), v1->trajectory().size());
+  EXPECT_FALSE(v1->has_serialized_history());
+  for (auto it1 = vessel_.trajectory().begin(), it2 = v1->trajectory().begin();
+       it1 != vessel_.trajectory().end();
+       ++it1, ++it2) {
+    EXPECT_EQ(it1->time, it2->time);
+    EXPECT_EQ(it1->degrees_of_freedom, it2->degrees_of_freedom);
+  }
+  EXPECT_EQ(vessel_.psychohistory()->back().time, v1->psychohistory_t_max());
+  serialization::Vessel third_message;
+  v1->WriteToMessage(&third_message,
+                     serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_THAT(third_message, EqualsProto(message));
+
+  // Concurrent accesses deserialize the history only once.
+  auto const v2 = Vessel::ReadFromMessage(
+      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  std::vector<std::thread> threads;
+  std::vector<std::int64_t> sizes(4);
+  for (int i = 0; i < sizes.size(); ++i) {
+    threads.emplace_back([&v2, &sizes, i]() {
+      sizes[i] = v2->psychohistory()->size() + v2->trajectory().size();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(v2->has_serialized_history());
+  EXPECT_THAT(sizes,
+              Each(vessel_.psychohistory()->size() +
+                   vessel_.trajectory().size()));
+}
+
 #if !defined(_DEBUG)
 TEST_F(VesselTest, TailSerialization) {
   // Must be large enough that truncation happens.
@@ -21,6 +21,11 @@ using namespace principia::quantities::_named_quantities;
 template<typename Argument, typename Function>
 using Value = std::invoke_result_t<Function, Argument>;
 
+// In the functions below, if |f| may also be called with a
+// |std::vector<Argument>| and then returns a |std::vector| of the values at
+// these arguments, it is called once for all the new Чебышёв–Lobatto points of
+// each degree.  This is useful when evaluating |f| has a high latency.
+
 // A function that returns true iff the interpolation interval should be split
 // further.  It is only called if the |error_estimate| is larger than the
 // |max_error| given to |AdaptiveЧебышёвPolynomialInterpolant|.
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,27 @@ using namespace principia::numerics::_чебышёв_lobatto;
 using namespace principia::quantities::_elementary_functions;
 using namespace principia::quantities::_si;
 
+// Evaluates |f| at all the |arguments|, in a single call if possible.
+template<typename Argument, typename Function>
+std::vector<Value<Argument, Function>> EvaluateAll(
+    Function const& f,
+    std::vector<Argument> const& arguments) {
+  if constexpr (std::is_invocable_r_v<std::vector<Value<Argument, Function>>,
+                                      Function const&,
+                                      std::vector<Argument> const&>) {
+    auto values = f(arguments);
+    CHECK_EQ(arguments.size(), values.size());
+    return values;
+  } else {
+    std::vector<Value<Argument, Function>> values;
+    values.reserve(arguments.size());
+    for (auto const& argument : arguments) {
+      values.push_back(f(argument));
+    }
+    return values;
+  }
+}
+
 // Compute the interpolation matrix and cache it in a static variable.
 template<int N>
 FixedMatrix<double, N + 1, N + 1> const& ЧебышёвInterpolationMatrix() {
@@ -71,8 +93,14 @@ not_null<std::unique_ptr<
   }
 
   // Evaluate |f| for the new points.
+  std::vector<Argument> new_points;
+  new_points.reserve(N / 2);
+  for (std::int64_t k = 1; k < N; k += 2) {
+    new_points.push_back(чебышёв_lobato_point(k));
+  }
+  auto const new_fₖ = EvaluateAll(f, new_points);
   for (std::int64_t k = 1; k < N; k += 2) {
-    fₖ[k] = f(чебышёв_lobato_point(k));
+    fₖ[k] = new_fₖ[k / 2];
   }
 
   // Compute the coefficients of the Чебышёв polynomial.
@@ -192,8 +220,9 @@ not_null<std::unique_ptr<
     Difference<Value<Argument, Function>>* const error_estimate) {
   auto const& a = lower_bound;
   auto const& b = upper_bound;
-  auto const f_a = f(a);
-  auto const f_b = f(b);
+  auto const f_ab = EvaluateAll(f, std::vector<Argument>{a, b});
+  auto const& f_a = f_ab[0];
+  auto const& f_b = f_ab[1];
   FixedVector<Value<Argument, Function>, 2> const fₖ({f_b, f_a});
   FixedVector<Value<Argument, Function>, 2> const aⱼ(
       {0.5 * (f_b + f_a), 0.5 * (f_b - f_a)});
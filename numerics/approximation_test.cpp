@@ -1,5 +1,8 @@
 #include "numerics/approximation.hpp"
 
+#include <cstdint>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "numerics/polynomial_in_чебышёв_basis.hpp"
@@ -69,6 +72,43 @@ TEST(ApproximationTest, Exp) {
   }
 }
 
+TEST(ApproximationTest, BatchedExp) {
+  // A function that may be evaluated one argument at a time or in batches.
+  struct BatchedExp {
+    double operator()(double const x) const {
+      return std::exp(x);
+    }
+    std::vector<double> operator()(std::vector<double> const& xs) const {
+      batch_sizes.push_back(xs.size());
+      std::vector<double> values;
+      for (double const x : xs) {
+        values.push_back(std::exp(x));
+      }
+      return values;
+    }
+    mutable std::vector<std::int64_t> batch_sizes;
+  };
+
+  BatchedExp const f;
+  auto const interpolant =
+      ЧебышёвPolynomialInterpolant<128>(f,
+                                        /*lower_bound=*/0.01,
+                                        /*upper_bound=*/3.0,
+                                        /*max_error=*/1e-6);
+  auto const unbatched_interpolant = ЧебышёвPolynomialInterpolant<128>(
+      [](double const x) { return std::exp(x); },
+      /*lower_bound=*/0.01,
+      /*upper_bound=*/3.0,
+      /*max_error=*/1e-6);
+
+  // One batch for the extremities, and one for the new points of each degree.
+  EXPECT_EQ(16, interpolant->degree());
+  EXPECT_THAT(f.batch_sizes, ElementsAre(2, 1, 2, 4, 8, 16));
+  for (double x = 0.01; x < 3; x += 0.01) {
+    EXPECT_EQ((*unbatched_interpolant)(x), (*interpolant)(x));
+  }
+}
+
 TEST(ApproximationTest, AdaptiveSinInverse) {
   auto const f = [](double const x) { return Sin(1 * Radian / x); };
   SubdivisionPredicate<double, double> subdivide =
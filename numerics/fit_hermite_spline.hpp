@@ -1,7 +1,9 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "geometry/hilbert.hpp"
 #include "quantities/named_quantities.hpp"
@@ -36,6 +38,21 @@ absl::StatusOr<std::list<typename Samples::const_iterator>> FitHermiteSpline(
         typename Samples::value_type const&)> const& get_derivative,
     typename Hilbert<Difference<Value>>::NormType const& tolerance);
 
+// Same as above, but the iterators are stored in |fit|, which is cleared
+// first.  This overload does not allocate if |fit| has enough capacity, which
+// is the case if it is reused across calls with samples of similar sizes.
+template<typename Value, typename Argument, typename Samples>
+absl::Status FitHermiteSpline(
+    Samples const& samples,
+    std::function<Argument const&(typename Samples::value_type const&)> const&
+        get_argument,
+    std::function<Value const&(typename Samples::value_type const&)> const&
+        get_value,
+    std::function<Derivative<Value, Argument> const&(
+        typename Samples::value_type const&)> const& get_derivative,
+    typename Hilbert<Difference<Value>>::NormType const& tolerance,
+    std::vector<typename Samples::const_iterator>& fit);
+
 }  // namespace internal
 
 using internal::FitHermiteSpline;
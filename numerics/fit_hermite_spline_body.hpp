@@ -4,6 +4,7 @@
 
 #include <list>
 #include <type_traits>
+#include <vector>
 
 #include "base/jthread.hpp"  // 🧙 For RETURN_IF_STOPPED.
 #include "base/ranges.hpp"
@@ -27,10 +28,30 @@ absl::StatusOr<std::list<typename Samples::const_iterator>> FitHermiteSpline(
     std::function<Derivative<Value, Argument> const&(
         typename Samples::value_type const&)> const& get_derivative,
     typename Hilbert<Difference<Value>>::NormType const& tolerance) {
+  std::vector<typename Samples::const_iterator> fit;
+  absl::Status const status = FitHermiteSpline<Value, Argument>(
+      samples, get_argument, get_value, get_derivative, tolerance, fit);
+  if (!status.ok()) {
+    return status;
+  }
+  return std::list<typename Samples::const_iterator>(fit.begin(), fit.end());
+}
+
+template<typename Value, typename Argument, typename Samples>
+absl::Status FitHermiteSpline(
+    Samples const& samples,
+    std::function<Argument const&(typename Samples::value_type const&)> const&
+        get_argument,
+    std::function<Value const&(typename Samples::value_type const&)> const&
+        get_value,
+    std::function<Derivative<Value, Argument> const&(
+        typename Samples::value_type const&)> const& get_derivative,
+    typename Hilbert<Difference<Value>>::NormType const& tolerance,
+    std::vector<typename Samples::const_iterator>& fit) {
   using Iterator = typename Samples::const_iterator;
 
   auto interpolation_error_is_within_tolerance =
-      [get_argument, get_derivative, get_value, tolerance](
+      [&get_argument, &get_derivative, &get_value, &tolerance](
           Iterator const begin, Iterator const last) {
         return Hermite3<Value, Argument>(
                    {get_argument(*begin), get_argument(*last)},
@@ -40,11 +61,11 @@ absl::StatusOr<std::list<typename Samples::const_iterator>> FitHermiteSpline(
                 Range(begin, last + 1), get_argument, get_value, tolerance);
       };
 
-  std::list<Iterator> fit;
+  fit.clear();
   if (samples.size() < 3) {
     // With 0 or 1 points there is nothing to interpolate, with 2 we cannot
     // estimate the error.
-    return fit;
+    return absl::OkStatus();
   }
 
   Iterator begin = samples.begin();
@@ -91,7 +112,7 @@ absl::StatusOr<std::list<typename Samples::const_iterator>> FitHermiteSpline(
 #if PRINCIPIA_MUST_ALWAYS_DOWNSAMPLE
   CHECK_LT(fit.size(), samples.size() - 2);
 #endif
-  return fit;
+  return absl::OkStatus();
 }
 
 }  // namespace internal
@@ -15,11 +15,13 @@
 #include "quantities/si.hpp"
 #include "testing_utilities/approximate_quantity.hpp"
 #include "testing_utilities/is_near.hpp"
+#include "testing_utilities/matchers.hpp"  // 🧙 For EXPECT_OK.
 
 namespace principia {
 namespace numerics {
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
 using ::testing::Eq;
 using ::testing::ResultOf;
 using namespace principia::base::_ranges;
@@ -113,6 +115,45 @@ TEST_F(FitHermiteSplineTest, Sinusoid) {
               IsNear(107_(1) * Nano(Metre)));
 }
 
+TEST_F(FitHermiteSplineTest, ReusedOutput) {
+  AngularFrequency const ω = 1 * Radian / Second;
+  std::vector<Sample> samples;
+  for (auto t = DoublePrecision<Instant>(t0_);
+       t.value < t0_ + π * Second;
+       t.Increment(20 * Milli(Second))) {
+    samples.push_back({t.value,
+                       Cos(ω * (t.value - t0_)) * Metre,
+                       -ω * Sin(ω * (t.value - t0_)) * Metre / Radian});
+  }
+  auto const fit_hermite_spline =
+      [&samples](std::vector<std::vector<Sample>::const_iterator>& fit) {
+        return FitHermiteSpline<Length, Instant>(
+            samples,
+            [](auto&& sample) -> auto&& { return sample.t; },
+            [](auto&& sample) -> auto&& { return sample.x; },
+            [](auto&& sample) -> auto&& { return sample.v; },
+            1 * Centi(Metre),
+            fit);
+      };
+
+  // The output is cleared before being filled, and its storage is reused.
+  std::vector<std::vector<Sample>::const_iterator> fit(100, samples.cend());
+  auto const* const data = fit.data();
+  EXPECT_OK(fit_hermite_spline(fit));
+  std::vector<std::vector<Sample>::const_iterator> const first_fit = fit;
+  EXPECT_OK(fit_hermite_spline(fit));
+  EXPECT_EQ(first_fit, fit);
+  EXPECT_EQ(data, fit.data());
+
+  auto const interpolation_points = FitHermiteSpline<Length, Instant>(
+      samples,
+      [](auto&& sample) -> auto&& { return sample.t; },
+      [](auto&& sample) -> auto&& { return sample.x; },
+      [](auto&& sample) -> auto&& { return sample.v; },
+      1 * Centi(Metre)).value();
+  EXPECT_THAT(interpolation_points, ElementsAreArray(fit));
+}
+
 #if PRINCIPIA_MUST_ALWAYS_DOWNSAMPLE
 TEST_F(FitHermiteSplineDeathTest, NoDownsampling) {
   AngularFrequency const ω = 1 * Radian / Second;
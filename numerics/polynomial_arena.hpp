@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "numerics/polynomial.hpp"
+#include "numerics/polynomial_in_monomial_basis.hpp"
+#include "quantities/named_quantities.hpp"
+
+namespace principia {
+namespace numerics {
+namespace _polynomial_arena {
+namespace internal {
+
+using namespace principia::base::_not_null;
+using namespace principia::numerics::_polynomial;
+using namespace principia::numerics::_polynomial_in_monomial_basis;
+using namespace principia::quantities::_named_quantities;
+
+// A storage for a sequence of polynomials that avoids a heap allocation per
+// polynomial.  The polynomials in the monomial basis whose degree is in
+// [min_degree, max_degree] are moved into contiguous buckets, one per degree,
+// and are evaluated without a virtual call on the polynomial (the polynomial
+// still calls its evaluator indirectly).  Other
+// polynomials are kept on the heap and evaluated through |Polynomial|.  The
+// polynomials are designated by (small, trivially copyable) handles.  This
+// class is not thread-safe.
+template<typename Value, typename Argument, int min_degree, int max_degree>
+class PolynomialArena {
+  static_assert(min_degree <= max_degree);
+
+  // The bucket for the polynomials that are not in the monomial basis, or don't
+  // have a degree in [min_degree, max_degree].
+  static constexpr int heap_bucket = max_degree - min_degree + 1;
+  static constexpr int number_of_buckets = heap_bucket + 1;
+  // The limit of |VisitBucket|.
+  static_assert(heap_bucket <= 16);
+
+ public:
+  class Handle {
+   public:
+    Handle() = default;
+
+   private:
+    Handle(int bucket, std::int32_t index);
+
+    std::int32_t bucket_ = heap_bucket;
+    std::int32_t index_ = -1;
+
+    friend class PolynomialArena;
+  };
+
+  PolynomialArena() = default;
+  PolynomialArena(PolynomialArena&&) = default;
+  PolynomialArena& operator=(PolynomialArena&&) = default;
+
+  // Takes ownership of |polynomial|, and returns a handle designating it.
+  Handle Add(
+      not_null<std::unique_ptr<Polynomial<Value, Argument>>> polynomial);
+
+  // Removes the polynomial designated by |handle|, which must be the one most
+  // recently added to this arena among those with the same type.  In practice,
+  // if the polynomials are removed in the reverse order of their addition, this
+  // condition is always satisfied.
+  void RemoveLast(Handle const& handle);
+
+  // Removes all the polynomials.
+  void Clear();
+
+  // Moves all the polynomials of |other| at the end of this arena and returns a
+  // function that maps a handle into |other| to a handle into this arena.
+  std::function<Handle(Handle const&)> Splice(PolynomialArena&& other);
+
+  // The polynomial designated by |handle|, for the operations that are not
+  // performance-critical, e.g., serialization.
+  Polynomial<Value, Argument> const& polynomial(Handle const& handle) const;
+
+  Value PRINCIPIA_VECTORCALL Evaluate(Handle const& handle,
+                                      Argument argument) const;
+  Derivative<Value, Argument> PRINCIPIA_VECTORCALL EvaluateDerivative(
+      Handle const& handle,
+      Argument argument) const;
+
+  // The number of polynomials in this arena, and the number of those that are
+  // not stored in the contiguous buckets.
+  std::int64_t size() const;
+  std::int64_t heap_size() const;
+
+ private:
+  template<int degree>
+  using Bucket =
+      std::vector<PolynomialInMonomialBasis<Value, Argument, degree>>;
+
+  template<typename Degrees>
+  struct BucketsGenerator;
+  template<int... degrees>
+  struct BucketsGenerator<std::integer_sequence<int, degrees...>> {
+    using Type = std::tuple<Bucket<min_degree + degrees>...>;
+  };
+  using Buckets = typename BucketsGenerator<
+      std::make_integer_sequence<int, heap_bucket>>::Type;
+
+  template<int degree>
+  Bucket<degree>& bucket();
+  template<int degree>
+  Bucket<degree> const& bucket() const;
+
+  // Returns the handle for |polynomial| if it can be stored in one of the
+  // buckets, or a handle to the heap bucket if it cannot.
+  template<int... degrees>
+  Handle AddToBucket(
+      not_null<std::unique_ptr<Polynomial<Value, Argument>>>& polynomial,
+      std::integer_sequence<int, degrees...>);
+
+  template<int degree>
+  Value EvaluateInBucket(std::int32_t index, Argument argument) const;
+  template<int degree>
+  Derivative<Value, Argument> EvaluateDerivativeInBucket(
+      std::int32_t index,
+      Argument argument) const;
+  template<int degree>
+  Polynomial<Value, Argument> const& PolynomialInBucket(
+      std::int32_t index) const;
+  template<int degree>
+  void RemoveLastInBucket(std::int32_t index);
+
+  // Calls |f.template operator()<degree>()| where |degree| is the degree of the
+  // polynomials of |bucket|, which must not be the heap bucket.  This is a
+  // |switch|, not an indirect call, so that the compiler may inline the
+  // evaluation.
+  template<typename F>
+  static decltype(auto) VisitBucket(std::int32_t bucket, F&& f);
+
+  Buckets buckets_;
+  std::vector<not_null<std::unique_ptr<Polynomial<Value, Argument>>>> heap_;
+};
+
+}  // namespace internal
+
+using internal::PolynomialArena;
+
+}  // namespace _polynomial_arena
+}  // namespace numerics
+}  // namespace principia
+
+#include "numerics/polynomial_arena_body.hpp"
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "numerics/polynomial_arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace numerics {
+namespace _polynomial_arena {
+namespace internal {
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+PolynomialArena<Value, Argument, min_degree, max_degree>::Handle::Handle(
+    int const bucket,
+    std::int32_t const index)
+    : bucket_(bucket),
+      index_(index) {}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+auto PolynomialArena<Value, Argument, min_degree, max_degree>::Add(
+    not_null<std::unique_ptr<Polynomial<Value, Argument>>> polynomial)
+    -> Handle {
+  Handle const handle = AddToBucket(
+      polynomial, std::make_integer_sequence<int, heap_bucket>());
+  if (handle.bucket_ != heap_bucket) {
+    return handle;
+  }
+  heap_.push_back(std::move(polynomial));
+  return Handle(heap_bucket, heap_.size() - 1);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+void PolynomialArena<Value, Argument, min_degree, max_degree>::RemoveLast(
+    Handle const& handle) {
+  if (handle.bucket_ == heap_bucket) {
+    CHECK_EQ(handle.index_, heap_.size() - 1);
+    heap_.pop_back();
+  } else {
+    VisitBucket(handle.bucket_, [this, &handle]<int degree>() {
+      this->template RemoveLastInBucket<degree>(handle.index_);
+    });
+  }
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+void PolynomialArena<Value, Argument, min_degree, max_degree>::Clear() {
+  std::apply([](auto&... buckets) { (buckets.clear(), ...); }, buckets_);
+  heap_.clear();
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+auto PolynomialArena<Value, Argument, min_degree, max_degree>::Splice(
+    PolynomialArena&& other) -> std::function<Handle(Handle const&)> {
+  std::array<std::int32_t, number_of_buckets> offsets;
+  [this, &other, &offsets]<int... degrees>(
+      std::integer_sequence<int, degrees...>) {
+    ((offsets[degrees] =
+          this->template bucket<min_degree + degrees>().size(),
+      std::move(other.template bucket<min_degree + degrees>().begin(),
+                other.template bucket<min_degree + degrees>().end(),
+                std::back_inserter(
+                    this->template bucket<min_degree + degrees>()))),
+     ...);
+  }(std::make_integer_sequence<int, heap_bucket>());
+  offsets[heap_bucket] = heap_.size();
+  std::move(other.heap_.begin(), other.heap_.end(), std::back_inserter(heap_));
+  other.Clear();
+
+  return [offsets](Handle const& handle) {
+    return Handle(handle.bucket_, handle.index_ + offsets[handle.bucket_]);
+  };
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+Polynomial<Value, Argument> const&
+PolynomialArena<Value, Argument, min_degree, max_degree>::polynomial(
+    Handle const& handle) const {
+  if (handle.bucket_ == heap_bucket) {
+    return *heap_[handle.index_];
+  } else {
+    return VisitBucket(
+        handle.bucket_,
+        [this, &handle]<int degree>() -> Polynomial<Value, Argument> const& {
+          return this->template PolynomialInBucket<degree>(handle.index_);
+        });
+  }
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+Value PRINCIPIA_VECTORCALL
+PolynomialArena<Value, Argument, min_degree, max_degree>::Evaluate(
+    Handle const& handle,
+    Argument const argument) const {
+  if (handle.bucket_ == heap_bucket) {
+    return (*heap_[handle.index_])(argument);
+  } else {
+    return VisitBucket(handle.bucket_, [this, &handle, argument]<int degree>() {
+      return this->template EvaluateInBucket<degree>(handle.index_, argument);
+    });
+  }
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+Derivative<Value, Argument> PRINCIPIA_VECTORCALL
+PolynomialArena<Value, Argument, min_degree, max_degree>::EvaluateDerivative(
+    Handle const& handle,
+    Argument const argument) const {
+  if (handle.bucket_ == heap_bucket) {
+    return heap_[handle.index_]->EvaluateDerivative(argument);
+  } else {
+    return VisitBucket(handle.bucket_, [this, &handle, argument]<int degree>() {
+      return this->template EvaluateDerivativeInBucket<degree>(handle.index_,
+                                                               argument);
+    });
+  }
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+std::int64_t
+PolynomialArena<Value, Argument, min_degree, max_degree>::size() const {
+  std::int64_t size = heap_.size();
+  std::apply([&size](auto const&... buckets) {
+               ((size += buckets.size()), ...);
+             },
+             buckets_);
+  return size;
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+std::int64_t
+PolynomialArena<Value, Argument, min_degree, max_degree>::heap_size() const {
+  return heap_.size();
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+auto PolynomialArena<Value, Argument, min_degree, max_degree>::bucket()
+    -> Bucket<degree>& {
+  return std::get<degree - min_degree>(buckets_);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+auto PolynomialArena<Value, Argument, min_degree, max_degree>::bucket() const
+    -> Bucket<degree> const& {
+  return std::get<degree - min_degree>(buckets_);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int... degrees>
+auto PolynomialArena<Value, Argument, min_degree, max_degree>::AddToBucket(
+    not_null<std::unique_ptr<Polynomial<Value, Argument>>>& polynomial,
+    std::integer_sequence<int, degrees...>) -> Handle {
+  int const degree = polynomial->degree();
+  Handle handle;
+  // The dynamic cast is only executed for the bucket that has the right degree,
+  // and is needed to rule out polynomials in other bases.
+  ([this, degree, &handle, &polynomial]() {
+     using P = PolynomialInMonomialBasis<Value, Argument, min_degree + degrees>;
+     if (degree == min_degree + degrees) {
+       if (auto* const p = dynamic_cast<P*>(&*polynomial); p != nullptr) {
+         auto& b = this->template bucket<min_degree + degrees>();
+         handle = Handle(degrees, b.size());
+         b.push_back(std::move(*p));
+       }
+     }
+   }(), ...);
+  return handle;
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+Value PolynomialArena<Value, Argument, min_degree, max_degree>::
+EvaluateInBucket(std::int32_t const index, Argument const argument) const {
+  // |operator()| is final, so this is not a virtual call.
+  return bucket<degree>()[index](argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+Derivative<Value, Argument>
+PolynomialArena<Value, Argument, min_degree, max_degree>::
+EvaluateDerivativeInBucket(std::int32_t const index,
+                           Argument const argument) const {
+  using P = PolynomialInMonomialBasis<Value, Argument, degree>;
+  // The qualified name suppresses the virtual call.
+  return bucket<degree>()[index].P::EvaluateDerivative(argument);
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+Polynomial<Value, Argument> const&
+PolynomialArena<Value, Argument, min_degree, max_degree>::PolynomialInBucket(
+    std::int32_t const index) const {
+  return bucket<degree>()[index];
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<int degree>
+void PolynomialArena<Value, Argument, min_degree, max_degree>::
+RemoveLastInBucket(std::int32_t const index) {
+  auto& b = bucket<degree>();
+  CHECK_EQ(index, b.size() - 1);
+  b.pop_back();
+}
+
+template<typename Value, typename Argument, int min_degree, int max_degree>
+template<typename F>
+decltype(auto)
+PolynomialArena<Value, Argument, min_degree, max_degree>::VisitBucket(
+    std::int32_t const bucket,
+    F&& f) {
+  DCHECK_LE(0, bucket);
+  DCHECK_LT(bucket, heap_bucket);
+  // The cases past the last bucket are never taken, but they must compile, so
+  // they use the degree of the last bucket.
+  static constexpr auto Degree = [](int const b) {
+    return min_degree + std::min(b, heap_bucket - 1);
+  };
+  switch (bucket) {
+    case 0:
+      return f.template operator()<Degree(0)>();
+    case 1:
+      return f.template operator()<Degree(1)>();
+    case 2:
+      return f.template operator()<Degree(2)>();
+    case 3:
+      return f.template operator()<Degree(3)>();
+    case 4:
+      return f.template operator()<Degree(4)>();
+    case 5:
+      return f.template operator()<Degree(5)>();
+    case 6:
+      return f.template operator()<Degree(6)>();
+    case 7:
+      return f.template operator()<Degree(7)>();
+    case 8:
+      return f.template operator()<Degree(8)>();
+    case 9:
+      return f.template operator()<Degree(9)>();
+    case 10:
+      return f.template operator()<Degree(10)>();
+    case 11:
+      return f.template operator()<Degree(11)>();
+    case 12:
+      return f.template operator()<Degree(12)>();
+    case 13:
+      return f.template operator()<Degree(13)>();
+    case 14:
+      return f.template operator()<Degree(14)>();
+    case 15:
+      return f.template operator()<Degree(15)>();
+    default:
+      LOG(FATAL) << "Unexpected bucket " << bucket;
+      std::abort();
+  }
+}
+
+}  // namespace internal
+}  // namespace _polynomial_arena
+}  // namespace numerics
+}  // namespace principia
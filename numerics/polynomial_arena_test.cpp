@@ -0,0 +1,169 @@
+#include "numerics/polynomial_arena.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/instant.hpp"
+#include "geometry/space.hpp"
+#include "gtest/gtest.h"
+#include "numerics/polynomial.hpp"
+#include "numerics/polynomial_evaluators.hpp"
+#include "numerics/polynomial_in_monomial_basis.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace numerics {
+
+using namespace principia::base::_not_null;
+using namespace principia::geometry::_frame;
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_instant;
+using namespace principia::geometry::_space;
+using namespace principia::numerics::_polynomial;
+using namespace principia::numerics::_polynomial_arena;
+using namespace principia::numerics::_polynomial_evaluators;
+using namespace principia::numerics::_polynomial_in_monomial_basis;
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+
+class PolynomialArenaTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+  using Arena = PolynomialArena<Position<World>, Instant,
+                                /*min_degree=*/3, /*max_degree=*/5>;
+  using P1 = PolynomialInMonomialBasis<Position<World>, Instant, 1>;
+  using P3 = PolynomialInMonomialBasis<Position<World>, Instant, 3>;
+  using P5 = PolynomialInMonomialBasis<Position<World>, Instant, 5>;
+
+  static not_null<std::unique_ptr<Polynomial<Position<World>, Instant>>>
+  MakeP1(double const x) {
+    return make_not_null_unique<P1>(
+        P1::Coefficients{World::origin + Displacement<World>({x * Metre,
+                                                              0 * Metre,
+                                                              0 * Metre}),
+                         Velocity<World>({1 * Metre / Second,
+                                          0 * Metre / Second,
+                                          0 * Metre / Second})},
+        t0_);
+  }
+
+  static not_null<std::unique_ptr<Polynomial<Position<World>, Instant>>>
+  MakeP3(double const x) {
+    return make_not_null_unique<P3>(
+        P3::Coefficients{World::origin + Displacement<World>({x * Metre,
+                                                              2 * Metre,
+                                                              3 * Metre}),
+                         Velocity<World>({4 * Metre / Second,
+                                          5 * Metre / Second,
+                                          6 * Metre / Second}),
+                         Vector<Acceleration, World>(
+                             {7 * Metre / Second / Second,
+                              8 * Metre / Second / Second,
+                              9 * Metre / Second / Second}),
+                         Vector<Jerk, World>(
+                             {-1 * Metre / Second / Second / Second,
+                              -2 * Metre / Second / Second / Second,
+                              -3 * Metre / Second / Second / Second})},
+        t0_,
+        with_evaluator<Estrin>);
+  }
+
+  static not_null<std::unique_ptr<Polynomial<Position<World>, Instant>>>
+  MakeP5(double const x) {
+    auto p3 = MakeP3(x);
+    return make_not_null_unique<P5>(
+        P5(*dynamic_cast_not_null<P3 const*>(p3.get())));
+  }
+
+  static constexpr Instant t0_ = Instant() + 1 * Second;
+  Arena arena_;
+};
+
+TEST_F(PolynomialArenaTest, Evaluate) {
+  std::vector<not_null<std::unique_ptr<Polynomial<Position<World>, Instant>>>>
+      expected;
+  std::vector<Arena::Handle> handles;
+  for (int i = 0; i < 10; ++i) {
+    auto polynomial = i % 3 == 0 ? MakeP1(i) : i % 3 == 1 ? MakeP3(i)
+                                                          : MakeP5(i);
+    expected.push_back(i % 3 == 0 ? MakeP1(i) : i % 3 == 1 ? MakeP3(i)
+                                                           : MakeP5(i));
+    handles.push_back(arena_.Add(std::move(polynomial)));
+  }
+  EXPECT_EQ(10, arena_.size());
+  EXPECT_EQ(4, arena_.heap_size());
+
+  Instant const t = t0_ + 3 * Second;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ((*expected[i])(t), arena_.Evaluate(handles[i], t)) << i;
+    EXPECT_EQ(expected[i]->EvaluateDerivative(t),
+              arena_.EvaluateDerivative(handles[i], t)) << i;
+    EXPECT_EQ(expected[i]->degree(), arena_.polynomial(handles[i]).degree())
+        << i;
+  }
+}
+
+TEST_F(PolynomialArenaTest, RemoveLast) {
+  auto const h1 = arena_.Add(MakeP3(1));
+  auto const h2 = arena_.Add(MakeP1(2));
+  auto const h3 = arena_.Add(MakeP3(3));
+  arena_.RemoveLast(h3);
+  arena_.RemoveLast(h2);
+  EXPECT_EQ(1, arena_.size());
+  EXPECT_EQ(0, arena_.heap_size());
+
+  auto const h4 = arena_.Add(MakeP3(4));
+  Instant const t = t0_;
+  EXPECT_EQ(1 * Metre,
+            (arena_.Evaluate(h1, t) - World::origin).coordinates().x);
+  EXPECT_EQ(4 * Metre,
+            (arena_.Evaluate(h4, t) - World::origin).coordinates().x);
+
+  arena_.Clear();
+  EXPECT_EQ(0, arena_.size());
+}
+
+TEST_F(PolynomialArenaTest, Splice) {
+  std::vector<Arena::Handle> handles;
+  handles.push_back(arena_.Add(MakeP3(1)));
+  handles.push_back(arena_.Add(MakeP1(2)));
+  handles.push_back(arena_.Add(MakeP5(3)));
+
+  Arena suffix;
+  std::vector<Arena::Handle> suffix_handles;
+  suffix_handles.push_back(suffix.Add(MakeP5(4)));
+  suffix_handles.push_back(suffix.Add(MakeP1(5)));
+  suffix_handles.push_back(suffix.Add(MakeP3(6)));
+
+  auto const rebase = arena_.Splice(std::move(suffix));
+  for (auto const& handle : suffix_handles) {
+    handles.push_back(rebase(handle));
+  }
+  EXPECT_EQ(6, arena_.size());
+  EXPECT_EQ(0, suffix.size());
+
+  Instant const t = t0_;
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ((i + 1) * Metre,
+              (arena_.Evaluate(handles[i], t) - World::origin).coordinates().x)
+        << i;
+  }
+
+  // The spliced polynomials are the last ones in their buckets.
+  for (int i = 5; i >= 0; --i) {
+    arena_.RemoveLast(handles[i]);
+  }
+  EXPECT_EQ(0, arena_.size());
+}
+
+}  // namespace numerics
+}  // namespace principia
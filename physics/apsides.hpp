@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <optional>
+#include <tuple>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -66,6 +68,22 @@ ComputeFirstCollision(
     std::function<Length(Angle const& latitude, Angle const& longitude)> const&
         radius);
 
+// Same as above, but |radii| is given the latitudes and longitudes of several
+// positions at once and must return the radii of the celestial at these
+// positions, in the same order.  This reduces the number of calls to |radii|,
+// which is useful when each call has a high latency.
+template<typename Frame>
+std::optional<typename DiscreteTrajectory<Frame>::value_type>
+ComputeFirstCollision(
+    RotatingBody<Frame> const& reference_body,
+    Trajectory<Frame> const& reference,
+    Trajectory<Frame> const& trajectory,
+    Interval<Instant> const& interval,
+    Length const& max_collision_error,
+    std::function<std::vector<Length>(
+        std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes)>
+        const& radii);
+
 // Computes the crossings of the section given by |begin| and |end| of
 // |trajectory| with the xy plane.  Appends the crossings that go towards the
 // |north| side of the xy plane to |ascending|, and those that go away from the
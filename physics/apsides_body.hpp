@@ -4,6 +4,7 @@
 
 #include <list>
 #include <optional>
+#include <tuple>
 #include <vector>
 
 #include "base/array.hpp"
@@ -384,34 +385,94 @@ ComputeFirstCollision(
     Length const& max_collision_error,
     std::function<Length(Angle const& latitude, Angle const& longitude)> const&
         radius) {
+  return ComputeFirstCollision(
+      reference_body,
+      reference,
+      trajectory,
+      interval,
+      max_collision_error,
+      std::function<std::vector<Length>(
+          std::vector<std::tuple<Angle, Angle>> const&)>(
+          [&radius](std::vector<std::tuple<Angle, Angle>> const&
+                        latitudes_longitudes) {
+            std::vector<Length> radii;
+            radii.reserve(latitudes_longitudes.size());
+            for (auto const& [latitude, longitude] : latitudes_longitudes) {
+              radii.push_back(radius(latitude, longitude));
+            }
+            return radii;
+          }));
+}
+
+template<typename Frame>
+std::optional<typename DiscreteTrajectory<Frame>::value_type>
+ComputeFirstCollision(
+    RotatingBody<Frame> const& reference_body,
+    Trajectory<Frame> const& reference,
+    Trajectory<Frame> const& trajectory,
+    Interval<Instant> const& interval,
+    Length const& max_collision_error,
+    std::function<std::vector<Length>(
+        std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes)>
+        const& radii) {
   // The frame of the surface of the celestial.
   using SurfaceFrame = geometry::_frame::Frame<struct SurfaceFrameTag>;
 
   std::int64_t number_of_evaluations = 0;
 
-  auto height_above_terrain_at_time = [&number_of_evaluations,
-                                       &radius,
-                                       &reference,
-                                       &reference_body,
-                                       &trajectory](Instant const& t) {
-    ++number_of_evaluations;
-    auto const reference_position = reference.EvaluatePosition(t);
-    auto const trajectory_position = trajectory.EvaluatePosition(t);
-    Displacement<Frame> const displacement_in_frame =
-        trajectory_position - reference_position;
-
-    auto const to_surface_frame =
-        reference_body.template ToSurfaceFrame<SurfaceFrame>(t);
-    Displacement<SurfaceFrame> const displacement_in_surface =
-        to_surface_frame(displacement_in_frame);
-
-    SphericalCoordinates<Length> const spherical_coordinates =
-        displacement_in_surface.coordinates().ToSpherical();
-
-    return spherical_coordinates.radius -
-           radius(spherical_coordinates.latitude,
-                  spherical_coordinates.longitude);
+  // The height above the terrain, which the interpolation evaluates in batches
+  // so as to make a single call to |radii| for all the new points of each
+  // degree.
+  struct HeightAboveTerrain {
+    Length operator()(Instant const& t) const {
+      return (*this)(std::vector<Instant>{t}).front();
+    }
+
+    std::vector<Length> operator()(std::vector<Instant> const& times) const {
+      number_of_evaluations += times.size();
+      std::vector<Length> spherical_radii;
+      std::vector<std::tuple<Angle, Angle>> latitudes_longitudes;
+      spherical_radii.reserve(times.size());
+      latitudes_longitudes.reserve(times.size());
+      for (Instant const& t : times) {
+        auto const reference_position = reference.EvaluatePosition(t);
+        auto const trajectory_position = trajectory.EvaluatePosition(t);
+        Displacement<Frame> const displacement_in_frame =
+            trajectory_position - reference_position;
+
+        auto const to_surface_frame =
+            reference_body.template ToSurfaceFrame<SurfaceFrame>(t);
+        Displacement<SurfaceFrame> const displacement_in_surface =
+            to_surface_frame(displacement_in_frame);
+
+        SphericalCoordinates<Length> const spherical_coordinates =
+            displacement_in_surface.coordinates().ToSpherical();
+        spherical_radii.push_back(spherical_coordinates.radius);
+        latitudes_longitudes.emplace_back(spherical_coordinates.latitude,
+                                          spherical_coordinates.longitude);
+      }
+
+      std::vector<Length> heights = radii(latitudes_longitudes);
+      CHECK_EQ(times.size(), heights.size());
+      for (std::int64_t i = 0; i < heights.size(); ++i) {
+        heights[i] = spherical_radii[i] - heights[i];
+      }
+      return heights;
+    }
+
+    RotatingBody<Frame> const& reference_body;
+    Trajectory<Frame> const& reference;
+    Trajectory<Frame> const& trajectory;
+    std::function<std::vector<Length>(
+        std::vector<std::tuple<Angle, Angle>> const&)> const& radii;
+    std::int64_t& number_of_evaluations;
   };
+  HeightAboveTerrain const height_above_terrain_at_time{
+      .reference_body = reference_body,
+      .reference = reference,
+      .trajectory = trajectory,
+      .radii = radii,
+      .number_of_evaluations = number_of_evaluations};
 
   // Subdivide the interpolant if it could have real roots given the current
   // error estimate.
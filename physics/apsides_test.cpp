@@ -1,10 +1,13 @@
 #include "physics/apsides.hpp"
 
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -42,8 +45,10 @@
 namespace principia {
 namespace physics {
 
+using ::testing::Contains;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::Gt;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::SizeIs;
@@ -343,6 +348,33 @@ TEST_F(ApsidesTest, ComputeFirstCollision) {
       AlmostEquals(Velocity<World>({0 * Metre / Second,
                                     -1 * Metre / Second,
                                     0 * Metre / Second}), 0));
+
+  // Same computation, but with the radii obtained in batches.  The result must
+  // be identical.
+  std::vector<std::int64_t> batch_sizes;
+  std::function<std::vector<Length>(
+      std::vector<std::tuple<Angle, Angle>> const&)> const radii =
+      [&batch_sizes, &radius](
+          std::vector<std::tuple<Angle, Angle>> const& latitudes_longitudes) {
+        batch_sizes.push_back(latitudes_longitudes.size());
+        std::vector<Length> result;
+        for (auto const& [latitude, longitude] : latitudes_longitudes) {
+          result.push_back(radius(latitude, longitude));
+        }
+        return result;
+      };
+  auto const maybe_batched_collision =
+      ComputeFirstCollision(body,
+                            reference_trajectory,
+                            vessel_trajectory,
+                            intervals[0],
+                            /*max_error=*/2e-4 * Metre,
+                            radii);
+  auto const& batched_collision = maybe_batched_collision.value();
+  EXPECT_EQ(collision.time, batched_collision.time);
+  EXPECT_EQ(collision.degrees_of_freedom,
+            batched_collision.degrees_of_freedom);
+  EXPECT_THAT(batch_sizes, Contains(Gt(1)));
 }
 
 #if !defined(_DEBUG)
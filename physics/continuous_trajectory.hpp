@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -13,6 +14,7 @@
 #include "geometry/space.hpp"
 #include "numerics/piecewise_poisson_series.hpp"
 #include "numerics/polynomial.hpp"
+#include "numerics/polynomial_arena.hpp"
 #include "numerics/polynomial_in_monomial_basis.hpp"
 #include "numerics/polynomial_evaluators.hpp"
 #include "physics/checkpointer.hpp"
@@ -36,6 +38,7 @@ using namespace principia::geometry::_instant;
 using namespace principia::geometry::_space;
 using namespace principia::numerics::_piecewise_poisson_series;
 using namespace principia::numerics::_polynomial;
+using namespace principia::numerics::_polynomial_arena;
 using namespace principia::numerics::_polynomial_evaluators;
 using namespace principia::numerics::_polynomial_in_monomial_basis;
 using namespace principia::physics::_checkpointer;
@@ -43,6 +46,10 @@ using namespace principia::physics::_degrees_of_freedom;
 using namespace principia::physics::_trajectory;
 using namespace principia::quantities::_quantities;
 
+// The range of degrees of the polynomials used for the approximation.
+constexpr int max_degree = 17;
+constexpr int min_degree = 3;
+
 // This class is thread-safe, but the client must be aware that if, for
 // instance, the trajectory is appended to asynchronously, successive calls to
 // |t_max()| may return different values.
@@ -78,6 +85,18 @@ class ContinuousTrajectory : public Trajectory<Frame> {
                       DegreesOfFreedom<Frame> const& degrees_of_freedom)
       EXCLUDES(lock_);
 
+  // Same as |Append|, but if the point completes a polynomial, the fitting of
+  // that polynomial is deferred: this function returns a function that
+  // performs the fitting and returns its status.  Otherwise, it returns a null
+  // function.  The fitting function may be called on any thread, but it must
+  // be called exactly once, and it must have returned before the next call to
+  // |Append|, |AppendWithDeferredFitting|, |Prepend| or |WriteToCheckpoint|,
+  // which check this.  Until it has returned, the new polynomial is not taken
+  // into account by |t_max| or by the evaluation functions.
+  std::function<absl::Status()> AppendWithDeferredFitting(
+      Instant const& time,
+      DegreesOfFreedom<Frame> const& degrees_of_freedom) EXCLUDES(lock_);
+
   // Prepends the given |trajectory| to this one.  Ideally the last point of
   // |trajectory| should match the first point of this object.
   // Note the rvalue reference: |ContinuousTrajectory| is not moveable and not
@@ -166,19 +185,22 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   ContinuousTrajectory();
 
  private:
+  // The polynomials produced by the Newhall approximation are stored by degree
+  // in contiguous buckets, see |PolynomialArena|.
+  using Polynomials =
+      PolynomialArena<Position<Frame>, Instant, min_degree, max_degree>;
+
   // Each polynomial is valid over an interval [t_min, t_max].  Polynomials are
   // stored in this vector sorted by their |t_max|, as it turns out that we
   // never need to extract their |t_min|.  Logically, the |t_min| for a
   // polynomial is the |t_max| of the previous one.  The first polynomial has a
-  // |t_min| which is |*first_time_|.
+  // |t_min| which is |*first_time_|.  The polynomial itself lives in
+  // |arena_|.
   struct InstantPolynomialPair {
-    InstantPolynomialPair(
-        Instant t_max,
-        not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-            polynomial);
+    InstantPolynomialPair(Instant t_max,
+                          typename Polynomials::Handle polynomial);
     Instant t_max;
-    not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-        polynomial;
+    typename Polynomials::Handle polynomial;
   };
   using InstantPolynomialPairs = std::vector<InstantPolynomialPair>;
 
@@ -192,11 +214,12 @@ class ContinuousTrajectory : public Trajectory<Frame> {
       Instant const& t_max,
       Displacement<Frame>& error_estimate) const;
 
-  // Computes the best Newhall approximation based on the desired tolerance.
-  // Adjust the |degree_| and other member variables to stay within the
-  // tolerance while minimizing the computational cost and avoiding numerical
-  // instabilities.
+  // Computes the best Newhall approximation over [t_min, time] based on the
+  // desired tolerance.  Adjust the |degree_| and other member variables to stay
+  // within the tolerance while minimizing the computational cost and avoiding
+  // numerical instabilities.
   absl::Status ComputeBestNewhallApproximation(
+      Instant const& t_min,
       Instant const& time,
       std::vector<Position<Frame>> const& q,
       std::vector<Velocity<Frame>> const& v) REQUIRES(lock_);
@@ -204,7 +227,8 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // Returns an iterator to the polynomial applicable for the given |time|, or
   // |begin| if |time| is before the first polynomial or |end| if |time| is
   // after the last polynomial.  If |time| is the |t_max| of some polynomial,
-  // that polynomial is returned.  Time complexity is O(N Log N).
+  // that polynomial is returned.  Time complexity is O(1) if the polynomials
+  // are aligned on |step_|, O(Log N) otherwise.
   typename InstantPolynomialPairs::const_iterator
   FindPolynomialForInstantLocked(Instant const& time) const
       REQUIRES_SHARED(lock_);
@@ -230,6 +254,7 @@ class ContinuousTrajectory : public Trajectory<Frame> {
 
   // The polynomials are in increasing time order.
   InstantPolynomialPairs polynomials_ GUARDED_BY(lock_);
+  Polynomials arena_ GUARDED_BY(lock_);
   Policy polynomial_evaluator_policy_;
 
   // Lookups into |polynomials_| are expensive because they entail a binary
@@ -244,7 +269,8 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   // multithreading it may be that different threads would want to access
   // polynomials at different indices, but by and large the threads progress in
   // parallel, and benchmarks show that there is no adverse performance effects.
-  // Any value in the range of |polynomials_| or 0 is correct.
+  // When this guess fails, the index is computed from the nominal duration of
+  // the polynomials.  Any value in the range of |polynomials_| or 0 is correct.
   mutable std::int64_t last_accessed_polynomial_ GUARDED_BY(lock_) = 0;
 
   // The time at which this trajectory starts.  Set for a nonempty trajectory.
@@ -256,6 +282,10 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   std::vector<std::pair<Instant, DegreesOfFreedom<Frame>>> last_points_
       GUARDED_BY(lock_);
 
+  // True between the time a fitting is returned by |AppendWithDeferredFitting|
+  // and the time it returns.  Used to enforce the contract of that function.
+  bool fitting_pending_ GUARDED_BY(lock_) = false;
+
   friend class TestableContinuousTrajectory<Frame>;
 };
 
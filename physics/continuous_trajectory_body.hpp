@@ -3,6 +3,7 @@
 #include "physics/continuous_trajectory.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -30,8 +31,6 @@ using namespace principia::numerics::_polynomial_in_чебышёв_basis;
 using namespace principia::numerics::_ulp_distance;
 using namespace principia::quantities::_si;
 
-constexpr int max_degree = 17;
-constexpr int min_degree = 3;
 int const max_degree_age = 100;
 
 // Only supports 8 divisions for now.
@@ -69,7 +68,7 @@ double ContinuousTrajectory<Frame>::average_degree() const {
   } else {
     double total = 0;
     for (auto const& pair : polynomials_) {
-      total += pair.polynomial->degree();
+      total += arena_.polynomial(pair.polynomial).degree();
     }
     return total / polynomials_.size();
   }
@@ -79,7 +78,22 @@ template<typename Frame>
 absl::Status ContinuousTrajectory<Frame>::Append(
     Instant const& time,
     DegreesOfFreedom<Frame> const& degrees_of_freedom) {
+  auto const fitting = AppendWithDeferredFitting(time, degrees_of_freedom);
+  if (fitting == nullptr) {
+    return absl::OkStatus();
+  } else {
+    return fitting();
+  }
+}
+
+template<typename Frame>
+std::function<absl::Status()>
+ContinuousTrajectory<Frame>::AppendWithDeferredFitting(
+    Instant const& time,
+    DegreesOfFreedom<Frame> const& degrees_of_freedom) {
   absl::MutexLock l(&lock_);
+  CHECK(!fitting_pending_) << "Append while a fitting is pending at "
+                           << last_points_.back().first;
 
   // Consistency checks.
   if (first_time_) {
@@ -94,15 +108,15 @@ absl::Status ContinuousTrajectory<Frame>::Append(
     first_time_ = time;
   }
 
-  absl::Status status;
+  std::function<absl::Status()> fitting;
   CHECK_LE(last_points_.size(), divisions);
   if (last_points_.size() == divisions) {
-    // These vectors are thread-local to avoid deallocation/reallocation each
-    // time we go through this code path.
-    thread_local std::vector<Position<Frame>> q(divisions + 1);
-    thread_local std::vector<Velocity<Frame>> v(divisions + 1);
-    q.clear();
-    v.clear();
+    // The points are copied because the fitting may happen after
+    // |last_points_| has been changed by subsequent calls to |Append|.
+    std::vector<Position<Frame>> q;
+    std::vector<Velocity<Frame>> v;
+    q.reserve(divisions + 1);
+    v.reserve(divisions + 1);
 
     for (auto const& [_, degrees_of_freedom] : last_points_) {
       q.push_back(degrees_of_freedom.position());
@@ -111,9 +125,18 @@ absl::Status ContinuousTrajectory<Frame>::Append(
     q.push_back(degrees_of_freedom.position());
     v.push_back(degrees_of_freedom.velocity());
 
-    status = ComputeBestNewhallApproximation(time, q, v);
+    fitting = [this,
+               t_min = last_points_.front().first,
+               time,
+               q = std::move(q),
+               v = std::move(v)]() {
+      absl::MutexLock l(&lock_);
+      fitting_pending_ = false;
+      return ComputeBestNewhallApproximation(t_min, time, q, v);
+    };
+    fitting_pending_ = true;
 
-    // Wipe-out the points that have just been incorporated in a polynomial.
+    // Wipe-out the points that are going to be incorporated in a polynomial.
     last_points_.clear();
   }
 
@@ -122,7 +145,7 @@ absl::Status ContinuousTrajectory<Frame>::Append(
   // every element but one.
   last_points_.emplace_back(time, degrees_of_freedom);
 
-  return status;
+  return fitting;
 }
 
 template<typename Frame>
@@ -130,6 +153,8 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
   absl::MutexLock l1(&lock_);
   absl::MutexLock l2(&prefix.lock_);
 
+  CHECK(!fitting_pending_);
+  CHECK(!prefix.fitting_pending_);
   CHECK_EQ(step_, prefix.step_);
   CHECK_EQ(tolerance_, prefix.tolerance_);
 
@@ -143,6 +168,7 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
     degree_ = prefix.degree_;
     degree_age_ = prefix.degree_age_;
     polynomials_ = std::move(prefix.polynomials_);
+    arena_ = std::move(prefix.arena_);
     last_accessed_polynomial_ = prefix.last_accessed_polynomial_;
     first_time_ = prefix.first_time_;
     last_points_ = prefix.last_points_;
@@ -153,11 +179,18 @@ void ContinuousTrajectory<Frame>::Prepend(ContinuousTrajectory&& prefix) {
     // library, so we cannot check that the trajectories are "continuous" at the
     // junction.
     CHECK_EQ(*first_time_, prefix.polynomials_.back().t_max);
-    // This operation is in O(prefix.size()).
+    // This operation is in O(prefix.size() + size()).  The polynomials of this
+    // object are moved after those of |prefix| in its arena, so that each
+    // bucket remains in increasing time order.
+    auto const rebase = prefix.arena_.Splice(std::move(arena_));
+    for (auto& pair : polynomials_) {
+      pair.polynomial = rebase(pair.polynomial);
+    }
     std::move(polynomials_.begin(),
               polynomials_.end(),
               std::back_inserter(prefix.polynomials_));
     polynomials_.swap(prefix.polynomials_);
+    arena_ = std::move(prefix.arena_);
     first_time_ = prefix.first_time_;
     // Note that any |last_points_| in |prefix| are irrelevant because they
     // correspond to a time interval covered by the first polynomial of this
@@ -211,7 +244,7 @@ int ContinuousTrajectory<Frame>::PiecewisePoissonSeriesDegree(
   auto const it_max = FindPolynomialForInstantLocked(t_max);
   int degree = min_degree;
   for (auto it = it_min;; ++it) {
-    degree = std::max(degree, it->polynomial->degree());
+    degree = std::max(degree, arena_.polynomial(it->polynomial).degree());
     if (it == it_max) {
       break;
     }
@@ -308,7 +341,8 @@ ContinuousTrajectory<Frame>::ToPiecewisePoissonSeries(
     Interval<Instant> interval;
     interval.Include(current_t_min);
     interval.Include(current_t_max);
-    auto const polynomial_cast_to_degree = cast_to_degree(it->polynomial.get());
+    auto const polynomial_cast_to_degree =
+        cast_to_degree(&arena_.polynomial(it->polynomial));
     if (result == nullptr) {
       result = std::make_unique<PiecewisePoisson>(
           interval, Poisson(polynomial_cast_to_degree, {{}}));
@@ -343,11 +377,11 @@ void ContinuousTrajectory<Frame>::WriteToMessage(
   // before the oldest checkpoint.
   for (auto const& pair : polynomials_) {
     Instant const& t_max = pair.t_max;
-    auto const& polynomial = pair.polynomial;
+    auto const& polynomial = arena_.polynomial(pair.polynomial);
     if (t_max <= checkpointer_->oldest_checkpoint()) {
       auto* const pair = message->add_instant_polynomial_pair();
       t_max.WriteToMessage(pair->mutable_t_max());
-      polynomial->WriteToMessage(pair->mutable_polynomial());
+      polynomial.WriteToMessage(pair->mutable_polynomial());
     } else {
       break;
     }
@@ -408,13 +442,14 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
       Displacement<Frame> error_estimate;  // Should we do something with this?
       continuous_trajectory->polynomials_.emplace_back(
           polynomial.upper_bound(),
-          continuous_trajectory->NewhallApproximationInMonomialBasis(
-              polynomial.degree(),
-              q,
-              v,
-              polynomial.lower_bound(),
-              polynomial.upper_bound(),
-              error_estimate));
+          continuous_trajectory->arena_.Add(
+              continuous_trajectory->NewhallApproximationInMonomialBasis(
+                  polynomial.degree(),
+                  q,
+                  v,
+                  polynomial.lower_bound(),
+                  polynomial.upper_bound(),
+                  error_estimate)));
     }
   } else {
     for (auto const& pair : message.instant_polynomial_pair()) {
@@ -439,8 +474,9 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
         // though we didn't have FMA when the save was created.
         continuous_trajectory->polynomials_.emplace_back(
             Instant::ReadFromMessage(pair.t_max()),
-            Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
-                EstrinWithoutFMA>(polynomial));
+            continuous_trajectory->arena_.Add(
+                Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
+                    EstrinWithoutFMA>(polynomial)));
       } else {
         serialization::Polynomial const& polynomial = pair.polynomial();
         if (polynomial.HasExtension(
@@ -453,14 +489,16 @@ ContinuousTrajectory<Frame>::ReadFromMessage(
           // |ReadFromMessage|.
           continuous_trajectory->polynomials_.emplace_back(
               Instant::ReadFromMessage(pair.t_max()),
-              Polynomial<Position<Frame>, Instant>::ReadFromMessage(
-                  polynomial));
+              continuous_trajectory->arena_.Add(
+                  Polynomial<Position<Frame>, Instant>::ReadFromMessage(
+                      polynomial)));
         } else {
           // The pre-Καραθεοδωρή path.
           continuous_trajectory->polynomials_.emplace_back(
               Instant::ReadFromMessage(pair.t_max()),
-              Polynomial<Position<Frame>, Instant>::template ReadFromMessage<
-                  Estrin>(polynomial));
+              continuous_trajectory->arena_.Add(
+                  Polynomial<Position<Frame>, Instant>::template
+                      ReadFromMessage<Estrin>(polynomial)));
         }
       }
     }
@@ -549,6 +587,7 @@ ContinuousTrajectory<Frame>::MakeCheckpointerWriter() {
         not_null<
             serialization::ContinuousTrajectory::Checkpoint*> const message) {
       absl::ReaderMutexLock l(&lock_);
+      CHECK(!fitting_pending_);
       adjusted_tolerance_.WriteToMessage(message->mutable_adjusted_tolerance());
       message->set_is_unstable(is_unstable_);
       message->set_degree(degree_);
@@ -592,6 +631,7 @@ ContinuousTrajectory<Frame>::MakeCheckpointerReader() {
       // Restore the other members to their state at the time of the checkpoint.
       if (last_points_.empty()) {
         polynomials_.clear();
+        arena_.Clear();
         first_time_ = std::nullopt;
       } else {
         // Locate the polynomial that ends at the first last_point_.  Note that
@@ -608,6 +648,12 @@ ContinuousTrajectory<Frame>::MakeCheckpointerReader() {
                                 InstantPolynomialPair const& right) {
                                return left < right.t_max;
                              });
+        // Remove the polynomials from the arena in the reverse order of their
+        // addition.
+        for (auto jt = polynomials_.end(); jt != it;) {
+          --jt;
+          arena_.RemoveLast(jt->polynomial);
+        }
         polynomials_.erase(it, polynomials_.end());
         if (polynomials_.empty()) {
           first_time_ = oldest_time;
@@ -645,8 +691,7 @@ Position<Frame> ContinuousTrajectory<Frame>::EvaluatePositionLocked(
   CHECK_GE(t_max_locked(), time);
   auto const it = FindPolynomialForInstantLocked(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return polynomial(time);
+  return arena_.Evaluate(it->polynomial, time);
 }
 
 template<typename Frame>
@@ -656,8 +701,7 @@ Velocity<Frame> ContinuousTrajectory<Frame>::EvaluateVelocityLocked(
   CHECK_GE(t_max_locked(), time);
   auto const it = FindPolynomialForInstantLocked(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return polynomial.EvaluateDerivative(time);
+  return arena_.EvaluateDerivative(it->polynomial, time);
 }
 
 template<typename Frame>
@@ -668,9 +712,9 @@ ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedomLocked(
   CHECK_GE(t_max_locked(), time);
   auto const it = FindPolynomialForInstantLocked(time);
   CHECK(it != polynomials_.end());
-  auto const& polynomial = *it->polynomial;
-  return DegreesOfFreedom<Frame>(polynomial(time),
-                                 polynomial.EvaluateDerivative(time));
+  return DegreesOfFreedom<Frame>(
+      arena_.Evaluate(it->polynomial, time),
+      arena_.EvaluateDerivative(it->polynomial, time));
 }
 
 template<typename Frame>
@@ -685,10 +729,9 @@ ContinuousTrajectory<Frame>::ContinuousTrajectory()
 template<typename Frame>
 ContinuousTrajectory<Frame>::InstantPolynomialPair::InstantPolynomialPair(
     Instant const t_max,
-    not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
-        polynomial)
+    typename Polynomials::Handle const polynomial)
     : t_max(t_max),
-      polynomial(std::move(polynomial)) {}
+      polynomial(polynomial) {}
 
 template<typename Frame>
 not_null<std::unique_ptr<Polynomial<Position<Frame>, Instant>>>
@@ -709,6 +752,7 @@ ContinuousTrajectory<Frame>::NewhallApproximationInMonomialBasis(
 
 template<typename Frame>
 absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
+    Instant const& t_min,
     Instant const& time,
     std::vector<Position<Frame>> const& q,
     std::vector<Velocity<Frame>> const& v) {
@@ -729,11 +773,11 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
   // Compute the approximation with the current degree.
   Displacement<Frame> displacement_error_estimate;
   polynomials_.emplace_back(time,
-                            NewhallApproximationInMonomialBasis(
+                            arena_.Add(NewhallApproximationInMonomialBasis(
                                 degree_,
                                 q, v,
-                                last_points_.cbegin()->first, time,
-                                displacement_error_estimate));
+                                t_min, time,
+                                displacement_error_estimate)));
 
   // Estimate the error.  For initializing |previous_error_estimate|, any value
   // greater than |error_estimate| will do.
@@ -765,11 +809,13 @@ absl::Status ContinuousTrajectory<Frame>::ComputeBestNewhallApproximation(
     ++degree_;
     VLOG(1) << "Increasing degree for " << this << " to " <<degree_
             << " because error estimate was " << error_estimate;
-    polynomials_.back().polynomial = NewhallApproximationInMonomialBasis(
-                                         degree_,
-                                         q, v,
-                                         last_points_.cbegin()->first, time,
-                                         displacement_error_estimate);
+    arena_.RemoveLast(polynomials_.back().polynomial);
+    polynomials_.back().polynomial =
+        arena_.Add(NewhallApproximationInMonomialBasis(
+            degree_,
+            q, v,
+            t_min, time,
+            displacement_error_estimate));
     previous_error_estimate = error_estimate;
     error_estimate = displacement_error_estimate.Norm();
   }
@@ -815,14 +861,44 @@ typename ContinuousTrajectory<Frame>::InstantPolynomialPairs::const_iterator
 ContinuousTrajectory<Frame>::FindPolynomialForInstantLocked(
     Instant const& time) const {
   // This returns the first polynomial |p| such that |time <= p.t_max|.
-  {
-    auto const begin = polynomials_.begin();
-    auto const it = begin + last_accessed_polynomial_;
-    if (it != polynomials_.end() && time <= it->t_max &&
-        (it == begin || std::prev(it)->t_max < time)) {
-      return it;
+  auto const begin = polynomials_.begin();
+  auto const end = polynomials_.end();
+  auto const is_polynomial_for_instant = [begin, end, &time](auto const it) {
+    return it != end && time <= it->t_max &&
+           (it == begin || std::prev(it)->t_max < time);
+  };
+
+  // Try the polynomial of the last lookup, it is the most likely to match.
+  if (auto const it = begin + last_accessed_polynomial_;
+      is_polynomial_for_instant(it)) {
+    return it;
+  }
+
+  // All the polynomials nominally cover |divisions| steps, so we can compute a
+  // guess of the index of the polynomial.  The guess may be off by one because
+  // of the jitter in the times, notably when |time| is at the boundary of two
+  // polynomials.  It may be completely off if the polynomials are not aligned
+  // on |first_time_|, e.g., for a trajectory read from an old save.
+  if (!polynomials_.empty()) {
+    std::int64_t const last_index = polynomials_.size() - 1;
+    double const index_guess =
+        std::floor((time - *first_time_) / (divisions * step_));
+    // Beware of NaNs and infinities.
+    std::int64_t const index =
+        index_guess >= 0 ? (index_guess <= last_index
+                                ? static_cast<std::int64_t>(index_guess)
+                                : last_index)
+                         : 0;
+    for (std::int64_t const probe : {index, index - 1, index + 1}) {
+      if (probe >= 0 && probe <= last_index &&
+          is_polynomial_for_instant(begin + probe)) {
+        last_accessed_polynomial_ = probe;
+        return begin + probe;
+      }
     }
   }
+
+  // Fall back to a binary search.
   {
     auto const it =
         std::lower_bound(polynomials_.begin(),
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <limits>
 #include <memory>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -124,7 +126,8 @@ TestableContinuousTrajectory<Frame>::LockAndComputeBestNewhallApproximation(
     std::vector<Position<Frame>> const& q,
     std::vector<Velocity<Frame>> const& v) {
   absl::MutexLock l(&this->lock_);
-  return this->ComputeBestNewhallApproximation(time, q, v);
+  return this->ComputeBestNewhallApproximation(
+      this->last_points_.cbegin()->first, time, q, v);
 }
 
 template<typename Frame>
@@ -641,6 +644,146 @@ TEST_F(ContinuousTrajectoryTest, Continuity) {
   EXPECT_THAT(p1, AlmostEquals(p3, 0, 2));
 }
 
+TEST_F(ContinuousTrajectoryTest, RandomAccess) {
+  int const number_of_steps = 1000;
+  Length const distance = 1 * Kilo(Metre);
+  Time const period = 100 * Second;
+  Time const step = 0.1 * Second;
+
+  auto position_function = [this, distance, period](Instant const t) {
+    Angle const angle = 2 * π * Radian * (t - t0_) / period;
+    return World::origin +
+        Displacement<World>({
+            distance * Cos(angle),
+            distance * Sin(angle),
+            0 * Metre});
+  };
+  auto velocity_function = [this, distance, period](Instant const t) {
+    AngularFrequency const ω = 2 * π * Radian / period;
+    Angle const angle = ω * (t - t0_);
+    return Velocity<World>({
+        -ω * distance * Sin(angle) / Radian,
+        ω * distance * Cos(angle) / Radian,
+        0 * Metre / Second});
+  };
+
+  auto const trajectory = std::make_unique<ContinuousTrajectory<World>>(
+                              step,
+                              /*tolerance=*/1 * Milli(Metre));
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *trajectory);
+
+  // Evaluate in an order that defeats the memory of the last lookup, and
+  // include the boundaries of the polynomials.
+  std::mt19937_64 random(42);
+  std::uniform_int_distribution<int> step_distribution(
+      0, (trajectory->t_max() - trajectory->t_min()) / step);
+  for (int i = 0; i < 1000; ++i) {
+    Instant const t = trajectory->t_min() + step_distribution(random) * step;
+    // Using the wrong polynomial would result in an error of many metres.
+    EXPECT_LT((trajectory->EvaluatePosition(t) - position_function(t)).Norm(),
+              1 * Centi(Metre)) << t;
+  }
+}
+
+TEST_F(ContinuousTrajectoryTest, DeferredFitting) {
+  int const number_of_steps = 100;
+  Length const distance = 1 * Kilo(Metre);
+  Time const period = 100 * Second;
+  Time const step = 1 * Second;
+
+  auto position_function = [this, distance, period](Instant const t) {
+    Angle const angle = 2 * π * Radian * (t - t0_) / period;
+    return World::origin +
+        Displacement<World>({
+            distance * Cos(angle),
+            distance * Sin(angle),
+            0 * Metre});
+  };
+  auto velocity_function = [this, distance, period](Instant const t) {
+    AngularFrequency const ω = 2 * π * Radian / period;
+    Angle const angle = ω * (t - t0_);
+    return Velocity<World>({
+        -ω * distance * Sin(angle) / Radian,
+        ω * distance * Cos(angle) / Radian,
+        0 * Metre / Second});
+  };
+
+  auto const expected_trajectory =
+      std::make_unique<ContinuousTrajectory<World>>(
+          step, /*tolerance=*/1 * Milli(Metre));
+  FillTrajectory(number_of_steps,
+                 step,
+                 position_function,
+                 velocity_function,
+                 t0_,
+                 *expected_trajectory);
+
+  // Run each fitting on another thread while the next point is computed, and
+  // wait for it before appending that point, as required by the contract of
+  // |AppendWithDeferredFitting|.
+  auto const actual_trajectory =
+      std::make_unique<ContinuousTrajectory<World>>(
+          step, /*tolerance=*/1 * Milli(Metre));
+  std::future<absl::Status> pending_fitting;
+  int number_of_fittings = 0;
+  for (int i = 0; i < number_of_steps; ++i) {
+    Instant const ti = t0_ + (i + 1) * step;
+    DegreesOfFreedom<World> const degrees_of_freedom(position_function(ti),
+                                                     velocity_function(ti));
+    if (pending_fitting.valid()) {
+      EXPECT_OK(pending_fitting.get());
+    }
+    auto fitting =
+        actual_trajectory->AppendWithDeferredFitting(ti, degrees_of_freedom);
+    if (fitting != nullptr) {
+      // Until the fitting has run, the polynomial is not visible.
+      EXPECT_GT(ti, actual_trajectory->t_max() + step);
+      pending_fitting = std::async(std::launch::async, std::move(fitting));
+      ++number_of_fittings;
+    }
+  }
+  if (pending_fitting.valid()) {
+    EXPECT_OK(pending_fitting.get());
+  }
+  EXPECT_EQ(number_of_steps / 8, number_of_fittings);
+
+  EXPECT_EQ(expected_trajectory->t_min(), actual_trajectory->t_min());
+  EXPECT_EQ(expected_trajectory->t_max(), actual_trajectory->t_max());
+  for (Instant t = expected_trajectory->t_min();
+       t <= expected_trajectory->t_max();
+       t += step / 10) {
+    EXPECT_EQ(expected_trajectory->EvaluateDegreesOfFreedom(t),
+              actual_trajectory->EvaluateDegreesOfFreedom(t));
+  }
+}
+
+using ContinuousTrajectoryDeathTest = ContinuousTrajectoryTest;
+
+TEST_F(ContinuousTrajectoryDeathTest, AppendWhileFittingPending) {
+  EXPECT_DEATH({
+    Time const step = 1 * Second;
+    ContinuousTrajectory<World> trajectory(step,
+                                           /*tolerance=*/1 * Milli(Metre));
+    std::function<absl::Status()> fitting;
+    Instant t = t0_;
+    while (fitting == nullptr) {
+      t += step;
+      fitting = trajectory.AppendWithDeferredFitting(
+          t,
+          DegreesOfFreedom<World>(World::origin, World::unmoving));
+    }
+    t += step;
+    trajectory.AppendWithDeferredFitting(
+        t,
+        DegreesOfFreedom<World>(World::origin, World::unmoving));
+  }, "fitting is pending");
+}
+
 TEST_F(ContinuousTrajectoryTest, Prepend) {
   int const number_of_steps1 = 20;
   int const number_of_steps2 = 15;
@@ -3,6 +3,7 @@
 #include "physics/discrete_trajectory_segment.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <string>
@@ -274,13 +275,22 @@ DiscreteTrajectorySegment<Frame>::ReadFromMessage(
   std::string_view zfp_timeline(message.zfp().timeline().data(),
                                 message.zfp().timeline().size());
 
-  decompressor.ReadFromMessageMultidimensional<2>(t, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(qx, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(qy, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(qz, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(px, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(py, zfp_timeline);
-  decompressor.ReadFromMessageMultidimensional<2>(pz, zfp_timeline);
+  bool const has_component_sizes = !message.zfp().component_size().empty();
+  if (has_component_sizes) {
+    std::vector<std::int64_t> const component_sizes(
+        message.zfp().component_size().begin(),
+        message.zfp().component_size().end());
+    decompressor.ReadFromMessageMultidimensional<2>(
+        {&t, &qx, &qy, &qz, &px, &py, &pz}, component_sizes, zfp_timeline);
+  } else {
+    decompressor.ReadFromMessageMultidimensional<2>(t, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(qx, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(qy, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(qz, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(px, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(py, zfp_timeline);
+    decompressor.ReadFromMessageMultidimensional<2>(pz, zfp_timeline);
+  }
 
   for (int i = 0; i < timeline_size; ++i) {
     Position<Frame> const q =
@@ -514,13 +524,23 @@ void DiscreteTrajectorySegment<Frame>::SetForkPoint(value_type const& point) {
 
 template<typename Frame>
 absl::Status DiscreteTrajectorySegment<Frame>::DownsampleIfNeeded() {
+  using ConstIterators = std::vector<typename Timeline::const_iterator>;
+
+  // Scratch storage, reused across calls (and across the segments downsampled
+  // by a thread) so that downsampling does not allocate in steady state.  This
+  // matters because the histories of all the vessels are appended to at every
+  // frame.
+  static thread_local ConstIterators dense_iterators;
+  static thread_local std::vector<typename ConstIterators::const_iterator>
+      right_endpoints;
+  static thread_local std::vector<Instant> right_endpoints_times;
+
   ++number_of_dense_points_;
   // Points, hence one more than intervals.
   if (number_of_dense_points_ >
       downsampling_parameters_->max_dense_intervals) {
     // Obtain iterators for all the dense points of the segment.
-    using ConstIterators = std::vector<typename Timeline::const_iterator>;
-    ConstIterators dense_iterators(number_of_dense_points_);
+    dense_iterators.resize(number_of_dense_points_);
     CHECK_LE(dense_iterators.size(), timeline_.size());
     auto it = timeline_.crbegin();
     for (int i = dense_iterators.size() - 1; i >= 0; --i) {
@@ -528,33 +548,32 @@ absl::Status DiscreteTrajectorySegment<Frame>::DownsampleIfNeeded() {
       ++it;
     }
 
-    absl::StatusOr<std::list<typename ConstIterators::const_iterator>>
-        right_endpoints = FitHermiteSpline<Position<Frame>, Instant>(
-            dense_iterators,
-            [](auto&& it) -> auto&& { return it->time; },
-            [](auto&& it) -> auto&& {
-              return it->degrees_of_freedom.position();
-            },
-            [](auto&& it) -> auto&& {
-              return it->degrees_of_freedom.velocity();
-            },
-            downsampling_parameters_->tolerance);
-    if (!right_endpoints.ok()) {
+    absl::Status const status = FitHermiteSpline<Position<Frame>, Instant>(
+        dense_iterators,
+        [](auto&& it) -> auto&& { return it->time; },
+        [](auto&& it) -> auto&& {
+          return it->degrees_of_freedom.position();
+        },
+        [](auto&& it) -> auto&& {
+          return it->degrees_of_freedom.velocity();
+        },
+        downsampling_parameters_->tolerance,
+        right_endpoints);
+    if (!status.ok()) {
       // Note that the actual appending took place; the propagated status only
       // reflects a lack of downsampling.
-      return right_endpoints.status();
+      return status;
     }
 
-    if (right_endpoints->empty()) {
-      right_endpoints->push_back(std::prev(dense_iterators.end()));
+    if (right_endpoints.empty()) {
+      right_endpoints.push_back(std::prev(dense_iterators.cend()));
     }
 
     // Obtain the times for the right endpoints.  This is necessary because we
     // cannot use iterators for erasing points, as they would get invalidated
     // after the first erasure.
-    std::vector<Instant> right_endpoints_times;
-    right_endpoints_times.reserve(right_endpoints.value().size());
-    for (auto const& it_in_dense_iterators : right_endpoints.value()) {
+    right_endpoints_times.clear();
+    for (auto const& it_in_dense_iterators : right_endpoints) {
       right_endpoints_times.push_back((*it_in_dense_iterators)->time);
     }
 
@@ -699,26 +718,30 @@ void DiscreteTrajectorySegment<Frame>::WriteToMessage(
   }
 
   // Times are exact.
-  ZfpCompressor time_compressor(0);
+  ZfpCompressor const time_compressor(0);
   // Lengths are approximated to the downsampling tolerance if downsampling is
   // enabled, otherwise they are exact.
   Length const length_tolerance = downsampling_parameters_.has_value()
                                       ? downsampling_parameters_->tolerance
                                       : Length();
-  ZfpCompressor length_compressor(length_tolerance / Metre);
+  ZfpCompressor const length_compressor(length_tolerance / Metre);
   // Speeds are approximated based on the length tolerance and the maximum
   // step in the timeline.
   ZfpCompressor const speed_compressor((length_tolerance / max_Δt) /
                                         (Metre / Second));
 
   ZfpCompressor::WriteVersion(message);
-  time_compressor.WriteToMessageMultidimensional<2>(t, zfp_timeline);
-  length_compressor.WriteToMessageMultidimensional<2>(qx, zfp_timeline);
-  length_compressor.WriteToMessageMultidimensional<2>(qy, zfp_timeline);
-  length_compressor.WriteToMessageMultidimensional<2>(qz, zfp_timeline);
-  speed_compressor.WriteToMessageMultidimensional<2>(px, zfp_timeline);
-  speed_compressor.WriteToMessageMultidimensional<2>(py, zfp_timeline);
-  speed_compressor.WriteToMessageMultidimensional<2>(pz, zfp_timeline);
+  std::vector<std::int64_t> component_sizes;
+  ZfpCompressor::WriteToMessageMultidimensional<2>(
+      {&time_compressor,
+       &length_compressor, &length_compressor, &length_compressor,
+       &speed_compressor, &speed_compressor, &speed_compressor},
+      {&t, &qx, &qy, &qz, &px, &py, &pz},
+      zfp_timeline,
+      &component_sizes);
+  for (std::int64_t const component_size : component_sizes) {
+    zfp->add_component_size(component_size);
+  }
 }
 
 }  // namespace internal
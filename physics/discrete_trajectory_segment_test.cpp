@@ -1,6 +1,7 @@
 #include "physics/discrete_trajectory_segment.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -486,6 +487,50 @@ TEST_F(DiscreteTrajectorySegmentTest, SerializationRoundTrip) {
   EXPECT_THAT(message2, EqualsProto(message1));
 }
 
+// Enough points for the components to be compressed concurrently.
+TEST_F(DiscreteTrajectorySegmentTest, SerializationConcurrent) {
+  auto const circle_segments = MakeSegments(1);
+  auto& circle = *circle_segments->begin();
+  AngularFrequency const ω = 3 * Radian / Second;
+  Length const r = 2 * Metre;
+  Time const Δt = 1 * Milli(Second);
+  Instant const t1 = t0_;
+  Instant const t2 = t0_ + 5 * Second;
+  AppendTrajectoryTimeline(
+      NewCircularTrajectoryTimeline<World>(ω, r, Δt, t1, t2),
+      /*to=*/circle);
+
+  serialization::DiscreteTrajectorySegment message;
+  circle.WriteToMessage(&message, /*exact=*/{});
+  EXPECT_EQ(7, message.zfp().component_size_size());
+  std::int64_t total_size = 0;
+  for (std::int64_t const component_size : message.zfp().component_size()) {
+    total_size += component_size;
+  }
+  EXPECT_EQ(message.zfp().timeline().size(), total_size);
+
+  // Without the sizes, as in older saves, the components are decoded
+  // sequentially.  Either way, the segment is restored exactly since it is not
+  // downsampled.
+  serialization::DiscreteTrajectorySegment message_without_sizes = message;
+  message_without_sizes.mutable_zfp()->clear_component_size();
+  for (auto const* const m : {&message, &message_without_sizes}) {
+    auto const deserialized_circle_segments = MakeSegments(1);
+    auto& deserialized_circle = *deserialized_circle_segments->begin();
+    deserialized_circle = DiscreteTrajectorySegment<World>::ReadFromMessage(
+        *m,
+        /*self=*/MakeIterator(deserialized_circle_segments.get(),
+                              deserialized_circle_segments->begin()));
+    EXPECT_EQ(circle.size(), deserialized_circle.size());
+    for (auto it1 = circle.begin(), it2 = deserialized_circle.begin();
+         it1 != circle.end();
+         ++it1, ++it2) {
+      EXPECT_EQ(it1->time, it2->time);
+      EXPECT_EQ(it1->degrees_of_freedom, it2->degrees_of_freedom);
+    }
+  }
+}
+
 TEST_F(DiscreteTrajectorySegmentTest, SerializationEmpty) {
   DiscreteTrajectorySegment<World> segment;
   serialization::DiscreteTrajectorySegment message;
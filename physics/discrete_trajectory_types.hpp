@@ -6,6 +6,7 @@
 #include "base/macros.hpp"  // 🧙 For forward declarations.
 #include "geometry/instant.hpp"
 #include "physics/degrees_of_freedom.hpp"
+#include "physics/flat_timeline.hpp"
 #include "quantities/quantities.hpp"
 
 // An internal header to avoid replicating data structures in multiple places.
@@ -58,12 +59,27 @@ struct Earlier {
 template<typename Frame>
 using Segments = std::list<DiscreteTrajectorySegment<Frame>>;
 
+// The two possible representations of the points of a segment.  The B-tree
+// supports efficient insertions anywhere, the flat timeline is optimized for
+// insertions and erasures at the ends, which are the common case.
 template<typename Frame>
-using Timeline = absl::btree_set<value_type<Frame>, Earlier>;
+using BTreeTimeline = absl::btree_set<value_type<Frame>, Earlier>;
+template<typename Frame>
+using FlatTimeline = _flat_timeline::FlatTimeline<value_type<Frame>>;
+
+#if PRINCIPIA_DISCRETE_TRAJECTORY_FLAT_TIMELINE
+template<typename Frame>
+using Timeline = FlatTimeline<Frame>;
+#else
+template<typename Frame>
+using Timeline = BTreeTimeline<Frame>;
+#endif
 
 }  // namespace internal
 
+using internal::BTreeTimeline;
 using internal::DownsamplingParameters;
+using internal::FlatTimeline;
 using internal::Segments;
 using internal::Timeline;
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <functional>
+#include <future>
 #include <limits>
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -12,6 +14,7 @@
 #include "base/concepts.hpp"
 #include "base/not_null.hpp"
 #include "base/recurring_thread.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/instant.hpp"
 #include "geometry/space.hpp"
@@ -26,6 +29,8 @@
 #include "physics/geopotential.hpp"
 #include "physics/integration_parameters.hpp"
 #include "physics/massive_body.hpp"
+#include "physics/point_mass_accelerations.hpp"
+#include "physics/positions_cache.hpp"
 #include "physics/tensors.hpp"
 #include "quantities/named_quantities.hpp"
 #include "quantities/quantities.hpp"
@@ -41,6 +46,7 @@ namespace internal {
 using namespace principia::base::_concepts;
 using namespace principia::base::_not_null;
 using namespace principia::base::_recurring_thread;
+using namespace principia::base::_thread_pool;
 using namespace principia::geometry::_grassmann;
 using namespace principia::geometry::_instant;
 using namespace principia::geometry::_space;
@@ -54,6 +60,8 @@ using namespace principia::physics::_discrete_trajectory;
 using namespace principia::physics::_geopotential;
 using namespace principia::physics::_integration_parameters;
 using namespace principia::physics::_massive_body;
+using namespace principia::physics::_point_mass_accelerations;
+using namespace principia::physics::_positions_cache;
 using namespace principia::physics::_tensors;
 using namespace principia::quantities::_named_quantities;
 using namespace principia::quantities::_quantities;
@@ -138,6 +146,12 @@ class Ephemeris {
 
   virtual absl::Status last_severe_integration_status() const;
 
+  // The number of evaluations of the positions of the massive bodies that were
+  // served by, resp. missed, the cache used by the acceleration and potential
+  // computations.
+  std::int64_t positions_cache_hits() const;
+  std::int64_t positions_cache_misses() const;
+
   // Prolongs the ephemeris up to at least |t|.  Returns an error iff the thread
   // is stopped.  After a successful call with the second parameter defaulted,
   // |t_max() >= t|.
@@ -186,7 +200,44 @@ class Ephemeris {
       std::int64_t max_ephemeris_steps = unlimited_max_ephemeris_steps)
       EXCLUDES(lock_);
 
-  // Same as above, but uses a generalized integrator.
+  // Same as above, but integrates the |trajectories| in lockstep, as a single
+  // system with a common step size.  The degrees of freedom of the massive
+  // bodies are evaluated once per evaluation time for all the |trajectories|.
+  // The step size is controlled by the trajectory having the largest error, so
+  // each trajectory is integrated at least as accurately as if it was flowed
+  // alone.  The |trajectories| must all end at the same time.  The
+  // |intrinsic_accelerations| correspond to the |trajectories|, may contain
+  // nulls, and may be empty.  A collision of one of the trajectories stops the
+  // integration of all of them.
+  virtual absl::Status FlowWithAdaptiveStep(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      AdaptiveStepParameters const& parameters,
+      std::int64_t max_ephemeris_steps = unlimited_max_ephemeris_steps)
+      EXCLUDES(lock_);
+
+  // Same as the first overload, but integrates each of the |trajectories|
+  // independently, with its own step size and its own |parameters|, as an
+  // ensemble.  The trajectories may end at different times.  The accelerations
+  // of the trajectories that are evaluated at the same time are computed
+  // together, so the degrees of freedom of the massive bodies are evaluated
+  // once for all of them.  The ephemeris is prolonged by at most
+  // |max_ephemeris_steps| for the entire ensemble.  Up to the resulting
+  // |t_max()|, each trajectory gets the same points as with the first overload.
+  // The result contains the status of each trajectory.  The integrator of all
+  // the |parameters| must be the |EmbeddedExplicitRungeKuttaNyströmIntegrator|
+  // for |Method|.
+  template<typename Method>
+  std::vector<absl::Status> FlowEnsembleWithAdaptiveStep(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      Instant const& t,
+      std::vector<AdaptiveStepParameters> const& parameters,
+      std::int64_t max_ephemeris_steps = unlimited_max_ephemeris_steps)
+      EXCLUDES(lock_);
+
+  // Same as the first overload, but uses a generalized integrator.
   virtual absl::Status FlowWithAdaptiveStep(
       not_null<DiscreteTrajectory<Frame>*> trajectory,
       GeneralizedIntrinsicAcceleration intrinsic_acceleration,
@@ -309,6 +360,9 @@ class Ephemeris {
   void AppendMassiveBodiesState(
       typename NewtonianMotionEquation::State const& state)
       REQUIRES(lock_);
+  // Waits until the |pending_fittings_| have completed, and records an
+  // apocalypse if any of them failed.
+  void AwaitFittings() REQUIRES(lock_);
   template<typename ContinuousTrajectoryPtr>
   static std::vector<absl::Status> AppendMassiveBodiesStateToTrajectories(
       typename NewtonianMotionEquation::State const& state,
@@ -326,6 +380,12 @@ class Ephemeris {
   virtual Instant t_min_locked() const REQUIRES_SHARED(lock_);
   virtual Instant t_max_locked() const REQUIRES_SHARED(lock_);
 
+  // Returns the positions of all the massive bodies at |t|, in the order of
+  // |bodies_|.  The result is looked up in, or inserted into,
+  // |positions_cache_|.
+  std::shared_ptr<typename PositionsCache<Frame>::Positions const>
+  EvaluatePositionsLocked(Instant const& t) const REQUIRES_SHARED(lock_);
+
   // Computes the Jacobian of the acceleration field between one body, |body1|
   // (with index |b1| in the |positions| and |jacobians| arrays) and the bodies
   // |bodies2| (with indices [b2_begin, b2_end[ in the |bodies2|, |positions|
@@ -378,29 +438,31 @@ class Ephemeris {
       std::vector<Geopotential<Frame>> const& geopotentials);
 
   // Computes the accelerations due to one body, |body1| (with index |b1| in the
-  // |bodies_| and |trajectories_| arrays) on massless bodies at the given
-  // |positions|.  The template parameter specifies what we know about the
-  // massive body, and therefore what forces apply.  Returns an integer for
-  // efficiency.
+  // |bodies_| and |trajectories_| arrays, located at |position1|) on massless
+  // bodies at the given |positions|.  The template parameter specifies what we
+  // know about the massive body, and therefore what forces apply.  Returns an
+  // integer for efficiency.
   template<bool body1_is_oblate>
   std::underlying_type_t<absl::StatusCode>
   ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
       Instant const& t,
       MassiveBody const& body1,
       std::size_t b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const
       REQUIRES_SHARED(lock_);
 
   // Computes the potential resulting from one body, |body1| (with index |b1| in
-  // the |bodies_| and |trajectories_| arrays) at the given |positions|.  The
-  // template parameter specifies what we know about the massive body, and
-  // therefore what potential applies.
+  // the |bodies_| and |trajectories_| arrays, located at |position1|) at the
+  // given |positions|.  The template parameter specifies what we know about the
+  // massive body, and therefore what potential applies.
   template<bool body1_is_oblate>
   void ComputeGravitationalPotentialsOfMassiveBody(
       Instant const& t,
       MassiveBody const& body1,
       std::size_t b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
       std::vector<SpecificEnergy>& potentials) const
       REQUIRES_SHARED(lock_);
@@ -430,11 +492,12 @@ class Ephemeris {
       std::vector<SpecificEnergy>& potentials) const
       EXCLUDES(lock_);
 
-  // Flows the given ODE with an adaptive step integrator.
+  // Flows the given ODE with an adaptive step integrator.  The |trajectories|
+  // must all end at the same time.
   template<typename ODE>
   absl::Status FlowODEWithAdaptiveStep(
       typename ODE::RightHandSideComputation compute_acceleration,
-      not_null<DiscreteTrajectory<Frame>*> trajectory,
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
       Instant const& t,
       _integration_parameters::AdaptiveStepParameters<ODE> const& parameters,
       std::int64_t max_ephemeris_steps) EXCLUDES(lock_);
@@ -473,6 +536,18 @@ class Ephemeris {
   int number_of_oblate_bodies_ = 0;
   int number_of_spherical_bodies_ = 0;
 
+  // Computes the mutual accelerations of the spherical bodies, which are at
+  // the end of |bodies_|.
+  PointMassAccelerations<Frame> spherical_bodies_accelerations_;
+  // The radii below which a massless body collides with a spherical body.
+  std::vector<Length> spherical_bodies_collision_radii_;
+
+  // The positions of the massive bodies at the times most recently used in the
+  // acceleration and potential computations.  Invalidated with |lock_| held
+  // exclusively whenever the trajectories change, so that no reader may insert
+  // stale positions.
+  mutable PositionsCache<Frame> positions_cache_;
+
   not_null<
       std::unique_ptr<Checkpointer<serialization::Ephemeris>>> checkpointer_;
 
@@ -499,6 +574,12 @@ class Ephemeris {
       instance_ GUARDED_BY(lock_);
 
   absl::Status last_severe_integration_status_ GUARDED_BY(lock_);
+
+  // The fittings running on the |SharedThreadPool|, with the indices of their
+  // trajectories.  They must be awaited before the |trajectories_| are
+  // extended, checkpointed or made visible to clients.
+  std::vector<std::pair<int, std::future<absl::Status>>> pending_fittings_
+      GUARDED_BY(lock_);
 };
 
 }  // namespace internal
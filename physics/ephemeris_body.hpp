@@ -7,6 +7,7 @@
 #include <limits>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -20,6 +21,8 @@
 #include "geometry/sign.hpp"
 #include "geometry/symmetric_bilinear_form.hpp"
 #include "integrators/embedded_explicit_generalized_runge_kutta_nyström_integrator.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_ensemble_integrator.hpp"  // NOLINT
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
 #include "integrators/methods.hpp"
 #include "numerics/double_precision.hpp"
 #include "numerics/hermite3.hpp"
@@ -44,6 +47,8 @@ using namespace principia::geometry::_r3_element;
 using namespace principia::geometry::_sign;
 using namespace principia::geometry::_symmetric_bilinear_form;
 using namespace principia::integrators::_embedded_explicit_generalized_runge_kutta_nyström_integrator;  // NOLINT
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_ensemble_integrator;  // NOLINT
+using namespace principia::integrators::_embedded_explicit_runge_kutta_nyström_integrator;  // NOLINT
 using namespace principia::integrators::_methods;
 using namespace principia::numerics::_double_precision;
 using namespace principia::numerics::_hermite3;
@@ -156,6 +161,16 @@ Ephemeris<Frame>::Ephemeris(
     }
   }
 
+  std::vector<GravitationalParameter> spherical_gravitational_parameters;
+  for (std::size_t b = number_of_oblate_bodies_; b < bodies_.size(); ++b) {
+    spherical_gravitational_parameters.push_back(
+        bodies_[b]->gravitational_parameter());
+    spherical_bodies_collision_radii_.push_back(min_radius_tolerance *
+                                                bodies_[b]->min_radius());
+  }
+  spherical_bodies_accelerations_ =
+      PointMassAccelerations<Frame>(spherical_gravitational_parameters);
+
   absl::ReaderMutexLock l(&lock_);  // For locking checks.
   instance_ = fixed_step_parameters_.integrator().NewInstance(
       problem,
@@ -216,6 +231,16 @@ absl::Status Ephemeris<Frame>::last_severe_integration_status() const {
   return last_severe_integration_status_;
 }
 
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::positions_cache_hits() const {
+  return positions_cache_.hits();
+}
+
+template<typename Frame>
+std::int64_t Ephemeris<Frame>::positions_cache_misses() const {
+  return positions_cache_.misses();
+}
+
 template<typename Frame>
 void Ephemeris<Frame>::RequestReanimation(Instant const& desired_t_min) {
   reanimator_.Start();
@@ -290,6 +315,9 @@ absl::Status Ephemeris<Frame>::Prolong(Instant const& t,
   // determined after the first integration.
   while (t_max_locked() < desired_t_max) {
     instance_->Solve(t_final).IgnoreError();
+    // The last fittings must be committed before |t_max()| is computed or the
+    // lock is released.
+    AwaitFittings();
     RETURN_IF_STOPPED;
     t_final += fixed_step_parameters_.step();
   }
@@ -391,12 +419,227 @@ absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
 
   return FlowODEWithAdaptiveStep<NewtonianMotionEquation>(
              std::move(compute_acceleration),
-             trajectory,
+             {trajectory},
              t,
              parameters,
              max_ephemeris_steps);
 }
 
+template<typename Frame>
+absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    AdaptiveStepParameters const& parameters,
+    std::int64_t const max_ephemeris_steps) {
+  auto compute_acceleration = [this, &intrinsic_accelerations](
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) {
+    // The massive bodies are evaluated once for all the massless bodies.
+    auto const error =
+        ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+            t,
+            positions,
+            accelerations);
+    // Add the intrinsic accelerations.
+    for (int i = 0; i < intrinsic_accelerations.size(); ++i) {
+      auto const& intrinsic_acceleration = intrinsic_accelerations[i];
+      if (intrinsic_acceleration != nullptr) {
+        accelerations[i] += intrinsic_acceleration(t);
+      }
+    }
+    return error == absl::StatusCode::kOk ? absl::OkStatus() :
+                    CollisionDetected();
+  };
+
+  return FlowODEWithAdaptiveStep<NewtonianMotionEquation>(
+             std::move(compute_acceleration),
+             trajectories,
+             t,
+             parameters,
+             max_ephemeris_steps);
+}
+
+template<typename Frame>
+template<typename Method>
+std::vector<absl::Status> Ephemeris<Frame>::FlowEnsembleWithAdaptiveStep(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    Instant const& t,
+    std::vector<AdaptiveStepParameters> const& parameters,
+    std::int64_t const max_ephemeris_steps) {
+  auto const& ensemble_integrator =
+      EmbeddedExplicitRungeKuttaNyströmEnsembleIntegrator<
+          Method, NewtonianMotionEquation>();
+  using EnsembleIntegrator =
+      std::remove_cvref_t<decltype(ensemble_integrator)>;
+  CHECK_EQ(trajectories.size(), parameters.size());
+  CHECK(intrinsic_accelerations.empty() ||
+        intrinsic_accelerations.size() == trajectories.size());
+  for (auto const& p : parameters) {
+    CHECK(&p.integrator() ==
+          &EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              Method, NewtonianMotionEquation>());
+  }
+
+  std::vector<absl::Status> statuses(trajectories.size());
+
+  // The indices of the trajectories that need to be integrated.  The members of
+  // the ensemble are in the same order.
+  std::vector<int> flowed_trajectories;
+  for (int i = 0; i < trajectories.size(); ++i) {
+    if (trajectories[i]->back().time != t) {
+      flowed_trajectories.push_back(i);
+    }
+  }
+  if (flowed_trajectories.empty()) {
+    return statuses;
+  }
+
+  Prolong(t, max_ephemeris_steps).IgnoreError();
+  if (this_stoppable_thread::get_stop_token().stop_requested()) {
+    for (int const i : flowed_trajectories) {
+      statuses[i] = absl::CancelledError("Cancelled by stop token");
+    }
+    return statuses;
+  }
+  Instant const t_final = std::min(t, t_max());
+
+  // Each member appends to a vector containing only its trajectory, as
+  // expected by |AppendMasslessBodiesStateToTrajectories|.  The vectors must
+  // not move while the ensemble exists.
+  std::vector<std::vector<not_null<DiscreteTrajectory<Frame>*>>>
+      member_trajectories;
+  member_trajectories.reserve(flowed_trajectories.size());
+  std::vector<typename EnsembleIntegrator::Member> members;
+  members.reserve(flowed_trajectories.size());
+  for (int const i : flowed_trajectories) {
+    auto const& [last_time, last_degrees_of_freedom] = trajectories[i]->back();
+    auto const& p = parameters[i];
+    member_trajectories.push_back({trajectories[i]});
+
+    typename NewtonianMotionEquation::State initial_state;
+    initial_state.time = DoublePrecision<Instant>(last_time);
+    initial_state.positions.emplace_back(last_degrees_of_freedom.position());
+    initial_state.velocities.emplace_back(last_degrees_of_freedom.velocity());
+
+    typename AdaptiveStepSizeIntegrator<NewtonianMotionEquation>::Parameters
+        const integrator_parameters(
+            /*first_time_step=*/t_final - last_time,
+            /*safety_factor=*/0.9,
+            p.max_steps(),
+            /*last_step_is_exact=*/true);
+    CHECK_GT(integrator_parameters.first_step, 0 * Second)
+        << "Flow back to the future: " << t_final << " <= " << last_time;
+
+    members.push_back(
+        {.initial_state = std::move(initial_state),
+         .append_state =
+             std::bind(&Ephemeris::AppendMasslessBodiesStateToTrajectories,
+                       _1,
+                       std::cref(member_trajectories.back())),
+         .tolerance_to_error_ratio =
+             std::bind(&Ephemeris<Frame>::ToleranceToErrorRatio,
+                       p.length_integration_tolerance(),
+                       p.speed_integration_tolerance(),
+                       _1, _2, _3),
+         .parameters = integrator_parameters});
+  }
+
+  // Returns true iff none of the |positions| is inside a massive body.
+  auto const compute_gravitational_accelerations =
+      [this](Instant const& time,
+             std::vector<Position<Frame>> const& positions,
+             std::vector<Vector<Acceleration, Frame>>& accelerations) {
+        auto const error =
+            ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
+                time, positions, accelerations);
+        return error == absl::StatusCode::kOk;
+      };
+
+  // Scratch storage for the batched computation.
+  std::vector<int> sorted_members;
+  std::vector<Position<Frame>> group_positions;
+  std::vector<Vector<Acceleration, Frame>> group_accelerations;
+  auto compute_accelerations =
+      [&compute_gravitational_accelerations,
+       &flowed_trajectories,
+       &intrinsic_accelerations,
+       &sorted_members,
+       &group_positions,
+       &group_accelerations](
+          std::vector<int> const& members,
+          std::vector<Instant> const& times,
+          std::vector<std::vector<Position<Frame>>> const& positions,
+          std::vector<std::vector<Vector<Acceleration, Frame>>>& accelerations,
+          std::vector<absl::Status>& statuses) {
+        // Group the members by time, so that the massive bodies are evaluated
+        // once per group.  The sort is stable to make the groups
+        // deterministic.
+        sorted_members = members;
+        std::stable_sort(sorted_members.begin(),
+                         sorted_members.end(),
+                         [&times](int const left, int const right) {
+                           return times[left] < times[right];
+                         });
+        for (auto first = sorted_members.begin();
+             first != sorted_members.end();) {
+          Instant const& time = times[*first];
+          auto const last = std::find_if(
+              first, sorted_members.end(), [&time, &times](int const m) {
+                return times[m] != time;
+              });
+          group_positions.clear();
+          for (auto it = first; it != last; ++it) {
+            group_positions.push_back(positions[*it].front());
+          }
+          group_accelerations.resize(group_positions.size());
+          bool const group_ok = compute_gravitational_accelerations(
+              time, group_positions, group_accelerations);
+          for (auto it = first; it != last; ++it) {
+            int const m = *it;
+            accelerations[m].front() = group_accelerations[it - first];
+            // Find out which members collided.  This is rare enough that the
+            // cost of recomputing their accelerations doesn't matter.
+            if (!group_ok &&
+                !compute_gravitational_accelerations(
+                    time, positions[m], accelerations[m])) {
+              statuses[m] = CollisionDetected();
+            }
+            if (!intrinsic_accelerations.empty()) {
+              auto const& intrinsic_acceleration =
+                  intrinsic_accelerations[flowed_trajectories[m]];
+              if (intrinsic_acceleration != nullptr) {
+                accelerations[m].front() += intrinsic_acceleration(time);
+              }
+            }
+          }
+          first = last;
+        }
+      };
+
+  auto const instance =
+      ensemble_integrator.NewInstance(members, compute_accelerations);
+  auto const member_statuses = instance->Solve(
+      std::vector<Instant>(flowed_trajectories.size(), t_final));
+
+  for (int m = 0; m < flowed_trajectories.size(); ++m) {
+    auto status = member_statuses[m];
+    // See |FlowODEWithAdaptiveStep| for the handling of the statuses.
+    if (absl::IsOutOfRange(status)) {
+      status = absl::OkStatus();
+    }
+    if (status.ok() && t_final != t) {
+      status = absl::DeadlineExceededError("Couldn't reach " + DebugString(t) +
+                                           ", stopping at " +
+                                           DebugString(t_final));
+    }
+    statuses[flowed_trajectories[m]] = std::move(status);
+  }
+  return statuses;
+}
+
 template<typename Frame>
 absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
     not_null<DiscreteTrajectory<Frame>*> trajectory,
@@ -425,7 +668,7 @@ absl::Status Ephemeris<Frame>::FlowWithAdaptiveStep(
 
   return FlowODEWithAdaptiveStep<GeneralizedNewtonianMotionEquation>(
              std::move(compute_acceleration),
-             trajectory,
+             {trajectory},
              t,
              parameters,
              max_ephemeris_steps);
@@ -451,7 +694,7 @@ JacobianOfAcceleration<Frame> Ephemeris<Frame>::ComputeJacobianOnMassiveBody(
     not_null<MassiveBody const*> body,
     Instant const& t) const {
   // NOTE(phl): This doesn't take high-order geopotential into account.
-  std::vector<Position<Frame>> positions;
+  std::shared_ptr<typename PositionsCache<Frame>::Positions const> positions;
   std::vector<JacobianOfAcceleration<Frame>> jacobians(bodies_.size());
   int b1 = -1;
 
@@ -459,15 +702,12 @@ JacobianOfAcceleration<Frame> Ephemeris<Frame>::ComputeJacobianOnMassiveBody(
   // "locked" method of each trajectory.
   {
     absl::ReaderMutexLock l(&lock_);
-    positions.reserve(bodies_.size());
+    positions = EvaluatePositionsLocked(t);
     for (int b = 0; b < bodies_.size(); ++b) {
-      auto const& current_body = bodies_[b];
-      auto const& current_body_trajectory = trajectories_[b];
-      if (current_body.get() == body) {
+      if (bodies_[b].get() == body) {
         CHECK_EQ(-1, b1);
         b1 = b;
       }
-      positions.push_back(current_body_trajectory->EvaluatePositionLocked(t));
     }
     CHECK_LE(0, b1);
   }
@@ -477,13 +717,13 @@ JacobianOfAcceleration<Frame> Ephemeris<Frame>::ComputeJacobianOnMassiveBody(
       /*bodies2=*/bodies_,
       /*b2_begin=*/0,
       /*b2_end=*/b1,
-      positions, jacobians);
+      *positions, jacobians);
   ComputeJacobianByMassiveBodyOnMassiveBodies(
       /*body1=*/*body, b1,
       /*bodies2=*/bodies_,
       /*b2_begin=*/b1 + 1,
       /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-      positions, jacobians);
+      *positions, jacobians);
 
   return jacobians[b1];
 }
@@ -602,7 +842,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
     Instant const& t) const {
   bool const body_is_oblate = body->is_oblate();
 
-  std::vector<Position<Frame>> positions;
+  std::shared_ptr<typename PositionsCache<Frame>::Positions const> positions;
   std::vector<Vector<Acceleration, Frame>> accelerations(bodies_.size());
   int b1 = -1;
 
@@ -610,15 +850,12 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
   // "locked" method of each trajectory.
   {
     absl::ReaderMutexLock l(&lock_);
-    positions.reserve(bodies_.size());
+    positions = EvaluatePositionsLocked(t);
     for (int b = 0; b < bodies_.size(); ++b) {
-      auto const& current_body = bodies_[b];
-      auto const& current_body_trajectory = trajectories_[b];
-      if (current_body.get() == body) {
+      if (bodies_[b].get() == body) {
         CHECK_EQ(-1, b1);
         b1 = b;
       }
-      positions.push_back(current_body_trajectory->EvaluatePositionLocked(t));
     }
     CHECK_LE(0, b1);
   }
@@ -631,7 +868,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*body1=*/*body, b1,
         /*bodies2=*/bodies_,
         /*b2_begin=*/0, /*b2_end=*/b1,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         /*body1_is_oblate=*/true,
         /*body2_is_oblate=*/true>(
@@ -639,7 +876,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*body1=*/*body, b1,
         /*bodies2=*/bodies_,
         /*b2_begin=*/b1 + 1, /*b2_end=*/number_of_oblate_bodies_,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         /*body1_is_oblate=*/true,
         /*body2_is_oblate=*/false>(
@@ -648,7 +885,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*bodies2=*/bodies_,
         /*b2_begin=*/number_of_oblate_bodies_,
         /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
   } else {
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         /*body1_is_oblate=*/false,
@@ -657,7 +894,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*body1=*/*body, b1,
         /*bodies2=*/bodies_,
         /*b2_begin=*/0, /*b2_end=*/number_of_oblate_bodies_,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         /*body1_is_oblate=*/false,
         /*body2_is_oblate=*/false>(
@@ -666,7 +903,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*bodies2=*/bodies_,
         /*b2_begin=*/number_of_oblate_bodies_,
         /*b2_end=*/b1,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
         /*body1_is_oblate=*/false,
         /*body2_is_oblate=*/false>(
@@ -675,7 +912,7 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationOnMassiveBody(
         /*bodies2=*/bodies_,
         /*b2_begin=*/b1 + 1,
         /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-        positions, accelerations, geopotentials_);
+        *positions, accelerations, geopotentials_);
   }
 
   return accelerations[b1];
@@ -1050,6 +1287,7 @@ absl::Status Ephemeris<Frame>::ReanimateOneCheckpoint(
     for (int i = 0; i < trajectories_.size(); ++i) {
       trajectories_[i]->Prepend(std::move(*trajectories[i]));
     }
+    positions_cache_.Invalidate();
     oldest_reanimated_checkpoint_ = t_initial;
   }
 
@@ -1061,13 +1299,47 @@ void Ephemeris<Frame>::AppendMassiveBodiesState(
     typename NewtonianMotionEquation::State const& state) {
   lock_.AssertHeld();
 
-  // Extend the trajectories.
-  auto const statuses = AppendMassiveBodiesStateToTrajectories(state,
-                                                               trajectories_);
+  // The fittings started at the previous step have been running while the
+  // integrator computed this step.  They must complete before the trajectories
+  // are extended.
+  AwaitFittings();
 
-  // Handle the apocalypse.
-  for (int i = 0; i < statuses.size(); ++i) {
-    auto const& status = statuses[i];
+  // Extend the trajectories.  If a polynomial is completed, the fitting, which
+  // is costly, is done on the shared pool, in parallel for all the bodies.
+  Instant const time = state.time.value;
+  for (int i = 0; i < trajectories_.size(); ++i) {
+    auto fitting = trajectories_[i]->AppendWithDeferredFitting(
+        time,
+        DegreesOfFreedom<Frame>(state.positions[i].value,
+                                state.velocities[i].value));
+    if (fitting != nullptr) {
+      pending_fittings_.emplace_back(
+          i, SharedThreadPool().Add(std::move(fitting)));
+    }
+  }
+  positions_cache_.Invalidate();
+
+  // Note that the checkpoint is written systematically after inserting the
+  // first point of the trajectories.  The checkpoints of the trajectories
+  // include the state of the fitting, so the fittings must complete before
+  // they are written.
+  if constexpr (serializable<Frame>) {
+    if (checkpointer_->WriteToCheckpointIfNeeded(
+            time, max_time_between_checkpoints)) {
+      AwaitFittings();
+      for (auto const& trajectory : trajectories_) {
+        trajectory->WriteToCheckpoint(time);
+      }
+    }
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::AwaitFittings() {
+  lock_.AssertHeld();
+  for (auto& [i, fitting] : pending_fittings_) {
+    // Handle the apocalypse.
+    absl::Status const status = fitting.get();
     if (!status.ok()) {
       last_severe_integration_status_ =
           absl::Status(status.code(),
@@ -1077,10 +1349,7 @@ void Ephemeris<Frame>::AppendMassiveBodiesState(
       LOG(ERROR) << "New Apocalypse: " << last_severe_integration_status_;
     }
   }
-
-  // Note that the checkpoint is written systematically after inserting the
-  // first point of the trajectories.
-  WriteToCheckpointIfNeeded(state.time.value);
+  pending_fittings_.clear();
 }
 
 template<typename Frame>
@@ -1134,6 +1403,23 @@ Ephemeris<Frame>::MakeMassiveBodiesNewtonianMotionEquation() {
   return equation;
 }
 
+template<typename Frame>
+std::shared_ptr<typename PositionsCache<Frame>::Positions const>
+Ephemeris<Frame>::EvaluatePositionsLocked(Instant const& t) const {
+  lock_.AssertReaderHeld();
+  if (auto cached_positions = positions_cache_.Find(t);
+      cached_positions != nullptr) {
+    return cached_positions;
+  }
+  auto positions = positions_cache_.NewPositions();
+  positions->reserve(trajectories_.size());
+  for (auto const& trajectory : trajectories_) {
+    positions->push_back(trajectory->EvaluatePositionLocked(t));
+  }
+  positions_cache_.Insert(t, positions);
+  return positions;
+}
+
 template<typename Frame>
 Instant Ephemeris<Frame>::instance_time_locked() const {
   return instance_->time().value;
@@ -1311,12 +1597,11 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
     Instant const& t,
     MassiveBody const& body1,
     std::size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
   lock_.AssertReaderHeld();
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  auto const& trajectory1 = *trajectories_[b1];
-  Position<Frame> const position1 = trajectory1.EvaluatePositionLocked(t);
   Length const body1_collision_radius =
       min_radius_tolerance * body1.min_radius();
   // TODO(phl): Use std::to_underlying when we have C++23.
@@ -1339,18 +1624,25 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
 
     auto const μ1_over_Δq³ = μ1 * one_over_Δq³;
     accelerations[b2] += Δq * μ1_over_Δq³;
+  }
 
-    if (body1_is_oblate) {
-      Vector<Quotient<Acceleration,
-                      GravitationalParameter>, Frame> const
-          spherical_harmonics_effect =
-              geopotentials_[b1].GeneralSphericalHarmonicsAcceleration(
-                  t,
-                  -Δq,
-                  Δq_norm,
-                  Δq²,
-                  one_over_Δq³);
-      accelerations[b2] += μ1 * spherical_harmonics_effect;
+  if constexpr (body1_is_oblate) {
+    // The geopotential is evaluated for all the massless bodies at once, which
+    // gives the same results as
+    // |Geopotential::GeneralSphericalHarmonicsAcceleration| for each of them.
+    thread_local std::vector<Displacement<Frame>> displacements;
+    thread_local std::vector<
+        Vector<Quotient<Acceleration, GravitationalParameter>, Frame>>
+        spherical_harmonics_effects;
+    displacements.clear();
+    for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+      displacements.push_back(positions[b2] - position1);
+    }
+    spherical_harmonics_effects.resize(positions.size());
+    geopotentials_[b1].GeneralSphericalHarmonicsAccelerations(
+        t, displacements, spherical_harmonics_effects);
+    for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+      accelerations[b2] += μ1 * spherical_harmonics_effects[b2];
     }
   }
   return error;
@@ -1362,12 +1654,11 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfMassiveBody(
     Instant const& t,
     MassiveBody const& body1,
     std::size_t b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
     std::vector<SpecificEnergy>& potentials) const {
   lock_.AssertReaderHeld();
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  auto const& trajectory1 = *trajectories_[b1];
-  Position<Frame> const position1 = trajectory1.EvaluatePositionLocked(t);
 
   for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
     // A vector from the center of |b2| to the center of |b1|.
@@ -1427,21 +1718,13 @@ Ephemeris<Frame>::ComputeGravitationalAccelerationBetweenAllMassiveBodies(
         /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
         positions, accelerations, geopotentials_);
   }
-  for (std::size_t b1 = number_of_oblate_bodies_;
-       b1 < number_of_oblate_bodies_ +
-            number_of_spherical_bodies_;
-       ++b1) {
-    MassiveBody const& body1 = *bodies_[b1];
-    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
-        /*body1_is_oblate=*/false,
-        /*body2_is_oblate=*/false>(
-        t,
-        body1, b1,
-        /*bodies2=*/bodies_,
-        /*b2_begin=*/b1 + 1,
-        /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-        positions, accelerations, geopotentials_);
-  }
+  // The interactions between spherical bodies are computed by a vectorized
+  // kernel which gives the same results as
+  // |ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies| with
+  // |body1_is_oblate| and |body2_is_oblate| both false.
+  spherical_bodies_accelerations_.Add(positions,
+                                      /*offset=*/number_of_oblate_bodies_,
+                                      accelerations);
 
   return absl::OkStatus();
 }
@@ -1461,26 +1744,30 @@ ComputeGravitationalAccelerationByAllMassiveBodiesOnMasslessBodies(
 
   // Locking ensures that we see a consistent state of all the trajectories.
   absl::ReaderMutexLock l(&lock_);
+  auto const massive_bodies_positions = EvaluatePositionsLocked(t);
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
                  /*body1_is_oblate=*/true>(
                  t,
                  body1, b1,
+                 (*massive_bodies_positions)[b1],
                  positions,
                  accelerations);
   }
-  for (std::size_t b1 = number_of_oblate_bodies_;
-       b1 < number_of_oblate_bodies_ +
-            number_of_spherical_bodies_;
-       ++b1) {
-    MassiveBody const& body1 = *bodies_[b1];
-    error |= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
-                 /*body1_is_oblate=*/false>(
-                 t,
-                 body1, b1,
-                 positions,
-                 accelerations);
+
+  // The spherical bodies are handled by a vectorized kernel which gives the
+  // same results as
+  // |ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies| with
+  // |body1_is_oblate| false.
+  if (!spherical_bodies_accelerations_.AddOnMasslessBodies(
+          *massive_bodies_positions,
+          /*offset=*/number_of_oblate_bodies_,
+          spherical_bodies_collision_radii_,
+          positions,
+          accelerations)) {
+    error |= static_cast<std::underlying_type_t<absl::StatusCode>>(
+        absl::StatusCode::kOutOfRange);
   }
   return static_cast<absl::StatusCode>(error);
 }
@@ -1495,11 +1782,13 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfAllMassiveBodies(
 
   // Locking ensures that we see a consistent state of all the trajectories.
   absl::ReaderMutexLock l(&lock_);
+  auto const massive_bodies_positions = EvaluatePositionsLocked(t);
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     ComputeGravitationalPotentialsOfMassiveBody</*body1_is_oblate=*/true>(
         t,
         body1, b1,
+        (*massive_bodies_positions)[b1],
         positions,
         potentials);
   }
@@ -1511,6 +1800,7 @@ void Ephemeris<Frame>::ComputeGravitationalPotentialsOfAllMassiveBodies(
     ComputeGravitationalPotentialsOfMassiveBody</*body1_is_oblate=*/false>(
         t,
         body1, b1,
+        (*massive_bodies_positions)[b1],
         positions,
         potentials);
   }
@@ -1520,18 +1810,16 @@ template<typename Frame>
 template<typename ODE>
 absl::Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
     typename ODE::RightHandSideComputation compute_acceleration,
-    not_null<DiscreteTrajectory<Frame>*> trajectory,
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
     Instant const& t,
     _integration_parameters::AdaptiveStepParameters<ODE> const& parameters,
     std::int64_t max_ephemeris_steps) {
-  auto const& [trajectory_last_time,
-               trajectory_last_degrees_of_freedom] = trajectory->back();
+  CHECK(!trajectories.empty());
+  Instant const trajectory_last_time = trajectories.front()->back().time;
   if (trajectory_last_time == t) {
     return absl::OkStatus();
   }
 
-  std::vector<not_null<DiscreteTrajectory<Frame>*>> const trajectories =
-      {trajectory};
   Prolong(t, max_ephemeris_steps).IgnoreError();
   RETURN_IF_STOPPED;
   Instant const t_final = std::min(t, t_max());
@@ -1539,9 +1827,15 @@ absl::Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
   InitialValueProblem<ODE> problem;
   problem.equation.compute_acceleration = std::move(compute_acceleration);
 
-  problem.initial_state = {trajectory_last_time,
-                           {trajectory_last_degrees_of_freedom.position()},
-                           {trajectory_last_degrees_of_freedom.velocity()}};
+  problem.initial_state.time = DoublePrecision<Instant>(trajectory_last_time);
+  for (auto const& trajectory : trajectories) {
+    auto const& [last_time, last_degrees_of_freedom] = trajectory->back();
+    CHECK_EQ(last_time, trajectory_last_time);
+    problem.initial_state.positions.emplace_back(
+        last_degrees_of_freedom.position());
+    problem.initial_state.velocities.emplace_back(
+        last_degrees_of_freedom.velocity());
+  }
 
   typename AdaptiveStepSizeIntegrator<ODE>::Parameters const
       integrator_parameters(
@@ -607,6 +607,189 @@ TEST_P(EphemerisTest, EarthTwoProbes) {
               Eq(q_probe2));
 }
 
+// The Earth and two massless probes, flowed in lockstep with an adaptive step.
+TEST_P(EphemerisTest, EarthTwoProbesAdaptiveStep) {
+  Length const distance_1 = 1e9 * Metre;
+  Length const distance_2 = 3e9 * Metre;
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  bodies.erase(bodies.begin() + 1);
+  initial_state.erase(initial_state.begin() + 1);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+
+  DiscreteTrajectory<ICRS> trajectory1;
+  EXPECT_OK(trajectory1.Append(
+      t0_,
+      DegreesOfFreedom<ICRS>(
+          earth_position +
+              Vector<Length, ICRS>({0 * Metre, distance_1, 0 * Metre}),
+          earth_velocity)));
+  auto const intrinsic_acceleration1 = [earth, distance_1](Instant const& t) {
+    return Vector<Acceleration, ICRS>(
+        {0 * si::Unit<Acceleration>,
+         earth->gravitational_parameter() / (distance_1 * distance_1),
+         0 * si::Unit<Acceleration>});
+  };
+
+  DiscreteTrajectory<ICRS> trajectory2;
+  EXPECT_OK(trajectory2.Append(
+      t0_,
+      DegreesOfFreedom<ICRS>(
+          earth_position +
+              Vector<Length, ICRS>({0 * Metre, -distance_2, 0 * Metre}),
+          earth_velocity)));
+  auto const intrinsic_acceleration2 = [earth, distance_2](Instant const& t) {
+    return Vector<Acceleration, ICRS>(
+        {0 * si::Unit<Acceleration>,
+         -earth->gravitational_parameter() / (distance_2 * distance_2),
+         0 * si::Unit<Acceleration>});
+  };
+
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      {&trajectory1, &trajectory2},
+      {intrinsic_acceleration1, intrinsic_acceleration2},
+      t0_ + period,
+      Ephemeris<ICRS>::AdaptiveStepParameters(
+          EmbeddedExplicitRungeKuttaNyströmIntegrator<
+              DormandالمكاوىPrince1986RKN434FM,
+              Ephemeris<ICRS>::NewtonianMotionEquation>(),
+          max_steps,
+          1e-9 * Metre,
+          2.6e-15 * Metre / Second),
+      Ephemeris<ICRS>::unlimited_max_ephemeris_steps));
+
+  // The trajectories were integrated in lockstep.
+  EXPECT_EQ(trajectory1.size(), trajectory2.size());
+  EXPECT_EQ(t0_ + period, trajectory1.back().time);
+  EXPECT_EQ(t0_ + period, trajectory2.back().time);
+  for (auto it1 = trajectory1.begin(), it2 = trajectory2.begin();
+       it1 != trajectory1.end();
+       ++it1, ++it2) {
+    EXPECT_EQ(it1->time, it2->time);
+  }
+
+  // Both probes stay put with respect to the Earth.
+  Position<ICRS> const final_earth_position =
+      ephemeris.trajectory(earth)->EvaluatePosition(t0_ + period);
+  Displacement<ICRS> const final_displacement1 =
+      trajectory1.back().degrees_of_freedom.position() - final_earth_position;
+  Displacement<ICRS> const final_displacement2 =
+      trajectory2.back().degrees_of_freedom.position() - final_earth_position;
+  EXPECT_THAT(Abs(final_displacement1.coordinates().x), Lt(1 * Metre));
+  EXPECT_THAT(RelativeError(distance_1, final_displacement1.coordinates().y),
+              Lt(1e-9));
+  EXPECT_THAT(Abs(final_displacement2.coordinates().x), Lt(1 * Metre));
+  EXPECT_THAT(RelativeError(-distance_2, final_displacement2.coordinates().y),
+              Lt(1e-9));
+}
+
+TEST_P(EphemerisTest, EarthTwoProbesEnsemble) {
+  Length const distance_1 = 1e9 * Metre;
+  Length const distance_2 = 3e9 * Metre;
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  MassiveBody const* const earth = bodies[0].get();
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/5 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+
+  DegreesOfFreedom<ICRS> const probe1_degrees_of_freedom(
+      earth_position + Vector<Length, ICRS>({0 * Metre, distance_1, 0 * Metre}),
+      earth_velocity);
+  auto const intrinsic_acceleration1 = [earth, distance_1](Instant const& t) {
+    return Vector<Acceleration, ICRS>(
+        {0 * si::Unit<Acceleration>,
+         earth->gravitational_parameter() / (distance_1 * distance_1),
+         0 * si::Unit<Acceleration>});
+  };
+  DegreesOfFreedom<ICRS> const probe2_degrees_of_freedom(
+      earth_position +
+          Vector<Length, ICRS>({0 * Metre, -distance_2, 0 * Metre}),
+      earth_velocity);
+
+  // The probes have different tolerances, so they take different steps.
+  Ephemeris<ICRS>::AdaptiveStepParameters const parameters1(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Ephemeris<ICRS>::NewtonianMotionEquation>(),
+      max_steps,
+      1e-9 * Metre,
+      2.6e-15 * Metre / Second);
+  Ephemeris<ICRS>::AdaptiveStepParameters const parameters2(
+      EmbeddedExplicitRungeKuttaNyströmIntegrator<
+          DormandالمكاوىPrince1986RKN434FM,
+          Ephemeris<ICRS>::NewtonianMotionEquation>(),
+      max_steps,
+      1e-3 * Metre,
+      1e-9 * Metre / Second);
+
+  DiscreteTrajectory<ICRS> alone1;
+  EXPECT_OK(alone1.Append(t0_, probe1_degrees_of_freedom));
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(&alone1,
+                                           intrinsic_acceleration1,
+                                           t0_ + period,
+                                           parameters1));
+  DiscreteTrajectory<ICRS> alone2;
+  EXPECT_OK(alone2.Append(t0_, probe2_degrees_of_freedom));
+  EXPECT_OK(ephemeris.FlowWithAdaptiveStep(
+      &alone2,
+      Ephemeris<ICRS>::NoIntrinsicAcceleration,
+      t0_ + period,
+      parameters2));
+
+  DiscreteTrajectory<ICRS> together1;
+  EXPECT_OK(together1.Append(t0_, probe1_degrees_of_freedom));
+  DiscreteTrajectory<ICRS> together2;
+  EXPECT_OK(together2.Append(t0_, probe2_degrees_of_freedom));
+  auto const statuses =
+      ephemeris.FlowEnsembleWithAdaptiveStep<DormandالمكاوىPrince1986RKN434FM>(
+          {&together1, &together2},
+          {intrinsic_acceleration1, Ephemeris<ICRS>::NoIntrinsicAcceleration},
+          t0_ + period,
+          {parameters1, parameters2});
+  ASSERT_EQ(2, statuses.size());
+  EXPECT_OK(statuses[0]);
+  EXPECT_OK(statuses[1]);
+
+  // Each probe gets exactly the points that it gets when flowed alone.
+  for (auto const& [alone, together] :
+       {std::pair{&alone1, &together1}, std::pair{&alone2, &together2}}) {
+    ASSERT_EQ(alone->size(), together->size());
+    for (auto it1 = alone->begin(), it2 = together->begin();
+         it1 != alone->end();
+         ++it1, ++it2) {
+      EXPECT_EQ(it1->time, it2->time);
+      EXPECT_EQ(it1->degrees_of_freedom, it2->degrees_of_freedom);
+    }
+  }
+}
+
 TEST_P(EphemerisTest, Serialization) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
   std::vector<DegreesOfFreedom<ICRS>> initial_state;
@@ -1227,6 +1410,16 @@ TEST_P(EphemerisTest, ComputeGravitationalPotential) {
         finite_difference_acceleration,
         RelativeErrorFrom(actual_acceleration, AllOf(Gt(1.1e-7), Lt(9.0e-6))));
   }
+
+  // All the evaluations were at the same time, so the positions of the massive
+  // bodies were only evaluated once.
+  EXPECT_EQ(1, ephemeris->positions_cache_misses());
+  EXPECT_EQ(4999, ephemeris->positions_cache_hits());
+
+  // Prolonging the ephemeris invalidates the cache.
+  CHECK_OK(ephemeris->Prolong(j2000 + 1 * Day));
+  ephemeris->ComputeGravitationalPotential(earth_position, j2000);
+  EXPECT_EQ(2, ephemeris->positions_cache_misses());
 }
 
 TEST_P(EphemerisTest, ComputeApsidesContinuousTrajectory) {
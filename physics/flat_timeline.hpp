@@ -0,0 +1,167 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "geometry/instant.hpp"
+
+namespace principia {
+namespace physics {
+namespace _flat_timeline {
+namespace internal {
+
+using namespace principia::geometry::_instant;
+
+// An append-optimized replacement for the |absl::btree_set| used to store the
+// points of a |DiscreteTrajectorySegment|.  |Value| must have a |time| member
+// of type |Instant|, and the values are ordered by increasing |time|.  This
+// class implements the subset of the API of |absl::btree_set| that is needed
+// by the trajectories, with the same semantics.
+// The points are stored in a chunked contiguous deque.  Insertions and
+// erasures at either end are amortized constant time and, unlike those of a
+// B-tree, do not invalidate the iterators to the other points.  Insertions and
+// erasures in the middle are linear in the distance to the closest end, and
+// invalidate the iterators past the modified position.  Lookups by time use
+// an interpolation search, which is constant time for roughly uniformly spaced
+// points, followed by an exponential search, which is logarithmic time in the
+// error of the interpolation.
+// The iterators remain valid when the timeline is moved.  A moved-from
+// timeline is empty.
+template<typename Value>
+class FlatTimeline {
+  struct Storage;
+
+ public:
+  class const_iterator;
+
+  using key_type = Value;
+  using value_type = Value;
+  using size_type = std::size_t;
+  using difference_type = std::int64_t;
+  using reference = value_type const&;
+  using const_reference = value_type const&;
+  using iterator = const_iterator;
+  using reverse_iterator = std::reverse_iterator<const_iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  class const_iterator {
+   public:
+    using difference_type = std::int64_t;
+    using value_type = Value;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+    using iterator_category = std::random_access_iterator_tag;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+    reference operator[](difference_type n) const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    const_iterator operator++(int);
+    const_iterator operator--(int);
+    const_iterator& operator+=(difference_type n);
+    const_iterator& operator-=(difference_type n);
+    const_iterator operator+(difference_type n) const;
+    const_iterator operator-(difference_type n) const;
+    difference_type operator-(const_iterator right) const;
+
+    friend const_iterator operator+(difference_type const n,
+                                    const_iterator const it) {
+      return it + n;
+    }
+
+    bool operator==(const_iterator other) const;
+    std::strong_ordering operator<=>(const_iterator other) const;
+
+   private:
+    const_iterator(Storage const* storage, std::int64_t index);
+
+    // |index_| is a logical index which is not affected by insertions or
+    // erasures at the beginning of the timeline.
+    Storage const* storage_ = nullptr;
+    std::int64_t index_ = 0;
+
+    friend class FlatTimeline;
+  };
+
+  FlatTimeline();
+  FlatTimeline(FlatTimeline const& other);
+  FlatTimeline(FlatTimeline&& other);
+  FlatTimeline& operator=(FlatTimeline const& other);
+  FlatTimeline& operator=(FlatTimeline&& other);
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+  const_reverse_iterator rbegin() const;
+  const_reverse_iterator rend() const;
+  const_reverse_iterator crbegin() const;
+  const_reverse_iterator crend() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  void clear();
+
+  // Returns the point at |time| and false if there is one, otherwise inserts a
+  // new point and returns it and true.
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  std::pair<iterator, bool> insert(value_type const& value);
+
+  // Same as |emplace|, but constant time if the point goes immediately before
+  // |hint| and |hint| is the beginning or the end of the timeline.
+  template<typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args);
+
+  // Returns an iterator to the point following the last erased point.
+  iterator erase(const_iterator first, const_iterator last);
+  iterator erase(const_iterator position);
+
+  const_iterator find(Instant const& t) const;
+  const_iterator lower_bound(Instant const& t) const;
+  const_iterator upper_bound(Instant const& t) const;
+
+  // Moves into this object the points of |other| whose times are not already
+  // present in this object.  Constant time per point if the times of |other|
+  // are all before or all after those of this object, linear in the total
+  // number of points otherwise.
+  void merge(FlatTimeline& other);
+  void merge(FlatTimeline&& other);
+
+ private:
+  struct Storage {
+    // The logical index of the first point.  Decremented by insertions at the
+    // beginning, incremented by erasures at the beginning.
+    std::int64_t first = 0;
+    std::deque<Value> points;
+  };
+
+  // Returns the offset in |points| of the first point whose time is not less
+  // than |t| (if |strict| is false) or greater than |t| (if |strict| is true).
+  std::int64_t Search(Instant const& t, bool strict) const;
+
+  const_iterator MakeIterator(std::int64_t offset) const;
+  std::int64_t Offset(const_iterator it) const;
+
+  // Never null.  Heap-allocated so that the iterators survive moves.
+  std::unique_ptr<Storage> storage_;
+};
+
+}  // namespace internal
+
+using internal::FlatTimeline;
+
+}  // namespace _flat_timeline
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/flat_timeline_body.hpp"
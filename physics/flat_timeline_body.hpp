@@ -0,0 +1,428 @@
+#pragma once
+
+#include "physics/flat_timeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace physics {
+namespace _flat_timeline {
+namespace internal {
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator*() const -> reference {
+  return storage_->points[index_ - storage_->first];
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator->() const -> pointer {
+  return &storage_->points[index_ - storage_->first];
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator[](
+    difference_type const n) const -> reference {
+  return storage_->points[index_ + n - storage_->first];
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator++() -> const_iterator& {
+  ++index_;
+  return *this;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator--() -> const_iterator& {
+  --index_;
+  return *this;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator++(int)  // NOLINT
+    -> const_iterator {
+  auto const initial = *this;
+  ++index_;
+  return initial;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator--(int)  // NOLINT
+    -> const_iterator {
+  auto const initial = *this;
+  --index_;
+  return initial;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator+=(difference_type const n)
+    -> const_iterator& {
+  index_ += n;
+  return *this;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator-=(difference_type const n)
+    -> const_iterator& {
+  index_ -= n;
+  return *this;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator+(
+    difference_type const n) const -> const_iterator {
+  return const_iterator(storage_, index_ + n);
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator-(
+    difference_type const n) const -> const_iterator {
+  return const_iterator(storage_, index_ - n);
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::const_iterator::operator-(
+    const_iterator const right) const -> difference_type {
+  DCHECK_EQ(storage_, right.storage_);
+  return index_ - right.index_;
+}
+
+template<typename Value>
+bool FlatTimeline<Value>::const_iterator::operator==(
+    const_iterator const other) const {
+  DCHECK_EQ(storage_, other.storage_);
+  return index_ == other.index_;
+}
+
+template<typename Value>
+std::strong_ordering FlatTimeline<Value>::const_iterator::operator<=>(
+    const_iterator const other) const {
+  DCHECK_EQ(storage_, other.storage_);
+  return index_ <=> other.index_;
+}
+
+template<typename Value>
+FlatTimeline<Value>::const_iterator::const_iterator(
+    Storage const* const storage,
+    std::int64_t const index)
+    : storage_(storage),
+      index_(index) {}
+
+template<typename Value>
+FlatTimeline<Value>::FlatTimeline()
+    : storage_(std::make_unique<Storage>()) {}
+
+template<typename Value>
+FlatTimeline<Value>::FlatTimeline(FlatTimeline const& other)
+    : storage_(std::make_unique<Storage>(*other.storage_)) {}
+
+template<typename Value>
+FlatTimeline<Value>::FlatTimeline(FlatTimeline&& other)
+    : storage_(std::exchange(other.storage_, std::make_unique<Storage>())) {}
+
+template<typename Value>
+FlatTimeline<Value>& FlatTimeline<Value>::operator=(
+    FlatTimeline const& other) {
+  if (this != &other) {
+    *storage_ = *other.storage_;
+  }
+  return *this;
+}
+
+template<typename Value>
+FlatTimeline<Value>& FlatTimeline<Value>::operator=(FlatTimeline&& other) {
+  if (this != &other) {
+    storage_ = std::exchange(other.storage_, std::make_unique<Storage>());
+  }
+  return *this;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::begin() const -> const_iterator {
+  return MakeIterator(0);
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::end() const -> const_iterator {
+  return MakeIterator(storage_->points.size());
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::cbegin() const -> const_iterator {
+  return begin();
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::cend() const -> const_iterator {
+  return end();
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::rbegin() const -> const_reverse_iterator {
+  return const_reverse_iterator(end());
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::rend() const -> const_reverse_iterator {
+  return const_reverse_iterator(begin());
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::crbegin() const -> const_reverse_iterator {
+  return rbegin();
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::crend() const -> const_reverse_iterator {
+  return rend();
+}
+
+template<typename Value>
+bool FlatTimeline<Value>::empty() const {
+  return storage_->points.empty();
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::size() const -> size_type {
+  return storage_->points.size();
+}
+
+template<typename Value>
+void FlatTimeline<Value>::clear() {
+  storage_->first = 0;
+  storage_->points.clear();
+}
+
+template<typename Value>
+template<typename... Args>
+auto FlatTimeline<Value>::emplace(Args&&... args)
+    -> std::pair<iterator, bool> {
+  auto& points = storage_->points;
+  Value value(std::forward<Args>(args)...);
+  std::int64_t const offset = Search(value.time, /*strict=*/false);
+  if (offset < points.size() && points[offset].time == value.time) {
+    return {MakeIterator(offset), false};
+  } else if (offset == points.size()) {
+    points.push_back(std::move(value));
+  } else if (offset == 0) {
+    points.push_front(std::move(value));
+    --storage_->first;
+  } else {
+    points.insert(points.begin() + offset, std::move(value));
+  }
+  return {MakeIterator(offset), true};
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::insert(value_type const& value)
+    -> std::pair<iterator, bool> {
+  return emplace(value);
+}
+
+template<typename Value>
+template<typename... Args>
+auto FlatTimeline<Value>::emplace_hint(const_iterator const hint,
+                                       Args&&... args) -> iterator {
+  auto& points = storage_->points;
+  Value value(std::forward<Args>(args)...);
+  if (hint == end() && (points.empty() || points.back().time < value.time)) {
+    points.push_back(std::move(value));
+    return MakeIterator(points.size() - 1);
+  } else if (hint == begin() && value.time < points.front().time) {
+    points.push_front(std::move(value));
+    --storage_->first;
+    return begin();
+  } else {
+    return emplace(std::move(value)).first;
+  }
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::erase(const_iterator const first,
+                                const_iterator const last) -> iterator {
+  auto& points = storage_->points;
+  std::int64_t const first_offset = Offset(first);
+  std::int64_t const last_offset = Offset(last);
+  DCHECK_LE(0, first_offset);
+  DCHECK_LE(first_offset, last_offset);
+  DCHECK_LE(last_offset, points.size());
+  points.erase(points.begin() + first_offset, points.begin() + last_offset);
+  if (first_offset == 0) {
+    // Erasing at the beginning must not change the logical indices of the
+    // remaining points.
+    storage_->first += last_offset - first_offset;
+    return MakeIterator(0);
+  } else {
+    return MakeIterator(first_offset);
+  }
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::erase(const_iterator const position) -> iterator {
+  return erase(position, std::next(position));
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::find(Instant const& t) const -> const_iterator {
+  std::int64_t const offset = Search(t, /*strict=*/false);
+  if (offset < storage_->points.size() &&
+      storage_->points[offset].time == t) {
+    return MakeIterator(offset);
+  } else {
+    return end();
+  }
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::lower_bound(Instant const& t) const
+    -> const_iterator {
+  return MakeIterator(Search(t, /*strict=*/false));
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::upper_bound(Instant const& t) const
+    -> const_iterator {
+  return MakeIterator(Search(t, /*strict=*/true));
+}
+
+template<typename Value>
+void FlatTimeline<Value>::merge(FlatTimeline& other) {
+  auto& points = storage_->points;
+  auto& other_points = other.storage_->points;
+  if (other_points.empty()) {
+    return;
+  }
+  if (points.empty() || points.back().time < other_points.front().time) {
+    std::move(other_points.begin(),
+              other_points.end(),
+              std::back_inserter(points));
+    other.clear();
+  } else if (other_points.back().time < points.front().time) {
+    std::move(other_points.rbegin(),
+              other_points.rend(),
+              std::front_inserter(points));
+    storage_->first -= other_points.size();
+    other.clear();
+  } else {
+    // Merge the two sequences in a single pass, as inserting the points one at
+    // a time would be linear in the distance to the closest end for each of
+    // them.  The points whose times are already present stay in |other|.
+    std::deque<Value> merged;
+    std::deque<Value> duplicates;
+    std::int64_t prepended = 0;
+    auto it = points.begin();
+    for (auto& value : other_points) {
+      while (it != points.end() && it->time < value.time) {
+        merged.push_back(std::move(*it));
+        ++it;
+      }
+      if (it != points.end() && it->time == value.time) {
+        duplicates.push_back(std::move(value));
+      } else {
+        if (it == points.begin()) {
+          ++prepended;
+        }
+        merged.push_back(std::move(value));
+      }
+    }
+    std::move(it, points.end(), std::back_inserter(merged));
+    points = std::move(merged);
+    // The logical indices of the points that were not preceded by an inserted
+    // point are unchanged, as for insertions at the beginning.
+    storage_->first -= prepended;
+    other.clear();
+    other_points = std::move(duplicates);
+  }
+}
+
+template<typename Value>
+void FlatTimeline<Value>::merge(FlatTimeline&& other) {
+  merge(other);
+}
+
+template<typename Value>
+std::int64_t FlatTimeline<Value>::Search(Instant const& t,
+                                         bool const strict) const {
+  auto const& points = storage_->points;
+  std::int64_t const size = points.size();
+  // True iff the point at |offset| is before the one we are looking for.
+  auto const before = [&points, &t, strict](std::int64_t const offset) {
+    return strict ? points[offset].time <= t : points[offset].time < t;
+  };
+  if (size == 0 || !before(0)) {
+    return 0;
+  } else if (before(size - 1)) {
+    return size;
+  }
+
+  // Now we know that the result is in ]0, size - 1].  Guess its position
+  // assuming that the points are uniformly spaced.
+  Instant const& t_front = points.front().time;
+  Instant const& t_back = points.back().time;
+  std::int64_t const guess = std::clamp<std::int64_t>(
+      std::llround((t - t_front) / (t_back - t_front) * (size - 1)),
+      1,
+      size - 1);
+
+  // Find a bracket [lower, upper] around the result by exponential search from
+  // |guess|.  We maintain the invariants |before(lower - 1)| and
+  // |!before(upper)|.
+  std::int64_t lower;
+  std::int64_t upper;
+  if (before(guess)) {
+    lower = guess + 1;
+    upper = size - 1;
+    for (std::int64_t step = 1; lower + step - 1 < upper; step *= 2) {
+      std::int64_t const probe = lower + step - 1;
+      if (before(probe)) {
+        lower = probe + 1;
+      } else {
+        upper = probe;
+        break;
+      }
+    }
+  } else {
+    lower = 1;
+    upper = guess;
+    for (std::int64_t step = 1; upper - step > lower - 1; step *= 2) {
+      std::int64_t const probe = upper - step;
+      if (before(probe)) {
+        lower = probe + 1;
+        break;
+      } else {
+        upper = probe;
+      }
+    }
+  }
+
+  // Binary search in the bracket.
+  while (lower < upper) {
+    std::int64_t const middle = lower + (upper - lower) / 2;
+    if (before(middle)) {
+      lower = middle + 1;
+    } else {
+      upper = middle;
+    }
+  }
+  return upper;
+}
+
+template<typename Value>
+auto FlatTimeline<Value>::MakeIterator(std::int64_t const offset) const
+    -> const_iterator {
+  return const_iterator(storage_.get(), storage_->first + offset);
+}
+
+template<typename Value>
+std::int64_t FlatTimeline<Value>::Offset(const_iterator const it) const {
+  DCHECK_EQ(storage_.get(), it.storage_);
+  return it.index_ - storage_->first;
+}
+
+}  // namespace internal
+}  // namespace _flat_timeline
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,256 @@
+#include "physics/flat_timeline.hpp"
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "absl/container/btree_set.h"
+#include "geometry/instant.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using ::testing::ElementsAre;
+using namespace principia::geometry::_instant;
+using namespace principia::physics::_flat_timeline;
+using namespace principia::quantities::_si;
+
+class FlatTimelineTest : public ::testing::Test {
+ protected:
+  struct Point {
+    Point(Instant const& time, int const payload)
+        : time(time), payload(payload) {}
+
+    Instant time;
+    int payload;
+  };
+
+  struct Earlier {
+    using is_transparent = void;
+    bool operator()(Point const& left, Point const& right) const {
+      return left.time < right.time;
+    }
+    bool operator()(Instant const& left, Point const& right) const {
+      return left < right.time;
+    }
+    bool operator()(Point const& left, Instant const& right) const {
+      return left.time < right;
+    }
+  };
+
+  static std::vector<int> Payloads(FlatTimeline<Point> const& timeline) {
+    std::vector<int> result;
+    for (auto const& point : timeline) {
+      result.push_back(point.payload);
+    }
+    return result;
+  }
+
+  Instant const t0_;
+};
+
+TEST_F(FlatTimelineTest, AppendPrependErase) {
+  FlatTimeline<Point> timeline;
+  EXPECT_TRUE(timeline.empty());
+  for (int i = 0; i < 5; ++i) {
+    timeline.emplace_hint(timeline.end(), t0_ + i * Second, i);
+  }
+  timeline.emplace_hint(timeline.begin(), t0_ - 1 * Second, -1);
+  EXPECT_EQ(6, timeline.size());
+  EXPECT_THAT(Payloads(timeline), ElementsAre(-1, 0, 1, 2, 3, 4));
+  EXPECT_EQ(4, timeline.crbegin()->payload);
+
+  // Inserting at an existing time does nothing.
+  auto const [it, inserted] = timeline.emplace(t0_ + 2 * Second, 42);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(2, it->payload);
+
+  timeline.emplace(t0_ + 2.5 * Second, 25);
+  EXPECT_THAT(Payloads(timeline), ElementsAre(-1, 0, 1, 2, 25, 3, 4));
+
+  auto const after = timeline.erase(timeline.find(t0_ + 1 * Second),
+                                    timeline.find(t0_ + 3 * Second));
+  EXPECT_EQ(3, after->payload);
+  EXPECT_THAT(Payloads(timeline), ElementsAre(-1, 0, 3, 4));
+
+  timeline.erase(timeline.begin(), std::next(timeline.begin(), 2));
+  EXPECT_THAT(Payloads(timeline), ElementsAre(3, 4));
+  timeline.clear();
+  EXPECT_TRUE(timeline.empty());
+}
+
+TEST_F(FlatTimelineTest, IteratorStability) {
+  FlatTimeline<Point> timeline;
+  for (int i = 0; i < 1000; ++i) {
+    timeline.emplace_hint(timeline.end(), t0_ + i * Second, i);
+  }
+  auto const it = timeline.find(t0_ + 500 * Second);
+  Point const* const pointer = &*it;
+
+  // Appending, prepending, and trimming the ends keep |it| valid.
+  for (int i = 1000; i < 5000; ++i) {
+    timeline.emplace_hint(timeline.end(), t0_ + i * Second, i);
+  }
+  for (int i = -1; i > -1000; --i) {
+    timeline.emplace_hint(timeline.begin(), t0_ + i * Second, i);
+  }
+  timeline.erase(timeline.begin(), timeline.lower_bound(t0_ + 100 * Second));
+  timeline.erase(timeline.upper_bound(t0_ + 900 * Second), timeline.end());
+  EXPECT_EQ(500, it->payload);
+  EXPECT_EQ(pointer, &*it);
+  EXPECT_EQ(400, std::distance(timeline.begin(), it));
+
+  // So does moving the timeline.
+  FlatTimeline<Point> moved = std::move(timeline);
+  EXPECT_TRUE(timeline.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(500, it->payload);
+  EXPECT_EQ(moved.end(), std::next(it, 401));
+}
+
+TEST_F(FlatTimelineTest, Merge) {
+  FlatTimeline<Point> timeline;
+  FlatTimeline<Point> later;
+  FlatTimeline<Point> earlier;
+  FlatTimeline<Point> overlapping;
+  timeline.emplace(t0_ + 3 * Second, 3);
+  timeline.emplace(t0_ + 4 * Second, 4);
+  later.emplace(t0_ + 5 * Second, 5);
+  later.emplace(t0_ + 6 * Second, 6);
+  earlier.emplace(t0_ + 1 * Second, 1);
+  overlapping.emplace(t0_ + 2 * Second, 20);
+  overlapping.emplace(t0_ + 4 * Second, 40);
+  overlapping.emplace(t0_ + 7 * Second, 70);
+
+  timeline.merge(later);
+  timeline.merge(earlier);
+  EXPECT_TRUE(later.empty());
+  EXPECT_TRUE(earlier.empty());
+  EXPECT_THAT(Payloads(timeline), ElementsAre(1, 3, 4, 5, 6));
+
+  timeline.merge(overlapping);
+  EXPECT_THAT(Payloads(timeline), ElementsAre(1, 20, 3, 4, 5, 6, 70));
+  EXPECT_THAT(Payloads(overlapping), ElementsAre(40));
+}
+
+// Checks that the lookups agree with those of a B-tree for irregularly spaced
+// points, which defeat the interpolation search.
+TEST_F(FlatTimelineTest, Lookups) {
+  std::mt19937_64 random(42);
+  std::exponential_distribution<> step_distribution(1.0);
+  absl::btree_set<Point, Earlier> btree;
+  FlatTimeline<Point> flat;
+  Instant t = t0_;
+  for (int i = 0; i < 1000; ++i) {
+    // Occasionally introduce a very large gap.
+    t += (i % 97 == 0 ? 1e6 : step_distribution(random)) * Second;
+    btree.emplace_hint(btree.end(), t, i);
+    flat.emplace_hint(flat.end(), t, i);
+  }
+  std::uniform_real_distribution<> time_distribution(
+      -10, (btree.rbegin()->time - t0_) / Second + 10);
+  for (int i = 0; i < 10'000; ++i) {
+    Instant const t = t0_ + time_distribution(random) * Second;
+    auto const btree_lower_bound = btree.lower_bound(t);
+    auto const flat_lower_bound = flat.lower_bound(t);
+    EXPECT_EQ(std::distance(btree.begin(), btree_lower_bound),
+              std::distance(flat.begin(), flat_lower_bound));
+    EXPECT_EQ(std::distance(btree.begin(), btree.upper_bound(t)),
+              std::distance(flat.begin(), flat.upper_bound(t)));
+  }
+  for (auto const& point : btree) {
+    auto const it = flat.find(point.time);
+    ASSERT_NE(flat.end(), it);
+    EXPECT_EQ(point.payload, it->payload);
+    EXPECT_EQ(std::distance(btree.begin(), btree.upper_bound(point.time)),
+              std::distance(flat.begin(), flat.upper_bound(point.time)));
+  }
+  EXPECT_EQ(flat.end(), flat.find(t0_ + 0.5 * Second));
+}
+
+// Checks that a random sequence of the operations used by the trajectories has
+// the same effect on a flat timeline and on a B-tree.
+TEST_F(FlatTimelineTest, RandomOperations) {
+  std::mt19937_64 random(1729);
+  std::uniform_int_distribution<> operation_distribution(0, 5);
+  std::uniform_int_distribution<> time_distribution(-500, 500);
+  absl::btree_set<Point, Earlier> btree;
+  FlatTimeline<Point> flat;
+  auto const expect_same = [&btree, &flat]() {
+    std::vector<int> btree_payloads;
+    for (auto const& point : btree) {
+      btree_payloads.push_back(point.payload);
+    }
+    EXPECT_EQ(btree_payloads, Payloads(flat));
+  };
+  for (int i = 0; i < 10'000; ++i) {
+    Instant const t = t0_ + time_distribution(random) * Second;
+    switch (operation_distribution(random)) {
+      case 0: {
+        // Insertion anywhere.
+        auto const [btree_it, btree_inserted] = btree.emplace(t, i);
+        auto const [flat_it, flat_inserted] = flat.emplace(t, i);
+        EXPECT_EQ(btree_inserted, flat_inserted);
+        EXPECT_EQ(btree_it->payload, flat_it->payload);
+        break;
+      }
+      case 1: {
+        // Insertion at the end, as when a trajectory is appended to.
+        Instant const time = btree.empty() ? t : btree.rbegin()->time + Second;
+        btree.emplace_hint(btree.end(), time, i);
+        flat.emplace_hint(flat.end(), time, i);
+        break;
+      }
+      case 2: {
+        // Insertion at the beginning.
+        Instant const time = btree.empty() ? t : btree.begin()->time - Second;
+        btree.emplace_hint(btree.begin(), time, i);
+        flat.emplace_hint(flat.begin(), time, i);
+        break;
+      }
+      case 3: {
+        // Erasure of a suffix, as in |ForgetAfter|.
+        btree.erase(btree.lower_bound(t), btree.end());
+        flat.erase(flat.lower_bound(t), flat.end());
+        break;
+      }
+      case 4: {
+        // Erasure of a prefix, as in |ForgetBefore|.
+        btree.erase(btree.begin(), btree.lower_bound(t));
+        flat.erase(flat.begin(), flat.lower_bound(t));
+        break;
+      }
+      case 5: {
+        // Erasure of a single point in the middle, as in downsampling.
+        auto const btree_it = btree.upper_bound(t);
+        auto const flat_it = flat.upper_bound(t);
+        if (btree_it != btree.end()) {
+          ASSERT_NE(flat.end(), flat_it);
+          btree.erase(btree_it);
+          flat.erase(flat_it);
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(btree.size(), flat.size());
+  }
+  expect_same();
+
+  // Copying and merging.
+  FlatTimeline<Point> copy = flat;
+  absl::btree_set<Point, Earlier> btree_copy = btree;
+  for (int i = 0; i < 100; ++i) {
+    Instant const t = t0_ + (time_distribution(random) + 0.5) * Second;
+    btree_copy.emplace(t, -i);
+    copy.emplace(t, -i);
+  }
+  btree.merge(btree_copy);
+  flat.merge(copy);
+  expect_same();
+  EXPECT_EQ(btree_copy.size(), copy.size());
+}
+
+}  // namespace physics
+}  // namespace principia
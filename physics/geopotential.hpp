@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <utility>
 #include <vector>
 
 #include "base/not_null.hpp"
@@ -15,6 +17,9 @@
 
 namespace principia {
 namespace physics {
+
+class GeopotentialTest;
+
 namespace _geopotential {
 namespace internal {
 
@@ -46,6 +51,17 @@ class Geopotential {
       Square<Length> const& r²,
       Exponentiation<Length, -3> const& one_over_r³) const;
 
+  // Same as |GeneralSphericalHarmonicsAcceleration| for all the displacements
+  // |r|, which are all taken at time |t|.  The results are stored in
+  // |accelerations|, which must have the same size as |r|.  The points are
+  // grouped in blocks which share the same limiting degree, and the recurrences
+  // are evaluated for an entire block at once.
+  void GeneralSphericalHarmonicsAccelerations(
+      Instant const& t,
+      std::vector<Displacement<Frame>> const& r,
+      std::vector<Vector<Quotient<Acceleration, GravitationalParameter>,
+                         Frame>>& accelerations) const;
+
   Quotient<SpecificEnergy, GravitationalParameter>
   GeneralSphericalHarmonicsPotential(
       Instant const& t,
@@ -76,9 +92,33 @@ class Geopotential {
 
   using UnitVector = Vector<double, Frame>;
 
+  // The signature of the functions that compute the acceleration for a
+  // particular kind of model.
+  using AccelerationKernel = Vector<ReducedAcceleration, Frame> (*)(
+      Geopotential<Frame> const& geopotential,
+      Instant const& t,
+      Displacement<Frame> const& r,
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Exponentiation<Length, -3> const& one_over_r³);
+
+  // Zonal models of degree at most this value use a |ZonalAcceleration|
+  // kernel.
+  static constexpr int max_zonal_kernel_degree = 10;
+
+  // Returns the |ZonalAcceleration| kernels for the given |degrees|, indexed by
+  // degree.  The entries for degrees 0 and 1 are null.
+  template<int... degrees>
+  static constexpr std::array<AccelerationKernel, sizeof...(degrees)>
+  ZonalAccelerationKernels(std::integer_sequence<int, degrees...>);
+
   // Holds precomputed data for one evaluation of the acceleration.
   struct Precomputations;
 
+  // Holds precomputed data for the evaluation of the acceleration for a block
+  // of points, in a structure-of-arrays layout.
+  struct BlockPrecomputations;
+
   // Helper templates for iterating over the degrees/orders of the geopotential.
   template<int degree, int order>
   class DegreeNOrderM;
@@ -94,6 +134,49 @@ class Geopotential {
   // |degree_damping_[1].outer_threshold()| are infinite, |limiting_degree > 1|.
   int LimitingDegree(Length const& r_norm) const;
 
+  // The kernel for arbitrary models.
+  static Vector<ReducedAcceleration, Frame> GeneralAcceleration(
+      Geopotential<Frame> const& geopotential,
+      Instant const& t,
+      Displacement<Frame> const& r,
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Exponentiation<Length, -3> const& one_over_r³);
+
+  // The kernel for zonal models of the given |degree|.  It performs the same
+  // operations as |GeneralAcceleration| for such a model, and therefore
+  // returns bitwise identical results, but it doesn't use the recurrences for
+  // the orders, doesn't look up the rotation of the body, and dispatches on
+  // the degree at construction rather than at each evaluation.
+  template<int degree>
+  static Vector<ReducedAcceleration, Frame> ZonalAcceleration(
+      Geopotential<Frame> const& geopotential,
+      Instant const& t,
+      Displacement<Frame> const& r,
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Exponentiation<Length, -3> const& one_over_r³);
+
+  // Computes the accelerations for the points of |block|, which must all have
+  // the same |max_degree| and the same zonality.  |x̂|, |ŷ|, |ẑ| is the basis
+  // used for these points.
+  void BlockAccelerations(
+      int max_degree,
+      bool is_zonal,
+      UnitVector const& x̂,
+      UnitVector const& ŷ,
+      UnitVector const& ẑ,
+      std::vector<Displacement<Frame>> const& r,
+      BlockPrecomputations& block,
+      std::vector<Vector<ReducedAcceleration, Frame>>& accelerations) const;
+
+  // Stores the coordinates of |vector| at index |i| of |per_point_vector|.
+  template<typename Scalar>
+  static void Store(
+      Vector<Scalar, Frame> const& vector,
+      int i,
+      typename BlockPrecomputations::PerPointVector& per_point_vector);
+
   not_null<OblateBody<Frame> const*> body_;
 
   // The contribution from the harmonics of degree n is damped by
@@ -109,6 +192,12 @@ class Geopotential {
   //   degree_damping[2] ≼ sectoral_damping_ ≼ degree_damping[3]
   // holds, where ≼ denotes the ordering of the thresholds.
   HarmonicDamping sectoral_damping_;
+
+  // Chosen at construction based on the model, so that the evaluation doesn't
+  // need to test its characteristics.
+  AccelerationKernel acceleration_kernel_;
+
+  friend class physics::GeopotentialTest;
 };
 
 }  // namespace internal
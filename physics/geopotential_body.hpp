@@ -3,6 +3,7 @@
 #include "physics/geopotential.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <queue>
 #include <vector>
@@ -13,6 +14,7 @@
 #include "numerics/legendre_normalization_factor.mathematica.h"
 #include "numerics/max_abs_normalized_associated_legendre_function.mathematica.h"
 #include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace physics {
@@ -25,6 +27,7 @@ using namespace principia::numerics::_fixed_arrays;
 using namespace principia::numerics::_legendre_normalization_factor;
 using namespace principia::numerics::_max_abs_normalized_associated_legendre_function;  // NOLINT
 using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_si;
 
 // The notation in this file follows documentation/Geopotential.pdf.
 
@@ -64,6 +67,63 @@ struct Geopotential<Frame>::Precomputations {
   FixedLowerTriangularMatrix<double, size> DmPn_of_sin_β{uninitialized};
 };
 
+template<typename Frame>
+struct Geopotential<Frame>::BlockPrecomputations {
+  static constexpr int size = Precomputations::size;
+  // The number of points processed together.  The loops over the points of a
+  // block are the innermost ones, so that the recurrences are evaluated for
+  // all the points at once.
+  static constexpr int block_size = 8;
+
+  template<typename T>
+  using PerPoint = std::array<T, block_size>;
+
+  // The coordinates of vectors, in SI units, for all the points.  The
+  // arithmetic on the coordinates is the same as that of |Vector|.
+  struct PerPointVector {
+    PerPoint<double> x;
+    PerPoint<double> y;
+    PerPoint<double> z;
+  };
+
+  // The number of points in the block and their indices in the input.
+  int count = 0;
+  PerPoint<std::size_t> indices;
+
+  // The fields below have the same meaning as in |Precomputations|, but for
+  // all the points of the block.
+  PerPoint<Length> r_norm;
+  PerPoint<Square<Length>> r²;
+  PerPoint<Vector<double, Frame>> r_normalized;
+
+  PerPoint<double> sin_β;
+  PerPoint<double> cos_β;
+
+  PerPointVector grad_𝔅_vector;
+  PerPointVector grad_𝔏_vector;
+
+  std::array<PerPoint<Exponentiation<Length, -2>>, size> ℜ_over_r;
+
+  std::array<PerPoint<double>, size> cos_mλ;
+  std::array<PerPoint<double>, size> sin_mλ;
+  std::array<PerPoint<double>, size> cos_β_to_the_m;
+
+  // Only the rows n, n - 1 and n - 2 of the triangle are needed by the
+  // recurrences, so row n is stored at index n % 3.
+  std::array<std::array<PerPoint<double>, size>, 3> DmPn_of_sin_β;
+
+  // The damped radial quantities for the current degree.
+  PerPoint<double> σℜ_over_r;
+  PerPointVector grad_σℜ;
+
+  // The contributions of the orders of the current degree, and of all the
+  // degrees.  They are stored so that they may be summed in the same order as
+  // in |DegreeNAllOrders| and |AllDegrees|, i.e., from the highest order or
+  // degree down.
+  std::array<PerPointVector, size> order_accelerations;
+  std::array<PerPointVector, size> degree_accelerations;
+};
+
 template<typename Frame>
 template<int degree, int order>
 class Geopotential<Frame>::DegreeNOrderM {
@@ -666,6 +726,16 @@ InitializePrecomputations(Geopotential<Frame> const& geopotential,
   DmPn_of_sin_β(1, 1) = 1;
 }
 
+template<typename Frame>
+template<int... degrees>
+constexpr auto Geopotential<Frame>::ZonalAccelerationKernels(
+    std::integer_sequence<int, degrees...>)
+    -> std::array<AccelerationKernel, sizeof...(degrees)> {
+  // The kernels for degrees 0 and 1 are not instantiated.
+  return {(degrees < 2 ? nullptr
+                       : &ZonalAcceleration<std::max(degrees, 2)>)...};
+}
+
 template<typename Frame>
 Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
                                   double const tolerance)
@@ -730,28 +800,52 @@ Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
     }
     harmonic_thresholds.pop();
   }
+
+  acceleration_kernel_ = &GeneralAcceleration;
+  if (body_->is_zonal() &&
+      body_->geopotential_degree() <= max_zonal_kernel_degree) {
+    static constexpr auto zonal_acceleration_kernels = ZonalAccelerationKernels(
+        std::make_integer_sequence<int, max_zonal_kernel_degree + 1>());
+    if (AccelerationKernel const kernel =
+            zonal_acceleration_kernels[body_->geopotential_degree()];
+        kernel != nullptr) {
+      acceleration_kernel_ = kernel;
+    }
+  }
+}
+
+template<typename Frame>
+Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
+Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
+    Instant const& t,
+    Displacement<Frame> const& r,
+    Length const& r_norm,
+    Square<Length> const& r²,
+    Exponentiation<Length, -3> const& one_over_r³) const {
+  return acceleration_kernel_(*this, t, r, r_norm, r², one_over_r³);
 }
 
 #define PRINCIPIA_CASE_SPHERICAL_HARMONICS_ACCELERATION(d)                     \
   case (d):                                                                    \
     return AllDegrees<std::make_integer_sequence<int, (d) + 1>>::Acceleration( \
-        *this, t, r, r_norm, r², one_over_r³)
+        geopotential, t, r, r_norm, r², one_over_r³)
 
 template<typename Frame>
-Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
-Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
+auto Geopotential<Frame>::GeneralAcceleration(
+    Geopotential<Frame> const& geopotential,
     Instant const& t,
     Displacement<Frame> const& r,
     Length const& r_norm,
     Square<Length> const& r²,
-    Exponentiation<Length, -3> const& one_over_r³) const {
+    Exponentiation<Length, -3> const& one_over_r³)
+    -> Vector<ReducedAcceleration, Frame> {
   if (r_norm != r_norm) {
     // Short-circuit NaN, to avoid having to deal with an unordered
     // |r_norm| when finding the partition point below.
     return NaN<ReducedAcceleration> * Vector<double, Frame>{};
   }
   // We have |max_degree > 0|.
-  int const max_degree = LimitingDegree(r_norm) - 1;
+  int const max_degree = geopotential.LimitingDegree(r_norm) - 1;
   switch (max_degree) {
     PRINCIPIA_CASE_SPHERICAL_HARMONICS_ACCELERATION(2);
     PRINCIPIA_CASE_SPHERICAL_HARMONICS_ACCELERATION(3);
@@ -807,13 +901,140 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
     case 1:
       return Vector<ReducedAcceleration, Frame>{};
     default:
-      LOG(FATAL) << "Unexpected degree " << max_degree << " " << body_->name();
+      LOG(FATAL) << "Unexpected degree " << max_degree << " "
+                 << geopotential.body_->name();
       std::abort();
   }
 }
 
 #undef PRINCIPIA_CASE_SPHERICAL_HARMONICS_ACCELERATION
 
+template<typename Frame>
+template<int degree>
+auto Geopotential<Frame>::ZonalAcceleration(
+    Geopotential<Frame> const& geopotential,
+    Instant const& t,
+    Displacement<Frame> const& r,
+    Length const& r_norm,
+    Square<Length> const& r²,
+    Exponentiation<Length, -3> const& one_over_r³)
+    -> Vector<ReducedAcceleration, Frame> {
+  if (r_norm != r_norm) {
+    // Short-circuit NaN, as in |GeneralAcceleration|.
+    return NaN<ReducedAcceleration> * Vector<double, Frame>{};
+  }
+  int const max_degree = geopotential.LimitingDegree(r_norm) - 1;
+  DCHECK_LE(max_degree, degree);
+  if (max_degree < 2) {
+    return Vector<ReducedAcceleration, Frame>{};
+  }
+
+  // The computations below are those of |InitializePrecomputations|,
+  // |DegreeNAllOrders| and |DegreeNOrderM| for order 0 in the zonal case, in
+  // the same order and with the same expressions, so that the results are
+  // bitwise identical.
+  OblateBody<Frame> const& body = *geopotential.body_;
+  auto const& cos = body.cos();
+
+  UnitVector const x̂ = body.equatorial();
+  UnitVector const ŷ = body.biequatorial();
+  UnitVector const ẑ = body.polar_axis();
+
+  Length const x = InnerProduct(r, x̂);
+  Length const y = InnerProduct(r, ŷ);
+  Length const z = InnerProduct(r, ẑ);
+
+  Square<Length> const x²_plus_y² = x * x + y * y;
+  Length const r_equatorial = Sqrt(x²_plus_y²);
+
+  double cos_λ = 1;
+  double sin_λ = 0;
+  if (r_equatorial > Length{}) {
+    Inverse<Length> const one_over_r_equatorial = 1 / r_equatorial;
+    cos_λ = x * one_over_r_equatorial;
+    sin_λ = y * one_over_r_equatorial;
+  }
+
+  Inverse<Length> const one_over_r_norm = 1 / r_norm;
+  UnitVector const r_normalized = r * one_over_r_norm;
+
+  double const cos_β = r_equatorial * one_over_r_norm;
+  double const sin_β = z * one_over_r_norm;
+
+  UnitVector const grad_𝔅_vector =
+      (-sin_β * cos_λ) * x̂ - (sin_β * sin_λ) * ŷ + cos_β * ẑ;
+
+  // The arrays are indexed by degree.  |D0Pn_of_sin_β| and |D1Pn_of_sin_β| are
+  // the columns 0 and 1 of |DmPn_of_sin_β|.
+  std::array<Inverse<Square<Length>>, degree + 1> ℜ_over_r;
+  std::array<double, degree + 1> D0Pn_of_sin_β;
+  std::array<double, degree + 1> D1Pn_of_sin_β;
+  std::array<Vector<ReducedAcceleration, Frame>, degree + 1> accelerations;
+
+  ℜ_over_r[1] = body.reference_radius() * one_over_r³;
+  D0Pn_of_sin_β[0] = 1;
+  D0Pn_of_sin_β[1] = sin_β;
+  D1Pn_of_sin_β[1] = 1;
+
+  for (int n = 2; n <= max_degree; ++n) {
+    constexpr int m = 0;
+    double const cos_β_to_the_m = 1;
+
+    int const h1 = n / 2;
+    int const h2 = n - h1;
+    ℜ_over_r[n] = ℜ_over_r[h1] * ℜ_over_r[h2] * r²;
+    auto const ℜʹ = -(n + 1) * ℜ_over_r[n];
+
+    Inverse<Square<Length>> σℜ_over_r;
+    Vector<Inverse<Square<Length>>, Frame> grad_σℜ;
+    geopotential.degree_damping_[n].ComputeDampedRadialQuantities(
+        r_norm,
+        r²,
+        r_normalized,
+        ℜ_over_r[n],
+        ℜʹ,
+        σℜ_over_r,
+        grad_σℜ);
+    DCHECK_LT(r_norm, geopotential.degree_damping_[n].outer_threshold());
+
+    D0Pn_of_sin_β[n] = ((2 * n - 1) * sin_β * D0Pn_of_sin_β[n - 1] -
+                        (n - 1) * D0Pn_of_sin_β[n - 2]) /
+                       n;
+    if (n == 2) {
+      D1Pn_of_sin_β[n] = ((2 * n - 1) * (sin_β * D1Pn_of_sin_β[n - 1] +
+                                         (m + 1) * D0Pn_of_sin_β[n - 1])) /
+                         n;
+    } else {
+      D1Pn_of_sin_β[n] = ((2 * n - 1) * (sin_β * D1Pn_of_sin_β[n - 1] +
+                                         (m + 1) * D0Pn_of_sin_β[n - 1]) -
+                          (n - 1) * D1Pn_of_sin_β[n - 2]) /
+                         n;
+    }
+
+    double const normalization_factor = LegendreNormalizationFactor(n, m);
+    double const 𝔅 = cos_β_to_the_m * D0Pn_of_sin_β[n];
+    double const grad_𝔅_polynomials =
+        cos_β * cos_β_to_the_m * D1Pn_of_sin_β[n];
+    double const 𝔏 = cos(n, m);
+
+    Vector<ReducedAcceleration, Frame> const 𝔅𝔏_grad_ℜ = (𝔅 * 𝔏) * grad_σℜ;
+    Vector<ReducedAcceleration, Frame> const ℜ𝔏_grad_𝔅 =
+        (σℜ_over_r * 𝔏 * grad_𝔅_polynomials) * grad_𝔅_vector;
+    Vector<ReducedAcceleration, Frame> const grad_ℜ𝔅𝔏 =
+        𝔅𝔏_grad_ℜ + ℜ𝔏_grad_𝔅;
+    accelerations[n] = normalization_factor * grad_ℜ𝔅𝔏;
+  }
+
+  // Sum from the highest degree down, as is done by |AllDegrees|, including the
+  // zero contributions of degrees 1 and 0, which may affect the sign of zeros.
+  Vector<ReducedAcceleration, Frame> acceleration = accelerations[max_degree];
+  for (int n = max_degree - 1; n >= 2; --n) {
+    acceleration = accelerations[n] + acceleration;
+  }
+  Vector<ReducedAcceleration, Frame> const zero;
+  return zero + (zero + acceleration);
+}
+
 #define PRINCIPIA_CASE_SPHERICAL_HARMONICS_POTENTIAL(d)                     \
   case (d):                                                                 \
     return AllDegrees<std::make_integer_sequence<int, (d) + 1>>::Potential( \
@@ -896,6 +1117,110 @@ Geopotential<Frame>::GeneralSphericalHarmonicsPotential(
 
 #undef PRINCIPIA_CASE_SPHERICAL_HARMONICS_POTENTIAL
 
+template<typename Frame>
+void Geopotential<Frame>::GeneralSphericalHarmonicsAccelerations(
+    Instant const& t,
+    std::vector<Displacement<Frame>> const& r,
+    std::vector<Vector<Quotient<Acceleration, GravitationalParameter>,
+                       Frame>>& accelerations) const {
+  CHECK_EQ(r.size(), accelerations.size());
+  if (acceleration_kernel_ != &GeneralAcceleration) {
+    // The specialized kernels are cheap enough that there is nothing to gain
+    // from blocking.
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      Square<Length> const r² = r[i].Norm²();
+      Length const r_norm = Sqrt(r²);
+      Exponentiation<Length, -3> const one_over_r³ = r_norm / (r² * r²);
+      accelerations[i] =
+          acceleration_kernel_(*this, t, r[i], r_norm, r², one_over_r³);
+    }
+    return;
+  }
+
+  using Block = BlockPrecomputations;
+  OblateBody<Frame> const& body = *body_;
+
+  // The bases are independent from the points, see
+  // |InitializePrecomputations|.
+  UnitVector const ẑ = body.polar_axis();
+  UnitVector const zonal_x̂ = body.equatorial();
+  UnitVector const zonal_ŷ = body.biequatorial();
+  UnitVector tesseral_x̂ = zonal_x̂;
+  UnitVector tesseral_ŷ = zonal_ŷ;
+  if (!body.is_zonal()) {
+    auto const from_surface_frame =
+      body.template FromSurfaceFrame<SurfaceFrame>(t);
+    tesseral_x̂ = from_surface_frame(x_);
+    tesseral_ŷ = from_surface_frame(y_);
+  }
+
+  // The blocks being filled, indexed by maximum degree and zonality.  A block
+  // is evaluated as soon as it is full.
+  struct PendingBlock {
+    int count = 0;
+    typename Block::template PerPoint<std::size_t> indices;
+  };
+  std::array<std::array<PendingBlock, 2>, Block::size> pending_blocks;
+  Block block;
+
+  auto const evaluate = [this,
+                         &accelerations,
+                         &block,
+                         &r,
+                         &tesseral_x̂,
+                         &tesseral_ŷ,
+                         &zonal_x̂,
+                         &zonal_ŷ,
+                         &ẑ](int const max_degree,
+                             bool const is_zonal,
+                             PendingBlock& pending_block) {
+    block.count = pending_block.count;
+    block.indices = pending_block.indices;
+    BlockAccelerations(max_degree,
+                       is_zonal,
+                       is_zonal ? zonal_x̂ : tesseral_x̂,
+                       is_zonal ? zonal_ŷ : tesseral_ŷ,
+                       ẑ,
+                       r,
+                       block,
+                       accelerations);
+    pending_block.count = 0;
+  };
+
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    Length const r_norm = Sqrt(r[i].Norm²());
+    if (r_norm != r_norm) {
+      // Short-circuit NaN, as in |GeneralSphericalHarmonicsAcceleration|.
+      accelerations[i] = NaN<ReducedAcceleration> * Vector<double, Frame>{};
+      continue;
+    }
+    // We have |max_degree > 0|.
+    int const max_degree = LimitingDegree(r_norm) - 1;
+    if (max_degree == 1) {
+      accelerations[i] = Vector<ReducedAcceleration, Frame>{};
+      continue;
+    }
+    bool const is_zonal =
+        body.is_zonal() || r_norm > sectoral_damping_.outer_threshold();
+    PendingBlock& pending_block = pending_blocks[max_degree][is_zonal];
+    pending_block.indices[pending_block.count] = i;
+    ++pending_block.count;
+    if (pending_block.count == Block::block_size) {
+      evaluate(max_degree, is_zonal, pending_block);
+    }
+  }
+
+  // Evaluate the partially-filled blocks.
+  for (int max_degree = 2; max_degree < Block::size; ++max_degree) {
+    for (bool const is_zonal : {false, true}) {
+      PendingBlock& pending_block = pending_blocks[max_degree][is_zonal];
+      if (pending_block.count > 0) {
+        evaluate(max_degree, is_zonal, pending_block);
+      }
+    }
+  }
+}
+
 template<typename Frame>
 std::vector<HarmonicDamping> const& Geopotential<Frame>::degree_damping()
     const {
@@ -921,6 +1246,306 @@ int Geopotential<Frame>::LimitingDegree(Length const& r_norm) const {
          degree_damping_.begin();
 }
 
+template<typename Frame>
+void Geopotential<Frame>::BlockAccelerations(
+    int const max_degree,
+    bool const is_zonal,
+    UnitVector const& x̂,
+    UnitVector const& ŷ,
+    UnitVector const& ẑ,
+    std::vector<Displacement<Frame>> const& r,
+    BlockPrecomputations& block,
+    std::vector<Vector<ReducedAcceleration, Frame>>& accelerations) const {
+  using PerPointVector = typename BlockPrecomputations::PerPointVector;
+  OblateBody<Frame> const& body = *body_;
+  auto const& cos = body.cos();
+  auto const& sin = body.sin();
+  int const count = block.count;
+
+  // The operations below are those of |InitializePrecomputations|,
+  // |DegreeNAllOrders| and |DegreeNOrderM|, performed in the same order so
+  // that each point gets the same result as with
+  // |GeneralSphericalHarmonicsAcceleration|.
+  for (int i = 0; i < count; ++i) {
+    Displacement<Frame> const& rᵢ = r[block.indices[i]];
+    Square<Length> const r² = rᵢ.Norm²();
+    Length const r_norm = Sqrt(r²);
+    Exponentiation<Length, -3> const one_over_r³ = r_norm / (r² * r²);
+
+    Length const x = InnerProduct(rᵢ, x̂);
+    Length const y = InnerProduct(rᵢ, ŷ);
+    Length const z = InnerProduct(rᵢ, ẑ);
+
+    Square<Length> const x²_plus_y² = x * x + y * y;
+    Length const r_equatorial = Sqrt(x²_plus_y²);
+
+    double cos_λ = 1;
+    double sin_λ = 0;
+    if (r_equatorial > Length{}) {
+      Inverse<Length> const one_over_r_equatorial = 1 / r_equatorial;
+      cos_λ = x * one_over_r_equatorial;
+      sin_λ = y * one_over_r_equatorial;
+    }
+
+    Inverse<Length> const one_over_r_norm = 1 / r_norm;
+    double const cos_β = r_equatorial * one_over_r_norm;
+    double const sin_β = z * one_over_r_norm;
+
+    block.r_norm[i] = r_norm;
+    block.r²[i] = r²;
+    block.r_normalized[i] = rᵢ * one_over_r_norm;
+    block.cos_β[i] = cos_β;
+    block.sin_β[i] = sin_β;
+    Store((-sin_β * cos_λ) * x̂ - (sin_β * sin_λ) * ŷ + cos_β * ẑ,
+          i,
+          block.grad_𝔅_vector);
+    Store(cos_λ * ŷ - sin_λ * x̂, i, block.grad_𝔏_vector);
+    block.ℜ_over_r[1][i] = body.reference_radius() * one_over_r³;
+    block.cos_mλ[1][i] = cos_λ;
+    block.sin_mλ[1][i] = sin_λ;
+    block.cos_β_to_the_m[0][i] = 1;
+    block.cos_β_to_the_m[1][i] = cos_β;
+    block.DmPn_of_sin_β[0][0][i] = 1;
+    block.DmPn_of_sin_β[1][0][i] = sin_β;
+    block.DmPn_of_sin_β[1][1][i] = 1;
+  }
+
+  // Sets the damped radial quantities of degree |n| according to |damping|.
+  auto const damp = [&block, count](int const n,
+                                    HarmonicDamping const& damping) {
+    auto const& ℜ_over_r = block.ℜ_over_r[n];
+    for (int i = 0; i < count; ++i) {
+      // Note that ∇ℜ = ℜʹ * r_normalized.
+      auto const ℜʹ = -(n + 1) * ℜ_over_r[i];
+      Inverse<Square<Length>> σℜ_over_r;
+      Vector<Inverse<Square<Length>>, Frame> grad_σℜ;
+      damping.ComputeDampedRadialQuantities(block.r_norm[i],
+                                            block.r²[i],
+                                            block.r_normalized[i],
+                                            ℜ_over_r[i],
+                                            ℜʹ,
+                                            σℜ_over_r,
+                                            grad_σℜ);
+      // If we are above the outer threshold, we should not have been called
+      // (σ = 0).
+      DCHECK_LT(block.r_norm[i], damping.outer_threshold());
+      block.σℜ_over_r[i] = σℜ_over_r / si::Unit<Inverse<Square<Length>>>;
+      Store(grad_σℜ, i, block.grad_σℜ);
+    }
+  };
+
+  for (int n = 2; n <= max_degree; ++n) {
+    // Degree-dependent precomputations.
+    {
+      auto& ℜ_over_r = block.ℜ_over_r[n];
+      auto const& ℜh1_over_r = block.ℜ_over_r[n / 2];
+      auto const& ℜh2_over_r = block.ℜ_over_r[n - n / 2];
+      for (int i = 0; i < count; ++i) {
+        ℜ_over_r[i] = ℜh1_over_r[i] * ℜh2_over_r[i] * block.r²[i];
+      }
+    }
+    damp(n, degree_damping_[n]);
+
+    auto& DmPn_of_sin_β = block.DmPn_of_sin_β[n % 3];
+    auto const& DmPn_minus_1_of_sin_β = block.DmPn_of_sin_β[(n - 1) % 3];
+    auto const& DmPn_minus_2_of_sin_β = block.DmPn_of_sin_β[(n - 2) % 3];
+    auto const& sin_β = block.sin_β;
+
+    // In the zonal case, no point in going beyond order 0.
+    int const max_order = is_zonal ? 0 : n;
+    for (int m = 0; m <= max_order; ++m) {
+      if (n == 2 && m == 1) {
+        // The degree 2 sectoral harmonics have their own damping.
+        damp(2, sectoral_damping_);
+        // Let's not forget the Legendre derivative that we would compute if we
+        // did not short-circuit.  The contribution of this order is known to
+        // be 0.
+        for (int i = 0; i < count; ++i) {
+          DmPn_of_sin_β[2][i] = 3;
+        }
+        continue;
+      }
+
+      // Order-dependent precomputations.
+      auto& cos_mλ = block.cos_mλ[m];
+      auto& sin_mλ = block.sin_mλ[m];
+      auto& cos_β_to_the_m = block.cos_β_to_the_m[m];
+      if (m == n) {
+        // Compute the values for m * λ based on the values around m/2 * λ to
+        // reduce error accumulation.
+        int const h1 = m / 2;
+        int const h2 = m - h1;
+        auto const& cos_h1λ = block.cos_mλ[h1];
+        auto const& sin_h1λ = block.sin_mλ[h1];
+        auto const& cos_β_to_the_h1 = block.cos_β_to_the_m[h1];
+        auto const& cos_h2λ = block.cos_mλ[h2];
+        auto const& sin_h2λ = block.sin_mλ[h2];
+        auto const& cos_β_to_the_h2 = block.cos_β_to_the_m[h2];
+        if (m % 2 == 0) {
+          for (int i = 0; i < count; ++i) {
+            sin_mλ[i] = 2 * sin_h1λ[i] * cos_h1λ[i];
+            cos_mλ[i] = (cos_h1λ[i] + sin_h1λ[i]) * (cos_h1λ[i] - sin_h1λ[i]);
+            cos_β_to_the_m[i] = cos_β_to_the_h1[i] * cos_β_to_the_h1[i];
+          }
+        } else {
+          for (int i = 0; i < count; ++i) {
+            sin_mλ[i] = sin_h1λ[i] * cos_h2λ[i] + cos_h1λ[i] * sin_h2λ[i];
+            cos_mλ[i] = cos_h1λ[i] * cos_h2λ[i] - sin_h1λ[i] * sin_h2λ[i];
+            cos_β_to_the_m[i] = cos_β_to_the_h1[i] * cos_β_to_the_h2[i];
+          }
+        }
+      }
+
+      // Recurrence relationship between the Legendre polynomials.
+      if (m == 0) {
+        for (int i = 0; i < count; ++i) {
+          DmPn_of_sin_β[0][i] =
+              ((2 * n - 1) * sin_β[i] * DmPn_minus_1_of_sin_β[0][i] -
+               (n - 1) * DmPn_minus_2_of_sin_β[0][i]) /
+              n;
+        }
+      }
+
+      // Recurrence relationship between the associated Legendre polynomials.
+      // Account for the fact that DmPn_of_sin_β is identically zero if m > n.
+      if (m == n) {
+        // Do not store the zero.
+      } else if (m == n - 1) {
+        for (int i = 0; i < count; ++i) {
+          DmPn_of_sin_β[m + 1][i] =
+              ((2 * n - 1) * (m + 1) * DmPn_minus_1_of_sin_β[m][i]) / n;
+        }
+      } else if (m == n - 2) {
+        for (int i = 0; i < count; ++i) {
+          DmPn_of_sin_β[m + 1][i] =
+              ((2 * n - 1) * (sin_β[i] * DmPn_minus_1_of_sin_β[m + 1][i] +
+                              (m + 1) * DmPn_minus_1_of_sin_β[m][i])) /
+              n;
+        }
+      } else {
+        for (int i = 0; i < count; ++i) {
+          DmPn_of_sin_β[m + 1][i] =
+              ((2 * n - 1) * (sin_β[i] * DmPn_minus_1_of_sin_β[m + 1][i] +
+                              (m + 1) * DmPn_minus_1_of_sin_β[m][i]) -
+               (n - 1) * DmPn_minus_2_of_sin_β[m + 1][i]) /
+              n;
+        }
+      }
+
+      // Contribution of degree n and order m.  The expressions are those of
+      // |DegreeNOrderM::Acceleration|, on the coordinates of the vectors.
+      double const normalization_factor = LegendreNormalizationFactor(n, m);
+      double const Cnm = cos(n, m);
+      double const Snm = sin(n, m);
+      auto const& cos_β = block.cos_β;
+      auto const& σℜ_over_r = block.σℜ_over_r;
+      auto const& grad_σℜ = block.grad_σℜ;
+      auto const& grad_𝔅_vector = block.grad_𝔅_vector;
+      auto const& grad_𝔏_vector = block.grad_𝔏_vector;
+      PerPointVector& order_acceleration = block.order_accelerations[m];
+      if (m == 0) {
+        for (int i = 0; i < count; ++i) {
+          double const 𝔅 = cos_β_to_the_m[i] * DmPn_of_sin_β[0][i];
+          double const grad_𝔅_polynomials =
+              cos_β[i] * cos_β_to_the_m[i] * DmPn_of_sin_β[1][i];
+          double const 𝔏 = Cnm;
+          double const 𝔅𝔏 = 𝔅 * 𝔏;
+          double const ℜ𝔏 = σℜ_over_r[i] * 𝔏 * grad_𝔅_polynomials;
+          order_acceleration.x[i] =
+              normalization_factor *
+              (𝔅𝔏 * grad_σℜ.x[i] + ℜ𝔏 * grad_𝔅_vector.x[i]);
+          order_acceleration.y[i] =
+              normalization_factor *
+              (𝔅𝔏 * grad_σℜ.y[i] + ℜ𝔏 * grad_𝔅_vector.y[i]);
+          order_acceleration.z[i] =
+              normalization_factor *
+              (𝔅𝔏 * grad_σℜ.z[i] + ℜ𝔏 * grad_𝔅_vector.z[i]);
+        }
+      } else {
+        auto const& cos_β_to_the_m_minus_1 = block.cos_β_to_the_m[m - 1];
+        for (int i = 0; i < count; ++i) {
+          double const 𝔅 = cos_β_to_the_m[i] * DmPn_of_sin_β[m][i];
+          double grad_𝔅_polynomials = 0;
+          if (m < n) {
+            grad_𝔅_polynomials =
+                cos_β[i] * cos_β_to_the_m[i] * DmPn_of_sin_β[m + 1][i];
+          }
+          // Remove a singularity when m == 0 and cos_β == 0.
+          grad_𝔅_polynomials -= m * sin_β[i] * cos_β_to_the_m_minus_1[i] *
+                                DmPn_of_sin_β[m][i];
+          double const 𝔏 = Cnm * cos_mλ[i] + Snm * sin_mλ[i];
+          double const 𝔅𝔏 = 𝔅 * 𝔏;
+          double const ℜ𝔏 = σℜ_over_r[i] * 𝔏 * grad_𝔅_polynomials;
+          // Compensate a cos_β to remove a singularity when cos_β == 0.
+          double const ℜ𝔅 =
+              σℜ_over_r[i] *
+              cos_β_to_the_m_minus_1[i] * DmPn_of_sin_β[m][i] *  // 𝔅/cos_β
+              m * (Snm * cos_mλ[i] - Cnm * sin_mλ[i]);
+          order_acceleration.x[i] =
+              normalization_factor *
+              ((𝔅𝔏 * grad_σℜ.x[i] + ℜ𝔏 * grad_𝔅_vector.x[i]) +
+               ℜ𝔅 * grad_𝔏_vector.x[i]);  // grad_𝔏*cos_β
+          order_acceleration.y[i] =
+              normalization_factor *
+              ((𝔅𝔏 * grad_σℜ.y[i] + ℜ𝔏 * grad_𝔅_vector.y[i]) +
+               ℜ𝔅 * grad_𝔏_vector.y[i]);
+          order_acceleration.z[i] =
+              normalization_factor *
+              ((𝔅𝔏 * grad_σℜ.z[i] + ℜ𝔏 * grad_𝔅_vector.z[i]) +
+               ℜ𝔅 * grad_𝔏_vector.z[i]);
+        }
+      }
+    }
+
+    // Sum the orders from the highest one down.
+    PerPointVector& degree_acceleration = block.degree_accelerations[n];
+    degree_acceleration = block.order_accelerations[max_order];
+    for (int m = max_order - 1; m >= 0; --m) {
+      if (n == 2 && m == 1) {
+        continue;
+      }
+      PerPointVector const& order_acceleration = block.order_accelerations[m];
+      for (int i = 0; i < count; ++i) {
+        degree_acceleration.x[i] =
+            order_acceleration.x[i] + degree_acceleration.x[i];
+        degree_acceleration.y[i] =
+            order_acceleration.y[i] + degree_acceleration.y[i];
+        degree_acceleration.z[i] =
+            order_acceleration.z[i] + degree_acceleration.z[i];
+      }
+    }
+  }
+
+  // Sum the degrees from the highest one down.
+  PerPointVector acceleration = block.degree_accelerations[max_degree];
+  for (int n = max_degree - 1; n >= 2; --n) {
+    PerPointVector const& degree_acceleration = block.degree_accelerations[n];
+    for (int i = 0; i < count; ++i) {
+      acceleration.x[i] = degree_acceleration.x[i] + acceleration.x[i];
+      acceleration.y[i] = degree_acceleration.y[i] + acceleration.y[i];
+      acceleration.z[i] = degree_acceleration.z[i] + acceleration.z[i];
+    }
+  }
+  for (int i = 0; i < count; ++i) {
+    accelerations[block.indices[i]] = Vector<ReducedAcceleration, Frame>(
+        {acceleration.x[i] * si::Unit<ReducedAcceleration>,
+         acceleration.y[i] * si::Unit<ReducedAcceleration>,
+         acceleration.z[i] * si::Unit<ReducedAcceleration>});
+  }
+}
+
+template<typename Frame>
+template<typename Scalar>
+void Geopotential<Frame>::Store(
+    Vector<Scalar, Frame> const& vector,
+    int const i,
+    typename BlockPrecomputations::PerPointVector& per_point_vector) {
+  auto const& coordinates = vector.coordinates();
+  per_point_vector.x[i] = coordinates.x / si::Unit<Scalar>;
+  per_point_vector.y[i] = coordinates.y / si::Unit<Scalar>;
+  per_point_vector.z[i] = coordinates.z / si::Unit<Scalar>;
+}
+
 template<typename Frame>
 const Vector<double, typename Geopotential<Frame>::SurfaceFrame>
     Geopotential<Frame>::x_({1, 0, 0});
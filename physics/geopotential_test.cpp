@@ -103,6 +103,25 @@ class GeopotentialTest : public ::testing::Test {
         t, r, r_norm, r², one_over_r³);
   }
 
+  // Bypasses the kernel chosen at construction.
+  template<typename Frame>
+  static Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
+  GeneralAcceleration(Geopotential<Frame> const& geopotential,
+                      Instant const& t,
+                      Displacement<Frame> const& r) {
+    auto const r² = r.Norm²();
+    auto const r_norm = Sqrt(r²);
+    auto const one_over_r³ = r_norm / (r² * r²);
+    return Geopotential<Frame>::GeneralAcceleration(
+        geopotential, t, r, r_norm, r², one_over_r³);
+  }
+
+  template<typename Frame>
+  static bool UsesGeneralAcceleration(Geopotential<Frame> const& geopotential) {
+    return geopotential.acceleration_kernel_ ==
+           &Geopotential<Frame>::GeneralAcceleration;
+  }
+
   template<typename Frame>
   static Quotient<SpecificEnergy, GravitationalParameter>
   GeneralSphericalHarmonicsPotential(Geopotential<Frame> const& geopotential,
@@ -797,6 +816,105 @@ TEST_F(GeopotentialTest, DampedForces) {
               Gt(earth_geopotential.degree_damping()[3].inner_threshold()));
 }
 
+TEST_F(GeopotentialTest, BatchedAcceleration) {
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+  solar_system_2000.LimitOblatenessToDegree("Earth", /*max_degree=*/10);
+  auto earth_message = solar_system_2000.gravity_model_message("Earth");
+  auto const earth = solar_system_2000.MakeOblateBody(earth_message);
+  Geopotential<ICRS> const geopotential(earth.get(), /*tolerance=*/0x1.0p-24);
+
+  // The distances span the thresholds of the geopotential, so that the points
+  // have different limiting degrees and some of them are zonal.  The number of
+  // points is not a multiple of the block size.
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> direction_distribution(-1, 1);
+  std::uniform_real_distribution<double> log_distance_distribution(6.5, 9.5);
+  std::vector<Displacement<ICRS>> displacements;
+  for (int i = 0; i < 1001; ++i) {
+    Vector<double, ICRS> const direction({direction_distribution(random),
+                                          direction_distribution(random),
+                                          direction_distribution(random)});
+    displacements.push_back(
+        std::pow(10, log_distance_distribution(random)) * Metre *
+        direction / direction.Norm());
+  }
+  // A point on the polar axis, where the longitude is undefined.
+  displacements.push_back(
+      Displacement<ICRS>({0 * Metre, 0 * Metre, 7e6 * Metre}));
+
+  Instant const t = Instant() + 1 * Hour;
+  std::vector<Vector<Quotient<Acceleration, GravitationalParameter>, ICRS>>
+      accelerations(displacements.size());
+  geopotential.GeneralSphericalHarmonicsAccelerations(
+      t, displacements, accelerations);
+  for (int i = 0; i < displacements.size(); ++i) {
+    EXPECT_THAT(accelerations[i],
+                Eq(GeneralSphericalHarmonicsAcceleration(
+                    geopotential, t, displacements[i])))
+        << i;
+  }
+}
+
+TEST_F(GeopotentialTest, ZonalAcceleration) {
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+
+  for (int const max_degree : {10, 7, 4, 3, 2}) {
+    solar_system_2000.LimitOblatenessToDegree("Earth", max_degree);
+
+    // Keep only the zonal coefficients of the Earth.
+    auto message = solar_system_2000.gravity_model_message("Earth");
+    for (auto& row : *message.mutable_geopotential()->mutable_row()) {
+      auto const columns = row.column();
+      row.clear_column();
+      for (auto const& column : columns) {
+        if (column.order() == 0) {
+          *row.add_column() = column;
+        }
+      }
+    }
+    auto const earth = solar_system_2000.MakeOblateBody(message);
+    ASSERT_TRUE(earth->is_zonal());
+    Geopotential<ICRS> const geopotential(earth.get(),
+                                          /*tolerance=*/0x1.0p-24);
+    ASSERT_FALSE(UsesGeneralAcceleration(geopotential));
+
+    // The distances cover the damped and undamped regions of all the degrees.
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> direction_distribution(-1, 1);
+    std::uniform_real_distribution<double> log_distance_distribution(6.5, 9.5);
+    for (int i = 0; i < 1000; ++i) {
+      Vector<double, ICRS> const direction({direction_distribution(random),
+                                            direction_distribution(random),
+                                            direction_distribution(random)});
+      Displacement<ICRS> const displacement =
+          std::pow(10, log_distance_distribution(random)) * Metre *
+          direction / direction.Norm();
+      EXPECT_THAT(GeneralSphericalHarmonicsAcceleration(
+                      geopotential, Instant(), displacement),
+                  Eq(GeneralAcceleration(geopotential,
+                                         Instant(),
+                                         displacement)))
+          << max_degree << " " << i;
+    }
+
+    // On the polar axis.
+    Displacement<ICRS> const polar_displacement =
+        7e6 * Metre * earth->polar_axis();
+    EXPECT_THAT(GeneralSphericalHarmonicsAcceleration(
+                    geopotential, Instant(), polar_displacement),
+                Eq(GeneralAcceleration(geopotential,
+                                       Instant(),
+                                       polar_displacement)))
+        << max_degree;
+  }
+}
+
 TEST_F(GeopotentialTest, Potential) {
   SolarSystem<ICRS> solar_system_2000(
             SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
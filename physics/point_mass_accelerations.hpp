@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/space.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace _point_mass_accelerations {
+namespace internal {
+
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_space;
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+
+// A kernel computing the mutual gravitational accelerations of a system of
+// point masses, and the accelerations that they exert on massless bodies.  The
+// positions and accelerations are transposed into structure-of-arrays buffers
+// of doubles (in SI units), so that the interactions of one body with several
+// other bodies may be computed with SIMD instructions.  AVX is used if the
+// compiler can emit VEX-encoded instructions and the processor supports them,
+// SSE2 is used otherwise.  Note that the compiler can emit VEX-encoded
+// instructions only with MSVC or when targeting AVX, so the default Linux and
+// macOS builds only use SSE2.
+// The operations are performed in the same order and with the same roundings
+// as the scalar loops of |Ephemeris|, and in particular no FMA is used, so the
+// results are bitwise identical to those of the scalar loops.
+// This class is thread-safe: the buffers are thread-local.
+template<typename Frame>
+class PointMassAccelerations final {
+ public:
+  // An empty system.
+  PointMassAccelerations() = default;
+  explicit PointMassAccelerations(
+      std::vector<GravitationalParameter> const& gravitational_parameters);
+
+  // The number of point masses.
+  std::size_t size() const;
+
+  // Adds to the |accelerations| with indices [offset, offset + size()[ the
+  // accelerations resulting from the mutual attraction of the point masses
+  // located at the |positions| with indices [offset, offset + size()[.  The
+  // other elements of |accelerations| are not touched.
+  void Add(std::vector<Position<Frame>> const& positions,
+           std::size_t offset,
+           std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+  // Adds to the |accelerations| of the massless bodies located at
+  // |massless_positions| the accelerations exerted by the point masses located
+  // at the |positions| with indices [offset, offset + size()[.  Returns false
+  // iff one of the massless bodies is not farther from a point mass than the
+  // corresponding element of |collision_radii|.
+  bool AddOnMasslessBodies(
+      std::vector<Position<Frame>> const& positions,
+      std::size_t offset,
+      std::vector<Length> const& collision_radii,
+      std::vector<Position<Frame>> const& massless_positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const;
+
+ private:
+  // The gravitational parameters, in m³/s².
+  std::vector<double> μ_;
+};
+
+}  // namespace internal
+
+using internal::PointMassAccelerations;
+
+}  // namespace _point_mass_accelerations
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/point_mass_accelerations_body.hpp"
@@ -0,0 +1,456 @@
+#pragma once
+
+#include "physics/point_mass_accelerations.hpp"
+
+#include <immintrin.h>
+
+#include <cmath>
+#include <vector>
+
+#include "base/cpuid.hpp"
+#include "base/macros.hpp"  // 🧙 For PRINCIPIA_COMPILER_MSVC.
+#include "glog/logging.h"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace _point_mass_accelerations {
+namespace internal {
+
+using namespace principia::base::_cpuid;
+using namespace principia::quantities::_si;
+
+// With clang, using AVX requires VEX-encoding everything; see #3019.  This is
+// the case when the translation unit targets AVX (e.g., with -mavx), otherwise
+// only MSVC compiles the 256-bit path.
+#if PRINCIPIA_COMPILER_MSVC || defined(__AVX__)
+constexpr bool CanEmitAVXInstructions = true;
+#else
+constexpr bool CanEmitAVXInstructions = false;
+#endif
+
+inline bool const UseAVX =
+    CanEmitAVXInstructions && CPUIDFeatureFlag::AVX.IsSet();
+
+// The structure-of-arrays buffers used by the kernel.  They are reused across
+// calls to avoid allocating.
+struct Buffers {
+  std::vector<double> qx;
+  std::vector<double> qy;
+  std::vector<double> qz;
+  std::vector<double> ax;
+  std::vector<double> ay;
+  std::vector<double> az;
+};
+
+// The functions below compute the interaction of the body |b1| with the bodies
+// starting at |b2| and return the index of the first body that they didn't
+// process.  The acceleration of |b1| is accumulated in |a1x|, |a1y| and |a1z|,
+// one body at a time, in the order of increasing indices.
+
+inline std::size_t AddAccelerationsAVX(std::size_t const n,
+                                       double const* const μ,
+                                       Buffers& buffers,
+                                       std::size_t const b1,
+                                       std::size_t b2,
+                                       double& a1x,
+                                       double& a1y,
+                                       double& a1z) {
+  if constexpr (CanEmitAVXInstructions) {
+    __m256d const x1 = _mm256_set1_pd(buffers.qx[b1]);
+    __m256d const y1 = _mm256_set1_pd(buffers.qy[b1]);
+    __m256d const z1 = _mm256_set1_pd(buffers.qz[b1]);
+    __m256d const μ1 = _mm256_set1_pd(μ[b1]);
+    alignas(32) double reaction_x[4];
+    alignas(32) double reaction_y[4];
+    alignas(32) double reaction_z[4];
+    for (; b2 + 4 <= n; b2 += 4) {
+      // A vector from the center of |b2| to the center of |b1|.
+      __m256d const Δx = _mm256_sub_pd(x1, _mm256_loadu_pd(&buffers.qx[b2]));
+      __m256d const Δy = _mm256_sub_pd(y1, _mm256_loadu_pd(&buffers.qy[b2]));
+      __m256d const Δz = _mm256_sub_pd(z1, _mm256_loadu_pd(&buffers.qz[b2]));
+
+      __m256d const Δq² = _mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(Δx, Δx), _mm256_mul_pd(Δy, Δy)),
+          _mm256_mul_pd(Δz, Δz));
+      __m256d const Δq_norm = _mm256_sqrt_pd(Δq²);
+      __m256d const one_over_Δq³ =
+          _mm256_div_pd(Δq_norm, _mm256_mul_pd(Δq², Δq²));
+
+      __m256d const μ1_over_Δq³ = _mm256_mul_pd(μ1, one_over_Δq³);
+      _mm256_storeu_pd(&buffers.ax[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.ax[b2]),
+                                     _mm256_mul_pd(Δx, μ1_over_Δq³)));
+      _mm256_storeu_pd(&buffers.ay[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.ay[b2]),
+                                     _mm256_mul_pd(Δy, μ1_over_Δq³)));
+      _mm256_storeu_pd(&buffers.az[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.az[b2]),
+                                     _mm256_mul_pd(Δz, μ1_over_Δq³)));
+
+      __m256d const μ2_over_Δq³ =
+          _mm256_mul_pd(_mm256_loadu_pd(&μ[b2]), one_over_Δq³);
+      _mm256_store_pd(reaction_x, _mm256_mul_pd(Δx, μ2_over_Δq³));
+      _mm256_store_pd(reaction_y, _mm256_mul_pd(Δy, μ2_over_Δq³));
+      _mm256_store_pd(reaction_z, _mm256_mul_pd(Δz, μ2_over_Δq³));
+      for (int i = 0; i < 4; ++i) {
+        a1x -= reaction_x[i];
+        a1y -= reaction_y[i];
+        a1z -= reaction_z[i];
+      }
+    }
+    return b2;
+  } else {
+    LOG(FATAL) << "Clang cannot use AVX without VEX-encoding everything";
+  }
+}
+
+inline std::size_t AddAccelerationsSSE2(std::size_t const n,
+                                        double const* const μ,
+                                        Buffers& buffers,
+                                        std::size_t const b1,
+                                        std::size_t b2,
+                                        double& a1x,
+                                        double& a1y,
+                                        double& a1z) {
+  __m128d const x1 = _mm_set1_pd(buffers.qx[b1]);
+  __m128d const y1 = _mm_set1_pd(buffers.qy[b1]);
+  __m128d const z1 = _mm_set1_pd(buffers.qz[b1]);
+  __m128d const μ1 = _mm_set1_pd(μ[b1]);
+  alignas(16) double reaction_x[2];
+  alignas(16) double reaction_y[2];
+  alignas(16) double reaction_z[2];
+  for (; b2 + 2 <= n; b2 += 2) {
+    // A vector from the center of |b2| to the center of |b1|.
+    __m128d const Δx = _mm_sub_pd(x1, _mm_loadu_pd(&buffers.qx[b2]));
+    __m128d const Δy = _mm_sub_pd(y1, _mm_loadu_pd(&buffers.qy[b2]));
+    __m128d const Δz = _mm_sub_pd(z1, _mm_loadu_pd(&buffers.qz[b2]));
+
+    __m128d const Δq² =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(Δx, Δx), _mm_mul_pd(Δy, Δy)),
+                   _mm_mul_pd(Δz, Δz));
+    __m128d const Δq_norm = _mm_sqrt_pd(Δq²);
+    __m128d const one_over_Δq³ = _mm_div_pd(Δq_norm, _mm_mul_pd(Δq², Δq²));
+
+    __m128d const μ1_over_Δq³ = _mm_mul_pd(μ1, one_over_Δq³);
+    _mm_storeu_pd(&buffers.ax[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.ax[b2]),
+                             _mm_mul_pd(Δx, μ1_over_Δq³)));
+    _mm_storeu_pd(&buffers.ay[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.ay[b2]),
+                             _mm_mul_pd(Δy, μ1_over_Δq³)));
+    _mm_storeu_pd(&buffers.az[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.az[b2]),
+                             _mm_mul_pd(Δz, μ1_over_Δq³)));
+
+    __m128d const μ2_over_Δq³ = _mm_mul_pd(_mm_loadu_pd(&μ[b2]), one_over_Δq³);
+    _mm_store_pd(reaction_x, _mm_mul_pd(Δx, μ2_over_Δq³));
+    _mm_store_pd(reaction_y, _mm_mul_pd(Δy, μ2_over_Δq³));
+    _mm_store_pd(reaction_z, _mm_mul_pd(Δz, μ2_over_Δq³));
+    for (int i = 0; i < 2; ++i) {
+      a1x -= reaction_x[i];
+      a1y -= reaction_y[i];
+      a1z -= reaction_z[i];
+    }
+  }
+  return b2;
+}
+
+inline std::size_t AddAccelerationsScalar(std::size_t const n,
+                                          double const* const μ,
+                                          Buffers& buffers,
+                                          std::size_t const b1,
+                                          std::size_t b2,
+                                          double& a1x,
+                                          double& a1y,
+                                          double& a1z) {
+  double const x1 = buffers.qx[b1];
+  double const y1 = buffers.qy[b1];
+  double const z1 = buffers.qz[b1];
+  double const μ1 = μ[b1];
+  for (; b2 < n; ++b2) {
+    // A vector from the center of |b2| to the center of |b1|.
+    double const Δx = x1 - buffers.qx[b2];
+    double const Δy = y1 - buffers.qy[b2];
+    double const Δz = z1 - buffers.qz[b2];
+
+    double const Δq² = Δx * Δx + Δy * Δy + Δz * Δz;
+    double const Δq_norm = std::sqrt(Δq²);
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+
+    double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    buffers.ax[b2] += Δx * μ1_over_Δq³;
+    buffers.ay[b2] += Δy * μ1_over_Δq³;
+    buffers.az[b2] += Δz * μ1_over_Δq³;
+
+    double const μ2_over_Δq³ = μ[b2] * one_over_Δq³;
+    a1x -= Δx * μ2_over_Δq³;
+    a1y -= Δy * μ2_over_Δq³;
+    a1z -= Δz * μ2_over_Δq³;
+  }
+  return b2;
+}
+
+// The functions below compute the accelerations exerted by a point mass with
+// coordinates |x1|, |y1|, |z1| on the massless bodies in |buffers| starting at
+// |b2|, and return the index of the first body that they didn't process.  They
+// set |collision| if one of the massless bodies is not farther than
+// |collision_radius| from the point mass.
+
+inline std::size_t AddMasslessAccelerationsAVX(std::size_t const n,
+                                               double const x1,
+                                               double const y1,
+                                               double const z1,
+                                               double const μ1,
+                                               double const collision_radius,
+                                               Buffers& buffers,
+                                               std::size_t b2,
+                                               bool& collision) {
+  if constexpr (CanEmitAVXInstructions) {
+    __m256d const x1_256d = _mm256_set1_pd(x1);
+    __m256d const y1_256d = _mm256_set1_pd(y1);
+    __m256d const z1_256d = _mm256_set1_pd(z1);
+    __m256d const μ1_256d = _mm256_set1_pd(μ1);
+    __m256d const collision_radius_256d = _mm256_set1_pd(collision_radius);
+    // Note that NaNs are collisions.
+    __m256d collisions = _mm256_setzero_pd();
+    for (; b2 + 4 <= n; b2 += 4) {
+      // A vector from the center of |b2| to the center of |b1|.
+      __m256d const Δx =
+          _mm256_sub_pd(x1_256d, _mm256_loadu_pd(&buffers.qx[b2]));
+      __m256d const Δy =
+          _mm256_sub_pd(y1_256d, _mm256_loadu_pd(&buffers.qy[b2]));
+      __m256d const Δz =
+          _mm256_sub_pd(z1_256d, _mm256_loadu_pd(&buffers.qz[b2]));
+
+      __m256d const Δq² = _mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(Δx, Δx), _mm256_mul_pd(Δy, Δy)),
+          _mm256_mul_pd(Δz, Δz));
+      __m256d const Δq_norm = _mm256_sqrt_pd(Δq²);
+      collisions = _mm256_or_pd(
+          collisions,
+          _mm256_cmp_pd(Δq_norm, collision_radius_256d, _CMP_NGT_UQ));
+      __m256d const one_over_Δq³ =
+          _mm256_div_pd(Δq_norm, _mm256_mul_pd(Δq², Δq²));
+
+      __m256d const μ1_over_Δq³ = _mm256_mul_pd(μ1_256d, one_over_Δq³);
+      _mm256_storeu_pd(&buffers.ax[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.ax[b2]),
+                                     _mm256_mul_pd(Δx, μ1_over_Δq³)));
+      _mm256_storeu_pd(&buffers.ay[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.ay[b2]),
+                                     _mm256_mul_pd(Δy, μ1_over_Δq³)));
+      _mm256_storeu_pd(&buffers.az[b2],
+                       _mm256_add_pd(_mm256_loadu_pd(&buffers.az[b2]),
+                                     _mm256_mul_pd(Δz, μ1_over_Δq³)));
+    }
+    collision |= _mm256_movemask_pd(collisions) != 0;
+    return b2;
+  } else {
+    LOG(FATAL) << "Clang cannot use AVX without VEX-encoding everything";
+  }
+}
+
+inline std::size_t AddMasslessAccelerationsSSE2(std::size_t const n,
+                                                double const x1,
+                                                double const y1,
+                                                double const z1,
+                                                double const μ1,
+                                                double const collision_radius,
+                                                Buffers& buffers,
+                                                std::size_t b2,
+                                                bool& collision) {
+  __m128d const x1_128d = _mm_set1_pd(x1);
+  __m128d const y1_128d = _mm_set1_pd(y1);
+  __m128d const z1_128d = _mm_set1_pd(z1);
+  __m128d const μ1_128d = _mm_set1_pd(μ1);
+  __m128d const collision_radius_128d = _mm_set1_pd(collision_radius);
+  // Note that NaNs are collisions.
+  __m128d collisions = _mm_setzero_pd();
+  for (; b2 + 2 <= n; b2 += 2) {
+    // A vector from the center of |b2| to the center of |b1|.
+    __m128d const Δx = _mm_sub_pd(x1_128d, _mm_loadu_pd(&buffers.qx[b2]));
+    __m128d const Δy = _mm_sub_pd(y1_128d, _mm_loadu_pd(&buffers.qy[b2]));
+    __m128d const Δz = _mm_sub_pd(z1_128d, _mm_loadu_pd(&buffers.qz[b2]));
+
+    __m128d const Δq² =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(Δx, Δx), _mm_mul_pd(Δy, Δy)),
+                   _mm_mul_pd(Δz, Δz));
+    __m128d const Δq_norm = _mm_sqrt_pd(Δq²);
+    collisions = _mm_or_pd(collisions,
+                           _mm_cmpngt_pd(Δq_norm, collision_radius_128d));
+    __m128d const one_over_Δq³ = _mm_div_pd(Δq_norm, _mm_mul_pd(Δq², Δq²));
+
+    __m128d const μ1_over_Δq³ = _mm_mul_pd(μ1_128d, one_over_Δq³);
+    _mm_storeu_pd(&buffers.ax[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.ax[b2]),
+                             _mm_mul_pd(Δx, μ1_over_Δq³)));
+    _mm_storeu_pd(&buffers.ay[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.ay[b2]),
+                             _mm_mul_pd(Δy, μ1_over_Δq³)));
+    _mm_storeu_pd(&buffers.az[b2],
+                  _mm_add_pd(_mm_loadu_pd(&buffers.az[b2]),
+                             _mm_mul_pd(Δz, μ1_over_Δq³)));
+  }
+  collision |= _mm_movemask_pd(collisions) != 0;
+  return b2;
+}
+
+inline std::size_t AddMasslessAccelerationsScalar(
+    std::size_t const n,
+    double const x1,
+    double const y1,
+    double const z1,
+    double const μ1,
+    double const collision_radius,
+    Buffers& buffers,
+    std::size_t b2,
+    bool& collision) {
+  for (; b2 < n; ++b2) {
+    // A vector from the center of |b2| to the center of |b1|.
+    double const Δx = x1 - buffers.qx[b2];
+    double const Δy = y1 - buffers.qy[b2];
+    double const Δz = z1 - buffers.qz[b2];
+
+    double const Δq² = Δx * Δx + Δy * Δy + Δz * Δz;
+    double const Δq_norm = std::sqrt(Δq²);
+    collision |= !(Δq_norm > collision_radius);
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+
+    double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    buffers.ax[b2] += Δx * μ1_over_Δq³;
+    buffers.ay[b2] += Δy * μ1_over_Δq³;
+    buffers.az[b2] += Δz * μ1_over_Δq³;
+  }
+  return b2;
+}
+
+// Transposes |positions| and |accelerations|, starting at |offset|, into the
+// first |n| elements of |buffers|.  The conversions to SI units are exact.
+template<typename Frame>
+void Transpose(std::vector<Position<Frame>> const& positions,
+               std::vector<Vector<Acceleration, Frame>> const& accelerations,
+               std::size_t const offset,
+               std::size_t const n,
+               Buffers& buffers) {
+  buffers.qx.resize(n);
+  buffers.qy.resize(n);
+  buffers.qz.resize(n);
+  buffers.ax.resize(n);
+  buffers.ay.resize(n);
+  buffers.az.resize(n);
+  for (std::size_t b = 0; b < n; ++b) {
+    auto const q = (positions[offset + b] - Frame::origin).coordinates();
+    buffers.qx[b] = q.x / si::Unit<Length>;
+    buffers.qy[b] = q.y / si::Unit<Length>;
+    buffers.qz[b] = q.z / si::Unit<Length>;
+    auto const& a = accelerations[offset + b].coordinates();
+    buffers.ax[b] = a.x / si::Unit<Acceleration>;
+    buffers.ay[b] = a.y / si::Unit<Acceleration>;
+    buffers.az[b] = a.z / si::Unit<Acceleration>;
+  }
+}
+
+// The converse of the above for the accelerations.
+template<typename Frame>
+void Untranspose(Buffers const& buffers,
+                 std::size_t const offset,
+                 std::size_t const n,
+                 std::vector<Vector<Acceleration, Frame>>& accelerations) {
+  for (std::size_t b = 0; b < n; ++b) {
+    accelerations[offset + b] = Vector<Acceleration, Frame>(
+        {buffers.ax[b] * si::Unit<Acceleration>,
+         buffers.ay[b] * si::Unit<Acceleration>,
+         buffers.az[b] * si::Unit<Acceleration>});
+  }
+}
+
+template<typename Frame>
+PointMassAccelerations<Frame>::PointMassAccelerations(
+    std::vector<GravitationalParameter> const& gravitational_parameters) {
+  μ_.reserve(gravitational_parameters.size());
+  for (auto const& μ : gravitational_parameters) {
+    μ_.push_back(μ / si::Unit<GravitationalParameter>);
+  }
+}
+
+template<typename Frame>
+std::size_t PointMassAccelerations<Frame>::size() const {
+  return μ_.size();
+}
+
+template<typename Frame>
+void PointMassAccelerations<Frame>::Add(
+    std::vector<Position<Frame>> const& positions,
+    std::size_t const offset,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  std::size_t const n = μ_.size();
+  CHECK_LE(offset + n, positions.size());
+  CHECK_LE(offset + n, accelerations.size());
+
+  thread_local Buffers buffers;
+  Transpose(positions, accelerations, offset, n, buffers);
+
+  double const* const μ = μ_.data();
+  for (std::size_t b1 = 0; b1 < n; ++b1) {
+    double a1x = buffers.ax[b1];
+    double a1y = buffers.ay[b1];
+    double a1z = buffers.az[b1];
+    std::size_t b2 = b1 + 1;
+    if (UseAVX) {
+      b2 = AddAccelerationsAVX(n, μ, buffers, b1, b2, a1x, a1y, a1z);
+    }
+    b2 = AddAccelerationsSSE2(n, μ, buffers, b1, b2, a1x, a1y, a1z);
+    b2 = AddAccelerationsScalar(n, μ, buffers, b1, b2, a1x, a1y, a1z);
+    DCHECK_EQ(n, b2);
+    buffers.ax[b1] = a1x;
+    buffers.ay[b1] = a1y;
+    buffers.az[b1] = a1z;
+  }
+
+  Untranspose(buffers, offset, n, accelerations);
+}
+
+template<typename Frame>
+bool PointMassAccelerations<Frame>::AddOnMasslessBodies(
+    std::vector<Position<Frame>> const& positions,
+    std::size_t const offset,
+    std::vector<Length> const& collision_radii,
+    std::vector<Position<Frame>> const& massless_positions,
+    std::vector<Vector<Acceleration, Frame>>& accelerations) const {
+  std::size_t const n = massless_positions.size();
+  CHECK_LE(offset + μ_.size(), positions.size());
+  CHECK_EQ(μ_.size(), collision_radii.size());
+  CHECK_EQ(n, accelerations.size());
+
+  thread_local Buffers buffers;
+  Transpose(massless_positions, accelerations, /*offset=*/0, n, buffers);
+
+  bool collision = false;
+  for (std::size_t b1 = 0; b1 < μ_.size(); ++b1) {
+    auto const q1 = (positions[offset + b1] - Frame::origin).coordinates();
+    double const x1 = q1.x / si::Unit<Length>;
+    double const y1 = q1.y / si::Unit<Length>;
+    double const z1 = q1.z / si::Unit<Length>;
+    double const μ1 = μ_[b1];
+    double const collision_radius = collision_radii[b1] / si::Unit<Length>;
+    std::size_t b2 = 0;
+    if (UseAVX) {
+      b2 = AddMasslessAccelerationsAVX(
+          n, x1, y1, z1, μ1, collision_radius, buffers, b2, collision);
+    }
+    b2 = AddMasslessAccelerationsSSE2(
+        n, x1, y1, z1, μ1, collision_radius, buffers, b2, collision);
+    b2 = AddMasslessAccelerationsScalar(
+        n, x1, y1, z1, μ1, collision_radius, buffers, b2, collision);
+    DCHECK_EQ(n, b2);
+  }
+
+  Untranspose(buffers, /*offset=*/0, n, accelerations);
+  return !collision;
+}
+
+}  // namespace internal
+}  // namespace _point_mass_accelerations
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,212 @@
+#include "physics/point_mass_accelerations.hpp"
+
+#include <random>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/space.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using ::testing::ElementsAreArray;
+using namespace principia::geometry::_frame;
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_space;
+using namespace principia::physics::_point_mass_accelerations;
+using namespace principia::quantities::_elementary_functions;
+using namespace principia::quantities::_named_quantities;
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+
+class PointMassAccelerationsTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  PointMassAccelerationsTest() : random_(42) {}
+
+  // The scalar loop of |Ephemeris| for spherical bodies.
+  static void ScalarAccelerations(
+      std::vector<GravitationalParameter> const& μ,
+      std::vector<Position<World>> const& positions,
+      std::size_t const offset,
+      std::vector<Vector<Acceleration, World>>& accelerations) {
+    for (std::size_t b1 = offset; b1 < offset + μ.size(); ++b1) {
+      Vector<Acceleration, World>& acceleration_on_b1 = accelerations[b1];
+      GravitationalParameter const& μ1 = μ[b1 - offset];
+      for (std::size_t b2 = b1 + 1; b2 < offset + μ.size(); ++b2) {
+        Vector<Acceleration, World>& acceleration_on_b2 = accelerations[b2];
+        GravitationalParameter const& μ2 = μ[b2 - offset];
+        Displacement<World> const Δq = positions[b1] - positions[b2];
+        Square<Length> const Δq² = Δq.Norm²();
+        Length const Δq_norm = Sqrt(Δq²);
+        Exponentiation<Length, -3> const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+        acceleration_on_b2 += Δq * (μ1 * one_over_Δq³);
+        acceleration_on_b1 -= Δq * (μ2 * one_over_Δq³);
+      }
+    }
+  }
+
+  // The scalar loop of |Ephemeris| for spherical bodies acting on massless
+  // bodies.
+  static bool ScalarMasslessAccelerations(
+      std::vector<GravitationalParameter> const& μ,
+      std::vector<Position<World>> const& positions,
+      std::vector<Length> const& collision_radii,
+      std::vector<Position<World>> const& massless_positions,
+      std::vector<Vector<Acceleration, World>>& accelerations) {
+    bool collision = false;
+    for (std::size_t b1 = 0; b1 < μ.size(); ++b1) {
+      for (std::size_t b2 = 0; b2 < massless_positions.size(); ++b2) {
+        Displacement<World> const Δq = positions[b1] - massless_positions[b2];
+        Square<Length> const Δq² = Δq.Norm²();
+        Length const Δq_norm = Sqrt(Δq²);
+        collision |= !(Δq_norm > collision_radii[b1]);
+        Exponentiation<Length, -3> const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+        accelerations[b2] += Δq * (μ[b1] * one_over_Δq³);
+      }
+    }
+    return !collision;
+  }
+
+  std::vector<GravitationalParameter> RandomGravitationalParameters(
+      int const n) {
+    std::uniform_real_distribution<double> μ_distribution(1e10, 1e20);
+    std::vector<GravitationalParameter> μ;
+    for (int i = 0; i < n; ++i) {
+      μ.push_back(μ_distribution(random_) * Pow<3>(Metre) / Pow<2>(Second));
+    }
+    return μ;
+  }
+
+  std::vector<Position<World>> RandomPositions(int const n) {
+    std::uniform_real_distribution<double> length_distribution(-1e12, 1e12);
+    std::vector<Position<World>> positions;
+    for (int i = 0; i < n; ++i) {
+      positions.push_back(
+          World::origin +
+          Displacement<World>({length_distribution(random_) * Metre,
+                               length_distribution(random_) * Metre,
+                               length_distribution(random_) * Metre}));
+    }
+    return positions;
+  }
+
+  std::vector<Vector<Acceleration, World>> RandomAccelerations(int const n) {
+    std::uniform_real_distribution<double> acceleration_distribution(-1, 1);
+    std::vector<Vector<Acceleration, World>> accelerations;
+    for (int i = 0; i < n; ++i) {
+      accelerations.push_back(Vector<Acceleration, World>(
+          {acceleration_distribution(random_) * Metre / Pow<2>(Second),
+           acceleration_distribution(random_) * Metre / Pow<2>(Second),
+           acceleration_distribution(random_) * Metre / Pow<2>(Second)}));
+    }
+    return accelerations;
+  }
+
+  std::mt19937_64 random_;
+};
+
+TEST_F(PointMassAccelerationsTest, BitwiseIdenticalToScalar) {
+  // Exercise all the combinations of vector and scalar tails.
+  for (int n = 1; n <= 17; ++n) {
+    auto const μ = RandomGravitationalParameters(n);
+    auto const positions = RandomPositions(n);
+    auto const initial_accelerations = RandomAccelerations(n);
+
+    PointMassAccelerations<World> const kernel(μ);
+    EXPECT_EQ(n, kernel.size());
+
+    auto expected_accelerations = initial_accelerations;
+    ScalarAccelerations(μ, positions, /*offset=*/0, expected_accelerations);
+    auto actual_accelerations = initial_accelerations;
+    kernel.Add(positions, /*offset=*/0, actual_accelerations);
+
+    EXPECT_THAT(actual_accelerations,
+                ElementsAreArray(expected_accelerations)) << n;
+  }
+}
+
+TEST_F(PointMassAccelerationsTest, Offset) {
+  int const offset = 3;
+  int const n = 11;
+  auto const μ = RandomGravitationalParameters(n);
+  auto const positions = RandomPositions(offset + n);
+  auto const initial_accelerations = RandomAccelerations(offset + n);
+
+  PointMassAccelerations<World> const kernel(μ);
+
+  auto expected_accelerations = initial_accelerations;
+  ScalarAccelerations(μ, positions, offset, expected_accelerations);
+  auto actual_accelerations = initial_accelerations;
+  kernel.Add(positions, offset, actual_accelerations);
+
+  EXPECT_THAT(actual_accelerations, ElementsAreArray(expected_accelerations));
+  // The elements before the offset are untouched.
+  for (int b = 0; b < offset; ++b) {
+    EXPECT_EQ(initial_accelerations[b], actual_accelerations[b]);
+  }
+}
+
+TEST_F(PointMassAccelerationsTest, MasslessBodies) {
+  int const n = 7;
+  auto const μ = RandomGravitationalParameters(n);
+  auto const positions = RandomPositions(n);
+  std::vector<Length> const collision_radii(n, 1e6 * Metre);
+  PointMassAccelerations<World> const kernel(μ);
+
+  for (int m = 1; m <= 9; ++m) {
+    auto const massless_positions = RandomPositions(m);
+    auto const initial_accelerations = RandomAccelerations(m);
+
+    auto expected_accelerations = initial_accelerations;
+    EXPECT_TRUE(ScalarMasslessAccelerations(μ,
+                                            positions,
+                                            collision_radii,
+                                            massless_positions,
+                                            expected_accelerations));
+    auto actual_accelerations = initial_accelerations;
+    EXPECT_TRUE(kernel.AddOnMasslessBodies(positions,
+                                           /*offset=*/0,
+                                           collision_radii,
+                                           massless_positions,
+                                           actual_accelerations));
+
+    EXPECT_THAT(actual_accelerations,
+                ElementsAreArray(expected_accelerations)) << m;
+  }
+}
+
+TEST_F(PointMassAccelerationsTest, Collision) {
+  int const n = 3;
+  auto const μ = RandomGravitationalParameters(n);
+  auto const positions = RandomPositions(n);
+  std::vector<Length> const collision_radii(n, 1e6 * Metre);
+  PointMassAccelerations<World> const kernel(μ);
+
+  // Each of the massless bodies in turn is close to the second point mass.
+  for (int m = 0; m < 5; ++m) {
+    auto massless_positions = RandomPositions(5);
+    massless_positions[m] =
+        positions[1] + Displacement<World>({1 * Metre, 2 * Metre, 3 * Metre});
+    auto accelerations = RandomAccelerations(5);
+    EXPECT_FALSE(kernel.AddOnMasslessBodies(positions,
+                                            /*offset=*/0,
+                                            collision_radii,
+                                            massless_positions,
+                                            accelerations)) << m;
+  }
+}
+
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "geometry/instant.hpp"
+#include "geometry/space.hpp"
+
+namespace principia {
+namespace physics {
+namespace _positions_cache {
+namespace internal {
+
+using namespace principia::geometry::_instant;
+using namespace principia::geometry::_space;
+
+// A small, thread-safe cache of the positions of a system of bodies, keyed by
+// time.  The cache is direct-mapped: inserting the positions for some time
+// evicts the entry, if any, that has the same slot, so the cache never grows.
+// All the entries are invalidated in constant time by bumping a generation
+// counter.  Lookups only take the lock of one slot in shared mode, so
+// concurrent readers don't block each other.  The storage of the evicted
+// entries is recycled, so that the cache doesn't allocate in the steady state.
+template<typename Frame>
+class PositionsCache {
+ public:
+  using Positions = std::vector<Position<Frame>>;
+
+  // Returns the positions inserted for |t| since the last call to
+  // |Invalidate|, or null if there are none.
+  std::shared_ptr<Positions const> Find(Instant const& t) const;
+
+  // Returns an empty vector in which to compute positions to be inserted.  Its
+  // storage is that of an evicted entry if one is available.
+  std::shared_ptr<Positions> NewPositions();
+
+  // Records the |positions| at |t|, possibly evicting another entry.
+  void Insert(Instant const& t, std::shared_ptr<Positions const> positions);
+
+  // Discards all the entries.  The caller must ensure that no call to |Insert|
+  // with positions computed before this call happens after it.
+  void Invalidate();
+
+  // The number of calls to |Find| that returned non-null, resp. null.
+  std::int64_t hits() const;
+  std::int64_t misses() const;
+
+ private:
+  static constexpr int number_of_slots = 16;
+
+  struct Slot {
+    mutable absl::Mutex lock;
+    std::int64_t generation GUARDED_BY(lock) = -1;
+    Instant time GUARDED_BY(lock);
+    std::shared_ptr<Positions const> positions GUARDED_BY(lock);
+  };
+
+  static int SlotIndex(Instant const& t);
+
+  std::array<Slot, number_of_slots> slots_;
+  // Evicted entries that nobody else references, ready for reuse by
+  // |NewPositions|.  At most |number_of_slots| of them are retained.
+  absl::Mutex free_positions_lock_;
+  std::vector<std::shared_ptr<Positions>> free_positions_
+      GUARDED_BY(free_positions_lock_);
+  std::atomic<std::int64_t> generation_ = 0;
+  mutable std::atomic<std::int64_t> hits_ = 0;
+  mutable std::atomic<std::int64_t> misses_ = 0;
+};
+
+}  // namespace internal
+
+using internal::PositionsCache;
+
+}  // namespace _positions_cache
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/positions_cache_body.hpp"
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "physics/positions_cache.hpp"
+
+#include <atomic>
+#include <bit>
+#include <utility>
+
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+namespace _positions_cache {
+namespace internal {
+
+using namespace principia::quantities::_quantities;
+using namespace principia::quantities::_si;
+
+template<typename Frame>
+std::shared_ptr<typename PositionsCache<Frame>::Positions const>
+PositionsCache<Frame>::Find(Instant const& t) const {
+  Slot const& slot = slots_[SlotIndex(t)];
+  std::int64_t const generation = generation_.load(std::memory_order_acquire);
+  {
+    absl::ReaderMutexLock l(&slot.lock);
+    if (slot.generation == generation && slot.time == t) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return slot.positions;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+}
+
+template<typename Frame>
+std::shared_ptr<typename PositionsCache<Frame>::Positions>
+PositionsCache<Frame>::NewPositions() {
+  {
+    absl::MutexLock l(&free_positions_lock_);
+    if (!free_positions_.empty()) {
+      std::shared_ptr<Positions> positions = std::move(free_positions_.back());
+      free_positions_.pop_back();
+      positions->clear();
+      return positions;
+    }
+  }
+  return std::make_shared<Positions>();
+}
+
+template<typename Frame>
+void PositionsCache<Frame>::Insert(
+    Instant const& t,
+    std::shared_ptr<Positions const> positions) {
+  Slot& slot = slots_[SlotIndex(t)];
+  std::int64_t const generation = generation_.load(std::memory_order_acquire);
+  std::shared_ptr<Positions const> evicted_positions;
+  {
+    absl::MutexLock l(&slot.lock);
+    slot.generation = generation;
+    slot.time = t;
+    evicted_positions = std::exchange(slot.positions, std::move(positions));
+  }
+  // Once out of the slot, the evicted positions cannot acquire new owners, so
+  // if we are the only owner we may safely reuse them.
+  if (evicted_positions != nullptr && evicted_positions.use_count() == 1) {
+    // Synchronize with the release of the other owners, if any, so that their
+    // reads happen before our writes.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    absl::MutexLock l(&free_positions_lock_);
+    if (free_positions_.size() < number_of_slots) {
+      free_positions_.push_back(
+          std::const_pointer_cast<Positions>(std::move(evicted_positions)));
+    }
+  }
+}
+
+template<typename Frame>
+void PositionsCache<Frame>::Invalidate() {
+  generation_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+template<typename Frame>
+std::int64_t PositionsCache<Frame>::hits() const {
+  return hits_.load(std::memory_order_relaxed);
+}
+
+template<typename Frame>
+std::int64_t PositionsCache<Frame>::misses() const {
+  return misses_.load(std::memory_order_relaxed);
+}
+
+template<typename Frame>
+int PositionsCache<Frame>::SlotIndex(Instant const& t) {
+  // The times are often multiples of some step, so their low-order bits are
+  // not random.  Use Fibonacci hashing to mix in the high-order bits.
+  std::uint64_t const bits =
+      std::bit_cast<std::uint64_t>((t - Instant()) / si::Unit<Time>);
+  return static_cast<int>((bits * 0x9E37'79B9'7F4A'7C15) >>
+                          (64 - std::bit_width<unsigned>(number_of_slots - 1)));
+}
+
+}  // namespace internal
+}  // namespace _positions_cache
+}  // namespace physics
+}  // namespace principia
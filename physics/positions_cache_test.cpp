@@ -0,0 +1,121 @@
+#include "physics/positions_cache.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/instant.hpp"
+#include "geometry/space.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace physics {
+
+using ::testing::ElementsAre;
+using ::testing::IsNull;
+using ::testing::NotNull;
+using namespace principia::geometry::_frame;
+using namespace principia::geometry::_grassmann;
+using namespace principia::geometry::_instant;
+using namespace principia::geometry::_space;
+using namespace principia::physics::_positions_cache;
+using namespace principia::quantities::_si;
+
+class PositionsCacheTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+  using Positions = PositionsCache<World>::Positions;
+
+  static std::shared_ptr<Positions const> MakePositions(double const x) {
+    return std::make_shared<Positions const>(Positions{
+        World::origin +
+            Displacement<World>({x * Metre, 2 * Metre, 3 * Metre})});
+  }
+
+  PositionsCache<World> cache_;
+};
+
+TEST_F(PositionsCacheTest, HitsAndMisses) {
+  Instant const t0 = Instant() + 1 * Second;
+  Instant const t1 = Instant() + 2 * Second;
+  EXPECT_THAT(cache_.Find(t0), IsNull());
+
+  cache_.Insert(t0, MakePositions(1));
+  auto const positions = cache_.Find(t0);
+  ASSERT_THAT(positions, NotNull());
+  EXPECT_THAT(*positions,
+              ElementsAre(World::origin +
+                          Displacement<World>(
+                              {1 * Metre, 2 * Metre, 3 * Metre})));
+  EXPECT_THAT(cache_.Find(t1), IsNull());
+
+  EXPECT_EQ(1, cache_.hits());
+  EXPECT_EQ(2, cache_.misses());
+}
+
+TEST_F(PositionsCacheTest, Invalidate) {
+  Instant const t = Instant() + 1 * Second;
+  cache_.Insert(t, MakePositions(1));
+  ASSERT_THAT(cache_.Find(t), NotNull());
+
+  cache_.Invalidate();
+  EXPECT_THAT(cache_.Find(t), IsNull());
+
+  cache_.Insert(t, MakePositions(4));
+  auto const positions = cache_.Find(t);
+  ASSERT_THAT(positions, NotNull());
+  EXPECT_EQ(4 * Metre, ((*positions)[0] - World::origin).coordinates().x);
+}
+
+TEST_F(PositionsCacheTest, Bounded) {
+  // Insert many more times than there are slots.  The most recent entry is
+  // always found.
+  Instant const t0 = Instant();
+  for (int i = 0; i < 1000; ++i) {
+    Instant const t = t0 + i * 10 * Second;
+    cache_.Insert(t, MakePositions(i));
+    auto const positions = cache_.Find(t);
+    ASSERT_THAT(positions, NotNull()) << i;
+    EXPECT_EQ(i * Metre, ((*positions)[0] - World::origin).coordinates().x);
+  }
+  // Some of the old entries must have been evicted.
+  int found = 0;
+  for (int i = 0; i < 1000; ++i) {
+    found += cache_.Find(t0 + i * 10 * Second) != nullptr;
+  }
+  EXPECT_LE(found, 16);
+  EXPECT_LT(0, found);
+}
+
+TEST_F(PositionsCacheTest, Recycling) {
+  Instant const t0 = Instant();
+  // An entry that is still referenced when it is evicted.
+  cache_.Insert(t0, MakePositions(0));
+  auto const held_positions = cache_.Find(t0);
+  ASSERT_THAT(held_positions, NotNull());
+
+  int recycled = 0;
+  for (int i = 1; i < 1000; ++i) {
+    auto positions = cache_.NewPositions();
+    EXPECT_TRUE(positions->empty());
+    EXPECT_NE(positions.get(), held_positions.get());
+    recycled += positions->capacity() > 0;
+    positions->push_back(
+        World::origin +
+        Displacement<World>({i * Metre, 0 * Metre, 0 * Metre}));
+    cache_.Insert(t0 + i * 10 * Second, std::move(positions));
+  }
+  // Once the slots are full, the evicted entries are reused.
+  EXPECT_LT(900, recycled);
+  // The entry that was held is unaffected.
+  EXPECT_EQ(0 * Metre, ((*held_positions)[0] - World::origin).coordinates().x);
+}
+
+}  // namespace physics
+}  // namespace principia